@@ -0,0 +1,35 @@
+/**
+* OpenCL YUV color conversion
+*
+* Converts planar YUV 4:2:0 video frames to RGBA images. The Y plane is followed by the U and V planes at half resolution.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+
+
+__kernel void yuv420ToRgba(__write_only image2d_t dst_image, __global const uchar* planes, int width, int height)
+{
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+    if(x >= width || y >= height)
+    {
+        return;
+    }
+
+    int chromaWidth = width / 2;
+    __global const uchar* uPlane = planes + width * height;
+    __global const uchar* vPlane = uPlane + chromaWidth * (height / 2);
+    int chromaIndex = (y / 2) * chromaWidth + x / 2;
+
+    /* ITU-R BT.601 with limited range, as used by MPEG-1. */
+    float luma = 1.164f * ((float)planes[y * width + x] - 16.0f);
+    float u = (float)uPlane[chromaIndex] - 128.0f;
+    float v = (float)vPlane[chromaIndex] - 128.0f;
+
+    float4 col;
+    col.x = luma + 1.596f * v;
+    col.y = luma - 0.392f * u - 0.813f * v;
+    col.z = luma + 2.017f * u;
+    col.w = 255.0f;
+    write_imagef(dst_image, (int2)(x, y), clamp(col / 255.0f, 0.0f, 1.0f));
+}
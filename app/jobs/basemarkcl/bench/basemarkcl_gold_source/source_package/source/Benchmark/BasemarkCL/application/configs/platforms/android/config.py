@@ -10,4 +10,4 @@ module("default").env["CPPPATH"] += [ "../../.." + "/libraries/common/ffmpeg/inc
 #module("default").env["LIBS"] += ["OpenCL", "avcodec", "avformat", "swscale", "avutil"]
 
 module("default").env["LIBPATH"] += ["../../.." + "/libraries/platforms/android/ffmpeg/lib"]
-module("default").env["LIBS"] += ["avcodec", "avformat", "swscale", "avutil"]
+module("default").env["LIBS"] += ["avcodec", "avformat", "swscale", "avutil", "dl"]
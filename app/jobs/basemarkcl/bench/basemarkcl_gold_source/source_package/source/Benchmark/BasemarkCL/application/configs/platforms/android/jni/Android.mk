@@ -37,10 +37,13 @@ $(CLMARK_PATH_REL)/sources/clutil/clu_image.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_kernel.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_platform.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_program.c \
+$(CLMARK_PATH_REL)/sources/clutil/clu_program_cache.c \
+$(CLMARK_PATH_REL)/sources/clutil/clu_image_cache.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_util.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_floatbuffer.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_profiler.c \
 $(CLMARK_PATH_REL)/sources/clutil/clu_intbuffer.c \
+$(CLMARK_PATH_REL)/sources/clutil/clu_work_group_tuner.c \
 $(CLMARK_PATH_REL)/sources/clutil/video.c 
 
 LOCAL_SRC_FILES_BFUTIL := \
@@ -48,16 +51,20 @@ $(CLMARK_PATH_REL)/sources/benchmarkutil/bf_benchmark_framework.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_info.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_logger.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_report.c \
+$(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_score.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_report_document.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/xml/bf_xml_attribute.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/xml/bf_xml_document.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/xml/bf_xml_node.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_timer.c \
+$(CLMARK_PATH_REL)/sources/benchmarkutil/report/bf_counters.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/scene/bf_scene.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/scene/bf_scene_queue.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/screenshot/bf_screenshot.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/settings/bf_settings.c \
+$(CLMARK_PATH_REL)/sources/benchmarkutil/util/bf_device_scheduler.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/util/bf_input_state.c \
+$(CLMARK_PATH_REL)/sources/benchmarkutil/util/bf_timing_hook.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/util/bf_util.c \
 $(CLMARK_PATH_REL)/sources/benchmarkutil/bf_version.c 
 
@@ -67,8 +74,12 @@ $(CLMARK_PATH_REL)/sources/clmark/application_interface.c \
 $(CLMARK_PATH_REL)/sources/clmark/menu/cl_loadscreen.c \
 $(CLMARK_PATH_REL)/sources/clmark/menu/cl_menu.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_compiler.c \
+$(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_compiler_scaling.c \
+$(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_hash_map.c \
+$(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_launch_overhead.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_julia.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_mandelbulb.c \
+$(CLMARK_PATH_REL)/sources/clmark/tests/feature/cl_memory_bandwidth.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_bilateral.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_blur.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_histogram.c \
@@ -78,6 +89,7 @@ $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_median.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_sharpening.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/image/cl_video.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/physics/cl_fluid.c \
+$(CLMARK_PATH_REL)/sources/clmark/tests/physics/cl_physics_scaling.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/physics/cl_soft_body.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/physics/cl_sph.c \
 $(CLMARK_PATH_REL)/sources/clmark/tests/physics/cl_wave.c \
@@ -1,2 +1,2 @@
 
-module("default").env["LIBS"] += ["OpenCL", "avcodec", "avformat", "swscale", "avutil"]
+module("default").env["LIBS"] += ["OpenCL", "avcodec", "avformat", "swscale", "avutil", "dl"]
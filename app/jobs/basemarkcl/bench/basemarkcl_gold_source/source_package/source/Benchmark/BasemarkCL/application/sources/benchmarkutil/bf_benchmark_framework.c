@@ -12,6 +12,8 @@
 #include <benchmarkutil/report/bf_logger.h>
 #include <benchmarkutil/report/bf_report.h>
 #include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_score.h>
+#include <benchmarkutil/util/bf_timing_hook.h>
 
 #include <application/kza_application.h>
 
@@ -29,11 +31,15 @@
 #include <system/kzs_types.h>
 #include <system/debug/kzs_error.h>
 #include <system/debug/kzs_log.h>
+#include <system/wrappers/kzs_math.h>
 #include <system/wrappers/kzs_string.h>
 
 #include <stdio.h>
 
 #include <clutil/clu_platform.h>
+#include <clutil/clu_program_cache.h>
+#include <clutil/clu_image_cache.h>
+#include <clutil/clu_work_group_tuner.h>
 #include <clutil/clu_util.h>
 
 #ifdef WIN32
@@ -59,6 +65,12 @@ struct BenchmarkFramework
     struct BfReportLogger* reportLogger; /**< Logger utilities for report generation. */
 
     struct CluInfo* cluInfo; /**< CL info. */
+    struct CluProgramCache* programCache; /**< Cache of built program binaries. KZ_NULL if disabled. */
+    struct CluImageCache* imageCache; /**< Cache of decoded images. KZ_NULL if disabled. */
+    struct CluWorkGroupTuner* workGroupTuner; /**< Work-group size tuner. KZ_NULL if disabled. */
+    enum BfWorkGroupTuningMode workGroupTuningMode; /**< How tunable scenes use the work-group size tuner. */
+    struct BfScoreConfiguration scoreConfiguration; /**< Configuration of scene score statistics. */
+    struct BfTimingHook* timingHook; /**< Loaded timing hook plugin. KZ_NULL if not configured. */
 
     struct BfReportDocument* reportDocument; /**< Report document for storing the benchmark results. */
 
@@ -106,6 +118,56 @@ kzsError bfCreate(const struct KzcMemoryManager* memoryManager, struct KzuEngine
     }
     result = bfReportLoggerCreate(memoryManager, &framework->reportLogger);
     kzsErrorForward(result);
+    {
+        kzInt frameTimingMode;
+        result = settingGetInt(bfGetSettings(framework), "FrameTimingMode", &frameTimingMode);
+        kzsErrorForward(result);
+        bfReportLoggerSetTimingMode(framework->reportLogger, (frameTimingMode == 1) ? BF_REPORT_TIMING_DEVICE : BF_REPORT_TIMING_WALL_CLOCK);
+    }
+    {
+        kzInt hardwareCounters;
+        result = settingGetInt(bfGetSettings(framework), "HardwareCounters", &hardwareCounters);
+        kzsErrorForward(result);
+        if(hardwareCounters != 0)
+        {
+            /* Counters are opened before the OpenCL context, so that worker threads of CPU devices are counted. */
+            result = bfReportLoggerEnableHardwareCounters(framework->reportLogger);
+            kzsErrorForward(result);
+        }
+    }
+    {
+        kzInt warmupFrames;
+        kzInt trimPercent;
+        kzInt bootstrapResamples;
+        result = settingGetInt(bfGetSettings(framework), "ScoreWarmupFrames", &warmupFrames);
+        kzsErrorForward(result);
+        result = settingGetInt(bfGetSettings(framework), "ScoreTrimPercent", &trimPercent);
+        kzsErrorForward(result);
+        result = settingGetInt(bfGetSettings(framework), "ScoreBootstrapResamples", &bootstrapResamples);
+        kzsErrorForward(result);
+        framework->scoreConfiguration.warmupFrames = (kzUint)kzsMax(warmupFrames, 0);
+        framework->scoreConfiguration.trimPercent = (kzUint)kzsClampi(trimPercent, 0, 49);
+        framework->scoreConfiguration.bootstrapResamples = (kzUint)kzsMax(bootstrapResamples, 0);
+    }
+    {
+        kzInt adaptiveRunLength;
+        kzFloat targetPrecision;
+        kzInt timeBudget;
+        kzInt minimumFrames;
+        result = settingGetInt(bfGetSettings(framework), "AdaptiveRunLength", &adaptiveRunLength);
+        kzsErrorForward(result);
+        result = settingGetFloat(bfGetSettings(framework), "AdaptiveTargetPrecision", &targetPrecision);
+        kzsErrorForward(result);
+        result = settingGetInt(bfGetSettings(framework), "AdaptiveTimeBudget", &timeBudget);
+        kzsErrorForward(result);
+        result = settingGetInt(bfGetSettings(framework), "AdaptiveMinimumFrames", &minimumFrames);
+        kzsErrorForward(result);
+        framework->scoreConfiguration.adaptiveRunLength = (adaptiveRunLength == 1);
+        framework->scoreConfiguration.adaptiveTargetPrecision = kzsMaxf(targetPrecision, 0.0f);
+        framework->scoreConfiguration.adaptiveTimeBudget = (kzUint)kzsMax(timeBudget, 0);
+        /* Confidence interval needs at least two frames. */
+        framework->scoreConfiguration.adaptiveMinimumFrames = (kzUint)kzsMax(minimumFrames, 2);
+    }
 
     kzsLog(KZS_LOG_LEVEL_INFO, "Starting OpenCL benchmark");
     kzsLog(KZS_LOG_LEVEL_INFO, "");
@@ -137,6 +199,68 @@ kzsError bfCreate(const struct KzcMemoryManager* memoryManager, struct KzuEngine
     result = bfSceneQueueCreate(memoryManager, &framework->testQueue);
     kzsErrorForward(result);
 
+    framework->programCache = KZ_NULL;
+    {
+        kzInt programCacheEnabled;
+        result = settingGetInt(bfGetSettings(framework), "ProgramCache", &programCacheEnabled);
+        kzsErrorForward(result);
+        if(programCacheEnabled == 1)
+        {
+            kzString programCacheDirectory;
+            result = settingGetString(bfGetSettings(framework), "ProgramCacheDirectory", &programCacheDirectory);
+            kzsErrorForward(result);
+            result = cluProgramCacheCreate(memoryManager, programCacheDirectory, &framework->programCache);
+            kzsErrorForward(result);
+        }
+    }
+
+    framework->imageCache = KZ_NULL;
+    {
+        kzInt imageCacheEnabled;
+        result = settingGetInt(bfGetSettings(framework), "ImageCache", &imageCacheEnabled);
+        kzsErrorForward(result);
+        if(imageCacheEnabled == 1)
+        {
+            kzString imageCacheDirectory;
+            result = settingGetString(bfGetSettings(framework), "ImageCacheDirectory", &imageCacheDirectory);
+            kzsErrorForward(result);
+            result = cluImageCacheCreate(memoryManager, imageCacheDirectory, &framework->imageCache);
+            kzsErrorForward(result);
+        }
+    }
+
+    framework->workGroupTuner = KZ_NULL;
+    framework->workGroupTuningMode = BF_WORK_GROUP_TUNING_DISABLED;
+    {
+        kzInt workGroupTuning;
+        result = settingGetInt(bfGetSettings(framework), "WorkGroupTuning", &workGroupTuning);
+        kzsErrorForward(result);
+        if(workGroupTuning == 1 || workGroupTuning == 2)
+        {
+            kzString workGroupTuningDirectory;
+            result = settingGetString(bfGetSettings(framework), "WorkGroupTuningDirectory", &workGroupTuningDirectory);
+            kzsErrorForward(result);
+            result = cluWorkGroupTunerCreate(memoryManager, workGroupTuningDirectory, &framework->workGroupTuner);
+            kzsErrorForward(result);
+            framework->workGroupTuningMode = (workGroupTuning == 1) ? BF_WORK_GROUP_TUNING_ENABLED : BF_WORK_GROUP_TUNING_COMPARE;
+        }
+    }
+
+    framework->timingHook = KZ_NULL;
+    {
+        kzString timingHookLibrary;
+        result = settingGetString(bfGetSettings(framework), "TimingHookLibrary", &timingHookLibrary);
+        kzsErrorForward(result);
+        if(kzcStringLength(timingHookLibrary) > 0)
+        {
+            kzString timingHookArguments;
+            result = settingGetString(bfGetSettings(framework), "TimingHookArguments", &timingHookArguments);
+            kzsErrorForward(result);
+            result = bfTimingHookCreate(memoryManager, timingHookLibrary, timingHookArguments, &framework->timingHook);
+            kzsErrorForward(result);
+        }
+    }
+
     framework->application = application;
     framework->engine = engine;
     framework->application = application;
@@ -192,6 +316,30 @@ kzsError bfDelete(struct BenchmarkFramework* framework)
     result = cluInfoDelete(framework->cluInfo);
     kzsErrorForward(result);
 
+    if(framework->programCache != KZ_NULL)
+    {
+        result = cluProgramCacheDelete(framework->programCache);
+        kzsErrorForward(result);
+    }
+
+    if(framework->imageCache != KZ_NULL)
+    {
+        result = cluImageCacheDelete(framework->imageCache);
+        kzsErrorForward(result);
+    }
+
+    if(framework->workGroupTuner != KZ_NULL)
+    {
+        result = cluWorkGroupTunerDelete(framework->workGroupTuner);
+        kzsErrorForward(result);
+    }
+
+    if(framework->timingHook != KZ_NULL)
+    {
+        result = bfTimingHookDelete(framework->timingHook);
+        kzsErrorForward(result);
+    }
+
     result = kzcMemoryManagerDelete(framework->quickManager);
     kzsErrorForward(result);
 
@@ -489,6 +637,42 @@ struct CluInfo* bfGetCluInfo(const struct BenchmarkFramework* framework)
     return framework->cluInfo;
 }
 
+struct CluProgramCache* bfGetProgramCache(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return framework->programCache;
+}
+
+struct CluImageCache* bfGetImageCache(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return framework->imageCache;
+}
+
+struct CluWorkGroupTuner* bfGetWorkGroupTuner(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return framework->workGroupTuner;
+}
+
+enum BfWorkGroupTuningMode bfGetWorkGroupTuningMode(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return framework->workGroupTuningMode;
+}
+
+const struct BfTimingHook* bfGetTimingHook(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return framework->timingHook;
+}
+
+const struct BfScoreConfiguration* bfGetScoreConfiguration(const struct BenchmarkFramework* framework)
+{
+    kzsAssert(kzcIsValidPointer(framework));
+    return &framework->scoreConfiguration;
+}
+
 kzsError bfReportCreate(struct BenchmarkFramework* framework)
 {
     kzsError result;
@@ -568,6 +752,8 @@ kzsError bfSetTimingStartExecPath(struct BenchmarkFramework* framework, kzString
     result = kzcStringCopy(bfGetMemoryManager(framework), startExecPath, &framework->timingStartAppPath);
     kzsErrorForward(result);
 
+    kzsLog(KZS_LOG_LEVEL_WARNING, "--on-measure-start runs a command on every frame. Use TimingHookLibrary for hooks that do not affect the results.");
+
     kzsSuccess();
 }
 
@@ -584,6 +770,8 @@ kzsError bfSetTimingStopExecPath(struct BenchmarkFramework* framework, kzString
     result = kzcStringCopy(bfGetMemoryManager(framework), stopExecPath, &framework->timingStopAppPath);
     kzsErrorForward(result);
 
+    kzsLog(KZS_LOG_LEVEL_WARNING, "--on-measure-stop runs a command on every frame. Use TimingHookLibrary for hooks that do not affect the results.");
+
     kzsSuccess();
 }
 
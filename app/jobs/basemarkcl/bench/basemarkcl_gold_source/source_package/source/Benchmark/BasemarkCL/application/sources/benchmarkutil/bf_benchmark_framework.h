@@ -23,6 +23,11 @@ struct KzaApplication;
 struct BfScene;
 struct BfInputState;
 struct CluInfo;
+struct CluProgramCache;
+struct CluImageCache;
+struct CluWorkGroupTuner;
+struct BfScoreConfiguration;
+struct BfTimingHook;
 
 /**
  * \struct BenchmarkFramework
@@ -30,6 +35,14 @@ struct CluInfo;
  */
 struct BenchmarkFramework;
 
+/** Work-group size tuning mode of the scenes. */
+enum BfWorkGroupTuningMode
+{
+    BF_WORK_GROUP_TUNING_DISABLED, /**< Scenes use their default local work sizes. */
+    BF_WORK_GROUP_TUNING_ENABLED, /**< Tunable scenes run with tuned local work sizes. */
+    BF_WORK_GROUP_TUNING_COMPARE /**< Tunable scenes run first with default and then again with tuned local work sizes. */
+};
+
 
 /** Create benchmark framework. */
 kzsError bfCreate(const struct KzcMemoryManager* memoryManager, struct KzuEngine* engine, struct KzaApplication* application, struct KzsWindow* window, kzString windowTitle, struct BenchmarkFramework** out_bf);
@@ -93,12 +106,28 @@ void bfSetClContext(struct BenchmarkFramework* framework, cl_context context);
 /** Get CluInfo structure from benchmark framework. */
 struct CluInfo* bfGetCluInfo(const struct BenchmarkFramework* framework);
 
+/** Gets the OpenCL program binary cache. KZ_NULL if program cache is disabled. */
+struct CluProgramCache* bfGetProgramCache(const struct BenchmarkFramework* framework);
+/** Gets the decoded image cache. KZ_NULL if image cache is disabled. */
+struct CluImageCache* bfGetImageCache(const struct BenchmarkFramework* framework);
+/** Gets the work-group size tuner. KZ_NULL if work-group tuning is disabled. */
+struct CluWorkGroupTuner* bfGetWorkGroupTuner(const struct BenchmarkFramework* framework);
+/** Gets the work-group size tuning mode. */
+enum BfWorkGroupTuningMode bfGetWorkGroupTuningMode(const struct BenchmarkFramework* framework);
+/** Gets the loaded timing hook plugin. KZ_NULL if none is configured. */
+const struct BfTimingHook* bfGetTimingHook(const struct BenchmarkFramework* framework);
+/** Gets the configuration of scene score statistics. */
+const struct BfScoreConfiguration* bfGetScoreConfiguration(const struct BenchmarkFramework* framework);
+
 /** Initializes the report document. */
 kzsError bfReportCreate(struct BenchmarkFramework* framework);
 /** Get bf report document. */
 struct BfReportDocument* bfGetReportDocument(const struct BenchmarkFramework* framework);
 
-/** Set path for applications which will be executed when test timing starts. Setting this to KZ_NULL disables the calls. */
+/**
+* Set path for applications which will be executed when test timing starts. Setting this to KZ_NULL disables the calls.
+* Kept for compatibility. Starting a process on each frame affects the results, so timing hook plugins are preferred.
+*/
 kzsError bfSetTimingStartExecPath(struct BenchmarkFramework* framework, kzString startExecPath);
 /** Returns the timing start test path. */
 kzString bfGetTimingStartExecPath(const struct BenchmarkFramework* framework);
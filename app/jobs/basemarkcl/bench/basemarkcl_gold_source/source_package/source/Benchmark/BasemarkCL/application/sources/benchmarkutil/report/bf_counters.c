@@ -0,0 +1,266 @@
+/**
+* \file
+* Benchmark framework hardware performance counters. Counters are available only on Linux, through perf_event_open.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "bf_counters.h"
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/wrappers/kzs_math.h>
+#include <system/debug/kzs_log.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#if defined(__NR_perf_event_open)
+#define BF_COUNTERS_PERF_EVENT
+#endif
+#endif
+
+
+#ifdef BF_COUNTERS_PERF_EVENT
+/** Counter value read from the kernel with PERF_FORMAT_TOTAL_TIME_ENABLED and PERF_FORMAT_TOTAL_TIME_RUNNING. */
+struct BfCounterReading
+{
+    __u64 value; /**< Raw count. */
+    __u64 timeEnabled; /**< Time the counter has been enabled. */
+    __u64 timeRunning; /**< Time the counter has been scheduled on the PMU. Less than enabled time when multiplexed. */
+};
+#endif
+
+struct BfCounters
+{
+#ifdef BF_COUNTERS_PERF_EVENT
+    int fileDescriptors[BF_COUNTER_TYPE_COUNT]; /**< Counter file descriptors, -1 for unavailable counters. */
+    struct BfCounterReading startReadings[BF_COUNTER_TYPE_COUNT]; /**< Readings at the start of current interval. */
+#endif
+    kzBool available[BF_COUNTER_TYPE_COUNT]; /**< Counter availability. */
+};
+
+
+#ifdef BF_COUNTERS_PERF_EVENT
+/** Opens a counter for the calling thread. Returns -1 on failure. */
+static int bfCountersOpen_internal(enum BfCounterType type);
+/** Reads a counter. Returns KZ_FALSE on failure. */
+static kzBool bfCountersRead_internal(int fileDescriptor, struct BfCounterReading* out_reading);
+#endif
+
+
+kzsError bfCountersCreate(const struct KzcMemoryManager* memoryManager, struct BfCounters** out_counters)
+{
+    kzsError result;
+    struct BfCounters* counters;
+    kzUint i;
+
+    result = kzcMemoryAllocVariable(memoryManager, counters, "Hardware counters");
+    kzsErrorForward(result);
+
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+#ifdef BF_COUNTERS_PERF_EVENT
+        counters->fileDescriptors[i] = bfCountersOpen_internal((enum BfCounterType)i);
+        counters->available[i] = (counters->fileDescriptors[i] >= 0);
+        if(!counters->available[i])
+        {
+            kzcLogDebug("Hardware counter %s is not available", bfCountersGetName((enum BfCounterType)i));
+        }
+#else
+        counters->available[i] = KZ_FALSE;
+#endif
+    }
+
+    if(!bfCountersIsAnyAvailable(counters))
+    {
+        kzsLog(KZS_LOG_LEVEL_WARNING, "Hardware counters are not available on this system.");
+    }
+
+    *out_counters = counters;
+    kzsSuccess();
+}
+
+kzsError bfCountersDelete(struct BfCounters* counters)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(counters));
+
+#ifdef BF_COUNTERS_PERF_EVENT
+    {
+        kzUint i;
+        for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+        {
+            if(counters->fileDescriptors[i] >= 0)
+            {
+                close(counters->fileDescriptors[i]);
+            }
+        }
+    }
+#endif
+
+    result = kzcMemoryFreeVariable(counters);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzBool bfCountersIsAvailable(const struct BfCounters* counters, enum BfCounterType type)
+{
+    kzsAssert(kzcIsValidPointer(counters));
+    return counters->available[type];
+}
+
+kzBool bfCountersIsAnyAvailable(const struct BfCounters* counters)
+{
+    kzUint i;
+    kzBool anyAvailable = KZ_FALSE;
+
+    kzsAssert(kzcIsValidPointer(counters));
+
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+        anyAvailable = anyAvailable || counters->available[i];
+    }
+    return anyAvailable;
+}
+
+kzString bfCountersGetName(enum BfCounterType type)
+{
+    kzString name;
+    switch(type)
+    {
+        case BF_COUNTER_CYCLES: name = "cycles"; break;
+        case BF_COUNTER_INSTRUCTIONS: name = "instructions"; break;
+        case BF_COUNTER_CACHE_MISSES: name = "cacheMisses"; break;
+        case BF_COUNTER_CONTEXT_SWITCHES: name = "contextSwitches"; break;
+        case BF_COUNTER_PAGE_FAULTS: name = "pageFaults"; break;
+        case BF_COUNTER_TYPE_COUNT:
+        default: name = "unknown"; break;
+    }
+    return name;
+}
+
+void bfCountersStart(struct BfCounters* counters)
+{
+#ifdef BF_COUNTERS_PERF_EVENT
+    kzUint i;
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+        if(counters->available[i] && !bfCountersRead_internal(counters->fileDescriptors[i], &counters->startReadings[i]))
+        {
+            counters->available[i] = KZ_FALSE;
+        }
+    }
+#else
+    KZ_UNUSED_PARAMETER(counters);
+#endif
+}
+
+void bfCountersStop(struct BfCounters* counters, kzUint* out_values)
+{
+    kzUint i;
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+        out_values[i] = 0;
+#ifdef BF_COUNTERS_PERF_EVENT
+        if(counters->available[i])
+        {
+            struct BfCounterReading reading;
+            if(bfCountersRead_internal(counters->fileDescriptors[i], &reading))
+            {
+                const struct BfCounterReading* startReading = &counters->startReadings[i];
+                kzDouble value = (kzDouble)(reading.value - startReading->value);
+                __u64 timeEnabled = reading.timeEnabled - startReading->timeEnabled;
+                __u64 timeRunning = reading.timeRunning - startReading->timeRunning;
+
+                /* Multiplexed counter counted only part of the interval, so the count is extrapolated. */
+                if(timeRunning > 0 && timeRunning < timeEnabled)
+                {
+                    value *= (kzDouble)timeEnabled / (kzDouble)timeRunning;
+                }
+                out_values[i] = (value >= (kzDouble)KZ_UINT_MAXIMUM) ? KZ_UINT_MAXIMUM : (kzUint)(value + 0.5);
+            }
+            else
+            {
+                counters->available[i] = KZ_FALSE;
+            }
+        }
+#endif
+    }
+#ifndef BF_COUNTERS_PERF_EVENT
+    KZ_UNUSED_PARAMETER(counters);
+#endif
+}
+
+
+#ifdef BF_COUNTERS_PERF_EVENT
+static int bfCountersOpen_internal(enum BfCounterType type)
+{
+    struct perf_event_attr attributes;
+    int fileDescriptor;
+
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    /* Threads created later, such as OpenCL CPU device workers, are counted into the same counter. */
+    attributes.inherit = 1;
+    attributes.exclude_hv = 1;
+
+    switch(type)
+    {
+        case BF_COUNTER_CYCLES:
+        {
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        }
+        case BF_COUNTER_INSTRUCTIONS:
+        {
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        }
+        case BF_COUNTER_CACHE_MISSES:
+        {
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        }
+        case BF_COUNTER_CONTEXT_SWITCHES:
+        {
+            attributes.type = PERF_TYPE_SOFTWARE;
+            attributes.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            break;
+        }
+        case BF_COUNTER_PAGE_FAULTS:
+        {
+            attributes.type = PERF_TYPE_SOFTWARE;
+            attributes.config = PERF_COUNT_SW_PAGE_FAULTS;
+            break;
+        }
+        case BF_COUNTER_TYPE_COUNT:
+        default:
+        {
+            return -1;
+        }
+    }
+
+    fileDescriptor = (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+    if(fileDescriptor < 0)
+    {
+        /* Unprivileged processes are usually allowed to count only user space. */
+        attributes.exclude_kernel = 1;
+        fileDescriptor = (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+    }
+    return fileDescriptor;
+}
+
+static kzBool bfCountersRead_internal(int fileDescriptor, struct BfCounterReading* out_reading)
+{
+    return read(fileDescriptor, out_reading, sizeof(*out_reading)) == (ssize_t)sizeof(*out_reading);
+}
+#endif
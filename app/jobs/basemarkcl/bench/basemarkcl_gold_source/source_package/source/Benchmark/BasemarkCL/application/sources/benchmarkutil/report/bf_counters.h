@@ -0,0 +1,65 @@
+/**
+* \file
+* Benchmark framework hardware performance counters. Counters are available only on Linux, through perf_event_open.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef BF_COUNTERS_H
+#define BF_COUNTERS_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/** Counted events. */
+enum BfCounterType
+{
+    BF_COUNTER_CYCLES, /**< CPU cycles. */
+    BF_COUNTER_INSTRUCTIONS, /**< Retired instructions. */
+    BF_COUNTER_CACHE_MISSES, /**< Last level cache misses. */
+    BF_COUNTER_CONTEXT_SWITCHES, /**< Context switches. */
+    BF_COUNTER_PAGE_FAULTS, /**< Page faults. */
+    BF_COUNTER_TYPE_COUNT /**< Number of counter types. */
+};
+
+
+/**
+* \struct BfCounters
+* Set of hardware performance counters.
+*/
+struct BfCounters;
+
+
+/**
+* Creates counters and opens them for the calling thread and the threads it creates afterwards, so that worker threads
+* of CPU OpenCL devices are included if the counters are created before the OpenCL context. Counters not permitted by
+* the system (see /proc/sys/kernel/perf_event_paranoid) or not supported by the CPU are left unavailable.
+* On other platforms no counters are available.
+*/
+kzsError bfCountersCreate(const struct KzcMemoryManager* memoryManager, struct BfCounters** out_counters);
+/** Closes and frees counters. */
+kzsError bfCountersDelete(struct BfCounters* counters);
+
+/** Returns KZ_TRUE if given counter is available. */
+kzBool bfCountersIsAvailable(const struct BfCounters* counters, enum BfCounterType type);
+/** Returns KZ_TRUE if any counter is available. */
+kzBool bfCountersIsAnyAvailable(const struct BfCounters* counters);
+/** Returns name of given counter type, used in the report. */
+kzString bfCountersGetName(enum BfCounterType type);
+
+/** Starts counting an interval. */
+void bfCountersStart(struct BfCounters* counters);
+/**
+* Stops counting the interval started with bfCountersStart. Writes the counts of the interval to out_values, which must have
+* BF_COUNTER_TYPE_COUNT elements. Counts are scaled if the kernel multiplexed the counters, and saturate to KZ_UINT_MAXIMUM.
+* Unavailable counters are zero.
+*/
+void bfCountersStop(struct BfCounters* counters, kzUint* out_values);
+
+
+#endif
@@ -11,8 +11,13 @@
 #include <benchmarkutil/report/xml/bf_xml_node.h>
 #include <benchmarkutil/report/xml/bf_xml_attribute.h>
 #include <benchmarkutil/report/bf_report.h>
+#include <benchmarkutil/report/bf_score.h>
 
 #include <clutil/clu_platform.h>
+#include <clutil/clu_program_cache.h>
+#include <clutil/clu_image_cache.h>
+#include <clutil/clu_profiler.h>
+#include <clutil/clu_work_group_tuner.h>
 
 #include <core/memory/kzc_memory_manager.h>
 #include <core/util/settings/kzc_settings.h>
@@ -648,76 +653,215 @@ kzsError bfInfoUpdateConfiguration(struct XMLNode* node, struct KzcSettingContai
 }
 
 
-static void bfInfoSwap_internal(kzUint *a, kzUint *b)
+kzsError bfInfoAddSeries(const struct KzcMemoryManager* memoryManager, const struct XMLNode* parent, kzString name, const kzUint* values, kzUint count)
 {
-    kzUint t=*a; 
-    *a=*b; 
-    *b=t;
+    kzsError result;
+    kzUint i;
+    kzMutableString seriesString;
+    struct KzcStringBuffer* stringBuffer;
+
+    result = kzcStringBufferCreate(memoryManager, count * 5, &stringBuffer);
+    kzsErrorForward(result);
+    for(i = 0; i < count - 1; ++i)
+    {
+        result = kzcStringBufferAppendFormat(stringBuffer, "%u, ", values[i]);
+        kzsErrorForward(result);
+    }
+    result = kzcStringBufferAppendFormat(stringBuffer, "%u", values[count - 1]);
+    kzsErrorForward(result);
+    result = kzcStringBufferToString(memoryManager, stringBuffer, &seriesString);
+    kzsErrorForward(result);
+
+    {
+        struct XMLNode* seriesNode;
+        result = XMLNodeCreateString(memoryManager, name, seriesString, &seriesNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(parent, seriesNode);
+        kzsErrorForward(result);
+    }
+
+    result = kzcStringBufferDelete(stringBuffer);
+    kzsErrorForward(result);
+    result = kzcStringDelete(seriesString);
+    kzsErrorForward(result);
+
+    kzsSuccess();
 }
 
-static void bfInfoSort_internal(kzUint* array, kzUint start, kzUint end)
+/** Calculates average of per frame values. */
+static kzFloat bfInfoCalculateAverage_internal(const kzUint* values, kzUint count)
 {
-    if (end > start + 1)
+    kzUint i;
+    kzFloat sum = 0.0f;
+    for(i = 0; i < count; ++i)
     {
-        kzUint piv = array[start];
-        kzUint l = start + 1;
-        kzUint r = end;
-        while(l < r)
+        sum += (kzFloat)values[i];
+    }
+    return (count > 0) ? sum / (kzFloat)count : 0.0f;
+}
+
+/** Adds the device timing breakdown of the frames under given XML node. */
+static kzsError bfInfoAddDeviceTiming_internal(const struct KzcMemoryManager* memoryManager, const struct XMLNode* testNode, const struct BfReportLogger* logger)
+{
+    kzsError result;
+    kzUint frameCount = bfReportLoggerGetFrameCount(logger);
+    kzUint* wallTimes = bfReportLoggerGetWallTimesArray(logger);
+    kzUint* deviceBusyTimes = bfReportLoggerGetDeviceBusyTimesArray(logger);
+    kzUint* hostOverheadTimes = bfReportLoggerGetHostOverheadTimesArray(logger);
+    kzUint* kernelGapTimes = bfReportLoggerGetKernelGapTimesArray(logger);
+    kzUint deviceFrameCount = bfReportLoggerGetDeviceFrameCount(logger);
+    /* Frames without device commands have zero busy time and gaps, so device averages are taken over the frames with commands. */
+    kzFloat deviceFrameScale = (deviceFrameCount > 0) ? (kzFloat)frameCount / (kzFloat)deviceFrameCount : 0.0f;
+    kzFloat averageWallTime = bfInfoCalculateAverage_internal(wallTimes, frameCount);
+    kzFloat averageDeviceBusyTime = bfInfoCalculateAverage_internal(deviceBusyTimes, frameCount) * deviceFrameScale;
+    kzFloat averageHostOverhead = bfInfoCalculateAverage_internal(hostOverheadTimes, frameCount);
+    kzFloat averageKernelGap = bfInfoCalculateAverage_internal(kernelGapTimes, frameCount) * deviceFrameScale;
+
+    kzcLogDebug("Average wall clock duration of frame %f (us)", averageWallTime);
+    kzcLogDebug("Average device busy time of frame %f (us)", averageDeviceBusyTime);
+    kzcLogDebug("Average host overhead of frame %f (us)", averageHostOverhead);
+    kzcLogDebug("Average gaps between kernels of frame %f (us)", averageKernelGap);
+
+    result = bfInfoAddScalar(memoryManager, testNode, "averageWallTime", averageWallTime);
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "averageDeviceBusyTime", averageDeviceBusyTime);
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "averageHostOverhead", averageHostOverhead);
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "averageKernelGap", averageKernelGap);
+    kzsErrorForward(result);
+
+    result = bfInfoAddSeries(memoryManager, testNode, "wallFrameTimes", wallTimes, frameCount);
+    kzsErrorForward(result);
+    result = bfInfoAddSeries(memoryManager, testNode, "deviceBusyTimes", deviceBusyTimes, frameCount);
+    kzsErrorForward(result);
+    result = bfInfoAddSeries(memoryManager, testNode, "hostOverheadTimes", hostOverheadTimes, frameCount);
+    kzsErrorForward(result);
+    result = bfInfoAddSeries(memoryManager, testNode, "kernelGapTimes", kernelGapTimes, frameCount);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+/** Length of the buffer of a formatted counter total, including terminator. Enough for all totals exactly representable in kzDouble. */
+#define BF_INFO_TOTAL_STRING_LENGTH 32
+
+/**
+* Formats non-negative counter total as decimal integer. Writes at most BF_INFO_TOTAL_STRING_LENGTH characters including the
+* terminator; totals with more digits are saturated to the largest value that fits.
+*/
+static void bfInfoFormatTotal_internal(kzDouble total, kzMutableString out_string)
+{
+    kzChar digits[BF_INFO_TOTAL_STRING_LENGTH];
+    kzUint digitCount = 0;
+    kzUint i;
+    kzDouble value = floor(total);
+
+    /* kzs_math only wraps single precision functions, which would round totals beyond 2^24. */
+    do
+    {
+        kzInt digit = (kzInt)fmod(value, 10.0);
+        digits[digitCount++] = (kzChar)('0' + ((digit < 0) ? 0 : (digit > 9) ? 9 : digit));
+        value = floor(value / 10.0);
+    }
+    while(value >= 1.0 && digitCount < BF_INFO_TOTAL_STRING_LENGTH - 1);
+
+    if(value >= 1.0)
+    {
+        for(i = 0; i < digitCount; ++i)
         {
-            if(array[l] <= piv)
-            {
-                l++;
-            }
-            else
-            {
-                bfInfoSwap_internal(&array[l], &array[--r]);
-            }
+            digits[i] = '9';
         }
-        bfInfoSwap_internal(&array[--l], &array[start]);
-        bfInfoSort_internal(array, start, l);
-        bfInfoSort_internal(array, r, end);
     }
+
+    for(i = 0; i < digitCount; ++i)
+    {
+        out_string[i] = digits[digitCount - 1 - i];
+    }
+    out_string[digitCount] = '\0';
 }
 
-static kzFloat bfInfoCalculateMedian_internal(kzUint* frameTimes, kzUint frameCount) 
+/** Adds the hardware counter totals and per frame counts under given XML node. */
+static kzsError bfInfoAddHardwareCounters_internal(const struct KzcMemoryManager* memoryManager, const struct XMLNode* testNode, const struct BfReportLogger* logger)
 {
-    kzFloat returnValue;
-    kzUint count = frameCount;
-    kzUint* values = frameTimes;
+    kzsError result;
+    kzUint i;
+    kzUint frameCount = bfReportLoggerGetFrameCount(logger);
+    kzDouble totals[BF_COUNTER_TYPE_COUNT];
+    struct XMLNode* countersNode;
 
-    bfInfoSort_internal(values, 0, count);
+    result = XMLNodeCreateContainer(memoryManager, "hardwareCounters", &countersNode);
+    kzsErrorForward(result);
+    result = XMLNodeAddChild(testNode, countersNode);
+    kzsErrorForward(result);
 
-    if(count % 2 == 0) 
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
     {
-        returnValue = ((values[count / 2] + values[count / 2 - 1]) / 2.0f);
+        kzUint* values = bfReportLoggerGetCounterArray(logger, (enum BfCounterType)i);
+        totals[i] = 0.0;
+        if(values != KZ_NULL)
+        {
+            kzUint j;
+            struct XMLNode* counterNode;
+            struct XMLNode* totalNode;
+            struct XMLAttribute* nameAttribute;
+            /* Totals exceed the range of integer nodes, and float nodes would round them. */
+            kzChar totalString[BF_INFO_TOTAL_STRING_LENGTH];
+
+            for(j = 0; j < frameCount; ++j)
+            {
+                totals[i] += (kzDouble)values[j];
+            }
+
+            result = XMLNodeCreateContainer(memoryManager, "counter", &counterNode);
+            kzsErrorForward(result);
+            result = XMLAttributeCreateString(memoryManager, "name", bfCountersGetName((enum BfCounterType)i), &nameAttribute);
+            kzsErrorForward(result);
+            result = XMLNodeAddAttribute(counterNode, nameAttribute);
+            kzsErrorForward(result);
+            result = XMLNodeAddChild(countersNode, counterNode);
+            kzsErrorForward(result);
+
+            bfInfoFormatTotal_internal(totals[i], totalString);
+            result = XMLNodeCreateString(memoryManager, "total", totalString, &totalNode);
+            kzsErrorForward(result);
+            result = XMLNodeAddChild(counterNode, totalNode);
+            kzsErrorForward(result);
+            result = bfInfoAddScalar(memoryManager, counterNode, "average", bfInfoCalculateAverage_internal(values, frameCount));
+            kzsErrorForward(result);
+            result = bfInfoAddSeries(memoryManager, counterNode, "frames", values, frameCount);
+            kzsErrorForward(result);
+
+            kzcLogDebug("Hardware counter %s total %f", bfCountersGetName((enum BfCounterType)i), (kzFloat)totals[i]);
+        }
     }
-    else 
+
+    if(totals[BF_COUNTER_CYCLES] > 0.0 && bfReportLoggerGetCounterArray(logger, BF_COUNTER_INSTRUCTIONS) != KZ_NULL)
     {
-        returnValue = (kzFloat)values[count / 2];
+        result = bfInfoAddScalar(memoryManager, countersNode, "instructionsPerCycle", (kzFloat)(totals[BF_COUNTER_INSTRUCTIONS] / totals[BF_COUNTER_CYCLES]));
+        kzsErrorForward(result);
     }
 
-    return returnValue;
+    kzsSuccess();
 }
 
-
 kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* logger, kzString sceneName, kzString sceneCategory, kzBool validData, 
-                                  kzBool binaryKernel, kzFloat scoreWeightFactor)
+                                  kzBool binaryKernel, kzFloat scoreWeightFactor, const struct BfScoreConfiguration* scoreConfiguration,
+                                  const struct CluProgramCache* programCache, const struct CluImageCache* imageCache, struct XMLNode** out_testNode)
 {
     kzsError result;
     kzUint i;
-    kzUint amount = 0;
-    kzUint highest = KZ_UINT_MINIMUM;
-    kzUint smallest = KZ_UINT_MAXIMUM;
-    kzFloat geometricMean = 1.0f;
-    kzFloat medianValue;
     kzUint* frameTimes = bfReportLoggerGetFrameTimesArray(logger);
     kzUint frameCount = bfReportLoggerGetFrameCount(logger);
-    kzFloat geometricMeanExponent = 1.0f / (kzFloat)frameCount;
-    kzFloat average;
-    kzFloat score = 0.0f;
+    kzUint* scoredFrameTimes;
+    kzUint scoredFrameCount;
+    kzFloat score;
+    kzFloat scoreLow;
+    kzFloat scoreHigh;
     kzMutableString frameTimeString;
     struct KzcStringBuffer* stringBuffer;
     struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(node);
+    struct BfScoreStatistics statistics;
 
     kzsAssert(frameTimes != KZ_NULL);
 
@@ -733,30 +877,26 @@ kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* l
     result = kzcStringBufferToString(memoryManager, stringBuffer, &frameTimeString);
     kzsErrorForward(result);
 
+    result = bfReportLoggerGetScoredFrameTimes(logger, memoryManager, &scoredFrameTimes, &scoredFrameCount);
+    kzsErrorForward(result);
+    result = bfScoreCalculateStatistics(memoryManager, scoredFrameTimes, scoredFrameCount, scoreConfiguration, &statistics);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(scoredFrameTimes);
+    kzsErrorForward(result);
 
-    for(i = 0; i < frameCount; ++i)
-    {
-        kzUint frameTime = frameTimes[i];
-        highest = kzsMaxU(frameTime, highest);
-        smallest = kzsMinU(frameTime, smallest);
-        amount += frameTime;
-        geometricMean *= kzsPowf((kzFloat)frameTime, geometricMeanExponent);
-    }
-
-    medianValue = bfInfoCalculateMedian_internal(frameTimes, frameCount);
-    average = amount / (kzFloat)(frameCount);
-    
-    if(frameCount > 0 && geometricMean > 0.0f)
-    {
-        score = kzsPowf(geometricMean, -1.0f) * 1000000.0f;
-    }
+    score = bfScoreFromFrameTime(statistics.geometricMean);
+    /* Longer frame time gives lower score, so the interval bounds swap. */
+    scoreLow = bfScoreFromFrameTime(statistics.geometricMeanHigh);
+    scoreHigh = bfScoreFromFrameTime(statistics.geometricMeanLow);
 
     kzcLogDebug("Score  %f (us)", score);
-    kzcLogDebug("Average duration of frame %f (us)", average);
-    kzcLogDebug("Geometric mean of frame duration %f (us)", geometricMean);
-    kzcLogDebug("Median %f (us)", medianValue);
-    kzcLogDebug("Fastest frame %u (us)", smallest);
-    kzcLogDebug("Slowest frame %u (us)", highest);
+    kzcLogDebug("Score 95%% confidence interval %f - %f", scoreLow, scoreHigh);
+    kzcLogDebug("Average duration of frame %f (us)", statistics.average);
+    kzcLogDebug("Geometric mean of frame duration %f (us)", statistics.geometricMean);
+    kzcLogDebug("Median %f (us)", statistics.median);
+    kzcLogDebug("Coefficient of variation %f", statistics.coefficientOfVariation);
+    kzcLogDebug("Fastest frame %u (us)", statistics.fastest);
+    kzcLogDebug("Slowest frame %u (us)", statistics.slowest);
     kzcLogDebug("Binary kernel %u", binaryKernel);
 
     {
@@ -770,6 +910,7 @@ kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* l
         kzsErrorForward(result);
         result = XMLNodeAddChild(node, testNode);
         kzsErrorForward(result);
+        *out_testNode = testNode;
         result = XMLAttributeCreateString(memoryManager, "name", sceneName, &nameAttribute);
         kzsErrorForward(result);
         result = XMLNodeAddAttribute(testNode, nameAttribute);
@@ -793,16 +934,70 @@ kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* l
         kzsErrorForward(result); 
         result = bfInfoAddScalar(memoryManager, testNode, "scoreScaleFactor", scoreWeightFactor);
         kzsErrorForward(result);
-        result = bfInfoAddInteger(memoryManager, testNode, "slowest", highest);
+        result = bfInfoAddInteger(memoryManager, testNode, "slowest", statistics.slowest);
         kzsErrorForward(result);
-        result = bfInfoAddInteger(memoryManager, testNode, "fastest", smallest);
+        result = bfInfoAddInteger(memoryManager, testNode, "fastest", statistics.fastest);
         kzsErrorForward(result); 
-        result = bfInfoAddScalar(memoryManager, testNode, "average", average);
+        result = bfInfoAddScalar(memoryManager, testNode, "average", statistics.average);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, testNode, "median", statistics.median);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, testNode, "geometricMean", statistics.geometricMean);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, testNode, "coefficientOfVariation", statistics.coefficientOfVariation);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, testNode, "scoreConfidenceLow", scoreLow);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, testNode, "scoreConfidenceHigh", scoreHigh);
         kzsErrorForward(result);
-        result = bfInfoAddScalar(memoryManager, testNode, "median", medianValue);
+        result = bfInfoAddInteger(memoryManager, testNode, "sampledFrames", (kzInt)statistics.sampleCount);
         kzsErrorForward(result);
-        result = bfInfoAddScalar(memoryManager, testNode, "geometricMean", geometricMean);
+        result = bfInfoAddInteger(memoryManager, testNode, "warmupFrames", (kzInt)statistics.warmupFrames);
         kzsErrorForward(result);
+        result = bfInfoAddInteger(memoryManager, testNode, "trimmedFrames", (kzInt)statistics.trimmedFrames);
+        kzsErrorForward(result);
+
+        if(programCache != KZ_NULL)
+        {
+            result = bfInfoAddInteger(memoryManager, testNode, "programCacheHits", (kzInt)cluProgramCacheGetHitCount(programCache));
+            kzsErrorForward(result);
+            result = bfInfoAddInteger(memoryManager, testNode, "programCacheMisses", (kzInt)cluProgramCacheGetMissCount(programCache));
+            kzsErrorForward(result);
+        }
+
+        /* Only scenes loading images through the image cache report it. */
+        if(imageCache != KZ_NULL && cluImageCacheGetHitCount(imageCache) + cluImageCacheGetMissCount(imageCache) > 0)
+        {
+            result = bfInfoAddInteger(memoryManager, testNode, "imageCacheHits", (kzInt)cluImageCacheGetHitCount(imageCache));
+            kzsErrorForward(result);
+            result = bfInfoAddInteger(memoryManager, testNode, "imageCacheMisses", (kzInt)cluImageCacheGetMissCount(imageCache));
+            kzsErrorForward(result);
+        }
+
+        {
+            struct XMLNode* timingModeNode;
+            kzBool deviceTiming = (bfReportLoggerGetTimingMode(logger) == BF_REPORT_TIMING_DEVICE && bfReportLoggerGetWallTimesArray(logger) != KZ_NULL);
+            /* Tests that record no device commands are scored by wall clock time even in device timing mode. */
+            kzBool deviceScored = deviceTiming && bfReportLoggerGetDeviceFrameCount(logger) > 0;
+            result = XMLNodeCreateString(memoryManager, "timingMode", deviceScored ? "device" : "wallClock", &timingModeNode);
+            kzsErrorForward(result);
+            result = XMLNodeAddChild(testNode, timingModeNode);
+            kzsErrorForward(result);
+
+            if(deviceTiming)
+            {
+                result = bfInfoAddInteger(memoryManager, testNode, "framesWithoutDeviceData", (kzInt)(frameCount - bfReportLoggerGetDeviceFrameCount(logger)));
+                kzsErrorForward(result);
+                result = bfInfoAddDeviceTiming_internal(memoryManager, testNode, logger);
+                kzsErrorForward(result);
+            }
+        }
+
+        if(bfReportLoggerGetHardwareCounters(logger) != KZ_NULL)
+        {
+            result = bfInfoAddHardwareCounters_internal(memoryManager, testNode, logger);
+            kzsErrorForward(result);
+        }
 
         {
             {
@@ -823,6 +1018,112 @@ kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* l
     kzsSuccess();
 }
 
+kzsError bfInfoUpdateProfilerResults(const struct XMLNode* testNode, const struct CluProfiler* profiler)
+{
+    kzsError result;
+    kzUint i;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct XMLNode* profileNode;
+
+    result = XMLNodeCreateContainer(memoryManager, "profile", &profileNode);
+    kzsErrorForward(result);
+    result = XMLNodeAddChild(testNode, profileNode);
+    kzsErrorForward(result);
+
+    /* Frames wait for the trace only when the drain thread falls behind. Nonzero value means the frame times were disturbed. */
+    result = bfInfoAddInteger(memoryManager, profileNode, "traceDroppedEvents", (kzInt)cluProfilerGetDroppedEventCount(profiler));
+    kzsErrorForward(result);
+
+    for(i = 0; i < cluProfilerGetKernelCount(profiler); ++i)
+    {
+        const struct CluProfilerKernelStatistics* statistics = cluProfilerGetKernelStatistics(profiler, i);
+        struct XMLNode* kernelNode;
+        struct XMLAttribute* nameAttribute;
+
+        result = XMLNodeCreateContainer(memoryManager, "kernel", &kernelNode);
+        kzsErrorForward(result);
+        result = XMLAttributeCreateString(memoryManager, "name", statistics->name, &nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddAttribute(kernelNode, nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(profileNode, kernelNode);
+        kzsErrorForward(result);
+
+        /* Times are reported in microseconds like the frame times. */
+        result = bfInfoAddInteger(memoryManager, kernelNode, "count", (kzInt)statistics->count);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "totalTime", (kzFloat)(statistics->totalTime / 1000.0));
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "averageTime", (kzFloat)(statistics->totalTime / 1000.0 / statistics->count));
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "minimumTime", (kzFloat)(statistics->minimumTime / 1000.0));
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "maximumTime", (kzFloat)(statistics->maximumTime / 1000.0));
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "averageQueueTime", (kzFloat)(statistics->totalQueueTime / 1000.0 / statistics->count));
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError bfInfoUpdateWorkGroupTunerResults(const struct XMLNode* testNode, const struct CluWorkGroupTuner* tuner)
+{
+    kzsError result;
+    kzUint i;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct XMLNode* tuningNode;
+
+    result = XMLNodeCreateContainer(memoryManager, "workGroupTuning", &tuningNode);
+    kzsErrorForward(result);
+    result = XMLNodeAddChild(testNode, tuningNode);
+    kzsErrorForward(result);
+
+    result = bfInfoAddInteger(memoryManager, tuningNode, "storedResults", (kzInt)cluWorkGroupTunerGetHitCount(tuner));
+    kzsErrorForward(result);
+    result = bfInfoAddInteger(memoryManager, tuningNode, "searches", (kzInt)cluWorkGroupTunerGetSearchCount(tuner));
+    kzsErrorForward(result);
+
+    for(i = 0; i < cluWorkGroupTunerGetResultCount(tuner); ++i)
+    {
+        const struct CluWorkGroupTunerResult* tunerResult = cluWorkGroupTunerGetResult(tuner, i);
+        struct XMLNode* kernelNode;
+        struct XMLAttribute* nameAttribute;
+        kzUint globalWorkSize[3];
+        kzUint localWorkSize[3];
+        kzUint dimension;
+
+        for(dimension = 0; dimension < tunerResult->dimensions; ++dimension)
+        {
+            globalWorkSize[dimension] = (kzUint)tunerResult->globalWorkSize[dimension];
+            localWorkSize[dimension] = (kzUint)tunerResult->localWorkSize[dimension];
+        }
+
+        result = XMLNodeCreateContainer(memoryManager, "kernel", &kernelNode);
+        kzsErrorForward(result);
+        result = XMLAttributeCreateString(memoryManager, "name", tunerResult->kernelName, &nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddAttribute(kernelNode, nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(tuningNode, kernelNode);
+        kzsErrorForward(result);
+
+        /* Zero local size means the default local size of the scene was the fastest. Times are in microseconds like the frame times. */
+        result = bfInfoAddSeries(memoryManager, kernelNode, "globalWorkSize", globalWorkSize, tunerResult->dimensions);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, kernelNode, "localWorkSize", localWorkSize, tunerResult->dimensions);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "defaultTime", (kzFloat)(tunerResult->defaultTime / 1000.0));
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, kernelNode, "tunedTime", (kzFloat)(tunerResult->tunedTime / 1000.0));
+        kzsErrorForward(result);
+        result = bfInfoAddInteger(memoryManager, kernelNode, "candidates", (kzInt)tunerResult->candidateCount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
 kzsError bfInfoUpdateOverallScore(const struct XMLDocument* xmlDocument, struct XMLNode* scoreNode, struct XMLNode* testsParentNode)
 {
     kzsError result;
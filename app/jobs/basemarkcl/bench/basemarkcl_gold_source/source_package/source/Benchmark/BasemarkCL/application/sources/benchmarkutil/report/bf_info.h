@@ -17,11 +17,24 @@
 struct XMLNode;
 struct XMLDocument;
 struct CluInfo;
+struct CluProgramCache;
+struct CluImageCache;
+struct CluProfiler;
+struct CluWorkGroupTuner;
 struct KzcSettingContainer;
 struct BfReportLogger;
+struct BfScoreConfiguration;
 struct KzsSurface;
+struct KzcMemoryManager;
 
 
+/** Adds integer valued child node to given XML node. */
+kzsError bfInfoAddInteger(const struct KzcMemoryManager* memoryManager, const struct XMLNode* parent, kzString name, kzInt value);
+/** Adds scalar valued child node to given XML node. */
+kzsError bfInfoAddScalar(const struct KzcMemoryManager* memoryManager, const struct XMLNode* parent, kzString name, kzFloat value);
+/** Adds comma separated list of values as child node to given XML node. Count must be at least one. */
+kzsError bfInfoAddSeries(const struct KzcMemoryManager* memoryManager, const struct XMLNode* parent, kzString name, const kzUint* values, kzUint count);
+
 /** Add OpenGL info to given XML node. */
 kzsError bfInfoUpdateGL(struct XMLNode* node);
 
@@ -34,9 +47,16 @@ kzsError bfInfoUpdateSurface(const struct XMLNode* node, const struct KzsSurface
 /** Add benchmark config data under given XML node. */
 kzsError bfInfoUpdateConfiguration(struct XMLNode* node, struct KzcSettingContainer* settingContainer);
 
-/** Add test results for a scene to given XML node. */
+/** Add test results for a scene to given XML node. Returns the node created for the scene. */
 kzsError bfInfoUpdateSceneResults(struct XMLNode* node, struct BfReportLogger* logger, kzString sceneName, kzString sceneCategory, kzBool validData, kzBool binaryKernel, 
-                                  kzFloat scoreWeightFactor);
+                                  kzFloat scoreWeightFactor, const struct BfScoreConfiguration* scoreConfiguration, const struct CluProgramCache* programCache,
+                                  const struct CluImageCache* imageCache, struct XMLNode** out_testNode);
+
+/** Add per-kernel statistics of the profiler trace under given scene node. */
+kzsError bfInfoUpdateProfilerResults(const struct XMLNode* testNode, const struct CluProfiler* profiler);
+
+/** Add default and tuned work-group sizes and times of the kernel launches under given scene node. */
+kzsError bfInfoUpdateWorkGroupTunerResults(const struct XMLNode* testNode, const struct CluWorkGroupTuner* tuner);
 
 /** Update overall score XML node. */
 kzsError bfInfoUpdateOverallScore(const struct XMLDocument* xmlDocument, struct XMLNode* scoreNode, struct XMLNode* testsParentNode);
@@ -21,23 +21,61 @@ struct BfReportLogger
 {
     kzUint frameIndex; /**< Frame index. */
     kzUint lastTime; /**< Last time stored. */
+    kzUint frameDuration; /**< Wall clock duration of the current frame, measured when its timer was stopped. */
     kzUint maximumFrameTimes; /**< Maximum frame times. */
     kzUint* frameTimes; /**< Frame times array. */
     kzBool isPartOfScore; /**< Is this scene calculated into the overall score. */
     struct BfTimer* timer;
+
+    enum BfReportTimingMode timingMode; /**< Frame timing mode. */
+    kzUint* wallTimes; /**< Wall clock frame times array. Used only with device timing. */
+    kzUint* deviceBusyTimes; /**< Device busy times array. Used only with device timing. */
+    kzUint* hostOverheadTimes; /**< Host overhead times array. Used only with device timing. */
+    kzUint* kernelGapTimes; /**< Device idle times between commands array. Used only with device timing. */
+    kzBool* deviceFrames; /**< Frames that recorded device commands. Used only with device timing. */
+    kzBool frameHasDeviceTimes; /**< Current frame recorded device commands. */
+    kzUint frameDeviceBusyTime; /**< Device busy time of the current frame. */
+    kzUint frameDeviceSpanTime; /**< Device span time of the current frame. */
+    kzUint deviceFrameCount; /**< Number of frames that recorded device commands. Used only with device timing. */
+
+    struct BfCounters* counters; /**< Hardware counters. KZ_NULL if not enabled. */
+    kzUint* counterValues[BF_COUNTER_TYPE_COUNT]; /**< Per frame hardware counter arrays. KZ_NULL for unavailable counters. */
+    kzUint frameCounterValues[BF_COUNTER_TYPE_COUNT]; /**< Hardware counter values of the current frame. */
 };
 
 
+/** Frees the per frame arrays of the logger. */
+static kzsError bfReportLoggerFreeArrays_internal(struct BfReportLogger* logger);
+
+
 kzsError bfReportLoggerCreate(const struct KzcMemoryManager* memoryManager, struct BfReportLogger** out_logger)
 {
     kzsError result;
     struct BfReportLogger* logger;
+    kzUint i;
 
     result = kzcMemoryAllocVariable(memoryManager, logger, "Report Logger");
     kzsErrorForward(result);
     logger->frameTimes = KZ_NULL;
     logger->maximumFrameTimes = 0;
     logger->isPartOfScore = KZ_TRUE;
+    logger->timingMode = BF_REPORT_TIMING_WALL_CLOCK;
+    logger->wallTimes = KZ_NULL;
+    logger->deviceBusyTimes = KZ_NULL;
+    logger->hostOverheadTimes = KZ_NULL;
+    logger->kernelGapTimes = KZ_NULL;
+    logger->deviceFrames = KZ_NULL;
+    logger->frameHasDeviceTimes = KZ_FALSE;
+    logger->frameDeviceBusyTime = 0;
+    logger->frameDeviceSpanTime = 0;
+    logger->deviceFrameCount = 0;
+    logger->frameDuration = 0;
+    logger->counters = KZ_NULL;
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+        logger->counterValues[i] = KZ_NULL;
+        logger->frameCounterValues[i] = 0;
+    }
 
     result = bfTimerCreate(memoryManager, &logger->timer);
     kzsErrorForward(result);
@@ -53,9 +91,12 @@ kzsError bfReportLoggerDelete(struct BfReportLogger* logger)
     result = bfTimerDelete(logger->timer);
     kzsErrorForward(result);
 
-    if(logger->maximumFrameTimes > 0)
+    result = bfReportLoggerFreeArrays_internal(logger);
+    kzsErrorForward(result);
+
+    if(logger->counters != KZ_NULL)
     {
-        result = kzcMemoryFreeArray(logger->frameTimes);
+        result = bfCountersDelete(logger->counters);
         kzsErrorForward(result);
     }
 
@@ -74,15 +115,39 @@ kzsError bfReportLoggerReset(struct BfReportLogger* logger, kzString logName, kz
 
     memoryManager = kzcMemoryGetManager(logger);
 
-    if(logger->maximumFrameTimes > 0)
-    {
-        result = kzcMemoryFreeArray(logger->frameTimes);
-        kzsErrorForward(result);
-    }
+    result = bfReportLoggerFreeArrays_internal(logger);
+    kzsErrorForward(result);
     if(frames > 0)
     {
         result = kzcMemoryAllocArray(memoryManager, logger->frameTimes, frames, "Frame times array");
         kzsErrorForward(result);
+
+        if(logger->timingMode == BF_REPORT_TIMING_DEVICE)
+        {
+            result = kzcMemoryAllocArray(memoryManager, logger->wallTimes, frames, "Wall clock frame times array");
+            kzsErrorForward(result);
+            result = kzcMemoryAllocArray(memoryManager, logger->deviceBusyTimes, frames, "Device busy times array");
+            kzsErrorForward(result);
+            result = kzcMemoryAllocArray(memoryManager, logger->hostOverheadTimes, frames, "Host overhead times array");
+            kzsErrorForward(result);
+            result = kzcMemoryAllocArray(memoryManager, logger->kernelGapTimes, frames, "Kernel gap times array");
+            kzsErrorForward(result);
+            result = kzcMemoryAllocArray(memoryManager, logger->deviceFrames, frames, "Device frames array");
+            kzsErrorForward(result);
+        }
+
+        if(logger->counters != KZ_NULL)
+        {
+            kzUint i;
+            for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+            {
+                if(bfCountersIsAvailable(logger->counters, (enum BfCounterType)i))
+                {
+                    result = kzcMemoryAllocArray(memoryManager, logger->counterValues[i], frames, "Hardware counter array");
+                    kzsErrorForward(result);
+                }
+            }
+        }
     }
     else
     {
@@ -95,33 +160,178 @@ kzsError bfReportLoggerReset(struct BfReportLogger* logger, kzString logName, kz
     kzcLogDebug("Running test: %s", logName);
 
     logger->frameIndex = 0;
+    logger->deviceFrameCount = 0;
+    kzsSuccess();
+}
+
+static kzsError bfReportLoggerFreeArrays_internal(struct BfReportLogger* logger)
+{
+    kzsError result;
+    kzUint i;
+
+    if(logger->frameTimes != KZ_NULL)
+    {
+        result = kzcMemoryFreeArray(logger->frameTimes);
+        kzsErrorForward(result);
+    }
+    if(logger->wallTimes != KZ_NULL)
+    {
+        result = kzcMemoryFreeArray(logger->wallTimes);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(logger->deviceBusyTimes);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(logger->hostOverheadTimes);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(logger->kernelGapTimes);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(logger->deviceFrames);
+        kzsErrorForward(result);
+    }
+    logger->frameTimes = KZ_NULL;
+    logger->wallTimes = KZ_NULL;
+    logger->deviceBusyTimes = KZ_NULL;
+    logger->hostOverheadTimes = KZ_NULL;
+    logger->kernelGapTimes = KZ_NULL;
+    logger->deviceFrames = KZ_NULL;
+
+    for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+    {
+        if(logger->counterValues[i] != KZ_NULL)
+        {
+            result = kzcMemoryFreeArray(logger->counterValues[i]);
+            kzsErrorForward(result);
+            logger->counterValues[i] = KZ_NULL;
+        }
+    }
+
     kzsSuccess();
 }
 
 kzsError bfReportLoggerUpdatePreFrame(struct BfReportLogger* logger)
 {
+    logger->frameHasDeviceTimes = KZ_FALSE;
+    logger->frameDeviceBusyTime = 0;
+    logger->frameDeviceSpanTime = 0;
+    if(logger->counters != KZ_NULL)
+    {
+        bfCountersStart(logger->counters);
+    }
     logger->lastTime = (kzUint)bfTimerGetElapsedTimeInMicroSeconds(logger->timer);
+    logger->frameDuration = 0;
     kzsSuccess();
 }
 
-kzsError bfReportLoggerUpdatePostFrame(struct BfReportLogger* logger)
+void bfReportLoggerStopFrameTimer(struct BfReportLogger* logger)
 {
     kzUint timeNow = (kzUint)bfTimerGetElapsedTimeInMicroSeconds(logger->timer);
-    kzUint delta = kzsMaxU(timeNow - logger->lastTime, 1);
+    logger->frameDuration = kzsMaxU(timeNow - logger->lastTime, 1);
+    if(logger->counters != KZ_NULL)
+    {
+        bfCountersStop(logger->counters, logger->frameCounterValues);
+    }
+}
+
+kzsError bfReportLoggerUpdatePostFrame(struct BfReportLogger* logger)
+{
+    kzUint delta;
+
+    if(logger->frameDuration == 0)
+    {
+        bfReportLoggerStopFrameTimer(logger);
+    }
+    delta = logger->frameDuration;
 
     kzsErrorTest(logger->frameIndex < logger->maximumFrameTimes, KZS_ERROR_ARRAY_OUT_OF_BOUNDS, "Array out of bounds for frametime logger.");
-    logger->frameTimes[logger->frameIndex] = delta;
 
-    logger->frameIndex++;
-    kzcLogDebug("Frame %d duration %d (us)", logger->frameIndex, delta);
+    {
+        kzUint i;
+        for(i = 0; i < BF_COUNTER_TYPE_COUNT; ++i)
+        {
+            if(logger->counterValues[i] != KZ_NULL)
+            {
+                logger->counterValues[i][logger->frameIndex] = logger->frameCounterValues[i];
+            }
+        }
+    }
+
+    if(logger->wallTimes != KZ_NULL)
+    {
+        /* Device timestamps and host clock are not synchronized, so only durations are compared. */
+        kzUint busyTime = logger->frameDeviceBusyTime;
+        kzUint spanTime = kzsMaxU(logger->frameDeviceSpanTime, busyTime);
+
+        /* Frames without any recorded commands, such as the online compiler test, have no device time. They are stored as zero
+           and left out of the device time statistics. */
+        logger->frameTimes[logger->frameIndex] = busyTime;
+        logger->deviceFrames[logger->frameIndex] = logger->frameHasDeviceTimes;
+        if(logger->frameHasDeviceTimes)
+        {
+            logger->deviceFrameCount++;
+        }
+        logger->wallTimes[logger->frameIndex] = delta;
+        logger->deviceBusyTimes[logger->frameIndex] = busyTime;
+        logger->kernelGapTimes[logger->frameIndex] = spanTime - busyTime;
+        logger->hostOverheadTimes[logger->frameIndex] = (delta > spanTime) ? delta - spanTime : 0;
+
+        logger->frameIndex++;
+        kzcLogDebug("Frame %d duration %d (us), device busy %d (us), kernel gaps %d (us)", logger->frameIndex, delta, busyTime, spanTime - busyTime);
+    }
+    else
+    {
+        logger->frameTimes[logger->frameIndex] = delta;
+
+        logger->frameIndex++;
+        kzcLogDebug("Frame %d duration %d (us)", logger->frameIndex, delta);
+    }
 
     kzsSuccess();
 }
 
+void bfReportLoggerSetTimingMode(struct BfReportLogger* logger, enum BfReportTimingMode timingMode)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    logger->timingMode = timingMode;
+}
+
+enum BfReportTimingMode bfReportLoggerGetTimingMode(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->timingMode;
+}
+
+void bfReportLoggerSetFrameDeviceTimes(struct BfReportLogger* logger, kzBool hasDeviceTimes, kzUint deviceBusyTime, kzUint deviceSpanTime)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    logger->frameHasDeviceTimes = hasDeviceTimes;
+    logger->frameDeviceBusyTime = deviceBusyTime;
+    logger->frameDeviceSpanTime = deviceSpanTime;
+}
+
+kzsError bfReportLoggerEnableHardwareCounters(struct BfReportLogger* logger)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(logger));
+
+    if(logger->counters == KZ_NULL)
+    {
+        result = bfCountersCreate(kzcMemoryGetManager(logger), &logger->counters);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+const struct BfCounters* bfReportLoggerGetHardwareCounters(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->counters;
+}
+
 kzUint bfReportLoggerGetFrameCount(const struct BfReportLogger* logger)
 {
     kzsAssert(kzcIsValidPointer(logger));
-    return logger->maximumFrameTimes;    
+    return logger->frameIndex;
 }
 
 kzUint* bfReportLoggerGetFrameTimesArray(const struct BfReportLogger* logger)
@@ -130,6 +340,84 @@ kzUint* bfReportLoggerGetFrameTimesArray(const struct BfReportLogger* logger)
     return logger->frameTimes;
 }
 
+kzBool bfReportLoggerFrameHasDeviceTimes(const struct BfReportLogger* logger, kzUint frameIndex)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    kzsAssert(frameIndex < logger->frameIndex);
+    return logger->deviceFrames != KZ_NULL && logger->deviceFrames[frameIndex];
+}
+
+kzUint bfReportLoggerGetDeviceFrameCount(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->deviceFrameCount;
+}
+
+kzsError bfReportLoggerGetScoredFrameTimes(const struct BfReportLogger* logger, const struct KzcMemoryManager* memoryManager,
+                                           kzUint** out_frameTimes, kzUint* out_frameCount)
+{
+    kzsError result;
+    kzUint i;
+    kzUint frameCount = 0;
+    kzUint* frameTimes;
+    kzBool deviceTiming;
+
+    kzsAssert(kzcIsValidPointer(logger));
+    kzsAssert(logger->frameIndex > 0);
+
+    deviceTiming = (logger->wallTimes != KZ_NULL && logger->deviceFrameCount > 0);
+
+    result = kzcMemoryAllocArray(memoryManager, frameTimes, logger->frameIndex, "Scored frame times");
+    kzsErrorForward(result);
+
+    for(i = 0; i < logger->frameIndex; ++i)
+    {
+        if(!deviceTiming)
+        {
+            /* Tests without any device commands are timed entirely by wall clock. */
+            frameTimes[frameCount++] = (logger->wallTimes != KZ_NULL) ? logger->wallTimes[i] : logger->frameTimes[i];
+        }
+        else if(logger->deviceFrames[i])
+        {
+            frameTimes[frameCount++] = logger->frameTimes[i];
+        }
+    }
+
+    *out_frameTimes = frameTimes;
+    *out_frameCount = frameCount;
+    kzsSuccess();
+}
+
+kzUint* bfReportLoggerGetWallTimesArray(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->wallTimes;
+}
+
+kzUint* bfReportLoggerGetDeviceBusyTimesArray(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->deviceBusyTimes;
+}
+
+kzUint* bfReportLoggerGetHostOverheadTimesArray(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->hostOverheadTimes;
+}
+
+kzUint* bfReportLoggerGetKernelGapTimesArray(const struct BfReportLogger* logger)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->kernelGapTimes;
+}
+
+kzUint* bfReportLoggerGetCounterArray(const struct BfReportLogger* logger, enum BfCounterType type)
+{
+    kzsAssert(kzcIsValidPointer(logger));
+    return logger->counterValues[type];
+}
+
 kzBool bfReportLoggerIsPartOfOverallScore(const struct BfReportLogger* logger)
 {
     kzsAssert(kzcIsValidPointer(logger));
@@ -11,6 +11,8 @@
 #include <system/kzs_types.h>
 #include <system/debug/kzs_error.h>
 
+#include "bf_counters.h"
+
 
 /* Forward declarations. */
 struct KzcMemoryManager;
@@ -22,6 +24,14 @@ struct KzcMemoryManager;
 struct BfReportLogger;
 
 
+/** Frame timing modes of report logger. */
+enum BfReportTimingMode
+{
+    BF_REPORT_TIMING_WALL_CLOCK, /**< Frame time is the host wall clock time of the frame. */
+    BF_REPORT_TIMING_DEVICE /**< Frame time is the OpenCL device busy time of the events recorded during the frame. */
+};
+
+
 /** Creates report generator struct. */
 kzsError bfReportLoggerCreate(const struct KzcMemoryManager* memoryManager, struct BfReportLogger** out_logger);
 
@@ -33,13 +43,58 @@ kzsError bfReportLoggerReset(struct BfReportLogger* logger, kzString logName, kz
 
 /** Updates logger pre frame. */
 kzsError bfReportLoggerUpdatePreFrame(struct BfReportLogger* logger);
+/**
+* Stops timing the current frame. Work done after this, such as collecting profiling data, is not included in the frame time.
+* If not called, the frame is timed until bfReportLoggerUpdatePostFrame.
+*/
+void bfReportLoggerStopFrameTimer(struct BfReportLogger* logger);
 /** Updates logger post frame. */
 kzsError bfReportLoggerUpdatePostFrame(struct BfReportLogger* logger);
 
-/** Gets the frame count from report logger. */
+/** Sets the frame timing mode. Takes effect from next reset. */
+void bfReportLoggerSetTimingMode(struct BfReportLogger* logger, enum BfReportTimingMode timingMode);
+/** Gets the frame timing mode. */
+enum BfReportTimingMode bfReportLoggerGetTimingMode(const struct BfReportLogger* logger);
+/**
+* Sets device times of the current frame in microseconds. Must be called before bfReportLoggerUpdatePostFrame when device timing is used.
+* hasDeviceTimes tells if the frame recorded device commands, as the times of very short commands round down to zero.
+* Busy time is the time device was executing commands, span is the time from first command start to last command end.
+*/
+void bfReportLoggerSetFrameDeviceTimes(struct BfReportLogger* logger, kzBool hasDeviceTimes, kzUint deviceBusyTime, kzUint deviceSpanTime);
+
+/**
+* Opens hardware performance counters, which are then read at the same points as the frame timer. Takes effect from next reset.
+* Call before the OpenCL context is created, so that the worker threads of CPU devices are counted.
+*/
+kzsError bfReportLoggerEnableHardwareCounters(struct BfReportLogger* logger);
+/** Gets the hardware counters of the logger. KZ_NULL if hardware counters are not enabled. */
+const struct BfCounters* bfReportLoggerGetHardwareCounters(const struct BfReportLogger* logger);
+
+/** Gets the number of frames recorded since the report logger was reset. */
 kzUint bfReportLoggerGetFrameCount(const struct BfReportLogger* logger);
-/** Gets the frame duration array from report logger. */
+/** Gets the frame duration array from report logger. With device timing, frames that recorded no device commands are zero. */
 kzUint* bfReportLoggerGetFrameTimesArray(const struct BfReportLogger* logger);
+/** Checks if the frame with given index recorded device commands. Always KZ_FALSE if device timing is not used. */
+kzBool bfReportLoggerFrameHasDeviceTimes(const struct BfReportLogger* logger, kzUint frameIndex);
+/** Gets the number of frames that recorded device commands. Zero if device timing is not used. */
+kzUint bfReportLoggerGetDeviceFrameCount(const struct BfReportLogger* logger);
+/**
+* Creates an array of the frame times used for statistics. With device timing, frames without device commands are left out.
+* If no frame recorded device commands, wall clock times of all frames are used instead. Free the array with kzcMemoryFreeArray.
+*/
+kzsError bfReportLoggerGetScoredFrameTimes(const struct BfReportLogger* logger, const struct KzcMemoryManager* memoryManager,
+                                           kzUint** out_frameTimes, kzUint* out_frameCount);
+/** Gets the wall clock frame duration array from report logger. KZ_NULL if device timing is not used. */
+kzUint* bfReportLoggerGetWallTimesArray(const struct BfReportLogger* logger);
+/** Gets the device busy time array from report logger. KZ_NULL if device timing is not used. */
+kzUint* bfReportLoggerGetDeviceBusyTimesArray(const struct BfReportLogger* logger);
+/** Gets the host overhead time array from report logger. KZ_NULL if device timing is not used. */
+kzUint* bfReportLoggerGetHostOverheadTimesArray(const struct BfReportLogger* logger);
+/** Gets the array of device idle times between commands from report logger. KZ_NULL if device timing is not used. */
+kzUint* bfReportLoggerGetKernelGapTimesArray(const struct BfReportLogger* logger);
+
+/** Gets the per frame array of given hardware counter from report logger. KZ_NULL if the counter is not available. */
+kzUint* bfReportLoggerGetCounterArray(const struct BfReportLogger* logger, enum BfCounterType type);
 
 /** Returns KZ_TRUE if current scene is part of overall score. False if not. */
 kzBool bfReportLoggerIsPartOfOverallScore(const struct BfReportLogger* logger);
@@ -24,6 +24,7 @@ struct BfReportDocument
 {
     struct XMLDocument* reportDocument; /**< XML document containing the report to be saved. */
     struct KzsTime time;
+    kzMutableString fileName; /**< File the report is saved to. If KZ_NULL, file name is generated from time. */
 };
 
 
@@ -58,6 +59,7 @@ kzsError bfReportDocumentCreate(const struct KzcMemoryManager* memoryManager, st
     kzsErrorForward(result);
 
     document->time = kzsTimeGetTime();
+    document->fileName = KZ_NULL;
 
     {
         result = XMLDocumentCreate(memoryManager, &document->reportDocument);
@@ -328,12 +330,34 @@ kzsError bfReportDocumentDelete(struct BfReportDocument* document)
 
     result = XMLDocumentDelete(document->reportDocument);
     kzsErrorForward(result);
+    if(document->fileName != KZ_NULL)
+    {
+        result = kzcStringDelete(document->fileName);
+        kzsErrorForward(result);
+    }
     result = kzcMemoryFreeVariable(document);
     kzsErrorForward(result);
 
     kzsSuccess();
 }
 
+kzsError bfReportDocumentSetFileName(struct BfReportDocument* document, kzString fileName)
+{
+    kzsError result;
+    kzsAssert(kzcIsValidPointer(document));
+
+    if(document->fileName != KZ_NULL)
+    {
+        result = kzcStringDelete(document->fileName);
+        kzsErrorForward(result);
+    }
+
+    result = kzcStringCopy(kzcMemoryGetManager(document), fileName, &document->fileName);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
 kzsError bfReportDocumentGetNode(const struct BfReportDocument* document, kzString path, struct XMLNode** out_node)
 {
     kzsError result;
@@ -356,9 +380,17 @@ kzsError bfReportDocumentSaveXML(const struct BfReportDocument* document)
 
     time = document->time;
 
-    result = kzcStringFormat(kzcMemoryGetManager(document), "reports/report_%d-%02d-%02d_%02d-%02d-%02d.xml", &fileName, 
-        time.year, time.month, time.day, time.hours, time.minutes, time.seconds);
-    kzsErrorForward(result);
+    if(document->fileName != KZ_NULL)
+    {
+        result = kzcStringCopy(kzcMemoryGetManager(document), document->fileName, &fileName);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = kzcStringFormat(kzcMemoryGetManager(document), "reports/report_%d-%02d-%02d_%02d-%02d-%02d.xml", &fileName, 
+            time.year, time.month, time.day, time.hours, time.minutes, time.seconds);
+        kzsErrorForward(result);
+    }
 
     result = XMLDocumentSaveToFile(document->reportDocument, fileName);
     kzsErrorForward(result);
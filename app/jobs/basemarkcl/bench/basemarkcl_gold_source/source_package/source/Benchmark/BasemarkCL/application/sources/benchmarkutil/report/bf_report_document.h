@@ -32,6 +32,9 @@ kzsError bfReportDocumentDelete(struct BfReportDocument* document);
 /** Get node that corresponds to given xml path. */
 kzsError bfReportDocumentGetNode(const struct BfReportDocument* document, kzString path, struct XMLNode** out_node);
 
+/** Sets file the report is saved to, replacing the default reports/report_<date>_<time>.xml. */
+kzsError bfReportDocumentSetFileName(struct BfReportDocument* document, kzString fileName);
+
 /** Save report document to xml. */
 kzsError bfReportDocumentSaveXML(const struct BfReportDocument* document);
 
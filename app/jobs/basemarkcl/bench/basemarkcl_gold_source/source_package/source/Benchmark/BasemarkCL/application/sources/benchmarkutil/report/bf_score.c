@@ -0,0 +1,275 @@
+/**
+* \file
+* Benchmark frame time statistics used for scoring.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "bf_score.h"
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/util/collection/kzc_sort.h>
+#include <core/util/math/kzc_random.h>
+
+#include <system/wrappers/kzs_math.h>
+
+
+/** Seed of the bootstrap resampling. Fixed so that the same frame times always give the same interval. */
+#define BF_SCORE_BOOTSTRAP_SEED 1234567
+
+
+/** Reorders values so that value at index k is the k:th smallest, smaller values precede it and larger follow it. */
+static void bfScoreSelect_internal(kzUint* values, kzInt count, kzInt k);
+
+
+static void bfScoreSelect_internal(kzUint* values, kzInt count, kzInt k)
+{
+    kzInt left = 0;
+    kzInt right = count - 1;
+
+    /* Quickselect with median of three pivot. Expected linear time. */
+    while(right > left)
+    {
+        kzInt middle = left + (right - left) / 2;
+        kzInt i = left;
+        kzInt j = right;
+        kzUint pivot;
+        kzUint swap;
+
+        if(values[middle] < values[left]) { swap = values[middle]; values[middle] = values[left]; values[left] = swap; }
+        if(values[right] < values[left]) { swap = values[right]; values[right] = values[left]; values[left] = swap; }
+        if(values[right] < values[middle]) { swap = values[right]; values[right] = values[middle]; values[middle] = swap; }
+        pivot = values[middle];
+
+        while(i <= j)
+        {
+            while(values[i] < pivot) ++i;
+            while(values[j] > pivot) --j;
+            if(i <= j)
+            {
+                swap = values[i]; values[i] = values[j]; values[j] = swap;
+                ++i;
+                --j;
+            }
+        }
+
+        if(k <= j)
+        {
+            right = j;
+        }
+        else if(k >= i)
+        {
+            left = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+kzFloat bfScoreCalculateMedian(kzUint* values, kzUint count)
+{
+    kzFloat median;
+    kzUint upper;
+
+    kzsAssert(count > 0);
+
+    bfScoreSelect_internal(values, (kzInt)count, (kzInt)(count / 2));
+    upper = values[count / 2];
+
+    if(count % 2 == 0)
+    {
+        /* Lower middle value is the largest of the lower half. */
+        kzUint lower = values[0];
+        kzUint i;
+        for(i = 1; i < count / 2; ++i)
+        {
+            lower = kzsMaxU(lower, values[i]);
+        }
+        median = (lower + upper) / 2.0f;
+    }
+    else
+    {
+        median = (kzFloat)upper;
+    }
+
+    return median;
+}
+
+kzUint bfScoreCalculatePercentile(kzUint* values, kzUint count, kzUint percentile)
+{
+    kzUint rank;
+
+    kzsAssert(count > 0);
+    kzsAssert(percentile <= 100);
+
+    /* Nearest rank is the smallest value with at least given percentage of values at or below it. */
+    rank = (percentile * count + 99) / 100;
+    rank = (rank > 0) ? rank - 1 : 0;
+
+    bfScoreSelect_internal(values, (kzInt)count, (kzInt)rank);
+    return values[rank];
+}
+
+void bfScoreRunningStatisticsReset(struct BfScoreRunningStatistics* statistics)
+{
+    statistics->frameCount = 0;
+    statistics->sampleCount = 0;
+    statistics->mean = 0.0;
+    statistics->squareSum = 0.0;
+}
+
+void bfScoreRunningStatisticsAdd(struct BfScoreRunningStatistics* statistics, const struct BfScoreConfiguration* configuration, kzUint frameTime)
+{
+    ++statistics->frameCount;
+    if(statistics->frameCount > configuration->warmupFrames)
+    {
+        /* Welford's update, so that no frame times need to be stored. */
+        kzDouble logFrameTime = kzsLogE((kzDouble)kzsMaxU(frameTime, 1));
+        kzDouble difference = logFrameTime - statistics->mean;
+        ++statistics->sampleCount;
+        statistics->mean += difference / statistics->sampleCount;
+        statistics->squareSum += difference * (logFrameTime - statistics->mean);
+    }
+}
+
+kzFloat bfScoreRunningStatisticsGetPrecision(const struct BfScoreRunningStatistics* statistics)
+{
+    kzFloat precision = KZ_FLOAT_MAXIMUM;
+
+    if(statistics->sampleCount > 1)
+    {
+        kzFloat variance = (kzFloat)(statistics->squareSum / (statistics->sampleCount - 1));
+        /* Interval of the mean logarithm maps to a relative interval of the geometric mean. */
+        kzFloat halfWidth = 1.96f * kzsSqrtf(variance / statistics->sampleCount);
+        precision = (kzsExp(halfWidth) - 1.0f) * 100.0f;
+    }
+
+    return precision;
+}
+
+kzFloat bfScoreFromFrameTime(kzFloat geometricMean)
+{
+    return (geometricMean > 0.0f) ? 1000000.0f / geometricMean : 0.0f;
+}
+
+kzsError bfScoreCalculateStatistics(const struct KzcMemoryManager* memoryManager, const kzUint* frameTimes, kzUint frameCount,
+                                    const struct BfScoreConfiguration* configuration, struct BfScoreStatistics* out_statistics)
+{
+    kzsError result;
+    kzUint i;
+    kzUint warmupFrames;
+    kzUint trimmedFrames;
+    kzUint sampleCount;
+    kzUint* values;
+    kzUint* samples;
+    kzFloat* logSamples;
+    kzDouble sum = 0.0;
+    kzDouble logSum = 0.0;
+    kzDouble squareSum = 0.0;
+    kzDouble mean;
+    kzUint fastest = KZ_UINT_MAXIMUM;
+    kzUint slowest = KZ_UINT_MINIMUM;
+    struct BfScoreStatistics statistics;
+
+    kzsAssert(frameCount > 0);
+    kzsAssert(configuration != KZ_NULL);
+
+    /* Always leave at least one frame for the statistics. */
+    warmupFrames = kzsMinU(configuration->warmupFrames, frameCount - 1);
+    sampleCount = frameCount - warmupFrames;
+    trimmedFrames = kzsMinU(sampleCount * kzsMinU(configuration->trimPercent, 50) / 100, (sampleCount - 1) / 2);
+
+    result = kzcMemoryAllocArray(memoryManager, values, sampleCount, "Score frame times");
+    kzsErrorForward(result);
+    for(i = 0; i < sampleCount; ++i)
+    {
+        values[i] = frameTimes[warmupFrames + i];
+    }
+
+    /* Move the fastest and the slowest frames to the ends of the array, and use the frames between. */
+    samples = values;
+    if(trimmedFrames > 0)
+    {
+        bfScoreSelect_internal(values, (kzInt)sampleCount, (kzInt)trimmedFrames);
+        bfScoreSelect_internal(values + trimmedFrames, (kzInt)(sampleCount - trimmedFrames), (kzInt)(sampleCount - 2 * trimmedFrames));
+        samples = values + trimmedFrames;
+        sampleCount -= 2 * trimmedFrames;
+    }
+
+    result = kzcMemoryAllocArray(memoryManager, logSamples, sampleCount, "Score logarithmic frame times");
+    kzsErrorForward(result);
+
+    for(i = 0; i < sampleCount; ++i)
+    {
+        kzUint frameTime = samples[i];
+        fastest = kzsMinU(frameTime, fastest);
+        slowest = kzsMaxU(frameTime, slowest);
+        sum += frameTime;
+        /* Geometric mean is accumulated as a sum of logarithms, since a product of roots loses precision. */
+        logSamples[i] = (kzFloat)kzsLogE((kzDouble)kzsMaxU(frameTime, 1));
+        logSum += logSamples[i];
+    }
+    mean = sum / sampleCount;
+    for(i = 0; i < sampleCount; ++i)
+    {
+        kzDouble difference = samples[i] - mean;
+        squareSum += difference * difference;
+    }
+
+    statistics.sampleCount = sampleCount;
+    statistics.warmupFrames = warmupFrames;
+    statistics.trimmedFrames = 2 * trimmedFrames;
+    statistics.fastest = fastest;
+    statistics.slowest = slowest;
+    statistics.average = (kzFloat)mean;
+    statistics.geometricMean = kzsExp((kzFloat)(logSum / sampleCount));
+    statistics.coefficientOfVariation = (mean > 0.0) ? kzsSqrtf((kzFloat)(squareSum / sampleCount)) / (kzFloat)mean : 0.0f;
+    statistics.geometricMeanLow = statistics.geometricMean;
+    statistics.geometricMeanHigh = statistics.geometricMean;
+
+    /* Percentile bootstrap of the geometric mean. */
+    if(configuration->bootstrapResamples > 0 && sampleCount > 1)
+    {
+        kzUint resampleCount = configuration->bootstrapResamples;
+        kzFloat* resampleMeans;
+        struct KzcRandom random = kzcRandomInline(BF_SCORE_BOOTSTRAP_SEED);
+        kzUint resample;
+
+        result = kzcMemoryAllocArray(memoryManager, resampleMeans, resampleCount, "Score bootstrap means");
+        kzsErrorForward(result);
+
+        for(resample = 0; resample < resampleCount; ++resample)
+        {
+            kzDouble resampleSum = 0.0;
+            for(i = 0; i < sampleCount; ++i)
+            {
+                resampleSum += logSamples[kzcRandomInteger(&random, 0, (kzInt)sampleCount)];
+            }
+            resampleMeans[resample] = (kzFloat)(resampleSum / sampleCount);
+        }
+
+        {
+            kzInt lowIndex = (kzInt)(0.025f * (resampleCount - 1));
+            kzInt highIndex = (kzInt)(0.975f * (resampleCount - 1) + 0.5f);
+            /* The resample count is small and fixed, so a full sort is cheap enough for both percentiles. */
+            kzcSort(resampleMeans, resampleCount, sizeof(*resampleMeans), kzcCompareFloats);
+            statistics.geometricMeanLow = kzsExp(resampleMeans[lowIndex]);
+            statistics.geometricMeanHigh = kzsExp(resampleMeans[highIndex]);
+        }
+
+        result = kzcMemoryFreeArray(resampleMeans);
+        kzsErrorForward(result);
+    }
+
+    /* Median reorders the samples, so it is calculated last. */
+    statistics.median = bfScoreCalculateMedian(samples, sampleCount);
+
+    result = kzcMemoryFreeArray(logSamples);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(values);
+    kzsErrorForward(result);
+
+    *out_statistics = statistics;
+    kzsSuccess();
+}
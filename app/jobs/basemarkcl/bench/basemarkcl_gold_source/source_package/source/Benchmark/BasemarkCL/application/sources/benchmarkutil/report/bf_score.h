@@ -0,0 +1,86 @@
+/**
+* \file
+* Benchmark frame time statistics used for scoring.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef BF_SCORE_H
+#define BF_SCORE_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/** Configuration of frame time statistics. */
+struct BfScoreConfiguration
+{
+    kzUint warmupFrames; /**< Number of frames discarded from the beginning of each scene. */
+    kzUint trimPercent; /**< Percentage of fastest and of slowest frames discarded as outliers. */
+    kzUint bootstrapResamples; /**< Number of bootstrap resamples for the confidence interval. Zero disables the interval. */
+    kzBool adaptiveRunLength; /**< Stop scenes once their score is stable instead of running the full frame count. */
+    kzFloat adaptiveTargetPrecision; /**< Target half-width of the 95% confidence interval of the score, in percent of the score. */
+    kzUint adaptiveTimeBudget; /**< Maximum running time of an adaptive scene in milliseconds. Zero for no limit. */
+    kzUint adaptiveMinimumFrames; /**< Number of measured frames an adaptive scene runs at least. */
+};
+
+/** Frame time statistics of a scene. Times are in microseconds. */
+struct BfScoreStatistics
+{
+    kzUint sampleCount; /**< Number of frames used for the statistics. */
+    kzUint warmupFrames; /**< Number of discarded warm-up frames. */
+    kzUint trimmedFrames; /**< Number of discarded outlier frames. */
+    kzUint fastest; /**< Fastest frame. */
+    kzUint slowest; /**< Slowest frame. */
+    kzFloat average; /**< Arithmetic mean of frames. */
+    kzFloat median; /**< Median of frames. */
+    kzFloat geometricMean; /**< Geometric mean of frames. */
+    kzFloat coefficientOfVariation; /**< Standard deviation of frames divided by their mean. */
+    kzFloat geometricMeanLow; /**< Lower bound of the 95% bootstrap confidence interval of the geometric mean. */
+    kzFloat geometricMeanHigh; /**< Upper bound of the 95% bootstrap confidence interval of the geometric mean. */
+};
+
+/** Frame time statistics accumulated while a scene runs. */
+struct BfScoreRunningStatistics
+{
+    kzUint frameCount; /**< Number of added frames, including warm-up frames. */
+    kzUint sampleCount; /**< Number of frames included in the statistics. */
+    kzDouble mean; /**< Mean of logarithmic frame times. */
+    kzDouble squareSum; /**< Sum of squared differences of logarithmic frame times from their mean. */
+};
+
+
+/**
+* Calculates statistics of frame times. Warm-up frames are discarded first, then configured percentage of fastest and slowest
+* frames is trimmed from the rest. Frame times are not modified. At least one frame is always used.
+*/
+kzsError bfScoreCalculateStatistics(const struct KzcMemoryManager* memoryManager, const kzUint* frameTimes, kzUint frameCount,
+                                    const struct BfScoreConfiguration* configuration, struct BfScoreStatistics* out_statistics);
+
+/** Returns the median of values in linear time. Values are reordered. */
+kzFloat bfScoreCalculateMedian(kzUint* values, kzUint count);
+
+/** Returns the nearest-rank percentile (0-100) of values in linear time. Values are reordered. */
+kzUint bfScoreCalculatePercentile(kzUint* values, kzUint count, kzUint percentile);
+
+/** Clears running statistics. */
+void bfScoreRunningStatisticsReset(struct BfScoreRunningStatistics* statistics);
+
+/** Adds a frame time to running statistics. Configured warm-up frames are skipped. */
+void bfScoreRunningStatisticsAdd(struct BfScoreRunningStatistics* statistics, const struct BfScoreConfiguration* configuration, kzUint frameTime);
+
+/**
+* Returns half-width of the 95% confidence interval of the geometric mean in percent of the geometric mean. Outliers are not trimmed,
+* so the estimate is conservative compared to the final statistics. Returns KZ_FLOAT_MAXIMUM until there are two frames.
+*/
+kzFloat bfScoreRunningStatisticsGetPrecision(const struct BfScoreRunningStatistics* statistics);
+
+/** Returns score of given geometric mean frame time. */
+kzFloat bfScoreFromFrameTime(kzFloat geometricMean);
+
+
+#endif
@@ -13,6 +13,7 @@
 #else
 #include <stddef.h>
 #include <sys/time.h>
+#include <time.h>
 #endif
 
 
@@ -24,6 +25,7 @@ struct BfTimer
     LARGE_INTEGER startTime; /**< Starting time of high frequency timer. */
 #else
     struct timeval startTime;
+    struct timespec monotonicStartTime; /**< Starting time of monotonic clock, used for nanosecond times. */
 #endif
 };
 
@@ -41,6 +43,7 @@ kzsError bfTimerCreate(const struct KzcMemoryManager* memoryManager, struct BfTi
     QueryPerformanceCounter(&timer->startTime);   
 #else
     gettimeofday(&timer->startTime, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &timer->monotonicStartTime);
 #endif
 
     *out_timer = timer;
@@ -98,3 +101,20 @@ kzUint bfTimerGetElapsedTimeInMicroSeconds(struct BfTimer* timer)
 
     return (kzUint)timeMs;
 }
+
+kzUint bfTimerGetElapsedTimeInNanoSeconds(struct BfTimer* timer)
+{
+    /* Elapsed time is calculated in full range and reduced modulo 2^32 only by the final unsigned conversion. */
+#if WIN32
+    LARGE_INTEGER time;
+    ULONGLONG ticks;
+    ULONGLONG frequency = (ULONGLONG)timer->frequency.QuadPart;
+    QueryPerformanceCounter(&time);
+    ticks = (ULONGLONG)(time.QuadPart - timer->startTime.QuadPart);
+    return (kzUint)((ticks / frequency) * 1000000000u + ((ticks % frequency) * 1000000000u) / frequency);
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (kzUint)(time.tv_sec - timer->monotonicStartTime.tv_sec) * 1000000000u + (kzUint)(time.tv_nsec - timer->monotonicStartTime.tv_nsec);
+#endif
+}
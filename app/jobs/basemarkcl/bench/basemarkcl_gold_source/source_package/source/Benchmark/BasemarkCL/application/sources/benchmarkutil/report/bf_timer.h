@@ -30,5 +30,11 @@ kzUint bfTimerGetElapsedTimeInMilliSeconds(struct BfTimer* timer);
 /** Returns elapsed time in microseconds. */
 kzUint bfTimerGetElapsedTimeInMicroSeconds(struct BfTimer* timer);
 
+/**
+* Returns elapsed time in nanoseconds modulo 2^32, so the value wraps around every 4.29 seconds. Unsigned difference of two
+* readings is correct if they are less than that apart.
+*/
+kzUint bfTimerGetElapsedTimeInNanoSeconds(struct BfTimer* timer);
+
 
 #endif
@@ -11,6 +11,9 @@
 #include <benchmarkutil/report/bf_report_document.h>
 #include <benchmarkutil/report/bf_report.h>
 #include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_score.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/util/bf_timing_hook.h>
 
 #include <user/engine/kzu_engine.h>
 #include <user/ui/kzu_ui_action.h>
@@ -23,9 +26,13 @@
 #include <core/util/collection/kzc_dynamic_array.h>
 
 #include <system/time/kzs_time.h>
+#include <system/time/kzs_tick.h>
 #include <system/wrappers/kzs_opengl.h>
 #include <system/wrappers/kzs_openvg.h>
 #include <clutil/clu_profiler.h>
+#include <clutil/clu_program_cache.h>
+#include <clutil/clu_image_cache.h>
+#include <clutil/clu_work_group_tuner.h>
 
 struct BfScene
 {
@@ -40,9 +47,87 @@ struct BfScene
     kzBool usingBinaryProgram; /**< Does scene use binary kernels. */
     struct CluProfiler *profiler; /* Profiler for this scene */
     kzFloat scoreWeightFactor; /**< How much weight does this test bring to overall score. */
+    kzBool adaptiveRunLength; /**< Can the scene stop before its frame counter runs out, when adaptive run length is enabled. */
+    struct BfScoreRunningStatistics runningStatistics; /**< Frame time statistics of the running scene for adaptive run length. */
+    kzUint startTime; /**< Timestamp in milliseconds when the scene started running. */
+    kzString stopReason; /**< Why the scene stopped: "frameLimit", "converged" or "timeBudget". */
+    kzBool timingHookActive; /**< Scene begin hook has been called without scene end. */
+    kzBool workGroupTunable; /**< Scene launches its kernels through the work-group tuner. */
+    kzBool workGroupTuned; /**< Scene runs with tuned work-group sizes. */
+    kzBool workGroupComparison; /**< Scene is the tuned copy of a scene run also with default work-group sizes. */
 };
 
 
+/** Checks whether an adaptive scene has run long enough. Sets the stop reason and returns KZ_TRUE if so. */
+static kzBool bfSceneIsRunLengthReached_internal(const struct BenchmarkFramework* framework, struct BfScene* sceneData);
+/** Adds the run length of the scene to its report node. */
+static kzsError bfSceneReportRunLength_internal(const struct BfScene* sceneData, const struct BfReportLogger* reportLogger, const struct XMLNode* testNode);
+/** Gets the path of a profiler output file of the scene. Spaces of the scene name are replaced with underscores. */
+static kzsError bfSceneGetProfilerPath_internal(const struct BfScene* sceneData, kzString extension, kzMutableString* out_path);
+
+
+static kzBool bfSceneIsRunLengthReached_internal(const struct BenchmarkFramework* framework, struct BfScene* sceneData)
+{
+    const struct BfScoreConfiguration* configuration = bfGetScoreConfiguration(framework);
+    kzBool reached = KZ_FALSE;
+
+    if(configuration->adaptiveRunLength && sceneData->adaptiveRunLength)
+    {
+        if(configuration->adaptiveTimeBudget > 0 && kzsTimeGetCurrentTimestamp() - sceneData->startTime >= configuration->adaptiveTimeBudget)
+        {
+            sceneData->stopReason = "timeBudget";
+            reached = KZ_TRUE;
+        }
+        else if(sceneData->runningStatistics.sampleCount >= configuration->adaptiveMinimumFrames &&
+                bfScoreRunningStatisticsGetPrecision(&sceneData->runningStatistics) <= configuration->adaptiveTargetPrecision)
+        {
+            sceneData->stopReason = "converged";
+            reached = KZ_TRUE;
+        }
+    }
+
+    return reached;
+}
+
+static kzsError bfSceneReportRunLength_internal(const struct BfScene* sceneData, const struct BfReportLogger* reportLogger, const struct XMLNode* testNode)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct XMLNode* node;
+
+    result = bfInfoAddInteger(memoryManager, testNode, "framesUsed", (kzInt)bfReportLoggerGetFrameCount(reportLogger));
+    kzsErrorForward(result);
+    result = bfInfoAddInteger(memoryManager, testNode, "frameLimit", (kzInt)sceneData->frameCounterInitialValue);
+    kzsErrorForward(result);
+    result = XMLNodeCreateString(memoryManager, "stopReason", sceneData->stopReason, &node);
+    kzsErrorForward(result);
+    result = XMLNodeAddChild(testNode, node);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError bfSceneGetProfilerPath_internal(const struct BfScene* sceneData, kzString extension, kzMutableString* out_path)
+{
+    kzsError result;
+    kzMutableString path;
+    kzUint i;
+
+    result = kzcStringFormat(kzcMemoryGetManager(sceneData), "profile_%s.%s", &path, sceneData->sceneName, extension);
+    kzsErrorForward(result);
+    for(i = 0; path[i] != '\0'; ++i)
+    {
+        if(path[i] == ' ')
+        {
+            path[i] = '_';
+        }
+    }
+
+    *out_path = path;
+    kzsSuccess();
+}
+
+
 KZ_CALLBACK KzuUiActionCallback bfSceneGetUiActionCallback(struct BfScene* sceneData)
 {
     kzsAssert(kzcIsValidPointer(sceneData));
@@ -68,6 +153,7 @@ kzsError bfTestConfigurationInitialize(const struct KzcMemoryManager* memoryMana
     configuration->uiAction = uiAction;
     configuration->preUpdate_private = preUpdate;
     configuration->postUpdate_private = postUpdate;
+    configuration->report_private = KZ_NULL;
     configuration->isBenchmarkedScene = KZ_TRUE;
 
     *out_configuration = configuration;
@@ -103,9 +189,11 @@ kzsError bfSceneCreate(const struct BenchmarkFramework* framework, struct BfScen
     kzsErrorForward(result);
     {
         kzInt profilingEnabled;
+        kzBool deviceTiming = (bfReportLoggerGetTimingMode(bfGetReportLogger(framework)) == BF_REPORT_TIMING_DEVICE);
         result = settingGetInt(bfGetSettings(framework), "EnableProfiling", &profilingEnabled);
         kzsErrorForward(result);
-        result = cluProfilerCreate(memoryManager, 1024, (profilingEnabled == 1), &sceneData->profiler);
+        /* Device timing needs the events of every frame, but they are traced to file only when profiling output is requested. */
+        result = cluProfilerCreate(memoryManager, 1024, deviceTiming, (profilingEnabled == 1), &sceneData->profiler);
         kzsErrorForward(result);
     }
 
@@ -118,6 +206,13 @@ kzsError bfSceneCreate(const struct BenchmarkFramework* framework, struct BfScen
     sceneData->validData = KZ_TRUE;
     sceneData->usingBinaryProgram = KZ_FALSE;
     sceneData->scoreWeightFactor = 1.0f;
+    sceneData->adaptiveRunLength = KZ_TRUE;
+    sceneData->stopReason = "frameLimit";
+    sceneData->timingHookActive = KZ_FALSE;
+    sceneData->workGroupTunable = KZ_FALSE;
+    sceneData->workGroupTuned = KZ_FALSE;
+    sceneData->workGroupComparison = KZ_FALSE;
+    bfScoreRunningStatisticsReset(&sceneData->runningStatistics);
 
     *out_sceneData = sceneData;
     kzsSuccess();
@@ -166,18 +261,82 @@ kzsError bfSceneInitialize(struct BenchmarkFramework* framework, struct BfScene*
     sceneData->frameCounterInitialValue = 0;
     sceneData->frameCounter = 0;
     sceneData->isPartOfScore = KZ_TRUE;
+    sceneData->adaptiveRunLength = KZ_TRUE;
+    sceneData->stopReason = "frameLimit";
+    bfScoreRunningStatisticsReset(&sceneData->runningStatistics);
 
     reportLogger = bfGetReportLogger(framework);
 
+    if(bfGetProgramCache(framework) != KZ_NULL)
+    {
+        result = cluProgramCacheResetStatistics(bfGetProgramCache(framework));
+        kzsErrorForward(result);
+    }
+    if(bfGetImageCache(framework) != KZ_NULL)
+    {
+        cluImageCacheResetStatistics(bfGetImageCache(framework));
+    }
+    if(bfGetWorkGroupTuner(framework) != KZ_NULL)
+    {
+        result = cluWorkGroupTunerReset(bfGetWorkGroupTuner(framework));
+        kzsErrorForward(result);
+    }
+
     result = sceneData->configuration->load_private(framework, sceneData);
     kzsErrorForward(result);
 
+    /* Tuning frame is run untimed before the trace starts, so that launches search their work-group sizes with the kernel arguments of the scene. */
+    if(bfSceneGetWorkGroupTuner(framework, sceneData) != KZ_NULL)
+    {
+        struct CluWorkGroupTuner* tuner = bfSceneGetWorkGroupTuner(framework, sceneData);
+
+        cluWorkGroupTunerSetSearchEnabled(tuner, KZ_TRUE);
+        result = sceneData->configuration->update_private(framework, 0, sceneData);
+        kzsErrorForward(result);
+        cluWorkGroupTunerSetSearchEnabled(tuner, KZ_FALSE);
+
+        result = cluProfilerEndFrame(sceneData->profiler);
+        kzsErrorForward(result);
+
+        /* Tuning frame advanced the simulation state of the scene, so the scene is loaded again for the measured run to start from
+           the same state as a run without tuning. The tuned sizes are bound to the kernels of the reloaded scene on their first launch. */
+        cluWorkGroupTunerUnbindKernels(tuner);
+        result = sceneData->configuration->free_private(framework, sceneData);
+        kzsErrorForward(result);
+        result = sceneData->configuration->load_private(framework, sceneData);
+        kzsErrorForward(result);
+    }
+    if(sceneData->workGroupComparison)
+    {
+        sceneData->isPartOfScore = KZ_FALSE;
+    }
+
     if(sceneData->configuration->isBenchmarkedScene)
     {
         result = bfReportLoggerReset(reportLogger, sceneData->sceneName, sceneData->frameCounter, sceneData->isPartOfScore);
         kzsErrorForward(result);
     }
 
+    if(sceneData->configuration->isBenchmarkedScene && sceneData->profiler->traceEnabled)
+    {
+        kzMutableString tracePath;
+        result = bfSceneGetProfilerPath_internal(sceneData, "cltrace", &tracePath);
+        kzsErrorForward(result);
+        result = cluProfilerBeginTrace(sceneData->profiler, tracePath);
+        kzsErrorForward(result);
+        result = kzcStringDelete(tracePath);
+        kzsErrorForward(result);
+    }
+
+    if(sceneData->configuration->isBenchmarkedScene)
+    {
+        bfTimingHookSceneBegin(bfGetTimingHook(framework), sceneData->sceneName);
+        sceneData->timingHookActive = KZ_TRUE;
+    }
+
+    /* Loading is not counted to the time budget of adaptive run length. */
+    sceneData->startTime = kzsTimeGetCurrentTimestamp();
+
     kzsSuccess();
 }
 
@@ -197,7 +356,7 @@ kzsError bfSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, s
 
     if(sceneData->configuration->isBenchmarkedScene)
     {
-        /* Execute the preframe executable. */
+        /* Execute the preframe executable. Compatibility only, as starting a process on each frame disturbs the results. */
         if(bfGetTimingStartExecPath(framework) != KZ_NULL)
         {
             kzInt value = (kzInt)system(bfGetTimingStartExecPath(framework));
@@ -210,6 +369,7 @@ kzsError bfSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, s
             kzsErrorForward(result);
         }
 
+        bfTimingHookFrameBegin(bfGetTimingHook(framework), sceneData->sceneName, bfReportLoggerGetFrameCount(reportLogger));
         result = bfReportLoggerUpdatePreFrame(reportLogger);
         kzsErrorForward(result);
     }
@@ -227,21 +387,46 @@ kzsError bfSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, s
         sceneComplete = KZ_FALSE;
     }
 
-    result = cluProfilerLogEvents(sceneData->profiler);
+    /* Profiling events are collected after the frame timer is stopped, so that they do not disturb the frame times. */
+    if(sceneData->configuration->isBenchmarkedScene)
+    {
+        bfReportLoggerStopFrameTimer(reportLogger);
+        bfTimingHookFrameEnd(bfGetTimingHook(framework), sceneData->sceneName, bfReportLoggerGetFrameCount(reportLogger));
+    }
+
+    result = cluProfilerEndFrame(sceneData->profiler);
     kzsErrorForward(result);
 
     if(sceneData->configuration->isBenchmarkedScene)
     {
+        bfReportLoggerSetFrameDeviceTimes(reportLogger, cluProfilerHasDeviceTimes(sceneData->profiler),
+                                          cluProfilerGetDeviceBusyTime(sceneData->profiler), cluProfilerGetDeviceSpanTime(sceneData->profiler));
         result = bfReportLoggerUpdatePostFrame(reportLogger);
         kzsErrorForward(result);
 
+        {
+            kzUint frameIndex = bfReportLoggerGetFrameCount(reportLogger) - 1;
+            kzUint frameTime = bfReportLoggerGetFrameTimesArray(reportLogger)[frameIndex];
+            /* With device timing, frames without device commands are not part of the statistics. */
+            if(bfReportLoggerGetTimingMode(reportLogger) != BF_REPORT_TIMING_DEVICE || bfReportLoggerFrameHasDeviceTimes(reportLogger, frameIndex))
+            {
+                bfScoreRunningStatisticsAdd(&sceneData->runningStatistics, bfGetScoreConfiguration(framework), frameTime);
+            }
+        }
+        /* Frame counter remains the upper limit of adaptive scenes. */
+        if(!sceneComplete && bfSceneIsRunLengthReached_internal(framework, sceneData))
+        {
+            sceneData->frameCounter = 0;
+            sceneComplete = KZ_TRUE;
+        }
+
         if(sceneData->configuration->postUpdate_private != KZ_NULL)
         {
             result = sceneData->configuration->postUpdate_private(framework, sceneData);
             kzsErrorForward(result);
         }
 
-        /* Execute the postframe executable. */
+        /* Execute the postframe executable. Compatibility only, as starting a process on each frame disturbs the results. */
         if(bfGetTimingStopExecPath(framework) != KZ_NULL)
         {
             kzInt value = (kzInt)system(bfGetTimingStopExecPath(framework));
@@ -251,12 +436,55 @@ kzsError bfSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, s
         if(sceneComplete)
         {
             struct XMLNode* node;
+            struct XMLNode* testNode;
             struct BfReportDocument* report = bfGetReportDocument(framework);
+
+            bfTimingHookSceneEnd(bfGetTimingHook(framework), sceneData->sceneName, bfReportLoggerGetFrameCount(reportLogger));
+            sceneData->timingHookActive = KZ_FALSE;
+
             result = bfReportDocumentGetNode(report, "xml/benchmark/tests", &node);
             kzsErrorForward(result);
-            result = bfInfoUpdateSceneResults(node, reportLogger, sceneData->sceneName, sceneData->sceneCategory, sceneData->validData, sceneData->usingBinaryProgram, sceneData->scoreWeightFactor);
+            result = bfInfoUpdateSceneResults(node, reportLogger, sceneData->sceneName, sceneData->sceneCategory, sceneData->validData, sceneData->usingBinaryProgram, sceneData->scoreWeightFactor,
+                                              bfGetScoreConfiguration(framework), bfGetProgramCache(framework), bfGetImageCache(framework), &testNode);
             kzsErrorForward(result);
 
+            result = bfSceneReportRunLength_internal(sceneData, reportLogger, testNode);
+            kzsErrorForward(result);
+
+            if(bfSceneGetWorkGroupTuner(framework, sceneData) != KZ_NULL)
+            {
+                result = bfInfoUpdateWorkGroupTunerResults(testNode, bfSceneGetWorkGroupTuner(framework, sceneData));
+                kzsErrorForward(result);
+            }
+
+            if(cluProfilerIsTracing(sceneData->profiler))
+            {
+                kzMutableString tracePath;
+                kzMutableString jsonPath;
+
+                result = cluProfilerEndTrace(sceneData->profiler);
+                kzsErrorForward(result);
+                result = bfInfoUpdateProfilerResults(testNode, sceneData->profiler);
+                kzsErrorForward(result);
+
+                result = bfSceneGetProfilerPath_internal(sceneData, "cltrace", &tracePath);
+                kzsErrorForward(result);
+                result = bfSceneGetProfilerPath_internal(sceneData, "json", &jsonPath);
+                kzsErrorForward(result);
+                result = cluProfilerConvertTraceToJson(kzcMemoryGetManager(sceneData), tracePath, jsonPath);
+                kzsErrorForward(result);
+                result = kzcStringDelete(jsonPath);
+                kzsErrorForward(result);
+                result = kzcStringDelete(tracePath);
+                kzsErrorForward(result);
+            }
+
+            if(sceneData->configuration->report_private != KZ_NULL)
+            {
+                result = sceneData->configuration->report_private(framework, sceneData, testNode);
+                kzsErrorForward(result);
+            }
+
             {
                 
                 kzInt outputReport;
@@ -297,6 +525,16 @@ kzsError bfSceneUninitialize(struct BenchmarkFramework* framework, struct BfScen
 
     kzsAssert(sceneData != KZ_NULL);
 
+    if(sceneData->timingHookActive)
+    {
+        bfTimingHookSceneEnd(bfGetTimingHook(framework), sceneData->sceneName, bfReportLoggerGetFrameCount(bfGetReportLogger(framework)));
+        sceneData->timingHookActive = KZ_FALSE;
+    }
+
+    /* Trace of an interrupted scene is closed, but not converted. */
+    result = cluProfilerEndTrace(sceneData->profiler);
+    kzsErrorForward(result);
+
     result = sceneData->configuration->free_private(framework, sceneData);
     kzsErrorForward(result);
 
@@ -367,6 +605,12 @@ void bfSceneDisableFromOverallScore(struct BfScene* sceneData)
     sceneData->isPartOfScore = KZ_FALSE;
 }
 
+void bfSceneDisableAdaptiveRunLength(struct BfScene* sceneData)
+{
+    kzsAssert(kzcIsValidPointer(sceneData));
+    sceneData->adaptiveRunLength = KZ_FALSE;
+}
+
 kzBool bfSceneGetValidConfigurationData(const struct BfScene* sceneData)
 {
     kzsAssert(kzcIsValidPointer(sceneData));
@@ -385,6 +629,51 @@ void bfSceneSetScoreWeightFactor(struct BfScene* sceneData, kzFloat sceneWeight)
     sceneData->scoreWeightFactor = sceneWeight;
 }
 
+void bfSceneEnableWorkGroupTuning(struct BfScene* sceneData)
+{
+    kzsAssert(kzcIsValidPointer(sceneData));
+    sceneData->workGroupTunable = KZ_TRUE;
+}
+
+kzBool bfSceneIsWorkGroupTunable(const struct BfScene* sceneData)
+{
+    kzsAssert(kzcIsValidPointer(sceneData));
+    return sceneData->workGroupTunable;
+}
+
+kzsError bfSceneSetWorkGroupTuned(const struct BenchmarkFramework* framework, struct BfScene* sceneData, kzBool tuned)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(sceneData));
+
+    if(tuned && !sceneData->workGroupComparison && bfGetWorkGroupTuningMode(framework) == BF_WORK_GROUP_TUNING_COMPARE)
+    {
+        kzMutableString sceneName;
+        result = kzcStringFormat(kzcMemoryGetManager(sceneData), "%s (tuned)", &sceneName, sceneData->sceneName);
+        kzsErrorForward(result);
+        result = kzcStringDelete(sceneData->sceneName);
+        kzsErrorForward(result);
+        sceneData->sceneName = sceneName;
+        sceneData->workGroupComparison = KZ_TRUE;
+    }
+    sceneData->workGroupTuned = tuned;
+
+    kzsSuccess();
+}
+
+struct CluWorkGroupTuner* bfSceneGetWorkGroupTuner(const struct BenchmarkFramework* framework, const struct BfScene* sceneData)
+{
+    kzsAssert(kzcIsValidPointer(sceneData));
+    return (sceneData->workGroupTunable && sceneData->workGroupTuned) ? bfGetWorkGroupTuner(framework) : KZ_NULL;
+}
+
+kzBool bfSceneIsWorkGroupProfilingRequired(const struct BenchmarkFramework* framework, const struct BfScene* sceneData)
+{
+    kzsAssert(kzcIsValidPointer(sceneData));
+    return sceneData->workGroupTunable && bfGetWorkGroupTuningMode(framework) != BF_WORK_GROUP_TUNING_DISABLED;
+}
+
 kzBool bfSceneGetUseProgramBinary(const struct BfScene* sceneData)
 {
     kzsAssert(kzcIsValidPointer(sceneData));
@@ -21,6 +21,8 @@ struct KzcMemoryManager;
 struct BenchmarkFramework;
 struct BfTestLogNameCollection;
 struct BfReportLogger;
+struct XMLNode;
+struct CluWorkGroupTuner;
 
 
 /**
@@ -46,6 +48,8 @@ typedef kzsError (*BenchmarkKeyInputPtr)(struct BenchmarkFramework* framework, c
 typedef kzsError (*BenchmarkPreUpdateTestPtr)(struct BenchmarkFramework* framework, struct BfScene* scene);
 /** Postupdate scene function prototype. This is called after scene is updated. */
 typedef kzsError (*BenchmarkPostUpdateTestPtr)(struct BenchmarkFramework* framework, struct BfScene* scene);
+/** Report scene function prototype. This is called after the scene results are added to report, for adding scene specific results. */
+typedef kzsError (*BenchmarkReportTestPtr)(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
 
 
 /** Scene configuration struct */
@@ -60,6 +64,7 @@ struct BfSceneConfiguration
     KzuUiActionCallback uiAction; /**< Kanzi User Interface action callback, if any. */
     BenchmarkPreUpdateTestPtr preUpdate_private; /**< Scene prepare before update. */ 
     BenchmarkPostUpdateTestPtr postUpdate_private; /**< Scene clean up after update. */
+    BenchmarkReportTestPtr report_private; /**< Scene specific report results, if any. */
     kzBool isBenchmarkedScene; /**< Indicates that benchmarking is enabled for the scene. Disable this for loading bars etc. */
 };
 
@@ -101,7 +106,10 @@ void* bfSceneGetUserData(const struct BfScene* scene);
 /* Returns the profiler for this scene */
 struct CluProfiler* bfSceneGetProfiler(const struct BfScene* scene);
 
-/** Initialize frame counter. Test will run this amount of frames. */
+/**
+* Initialize frame counter. Test will run this amount of frames. With adaptive run length the test may stop earlier,
+* once its score is stable or its time budget is spent.
+*/
 void bfSceneSetFrameCounter(struct BfScene* sceneData, kzUint frameCount);
 /** Get current remaining frames count. */
 kzUint bfSceneGetFrameCounterValue(const struct BfScene* sceneData);
@@ -109,6 +117,8 @@ kzUint bfSceneGetFrameCounterValue(const struct BfScene* sceneData);
 kzUint bfSceneGetFrameInitialCounterValue(const struct BfScene* sceneData);
 /** Sets scene to not be included in overall benchmark score. */
 void bfSceneDisableFromOverallScore(struct BfScene* sceneData);
+/** Sets scene to always run its full frame count. Needed by scenes that do a different task on each frame. */
+void bfSceneDisableAdaptiveRunLength(struct BfScene* sceneData);
 
 /** Is valid configuration. */
 kzBool bfSceneGetValidConfigurationData(const struct BfScene* sceneData);
@@ -118,6 +128,23 @@ void bfSceneSetValidConfigurationData(struct BfScene* sceneData, kzBool valid);
 /** Sets scene score weight factor for final score calculation. */
 void bfSceneSetScoreWeightFactor(struct BfScene* sceneData, kzFloat sceneWeight);
 
+/** Marks the scene to launch its kernels through the work-group tuner. Called by scenes when they are created. */
+void bfSceneEnableWorkGroupTuning(struct BfScene* sceneData);
+/** Returns KZ_TRUE if the scene launches its kernels through the work-group tuner. */
+kzBool bfSceneIsWorkGroupTunable(const struct BfScene* sceneData);
+/**
+* Sets the scene to run with tuned work-group sizes. In BF_WORK_GROUP_TUNING_COMPARE mode the tuned scene is a copy of
+* the default one, so it is renamed with " (tuned)" suffix and left out of the overall score.
+*/
+kzsError bfSceneSetWorkGroupTuned(const struct BenchmarkFramework* framework, struct BfScene* sceneData, kzBool tuned);
+/** Gets the work-group tuner for launching the kernels of the scene. KZ_NULL if the scene does not run tuned. */
+struct CluWorkGroupTuner* bfSceneGetWorkGroupTuner(const struct BenchmarkFramework* framework, const struct BfScene* sceneData);
+/**
+* Returns KZ_TRUE if the command queues of the scene need event profiling for the work-group tuner. This is the case also
+* for the default run in BF_WORK_GROUP_TUNING_COMPARE mode, so that both runs use the same kind of queue.
+*/
+kzBool bfSceneIsWorkGroupProfilingRequired(const struct BenchmarkFramework* framework, const struct BfScene* sceneData);
+
 /** Uses binary kernels. */
 kzBool bfSceneGetUseProgramBinary(const struct BfScene* sceneData);
 /** Set binary kernels usage. */
@@ -0,0 +1,592 @@
+/**
+* \file
+* Multi-device scheduler. Runs the benchmark concurrently on every OpenCL device of the system.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "bf_device_scheduler.h"
+
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/bf_version.h>
+
+#include <clutil/clu_platform.h>
+
+#include <core/util/collection/kzc_dynamic_array.h>
+#include <core/util/io/kzc_file.h>
+#include <core/util/io/kzc_output_stream.h>
+#include <core/util/string/kzc_string.h>
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/time/kzs_time.h>
+#include <system/debug/kzs_log.h>
+#include <system/wrappers/kzs_string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+/** Exit code recorded for worker processes that could not be started or did not exit normally. */
+#define BF_DEVICE_SCHEDULER_EXIT_CODE_FAILED -1
+
+
+/** Worker process running tests on one device. */
+struct BfDeviceSchedulerWorker
+{
+    kzUint platform; /**< Index of the OpenCL platform. */
+    kzUint device; /**< Index of the device on the platform. */
+    kzString deviceName; /**< Name of the device. */
+    kzBool busy; /**< Is a worker process running. */
+    kzBool failed; /**< Worker process could not be started. No further runs are given to the worker. */
+    kzUint runIndex; /**< Index of the run executed by the worker process. */
+    struct BfTimer* timer; /**< Timer started when the worker process was started. */
+#ifdef WIN32
+    HANDLE process; /**< Handle of the worker process. */
+#else
+    pid_t process; /**< Process id of the worker process. */
+#endif
+};
+
+/** Tests run by one worker process. */
+struct BfDeviceSchedulerRun
+{
+    kzMutableString tests; /**< Comma separated list of tests. */
+    kzMutableString reportPath; /**< Report file written by the worker process. */
+    kzUint workerIndex; /**< Worker running the tests. Fixed beforehand when replicating, assigned at start when sharing. */
+    kzBool started; /**< Has a worker process been started for the run. Runs left unstarted are reported as failed. */
+    kzInt exitCode; /**< Exit code of the worker process. */
+    kzUint wallTime; /**< Time in milliseconds from starting to exiting of the worker process. */
+};
+
+
+/** Starts worker process running given run. Process is left unset on failure. */
+static kzsError bfDeviceSchedulerStart_internal(const struct KzcMemoryManager* memoryManager, kzString executablePath, struct BfDeviceSchedulerWorker* worker,
+                                                const struct BfDeviceSchedulerRun* run, kzBool* out_started);
+/** Waits until any busy worker exits. Returns index of the worker and exit code of its process. */
+static kzsError bfDeviceSchedulerWaitAny_internal(struct BfDeviceSchedulerWorker* workers, kzUint workerCount, kzUint* out_workerIndex, kzInt* out_exitCode);
+/** Writes the merged report of all runs. */
+static kzsError bfDeviceSchedulerWriteReport_internal(const struct KzcMemoryManager* memoryManager, enum BfDeviceSchedulerMode mode,
+                                                      const struct BfDeviceSchedulerWorker* workers, const struct BfDeviceSchedulerRun* runs,
+                                                      kzUint wallTime);
+/** Writes string to stream with XML special characters escaped. */
+static kzsError bfDeviceSchedulerWriteEscaped_internal(struct KzcOutputStream* stream, kzString string);
+/** Writes string to stream. */
+static kzsError bfDeviceSchedulerWrite_internal(struct KzcOutputStream* stream, kzString string);
+
+
+kzBool bfDeviceSchedulerParseMode(kzString value, enum BfDeviceSchedulerMode* out_mode)
+{
+    kzBool recognized = KZ_TRUE;
+
+    if(kzsStrcmp(value, "off") == 0 || kzsStrcmp(value, "0") == 0)
+    {
+        *out_mode = BF_DEVICE_SCHEDULER_DISABLED;
+    }
+    else if(kzsStrcmp(value, "replicate") == 0 || kzsStrcmp(value, "1") == 0)
+    {
+        *out_mode = BF_DEVICE_SCHEDULER_REPLICATE;
+    }
+    else if(kzsStrcmp(value, "share") == 0 || kzsStrcmp(value, "2") == 0)
+    {
+        *out_mode = BF_DEVICE_SCHEDULER_SHARE;
+    }
+    else
+    {
+        recognized = KZ_FALSE;
+    }
+
+    return recognized;
+}
+
+kzsError bfDeviceSchedulerRun(const struct KzcMemoryManager* memoryManager, const struct CluInfo* cluInfo, enum BfDeviceSchedulerMode mode,
+                              kzString executablePath, kzString testNames)
+{
+    kzsError result;
+    struct BfDeviceSchedulerWorker* workers;
+    struct BfDeviceSchedulerRun* runs;
+    kzUint workerCount = 0;
+    kzUint runCount;
+    kzUint completedCount = 0;
+    kzMutableString* testNamesArray;
+    kzUint testCount;
+    struct BfTimer* timer;
+    kzUint i;
+
+    kzsAssert(mode != BF_DEVICE_SCHEDULER_DISABLED);
+
+    /* One worker for each device of each platform. */
+    for(i = 0; i < kzcDynamicArrayGetSize(cluInfo->platforms); ++i)
+    {
+        const struct CluPlatformInfo* platformInfo = (const struct CluPlatformInfo*)kzcDynamicArrayGet(cluInfo->platforms, i);
+        workerCount += kzcDynamicArrayGetSize(platformInfo->devices);
+    }
+    kzsErrorTest(workerCount > 0, KZS_ERROR_ILLEGAL_OPERATION, "No OpenCL devices available for multi-device run");
+
+    result = kzcMemoryAllocArray(memoryManager, workers, workerCount, "Device scheduler workers");
+    kzsErrorForward(result);
+    {
+        kzUint workerIndex = 0;
+        for(i = 0; i < kzcDynamicArrayGetSize(cluInfo->platforms); ++i)
+        {
+            const struct CluPlatformInfo* platformInfo = (const struct CluPlatformInfo*)kzcDynamicArrayGet(cluInfo->platforms, i);
+            kzUint n;
+            for(n = 0; n < kzcDynamicArrayGetSize(platformInfo->devices); ++n)
+            {
+                const struct CluDeviceInfo* deviceInfo = (const struct CluDeviceInfo*)kzcDynamicArrayGet(platformInfo->devices, n);
+                struct BfDeviceSchedulerWorker* worker = &workers[workerIndex++];
+                worker->platform = i;
+                worker->device = n;
+                worker->deviceName = deviceInfo->name;
+                worker->busy = KZ_FALSE;
+                worker->failed = KZ_FALSE;
+                worker->runIndex = 0;
+                worker->timer = KZ_NULL;
+            }
+        }
+    }
+
+    result = kzcStringSplit(memoryManager, testNames, ",", &testCount, &testNamesArray);
+    kzsErrorForward(result);
+
+    /* Replicated runs are bound to their device, shared runs contain one test each and go to the first free device. */
+    runCount = (mode == BF_DEVICE_SCHEDULER_REPLICATE) ? workerCount : testCount;
+    result = kzcMemoryAllocArray(memoryManager, runs, runCount, "Device scheduler runs");
+    kzsErrorForward(result);
+    for(i = 0; i < runCount; ++i)
+    {
+        struct BfDeviceSchedulerRun* run = &runs[i];
+        if(mode == BF_DEVICE_SCHEDULER_REPLICATE)
+        {
+            result = kzcStringCopy(memoryManager, testNames, &run->tests);
+            kzsErrorForward(result);
+            run->workerIndex = i;
+        }
+        else
+        {
+            result = kzcStringCopy(memoryManager, kzcStringTrim(testNamesArray[i]), &run->tests);
+            kzsErrorForward(result);
+            run->workerIndex = 0;
+        }
+        run->reportPath = KZ_NULL;
+        run->started = KZ_FALSE;
+        run->exitCode = BF_DEVICE_SCHEDULER_EXIT_CODE_FAILED;
+        run->wallTime = 0;
+    }
+
+    result = kzcLog(memoryManager, KZS_LOG_LEVEL_INFO, "Running %u tests on %u devices (%s)", testCount, workerCount,
+                    (mode == BF_DEVICE_SCHEDULER_REPLICATE) ? "replicated" : "shared");
+    kzsErrorForward(result);
+
+    result = bfTimerCreate(memoryManager, &timer);
+    kzsErrorForward(result);
+
+    while(completedCount < runCount)
+    {
+        kzUint workerIndex;
+        kzInt exitCode;
+        kzBool anyBusy = KZ_FALSE;
+
+        /* Give each idle worker the next run it can take. */
+        for(workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+        {
+            struct BfDeviceSchedulerWorker* worker = &workers[workerIndex];
+            kzUint runIndex;
+            for(runIndex = 0; runIndex < runCount && !worker->busy && !worker->failed; ++runIndex)
+            {
+                struct BfDeviceSchedulerRun* run = &runs[runIndex];
+                if(!run->started && (mode == BF_DEVICE_SCHEDULER_SHARE || run->workerIndex == workerIndex))
+                {
+                    kzBool started;
+                    result = kzcStringFormat(memoryManager, "reports/device_%u_%u_run_%u.xml", &run->reportPath, worker->platform, worker->device, runIndex);
+                    kzsErrorForward(result);
+
+                    worker->runIndex = runIndex;
+                    result = bfDeviceSchedulerStart_internal(memoryManager, executablePath, worker, run, &started);
+                    kzsErrorForward(result);
+                    if(started)
+                    {
+                        run->started = KZ_TRUE;
+                        run->workerIndex = workerIndex;
+                    }
+                    else
+                    {
+                        /* A shared run stays available for the other devices. A replicated run is reported as not started. */
+                        result = kzcLog(memoryManager, KZS_LOG_LEVEL_WARNING, "Failed to start worker for device '%s'", worker->deviceName);
+                        kzsErrorForward(result);
+                        worker->failed = KZ_TRUE;
+                        result = kzcStringDelete(run->reportPath);
+                        kzsErrorForward(result);
+                        run->reportPath = KZ_NULL;
+                    }
+                }
+            }
+            anyBusy = anyBusy || worker->busy;
+        }
+
+        if(!anyBusy)
+        {
+            /* Remaining runs belong to workers that failed to start. */
+            for(i = 0; i < runCount; ++i)
+            {
+                if(!runs[i].started)
+                {
+                    result = kzcLog(memoryManager, KZS_LOG_LEVEL_WARNING, "Tests '%s' were not run on any device", runs[i].tests);
+                    kzsErrorForward(result);
+                }
+            }
+            break;
+        }
+
+        result = bfDeviceSchedulerWaitAny_internal(workers, workerCount, &workerIndex, &exitCode);
+        kzsErrorForward(result);
+        {
+            struct BfDeviceSchedulerWorker* worker = &workers[workerIndex];
+            struct BfDeviceSchedulerRun* run = &runs[worker->runIndex];
+            run->exitCode = exitCode;
+            run->wallTime = bfTimerGetElapsedTimeInMilliSeconds(worker->timer);
+            result = bfTimerDelete(worker->timer);
+            kzsErrorForward(result);
+            worker->timer = KZ_NULL;
+            worker->busy = KZ_FALSE;
+            ++completedCount;
+
+            result = kzcLog(memoryManager, KZS_LOG_LEVEL_INFO, "Device '%s' completed '%s' in %u ms with exit code %d", worker->deviceName, run->tests,
+                            run->wallTime, exitCode);
+            kzsErrorForward(result);
+        }
+    }
+
+    result = bfDeviceSchedulerWriteReport_internal(memoryManager, mode, workers, runs, bfTimerGetElapsedTimeInMilliSeconds(timer));
+    kzsErrorForward(result);
+
+    result = bfTimerDelete(timer);
+    kzsErrorForward(result);
+
+    for(i = 0; i < runCount; ++i)
+    {
+        result = kzcStringDelete(runs[i].tests);
+        kzsErrorForward(result);
+        if(runs[i].reportPath != KZ_NULL)
+        {
+            result = kzcStringDelete(runs[i].reportPath);
+            kzsErrorForward(result);
+        }
+    }
+    result = kzcMemoryFreeArray(runs);
+    kzsErrorForward(result);
+    for(i = 0; i < testCount; ++i)
+    {
+        result = kzcStringDelete(testNamesArray[i]);
+        kzsErrorForward(result);
+    }
+    result = kzcMemoryFreeArray(testNamesArray);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(workers);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError bfDeviceSchedulerStart_internal(const struct KzcMemoryManager* memoryManager, kzString executablePath, struct BfDeviceSchedulerWorker* worker,
+                                                const struct BfDeviceSchedulerRun* run, kzBool* out_started)
+{
+    kzsError result;
+    kzMutableString platformArgument;
+    kzMutableString deviceArgument;
+    kzMutableString testsArgument;
+    kzMutableString reportArgument;
+    kzString schedulerArgument = "--all-devices=off";
+    kzBool started;
+
+    result = kzcStringFormat(memoryManager, "--platform=%u", &platformArgument, worker->platform);
+    kzsErrorForward(result);
+    result = kzcStringFormat(memoryManager, "--device=%u", &deviceArgument, worker->device);
+    kzsErrorForward(result);
+    result = kzcStringFormat(memoryManager, "--tests=%s", &testsArgument, run->tests);
+    kzsErrorForward(result);
+    result = kzcStringFormat(memoryManager, "--report=%s", &reportArgument, run->reportPath);
+    kzsErrorForward(result);
+
+    result = bfTimerCreate(memoryManager, &worker->timer);
+    kzsErrorForward(result);
+
+#ifdef WIN32
+    {
+        kzMutableString commandLine;
+        STARTUPINFOA startupInfo;
+        PROCESS_INFORMATION processInformation;
+
+        result = kzcStringFormat(memoryManager, "\"%s\" %s %s \"%s\" \"%s\" %s", &commandLine, executablePath, platformArgument, deviceArgument,
+                                 testsArgument, reportArgument, schedulerArgument);
+        kzsErrorForward(result);
+
+        ZeroMemory(&startupInfo, sizeof(startupInfo));
+        startupInfo.cb = sizeof(startupInfo);
+        started = (CreateProcessA(KZ_NULL, commandLine, KZ_NULL, KZ_NULL, FALSE, 0, KZ_NULL, KZ_NULL, &startupInfo, &processInformation) != 0);
+        if(started)
+        {
+            CloseHandle(processInformation.hThread);
+            worker->process = processInformation.hProcess;
+        }
+
+        result = kzcStringDelete(commandLine);
+        kzsErrorForward(result);
+    }
+#else
+    {
+        char* arguments[7];
+        pid_t process;
+
+        arguments[0] = (char*)executablePath;
+        arguments[1] = platformArgument;
+        arguments[2] = deviceArgument;
+        arguments[3] = testsArgument;
+        arguments[4] = reportArgument;
+        arguments[5] = (char*)schedulerArgument;
+        arguments[6] = KZ_NULL;
+
+        process = fork();
+        if(process == 0)
+        {
+            execv(executablePath, arguments);
+            _exit(127);
+        }
+        started = (process > 0);
+        if(started)
+        {
+            worker->process = process;
+        }
+    }
+#endif
+
+    if(started)
+    {
+        worker->busy = KZ_TRUE;
+    }
+    else
+    {
+        result = bfTimerDelete(worker->timer);
+        kzsErrorForward(result);
+        worker->timer = KZ_NULL;
+    }
+
+    result = kzcStringDelete(platformArgument);
+    kzsErrorForward(result);
+    result = kzcStringDelete(deviceArgument);
+    kzsErrorForward(result);
+    result = kzcStringDelete(testsArgument);
+    kzsErrorForward(result);
+    result = kzcStringDelete(reportArgument);
+    kzsErrorForward(result);
+
+    *out_started = started;
+    kzsSuccess();
+}
+
+static kzsError bfDeviceSchedulerWaitAny_internal(struct BfDeviceSchedulerWorker* workers, kzUint workerCount, kzUint* out_workerIndex, kzInt* out_exitCode)
+{
+    kzUint workerIndex = workerCount;
+    kzInt exitCode = BF_DEVICE_SCHEDULER_EXIT_CODE_FAILED;
+    kzUint i;
+
+#ifdef WIN32
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    kzUint handleWorkers[MAXIMUM_WAIT_OBJECTS];
+    DWORD handleCount = 0;
+    DWORD waitResult;
+
+    for(i = 0; i < workerCount && handleCount < MAXIMUM_WAIT_OBJECTS; ++i)
+    {
+        if(workers[i].busy)
+        {
+            handles[handleCount] = workers[i].process;
+            handleWorkers[handleCount] = i;
+            ++handleCount;
+        }
+    }
+
+    waitResult = WaitForMultipleObjects(handleCount, handles, FALSE, INFINITE);
+    kzsErrorTest(waitResult < WAIT_OBJECT_0 + handleCount, KZS_ERROR_ILLEGAL_OPERATION, "Failed to wait for worker processes");
+    workerIndex = handleWorkers[waitResult - WAIT_OBJECT_0];
+    {
+        DWORD processExitCode;
+        if(GetExitCodeProcess(workers[workerIndex].process, &processExitCode))
+        {
+            exitCode = (kzInt)processExitCode;
+        }
+    }
+    CloseHandle(workers[workerIndex].process);
+#else
+    while(workerIndex == workerCount)
+    {
+        int status;
+        pid_t process = waitpid(-1, &status, 0);
+        kzsErrorTest(process > 0, KZS_ERROR_ILLEGAL_OPERATION, "Failed to wait for worker processes");
+
+        /* Processes not started by the scheduler are ignored. */
+        for(i = 0; i < workerCount; ++i)
+        {
+            if(workers[i].busy && workers[i].process == process)
+            {
+                workerIndex = i;
+                exitCode = WIFEXITED(status) ? (kzInt)WEXITSTATUS(status) : BF_DEVICE_SCHEDULER_EXIT_CODE_FAILED;
+            }
+        }
+    }
+#endif
+
+    *out_workerIndex = workerIndex;
+    *out_exitCode = exitCode;
+    kzsSuccess();
+}
+
+static kzsError bfDeviceSchedulerWriteReport_internal(const struct KzcMemoryManager* memoryManager, enum BfDeviceSchedulerMode mode,
+                                                      const struct BfDeviceSchedulerWorker* workers, const struct BfDeviceSchedulerRun* runs,
+                                                      kzUint wallTime)
+{
+    kzsError result;
+    struct KzcOutputStream* stream;
+    kzMutableString fileName;
+    kzMutableString text;
+    kzUint serialTime = 0;
+    kzUint i;
+    struct KzsTime time = kzsTimeGetTime();
+
+    for(i = 0; i < kzcArrayLength(runs); ++i)
+    {
+        serialTime += runs[i].wallTime;
+    }
+
+    result = kzcStringFormat(memoryManager, "reports/multi_device_report_%d-%02d-%02d_%02d-%02d-%02d.xml", &fileName,
+                             time.year, time.month, time.day, time.hours, time.minutes, time.seconds);
+    kzsErrorForward(result);
+    result = kzcOutputStreamCreateToFile(memoryManager, fileName, KZC_IO_STREAM_ENDIANNESS_UNSPECIFIED, &stream);
+    kzsErrorForward(result);
+
+    /* Wall time is the time of the whole run and serial time the time the runs would have taken one device at a time. */
+    result = kzcStringFormat(memoryManager, "<?xml version=\"1.0\" ?>\n<multiDeviceReport>\n    <benchmarkVersion>%s</benchmarkVersion>\n"
+                             "    <mode>%s</mode>\n    <wallTime>%u</wallTime>\n    <serialTime>%u</serialTime>\n", &text,
+                             bfGetVersionString(), (mode == BF_DEVICE_SCHEDULER_REPLICATE) ? "replicate" : "share", wallTime, serialTime);
+    kzsErrorForward(result);
+    result = bfDeviceSchedulerWrite_internal(stream, text);
+    kzsErrorForward(result);
+    result = kzcStringDelete(text);
+    kzsErrorForward(result);
+
+    for(i = 0; i < kzcArrayLength(runs); ++i)
+    {
+        const struct BfDeviceSchedulerRun* run = &runs[i];
+        const struct BfDeviceSchedulerWorker* worker = &workers[run->workerIndex];
+
+        /* Runs that never started keep the failed exit code, so they are listed as failed rather than left out. */
+        result = kzcStringFormat(memoryManager, "    <run>\n        <platform>%u</platform>\n        <device>%u</device>\n        <started>%s</started>\n"
+                                 "        <exitCode>%d</exitCode>\n        <wallTime>%u</wallTime>\n        <deviceName>", &text, worker->platform, worker->device,
+                                 run->started ? "true" : "false", run->exitCode, run->wallTime);
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerWrite_internal(stream, text);
+        kzsErrorForward(result);
+        result = kzcStringDelete(text);
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerWriteEscaped_internal(stream, worker->deviceName);
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerWrite_internal(stream, "</deviceName>\n        <tests>");
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerWriteEscaped_internal(stream, run->tests);
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerWrite_internal(stream, "</tests>\n");
+        kzsErrorForward(result);
+
+        /* Report of the worker is included as is, without its XML declarations. */
+        if(run->reportPath != KZ_NULL && kzcFileExists(run->reportPath))
+        {
+            kzMutableString* lines;
+            kzUint n;
+
+            result = kzcFileReadTextFileLines(memoryManager, run->reportPath, &lines);
+            kzsErrorForward(result);
+
+            result = bfDeviceSchedulerWrite_internal(stream, "        <report>\n");
+            kzsErrorForward(result);
+            for(n = 0; n < kzcArrayLength(lines); ++n)
+            {
+                if(!(lines[n][0] == '<' && lines[n][1] == '?'))
+                {
+                    result = bfDeviceSchedulerWrite_internal(stream, lines[n]);
+                    kzsErrorForward(result);
+                    result = bfDeviceSchedulerWrite_internal(stream, "\n");
+                    kzsErrorForward(result);
+                }
+                result = kzcStringDelete(lines[n]);
+                kzsErrorForward(result);
+            }
+            result = bfDeviceSchedulerWrite_internal(stream, "        </report>\n");
+            kzsErrorForward(result);
+
+            result = kzcMemoryFreeArray(lines);
+            kzsErrorForward(result);
+        }
+
+        result = bfDeviceSchedulerWrite_internal(stream, "    </run>\n");
+        kzsErrorForward(result);
+    }
+
+    result = bfDeviceSchedulerWrite_internal(stream, "</multiDeviceReport>\n");
+    kzsErrorForward(result);
+    result = kzcOutputStreamDelete(stream);
+    kzsErrorForward(result);
+
+    result = kzcLog(memoryManager, KZS_LOG_LEVEL_INFO, "Multi-device report created to '%s'. Wall time %u ms, serial time %u ms.", fileName, wallTime, serialTime);
+    kzsErrorForward(result);
+
+    result = kzcStringDelete(fileName);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError bfDeviceSchedulerWriteEscaped_internal(struct KzcOutputStream* stream, kzString string)
+{
+    kzsError result;
+    kzUint start = 0;
+    kzUint i;
+    kzUint length = kzcStringLength(string);
+
+    for(i = 0; i < length; ++i)
+    {
+        kzString entity = KZ_NULL;
+        switch(string[i])
+        {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            default: break;
+        }
+        if(entity != KZ_NULL)
+        {
+            result = kzcOutputStreamWriteBytes(stream, i - start, (const kzByte*)&string[start]);
+            kzsErrorForward(result);
+            result = bfDeviceSchedulerWrite_internal(stream, entity);
+            kzsErrorForward(result);
+            start = i + 1;
+        }
+    }
+    result = kzcOutputStreamWriteBytes(stream, length - start, (const kzByte*)&string[start]);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError bfDeviceSchedulerWrite_internal(struct KzcOutputStream* stream, kzString string)
+{
+    kzsError result;
+
+    result = kzcOutputStreamWriteBytes(stream, kzcStringLength(string), (const kzByte*)string);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
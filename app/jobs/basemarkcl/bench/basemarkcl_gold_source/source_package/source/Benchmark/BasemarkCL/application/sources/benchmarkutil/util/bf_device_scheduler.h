@@ -0,0 +1,44 @@
+/**
+* \file
+* Multi-device scheduler. Runs the benchmark concurrently on every OpenCL device of the system.
+*
+* Scenes share the Kanzi engine, window and project of their process, so each device is run by a worker process of
+* its own, which has its own benchmark framework, OpenCL context and report logger. Worker processes are started with
+* command line parameters selecting the device, tests and report file, and their reports are merged into one document.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef BF_DEVICE_SCHEDULER_H
+#define BF_DEVICE_SCHEDULER_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+struct CluInfo;
+
+
+/** Scheduling of tests to devices. */
+enum BfDeviceSchedulerMode
+{
+    BF_DEVICE_SCHEDULER_DISABLED, /**< Benchmark runs on single device in this process. */
+    BF_DEVICE_SCHEDULER_REPLICATE, /**< Every device runs all tests, for comparing devices. */
+    BF_DEVICE_SCHEDULER_SHARE /**< Devices take tests one by one from a shared queue until all tests are run. */
+};
+
+
+/**
+* Runs given tests on all devices of cluInfo and waits for them to complete. Executable path is the benchmark executable
+* started for each worker. Test names is comma separated list of tests. Merged report is written to reports directory.
+*/
+kzsError bfDeviceSchedulerRun(const struct KzcMemoryManager* memoryManager, const struct CluInfo* cluInfo, enum BfDeviceSchedulerMode mode,
+                              kzString executablePath, kzString testNames);
+
+/** Parses scheduler mode from command line value "off", "replicate" or "share". Returns KZ_FALSE if value is not recognized. */
+kzBool bfDeviceSchedulerParseMode(kzString value, enum BfDeviceSchedulerMode* out_mode);
+
+
+#endif
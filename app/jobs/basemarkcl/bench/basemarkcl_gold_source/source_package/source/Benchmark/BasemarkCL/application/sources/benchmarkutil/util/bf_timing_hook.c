@@ -0,0 +1,179 @@
+/**
+* \file
+* Timing hooks. Loads a timing hook plugin and calls it at scene and frame boundaries.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "bf_timing_hook.h"
+#include "bf_timing_hook_plugin.h"
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/kzs_error_codes.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+
+struct BfTimingHook
+{
+#ifdef WIN32
+    HMODULE library; /**< Handle of the plugin library. */
+#else
+    void* library; /**< Handle of the plugin library. */
+#endif
+    const struct BfTimingHookInterface* plugin; /**< Callbacks of the plugin. */
+    void* context; /**< Plugin context returned by create callback. */
+};
+
+
+/** Loads the plugin library. Library is KZ_NULL if loading fails. */
+static kzsError bfTimingHookLoadLibrary_internal(const struct KzcMemoryManager* memoryManager, struct BfTimingHook* timingHook, kzString libraryPath);
+/** Resolves and validates the plugin interface of a loaded library. */
+static kzsError bfTimingHookResolveInterface_internal(struct BfTimingHook* timingHook);
+/** Unloads the plugin library. */
+static void bfTimingHookUnloadLibrary_internal(const struct BfTimingHook* timingHook);
+
+
+static kzsError bfTimingHookLoadLibrary_internal(const struct KzcMemoryManager* memoryManager, struct BfTimingHook* timingHook, kzString libraryPath)
+{
+    kzsError result;
+
+#ifdef WIN32
+    timingHook->library = LoadLibraryA(libraryPath);
+    if(timingHook->library == KZ_NULL)
+    {
+        result = kzcLog(memoryManager, KZS_LOG_LEVEL_ERROR, "Failed to load timing hook library '%s'.", libraryPath);
+        kzsErrorForward(result);
+        kzsErrorThrow(KZS_ERROR_FILE_OPEN_FAILED, "Failed to load timing hook library");
+    }
+#else
+    timingHook->library = dlopen(libraryPath, RTLD_NOW | RTLD_LOCAL);
+    if(timingHook->library == KZ_NULL)
+    {
+        result = kzcLog(memoryManager, KZS_LOG_LEVEL_ERROR, "Failed to load timing hook library '%s': %s", libraryPath, dlerror());
+        kzsErrorForward(result);
+        kzsErrorThrow(KZS_ERROR_FILE_OPEN_FAILED, "Failed to load timing hook library");
+    }
+#endif
+
+    kzsSuccess();
+}
+
+static kzsError bfTimingHookResolveInterface_internal(struct BfTimingHook* timingHook)
+{
+    BfTimingHookGetInterfaceFunction getInterface;
+
+#ifdef WIN32
+    getInterface = (BfTimingHookGetInterfaceFunction)GetProcAddress(timingHook->library, BF_TIMING_HOOK_ENTRY_POINT);
+#else
+    /* Conversion from object pointer to function pointer is the documented way of using dlsym. */
+    *(void**)&getInterface = dlsym(timingHook->library, BF_TIMING_HOOK_ENTRY_POINT);
+#endif
+
+    kzsErrorTest(getInterface != KZ_NULL, KZS_ERROR_ILLEGAL_ARGUMENT, "Timing hook library does not export " BF_TIMING_HOOK_ENTRY_POINT);
+    timingHook->plugin = getInterface();
+    kzsErrorTest(timingHook->plugin != KZ_NULL && timingHook->plugin->apiVersion == BF_TIMING_HOOK_API_VERSION, KZS_ERROR_ILLEGAL_ARGUMENT,
+                 "Timing hook library has incompatible interface version");
+
+    kzsSuccess();
+}
+
+static void bfTimingHookUnloadLibrary_internal(const struct BfTimingHook* timingHook)
+{
+#ifdef WIN32
+    FreeLibrary(timingHook->library);
+#else
+    dlclose(timingHook->library);
+#endif
+}
+
+kzsError bfTimingHookCreate(const struct KzcMemoryManager* memoryManager, kzString libraryPath, kzString arguments, struct BfTimingHook** out_timingHook)
+{
+    kzsError result;
+    kzsError loadResult;
+    struct BfTimingHook* timingHook;
+
+    result = kzcMemoryAllocVariable(memoryManager, timingHook, "Timing hook");
+    kzsErrorForward(result);
+
+    /* A missing or incompatible plugin is reported to the caller, so nothing loaded so far may be left behind. */
+    loadResult = bfTimingHookLoadLibrary_internal(memoryManager, timingHook, libraryPath);
+    kzsErrorIf(loadResult)
+    {
+        result = kzcMemoryFreeVariable(timingHook);
+        kzsErrorForward(result);
+        kzsErrorForward(loadResult);
+    }
+
+    loadResult = bfTimingHookResolveInterface_internal(timingHook);
+    kzsErrorIf(loadResult)
+    {
+        bfTimingHookUnloadLibrary_internal(timingHook);
+        result = kzcMemoryFreeVariable(timingHook);
+        kzsErrorForward(result);
+        kzsErrorForward(loadResult);
+    }
+
+    timingHook->context = (timingHook->plugin->create != KZ_NULL) ? timingHook->plugin->create(arguments) : KZ_NULL;
+
+    kzsLog(KZS_LOG_LEVEL_INFO, "Timing hook library loaded.");
+
+    *out_timingHook = timingHook;
+    kzsSuccess();
+}
+
+kzsError bfTimingHookDelete(struct BfTimingHook* timingHook)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(timingHook));
+
+    if(timingHook->plugin->destroy != KZ_NULL)
+    {
+        timingHook->plugin->destroy(timingHook->context);
+    }
+
+    bfTimingHookUnloadLibrary_internal(timingHook);
+
+    result = kzcMemoryFreeVariable(timingHook);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+void bfTimingHookSceneBegin(const struct BfTimingHook* timingHook, kzString sceneName)
+{
+    if(timingHook != KZ_NULL && timingHook->plugin->sceneBegin != KZ_NULL)
+    {
+        timingHook->plugin->sceneBegin(timingHook->context, sceneName);
+    }
+}
+
+void bfTimingHookFrameBegin(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameIndex)
+{
+    if(timingHook != KZ_NULL && timingHook->plugin->frameBegin != KZ_NULL)
+    {
+        timingHook->plugin->frameBegin(timingHook->context, sceneName, frameIndex);
+    }
+}
+
+void bfTimingHookFrameEnd(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameIndex)
+{
+    if(timingHook != KZ_NULL && timingHook->plugin->frameEnd != KZ_NULL)
+    {
+        timingHook->plugin->frameEnd(timingHook->context, sceneName, frameIndex);
+    }
+}
+
+void bfTimingHookSceneEnd(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameCount)
+{
+    if(timingHook != KZ_NULL && timingHook->plugin->sceneEnd != KZ_NULL)
+    {
+        timingHook->plugin->sceneEnd(timingHook->context, sceneName, frameCount);
+    }
+}
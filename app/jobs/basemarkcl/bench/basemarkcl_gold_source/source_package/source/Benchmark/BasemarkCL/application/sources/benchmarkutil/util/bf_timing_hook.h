@@ -0,0 +1,44 @@
+/**
+* \file
+* Timing hooks. Loads a timing hook plugin and calls it at scene and frame boundaries.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef BF_TIMING_HOOK_H
+#define BF_TIMING_HOOK_H
+
+
+#include <system/debug/kzs_error.h>
+#include <system/kzs_types.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/**
+ * \struct BfTimingHook
+ * Loaded timing hook plugin.
+ */
+struct BfTimingHook;
+
+
+/**
+* Loads timing hook plugin from given shared library and creates the plugin context with given arguments.
+* Errors are thrown if the library cannot be loaded or it does not export a compatible interface.
+*/
+kzsError bfTimingHookCreate(const struct KzcMemoryManager* memoryManager, kzString libraryPath, kzString arguments, struct BfTimingHook** out_timingHook);
+/** Destroys the plugin context and unloads the library. */
+kzsError bfTimingHookDelete(struct BfTimingHook* timingHook);
+
+/** Calls the scene begin hook. Timing hook can be KZ_NULL. */
+void bfTimingHookSceneBegin(const struct BfTimingHook* timingHook, kzString sceneName);
+/** Calls the frame begin hook. Timing hook can be KZ_NULL. */
+void bfTimingHookFrameBegin(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameIndex);
+/** Calls the frame end hook. Timing hook can be KZ_NULL. */
+void bfTimingHookFrameEnd(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameIndex);
+/** Calls the scene end hook. Timing hook can be KZ_NULL. */
+void bfTimingHookSceneEnd(const struct BfTimingHook* timingHook, kzString sceneName, kzUint frameCount);
+
+
+#endif
@@ -0,0 +1,49 @@
+/**
+* \file
+* Interface of timing hook plugins. Plugins are shared libraries loaded by the benchmark for attaching power meters,
+* tracers and similar tools to the measured frames. This header has no dependencies, so that plugins can be built
+* without the benchmark sources.
+*
+* Plugin exports function named BF_TIMING_HOOK_ENTRY_POINT of type BfTimingHookGetInterfaceFunction. Callbacks are
+* called from the benchmark main thread. Frame begin is called right before frame timing starts and frame end right
+* after it stops, so the time spent in callbacks is not included in the results. Callbacks may be left null.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef BF_TIMING_HOOK_PLUGIN_H
+#define BF_TIMING_HOOK_PLUGIN_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/** Version of the plugin interface. Plugins built for other version are rejected. */
+#define BF_TIMING_HOOK_API_VERSION 1
+/** Name of the function exported by plugins. */
+#define BF_TIMING_HOOK_ENTRY_POINT "bfTimingHookGetInterface"
+
+
+/** Plugin interface. Context is the value returned by create. */
+struct BfTimingHookInterface
+{
+    unsigned int apiVersion; /**< BF_TIMING_HOOK_API_VERSION the plugin was built with. */
+    void* (*create)(const char* arguments); /**< Called once after loading with TimingHookArguments of application.cfg. */
+    void (*destroy)(void* context); /**< Called once before unloading. */
+    void (*sceneBegin)(void* context, const char* sceneName); /**< Called when a benchmarked scene has been loaded. */
+    void (*frameBegin)(void* context, const char* sceneName, unsigned int frameIndex); /**< Called before the frame is timed. */
+    void (*frameEnd)(void* context, const char* sceneName, unsigned int frameIndex); /**< Called after the frame is timed. */
+    void (*sceneEnd)(void* context, const char* sceneName, unsigned int frameCount); /**< Called when the scene ends. */
+};
+
+/** Type of the exported entry point. */
+typedef const struct BfTimingHookInterface* (*BfTimingHookGetInterfaceFunction)(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
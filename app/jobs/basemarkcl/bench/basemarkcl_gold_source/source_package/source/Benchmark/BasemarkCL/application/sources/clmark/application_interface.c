@@ -34,6 +34,7 @@
 #include <benchmarkutil/report/bf_report_document.h>
 #include <benchmarkutil/report/xml/bf_xml_document.h>
 #include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/util/bf_device_scheduler.h>
 
 #include "menu/cl_menu.h"
 #include "menu/cl_loadscreen.h"
@@ -44,9 +45,20 @@
 #include "tests/physics/cl_soft_body.h"
 #include "tests/physics/cl_sph.h"
 #include "tests/physics/cl_wave.h"
+#include "tests/physics/cl_physics_scaling.h"
 #include "tests/feature/cl_mandelbulb.h"
 #include "tests/feature/cl_julia.h"
 #include "tests/feature/cl_compiler.h"
+#include "tests/feature/cl_compiler_scaling.h"
+#include "tests/feature/cl_memory_bandwidth.h"
+#include "tests/feature/cl_launch_overhead.h"
+#include "tests/feature/cl_hash_map.h"
+
+
+/** Index of the test that queues all other tests. */
+#define TEST_INDEX_ALL_TESTS 40
+/** Number of physics tests. Physics tests have the first indices and each of them has a problem-size sweep. */
+#define TEST_INDEX_PHYSICS_COUNT 4
 
 
 /* Input handling callbacks */
@@ -59,8 +71,17 @@ KZ_CALLBACK kzsError clMenuExit(const struct KzuUiComponentNode* node, void* use
 KZ_CALLBACK kzsError clMenuStartTestHandler(const struct KzuUiComponentNode* node, void* userData, struct KzuUiEvent* event, kzString eventType, struct KzcHashMap* parameters);
 /** Launches test with given index. */
 static kzsError launchTest_internal(struct KzaApplication* application, kzUint index);
-/** Launches given test and places loading bar before the test. */
-static kzsError launchTestWithLoadingBar_internal(const struct BenchmarkFramework* framework, struct BfScene* scene);
+/**
+* Pushes the scene to the queue after a loading screen. Tuned copy is the second run of a scene in work-group tuning
+* comparison mode, which is dropped if the scene is not tunable.
+*/
+static kzsError launchTestWithLoadingBar_internal(const struct BenchmarkFramework* framework, struct BfScene* scene, kzBool tunedCopy);
+/** Creates the test of given index and adds it to the queue. */
+static kzsError addTestToQueue_internal(struct BenchmarkFramework* framework, kzUint index, kzBool tunedCopy, kzBool* out_testExists);
+/** Adds the problem size sweep of the physics test of given index to the queue. */
+static kzsError addPhysicsScalingTestsToQueue_internal(struct BenchmarkFramework* framework, kzUint index);
+/** Returns comma separated list of tests to autorun, from command line or settings. */
+static kzsError getAutorunTestNames_internal(const struct BenchmarkFramework* framework, kzMutableString* out_testNames);
 
 
 static void kzApplicationChangeState(struct ApplicationData* applicationData, enum ApplicationState nextState)
@@ -114,6 +135,10 @@ kzsError kzApplicationInitialize(struct KzaApplication* application)
     struct ApplicationData* applicationData;
     struct KzaSystemProperties* systemProperties;
     kzMutableString commandLineParameters;
+    kzInt commandLinePlatformId = -1;
+    kzInt commandLineDeviceId = -1;
+    kzBool schedulerModeOverridden = KZ_FALSE;
+    enum BfDeviceSchedulerMode schedulerMode = BF_DEVICE_SCHEDULER_DISABLED;
 
     systemProperties = kzaApplicationGetSystemProperties(application);
     memoryManager = kzaApplicationGetApplicationMemoryManager(application);
@@ -199,6 +224,25 @@ kzsError kzApplicationInitialize(struct KzaApplication* application)
                         bfSetRepeat(applicationData->framework, KZ_TRUE);
                     }
                 }
+                else if(kzsStrcmp(splitStrings[0], "--platform") == 0)
+                {
+                    commandLinePlatformId = kzcStringToInt(splitStrings[1]);
+                }
+                else if(kzsStrcmp(splitStrings[0], "--device") == 0)
+                {
+                    commandLineDeviceId = kzcStringToInt(splitStrings[1]);
+                }
+                else if(kzsStrcmp(splitStrings[0], "--report") == 0)
+                {
+                    /* File names are case sensitive on most platforms, so the value is taken from the original argument. */
+                    kzString reportPath = argument + kzcStringLength(splitStrings[0]) + 1;
+                    result = bfReportDocumentSetFileName(bfGetReportDocument(applicationData->framework), reportPath);
+                    kzsErrorForward(result);
+                }
+                else if(kzsStrcmp(splitStrings[0], "--all-devices") == 0 && bfDeviceSchedulerParseMode(splitStrings[1], &schedulerMode))
+                {
+                    schedulerModeOverridden = KZ_TRUE;
+                }
                 else
                 {
                     result = kzcLog(bfGetMemoryManager(applicationData->framework), KZS_LOG_LEVEL_WARNING, "Unrecognized command line parameter: \"%s\".", argument);
@@ -239,6 +283,12 @@ kzsError kzApplicationInitialize(struct KzaApplication* application)
             kzsLog(KZS_LOG_LEVEL_INFO, "   comma separated list of tests to run");
             kzsLog(KZS_LOG_LEVEL_INFO, " --repeat=1");
             kzsLog(KZS_LOG_LEVEL_INFO, "   repeat given tests");
+            kzsLog(KZS_LOG_LEVEL_INFO, " --platform=0 --device=1");
+            kzsLog(KZS_LOG_LEVEL_INFO, "   OpenCL platform and device to use, overrides ForceOpenCLPlatform and ForceOpenCLDevice");
+            kzsLog(KZS_LOG_LEVEL_INFO, " --report=\"reports/report.xml\"");
+            kzsLog(KZS_LOG_LEVEL_INFO, "   file to save the report to");
+            kzsLog(KZS_LOG_LEVEL_INFO, " --all-devices=replicate");
+            kzsLog(KZS_LOG_LEVEL_INFO, "   run tests concurrently on all OpenCL devices: off, replicate or share");
             kzsLog(KZS_LOG_LEVEL_INFO, " ");
         }
     }
@@ -279,15 +329,47 @@ kzsError kzApplicationInitialize(struct KzaApplication* application)
     result = clMenuInitialize(applicationData->framework, applicationData->menu);
     kzsErrorForward(result);
 
+    /* Check if multi-device run is requested. Worker processes run the tests and this process quits when they are done. */
+    if(!schedulerModeOverridden)
+    {
+        kzInt schedulerValue;
+        result = settingGetInt(bfGetSettings(applicationData->framework), "MultiDeviceScheduler", &schedulerValue);
+        kzsErrorForward(result);
+        schedulerMode = (schedulerValue == 1) ? BF_DEVICE_SCHEDULER_REPLICATE :
+                        (schedulerValue == 2) ? BF_DEVICE_SCHEDULER_SHARE : BF_DEVICE_SCHEDULER_DISABLED;
+    }
 
-    /* Check if menu skip is requested. */
+    if(schedulerMode != BF_DEVICE_SCHEDULER_DISABLED)
     {
+        kzMutableString testNames;
+        result = getAutorunTestNames_internal(applicationData->framework, &testNames);
+        kzsErrorForward(result);
+        result = bfDeviceSchedulerRun(memoryManager, bfGetCluInfo(applicationData->framework), schedulerMode,
+                                      systemProperties->programArguments[0], testNames);
+        kzsErrorForward(result);
+        result = kzcStringDelete(testNames);
+        kzsErrorForward(result);
+
+        kzApplicationChangeState(applicationData, APPLICATION_STATE_QUIT);
+    }
+    else
+    {
+        /* Check if menu skip is requested. */
         kzInt platformId, deviceId;
         struct KzcSettingContainer* settings = bfGetSettings(applicationData->framework);
         result = settingGetInt(settings, "ForceOpenCLPlatform", &platformId);
         kzsErrorForward(result);
         result = settingGetInt(settings, "ForceOpenCLDevice", &deviceId);
         kzsErrorForward(result);
+
+        if(commandLinePlatformId >= 0)
+        {
+            platformId = commandLinePlatformId;
+        }
+        if(commandLineDeviceId >= 0)
+        {
+            deviceId = commandLineDeviceId;
+        }
         
         {
             kzBool success;
@@ -600,28 +682,168 @@ KZ_CALLBACK kzsError clMenuExit(const struct KzuUiComponentNode* node, void* use
     kzsSuccess();
 }
 
-static kzsError launchTestWithLoadingBar_internal(const struct BenchmarkFramework* framework, struct BfScene* scene)
+static kzsError launchTestWithLoadingBar_internal(const struct BenchmarkFramework* framework, struct BfScene* scene, kzBool tunedCopy)
 {
     kzsError result;
 
-    /* Add load screen. */
+    if(tunedCopy && !bfSceneIsWorkGroupTunable(scene))
     {
-        struct BfScene* loadingScene;
-        result = clLoadScreenCreate(framework, &loadingScene);
+        result = bfSceneDelete(scene);
         kzsErrorForward(result);
-        result = bfAddScene(framework, loadingScene);
+    }
+    else
+    {
+        result = bfSceneSetWorkGroupTuned(framework, scene, tunedCopy || bfGetWorkGroupTuningMode(framework) == BF_WORK_GROUP_TUNING_ENABLED);
+        kzsErrorForward(result);
+
+        /* Add load screen. */
+        {
+            struct BfScene* loadingScene;
+            result = clLoadScreenCreate(framework, &loadingScene);
+            kzsErrorForward(result);
+            result = bfAddScene(framework, loadingScene);
+            kzsErrorForward(result);
+        }
+        /* Add test. */
+        {
+            result = bfAddScene(framework, scene);
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static kzsError getAutorunTestNames_internal(const struct BenchmarkFramework* framework, kzMutableString* out_testNames)
+{
+    kzsError result;
+    kzMutableString testNames;
+
+    if(bfGetOverrideTestsList(framework) != KZ_NULL)
+    {
+        result = kzcStringCopy(bfGetMemoryManager(framework), bfGetOverrideTestsList(framework), &testNames);
         kzsErrorForward(result);
     }
-    /* Add test. */
+    else
     {
-        result = bfAddScene(framework, scene);
+        struct KzcSettingNode* testsNode;
+
+        result = kzcStringCreateEmpty(bfGetMemoryManager(framework), &testNames);
+        kzsErrorForward(result);
+
+        result = kzcSettingContainerGetNode(bfGetSettings(framework), "Autorun/IncludedTests", &testsNode);
         kzsErrorForward(result);
+
+        if(testsNode != KZ_NULL)
+        {
+            struct KzcHashMap* settingDictionary = kzcSettingNodeGetDictionary(testsNode);
+            if(settingDictionary != KZ_NULL)
+            {
+                struct KzcHashMapIterator it = kzcHashMapGetIterator(settingDictionary);
+
+                while(kzcHashMapIterate(it))
+                {
+                    kzString name = kzcHashMapIteratorGetKey(it);
+                    kzInt intValue;
+
+                    if(kzcSettingNodeGetInteger(testsNode, name, &intValue) && intValue != 0)
+                    {
+                        kzMutableString previousNames = testNames;
+                        result = kzcStringConcatenateMultiple(bfGetMemoryManager(framework), 3, &testNames, previousNames,
+                                                              (kzcStringLength(previousNames) > 0) ? "," : "", name);
+                        kzsErrorForward(result);
+                        result = kzcStringDelete(previousNames);
+                        kzsErrorForward(result);
+                    }
+                }
+            }
+        }
     }
 
+    *out_testNames = testNames;
     kzsSuccess();
 }
 
 kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBool* out_testExists)
+{
+    kzsError result;
+
+    result = addTestToQueue_internal(framework, index, KZ_FALSE, out_testExists);
+    kzsErrorForward(result);
+
+    /* Run all tests adds the tuned copies of each test by itself. */
+    if(bfGetWorkGroupTuningMode(framework) == BF_WORK_GROUP_TUNING_COMPARE && index != TEST_INDEX_ALL_TESTS)
+    {
+        result = addTestToQueue_internal(framework, index, KZ_TRUE, KZ_NULL);
+        kzsErrorForward(result);
+    }
+
+    if(index < TEST_INDEX_PHYSICS_COUNT)
+    {
+        kzInt physicsScaling;
+        result = settingGetInt(bfGetSettings(framework), "PhysicsScaling", &physicsScaling);
+        kzsErrorForward(result);
+        if(physicsScaling != 0)
+        {
+            result = addPhysicsScalingTestsToQueue_internal(framework, index);
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static kzsError addPhysicsScalingTestsToQueue_internal(struct BenchmarkFramework* framework, kzUint index)
+{
+    kzsError result;
+    kzString sizeSettings[TEST_INDEX_PHYSICS_COUNT] = {"SoftBodyScalingSizes", "FluidScalingSizes", "SphScalingSizes", "WaveScalingSizes"};
+    kzUint sizes[PHYSICS_SCALING_MAXIMUM_SIZES];
+    kzUint sizeCount;
+    kzUint i;
+
+    kzsAssert(index < TEST_INDEX_PHYSICS_COUNT);
+
+    result = physicsScalingGetSizes(framework, sizeSettings[index], sizes, &sizeCount);
+    kzsErrorForward(result);
+
+    for(i = 0; i < sizeCount; ++i)
+    {
+        struct BfScene* scene = KZ_NULL;
+        switch(index)
+        {
+            case 0:
+            {
+                result = softBodyCreateWithParticlesPerSide(framework, sizes[i], &scene);
+                kzsErrorForward(result);
+                break;
+            }
+            case 1:
+            {
+                result = fluidCreateWithGridSize(framework, sizes[i], &scene);
+                kzsErrorForward(result);
+                break;
+            }
+            case 2:
+            {
+                result = sphCreateWithParticleCount(framework, sizes[i], &scene);
+                kzsErrorForward(result);
+                break;
+            }
+            default:
+            {
+                result = waveCreateWithSideLength(framework, sizes[i], &scene);
+                kzsErrorForward(result);
+                break;
+            }
+        }
+        result = launchTestWithLoadingBar_internal(framework, scene, KZ_FALSE);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+static kzsError addTestToQueue_internal(struct BenchmarkFramework* framework, kzUint index, kzBool tunedCopy, kzBool* out_testExists)
 {
     kzsError result;
     kzBool exists = KZ_TRUE;
@@ -634,7 +856,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = softBodyCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -643,7 +865,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = fluidCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -652,7 +874,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = sphCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -663,7 +885,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = waveCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);    
             break;
         }
@@ -673,7 +895,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = blurCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -682,7 +904,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = histogramCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -691,7 +913,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = medianCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -700,7 +922,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = bilateralCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -709,7 +931,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = sharpeningCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -720,7 +942,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = blurVideoCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -730,7 +952,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = histogramVideoCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -739,7 +961,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = medianVideoCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -748,7 +970,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = bilateralVideoCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -757,7 +979,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = sharpeningVideoCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -768,7 +990,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = mandelbulbCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -777,7 +999,7 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = juliaCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
@@ -786,13 +1008,58 @@ kzsError addTestToQueue(struct BenchmarkFramework* framework, kzUint index, kzBo
             struct BfScene* scene;
             result = compilerTestCreate(framework, &scene);
             kzsErrorForward(result);
-            result = launchTestWithLoadingBar_internal(framework, scene);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
+            kzsErrorForward(result);
+            break;
+        }
+        case 33:
+        {
+            struct BfScene* scene;
+            result = parallelCompilerTestCreate(framework, &scene);
+            kzsErrorForward(result);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
+            kzsErrorForward(result);
+            break;
+        }
+        case 34:
+        {
+            struct BfScene* scene;
+            result = compilerScalingTestCreate(framework, &scene);
+            kzsErrorForward(result);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
+            kzsErrorForward(result);
+            break;
+        }
+        case 35:
+        {
+            struct BfScene* scene;
+            result = memoryBandwidthTestCreate(framework, &scene);
+            kzsErrorForward(result);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
+            kzsErrorForward(result);
+            break;
+        }
+        case 36:
+        {
+            struct BfScene* scene;
+            result = launchOverheadTestCreate(framework, &scene);
+            kzsErrorForward(result);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
+            kzsErrorForward(result);
+            break;
+        }
+        case 37:
+        {
+            struct BfScene* scene;
+            result = hashMapTestCreate(framework, &scene);
+            kzsErrorForward(result);
+            result = launchTestWithLoadingBar_internal(framework, scene, tunedCopy);
             kzsErrorForward(result);
             break;
         }
 
         /* Run all tests. */
-        case 40:
+        case TEST_INDEX_ALL_TESTS:
         {
             kzUint i;
             for(i = 0; i < 32; i++)
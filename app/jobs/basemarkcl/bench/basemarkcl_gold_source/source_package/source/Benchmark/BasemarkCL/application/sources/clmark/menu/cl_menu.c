@@ -96,11 +96,11 @@ kzString testObjectNames[OBJECT_NAME_COUNT] =
     "TestMandelbulb",
     "TestJuliaFractal",
     "TestOnlineCompiler",
-    "",
-    "",
-    "",
-    "",
-    "",
+    "TestParallelCompiler",
+    "TestCompilerScaling",
+    "TestMemoryBandwidth",
+    "TestLaunchOverhead",
+    "TestHashMap",
     "",
     "",
 
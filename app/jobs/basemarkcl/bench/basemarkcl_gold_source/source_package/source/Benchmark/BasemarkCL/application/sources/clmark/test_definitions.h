@@ -7,6 +7,7 @@
 #define TEST_DEFINITIONS_H
 
 
+/* Frame counts are upper limits for tests when AdaptiveRunLength is enabled in application.cfg. */
 #if 1
 /** SPH test framecount. */
 #define SPH_FRAME_COUNT 800
@@ -55,6 +56,7 @@
 #define SOFTBODY_HASH                "9d2a4e449c76d1e2dcc43892b88ac2be"
 #define SPH_HASH                     "c0bf52a56e01f0154e8f545b04cba9c9"
 #define WAVE_SIMULATION_HASH         "39190616006a04eb8e514bbcac977f48"
+#define YUV_CONVERSION_HASH          "856c185643e4041800ca226f52700646"
 
 
 /** Images. */
@@ -4,10 +4,17 @@
  * Copyright 2011 by Rightware. All rights reserved.
  */
 
+#include "cl_compiler.h"
+
 #include <benchmarkutil/bf_benchmark_framework.h>
 #include <benchmarkutil/scene/bf_scene.h>
 #include <benchmarkutil/util/bf_util.h>
+#include <benchmarkutil/settings/bf_settings.h>
 #include <benchmarkutil/report/bf_report.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
 
 #include <clutil/clu_platform.h>
 #include <clutil/clu_program.h>
@@ -25,10 +32,34 @@
 
 #include <core/debug/kzc_log.h>
 #include <core/util/math/kzc_random.h>
+#include <core/util/io/kzc_file.h>
+#include <core/util/string/kzc_string.h>
 #include <core/memory/kzc_memory_manager.h>
 
+#include <system/thread/kzs_thread.h>
+#include <system/wrappers/kzs_math.h>
+
 #include <clutil/clu_opencl_base.h>
 #define PROGRAM_COUNT 13
+
+/** Programs built by the compiler tests. */
+static kzString compilerProgramNames[PROGRAM_COUNT] = 
+{
+    "data/fluid.cl",
+    "data/sph.cl",
+    "data/median.cl",
+    "data/wave_simulation.cl",
+    "data/basic_image_operations.cl",
+    "data/fft.cl",
+    "data/histogram.cl",
+    "data/julia.cl",
+    "data/mandelbulb.cl",   
+    "data/convolution2d.cl",
+    "data/separable_convolution2d.cl",
+    "data/softbody.cl",
+    "data/bilateral.cl"
+};
+
 /** Vector test state. */
 
 
@@ -69,6 +100,7 @@ kzsError compilerSceneLoad(struct BenchmarkFramework* framework, struct BfScene*
     cluClErrorTest(clResult);
     bfSceneSetFrameCounter(scene, PROGRAM_COUNT);
     bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
     
     result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
     kzsErrorForward(result);
@@ -93,22 +125,6 @@ kzsError compilerSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaT
     struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(framework);
     struct CompilerTestState *testData = NULL;
     cl_program testProgram;
-    kzString programNames[PROGRAM_COUNT] = 
-    {
-        "data/fluid.cl",
-        "data/sph.cl",
-        "data/median.cl",
-        "data/wave_simulation.cl",
-        "data/basic_image_operations.cl",
-        "data/fft.cl",
-        "data/histogram.cl",
-        "data/julia.cl",
-        "data/mandelbulb.cl",   
-        "data/convolution2d.cl",
-        "data/separable_convolution2d.cl",
-        "data/softbody.cl",
-        "data/bilateral.cl"
-    };
 
     context = bfGetClContext(framework);
 
@@ -116,7 +132,7 @@ kzsError compilerSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaT
     kzsAssert(kzcIsValidPointer(testData));
 
     
-    result = cluGetBuiltProgramFromFile(memoryManager, programNames[bfSceneGetFrameCounterValue(scene) - 1], KZ_TRUE, context, &testProgram, KZ_NULL);
+    result = cluGetBuiltProgramFromFile(memoryManager, compilerProgramNames[bfSceneGetFrameCounterValue(scene) - 1], KZ_TRUE, context, &testProgram, KZ_NULL);
     kzsErrorForward(result);
 
     clResult = clReleaseProgram(testProgram);
@@ -169,3 +185,499 @@ kzsError compilerTestCreate(struct BenchmarkFramework* framework, struct BfScene
     *out_scene = scene;
     kzsSuccess();
 }
+
+
+/** Build of a single program in the parallel compiler test. */
+struct ParallelCompilerBuild
+{
+    struct ParallelCompilerTestState* testData; /**< Test owning the build. */
+    kzUint programIndex; /**< Index of the built program. */
+    cl_program program; /**< Program being built. */
+    kzUint startTime; /**< Time when the build was started in microseconds. */
+};
+
+/** Parallel compiler test state. */
+struct ParallelCompilerTestState
+{
+    cl_context context; /**< OpenCL context. */
+    cl_device_id device; /**< Device the programs are built for. */
+
+    kzMutableString programSources[PROGRAM_COUNT]; /**< Sources of the built programs. Read before timing. */
+    struct ParallelCompilerBuild builds[PROGRAM_COUNT]; /**< Builds of the current frame. */
+
+    kzUint stepCount; /**< Number of frames. Each thread count is one frame, last frame uses build callbacks. */
+    kzUint* threadCounts; /**< Worker thread count for each frame. Zero for the build callback frame. */
+    kzUint* wallTimes; /**< Wall time of building all programs for each frame in microseconds. */
+    kzUint* programLatencies; /**< Build latency of each program for each frame in microseconds. */
+
+    struct BfTimer* timer; /**< Timer shared by the worker threads. */
+    struct KzsThreadLock* lock; /**< Lock protecting the build counters. Set when all callback builds are complete. */
+    kzUint nextProgram; /**< Index of the next program to be built by the workers. */
+    kzUint completedPrograms; /**< Number of completed callback builds. */
+    kzUint failedBuilds; /**< Number of builds that failed. */
+    kzUint currentStep; /**< Frame being run. */
+
+    struct KzuMaterial* loadingMaterial; /**< Material used to render progress bar. */
+    struct KzuPropertyType* loadingPropertyType; /**< Property driving progress bar position. */
+};
+
+
+/** Builds one program and records its latency. Called from the worker threads. */
+static kzsError parallelCompilerBuildProgram_internal(struct ParallelCompilerTestState* testData, kzUint programIndex);
+/** Worker thread building programs until all programs of the frame are taken. */
+static kzsError parallelCompilerWorker_internal(void* userData);
+/** Completion callback of asynchronous program builds. */
+static void CL_CALLBACK parallelCompilerBuildNotify_internal(cl_program program, void* userData);
+/** Builds all programs using given number of worker threads. */
+static kzsError parallelCompilerBuildWithThreads_internal(struct ParallelCompilerTestState* testData, kzUint threadCount);
+/** Builds all programs using build completion callbacks. */
+static kzsError parallelCompilerBuildWithCallbacks_internal(struct ParallelCompilerTestState* testData);
+/** Marks one callback build completed. Sets the lock when all builds are completed. */
+static kzsError parallelCompilerCompleteBuild_internal(struct ParallelCompilerTestState* testData, kzBool buildSucceeded);
+
+
+static kzsError parallelCompilerBuildProgram_internal(struct ParallelCompilerTestState* testData, kzUint programIndex)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_program program;
+    kzString source = testData->programSources[programIndex];
+    kzUint startTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer);
+    kzBool buildSucceeded = KZ_FALSE;
+
+    program = clCreateProgramWithSource(testData->context, 1, &source, KZ_NULL, &clResult);
+    cluClErrorTest(clResult);
+    if(clResult == CL_SUCCESS)
+    {
+        clResult = clBuildProgram(program, 1, &testData->device, KZ_NULL, KZ_NULL, KZ_NULL);
+        cluClErrorTest(clResult);
+        buildSucceeded = (clResult == CL_SUCCESS);
+    }
+
+    testData->programLatencies[testData->currentStep * PROGRAM_COUNT + programIndex] = bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - startTime;
+
+    if(program != KZ_NULL)
+    {
+        clResult = clReleaseProgram(program);
+        cluClErrorTest(clResult);
+    }
+
+    if(!buildSucceeded)
+    {
+        result = kzsThreadLockAcquire(testData->lock);
+        kzsErrorForward(result);
+        ++testData->failedBuilds;
+        result = kzsThreadLockRelease(testData->lock);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+static kzsError parallelCompilerWorker_internal(void* userData)
+{
+    kzsError result;
+    struct ParallelCompilerTestState* testData = (struct ParallelCompilerTestState*)userData;
+
+    for(;;)
+    {
+        kzUint programIndex;
+
+        result = kzsThreadLockAcquire(testData->lock);
+        kzsErrorForward(result);
+        programIndex = testData->nextProgram++;
+        result = kzsThreadLockRelease(testData->lock);
+        kzsErrorForward(result);
+
+        if(programIndex >= PROGRAM_COUNT)
+        {
+            break;
+        }
+
+        result = parallelCompilerBuildProgram_internal(testData, programIndex);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+static kzsError parallelCompilerBuildWithThreads_internal(struct ParallelCompilerTestState* testData, kzUint threadCount)
+{
+    kzsError result;
+    kzsError buildResult = KZS_SUCCESS;
+    kzUint i;
+    kzUint createdThreadCount = 1;
+    struct KzsThread* threads[PROGRAM_COUNT];
+
+    kzsAssert(threadCount > 0 && threadCount <= PROGRAM_COUNT);
+
+    testData->nextProgram = 0;
+
+    /* The calling thread works as the first worker. */
+    for(i = 1; i < threadCount && buildResult == KZS_SUCCESS; ++i)
+    {
+        buildResult = kzsThreadCreate(parallelCompilerWorker_internal, testData, KZ_FALSE, &threads[i]);
+        if(buildResult == KZS_SUCCESS)
+        {
+            ++createdThreadCount;
+        }
+    }
+
+    if(buildResult == KZS_SUCCESS)
+    {
+        buildResult = parallelCompilerWorker_internal(testData);
+    }
+
+    if(buildResult != KZS_SUCCESS)
+    {
+        /* Workers already started must not take new programs, but they still use the test data until joined. */
+        result = kzsThreadLockAcquire(testData->lock);
+        kzsErrorForward(result);
+        testData->nextProgram = PROGRAM_COUNT;
+        result = kzsThreadLockRelease(testData->lock);
+        kzsErrorForward(result);
+    }
+
+    for(i = 1; i < createdThreadCount; ++i)
+    {
+        kzsError exitResult;
+
+        result = kzsThreadJoin(threads[i]);
+        kzsErrorForward(result);
+        exitResult = kzsThreadGetExitResult(threads[i]);
+        if(buildResult == KZS_SUCCESS)
+        {
+            buildResult = exitResult;
+        }
+        result = kzsThreadDelete(threads[i]);
+        kzsErrorForward(result);
+    }
+
+    kzsErrorForward(buildResult);
+    kzsSuccess();
+}
+
+static kzsError parallelCompilerCompleteBuild_internal(struct ParallelCompilerTestState* testData, kzBool buildSucceeded)
+{
+    kzsError result;
+
+    result = kzsThreadLockAcquire(testData->lock);
+    kzsErrorForward(result);
+    if(!buildSucceeded)
+    {
+        ++testData->failedBuilds;
+    }
+    ++testData->completedPrograms;
+    if(testData->completedPrograms == PROGRAM_COUNT)
+    {
+        result = kzsThreadLockSet(testData->lock, KZ_TRUE, KZ_FALSE);
+        kzsErrorForward(result);
+    }
+    result = kzsThreadLockRelease(testData->lock);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static void CL_CALLBACK parallelCompilerBuildNotify_internal(cl_program program, void* userData)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_build_status buildStatus = CL_BUILD_ERROR;
+    struct ParallelCompilerBuild* build = (struct ParallelCompilerBuild*)userData;
+    struct ParallelCompilerTestState* testData = build->testData;
+
+    testData->programLatencies[testData->currentStep * PROGRAM_COUNT + build->programIndex] = 
+        bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - build->startTime;
+
+    clResult = clGetProgramBuildInfo(program, testData->device, CL_PROGRAM_BUILD_STATUS, sizeof(buildStatus), &buildStatus, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    result = parallelCompilerCompleteBuild_internal(testData, buildStatus == CL_BUILD_SUCCESS);
+    if(result != KZS_SUCCESS)
+    {
+        kzsLog(KZS_LOG_LEVEL_WARNING, "Failed to complete program build in parallel compiler test");
+    }
+}
+
+static kzsError parallelCompilerBuildWithCallbacks_internal(struct ParallelCompilerTestState* testData)
+{
+    kzsError result;
+    cl_int clResult;
+    kzUint i;
+
+    testData->completedPrograms = 0;
+    result = kzsThreadLockSet(testData->lock, KZ_FALSE, KZ_TRUE);
+    kzsErrorForward(result);
+
+    for(i = 0; i < PROGRAM_COUNT; ++i)
+    {
+        struct ParallelCompilerBuild* build = &testData->builds[i];
+        kzString source = testData->programSources[i];
+
+        build->testData = testData;
+        build->programIndex = i;
+        build->startTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer);
+        build->program = clCreateProgramWithSource(testData->context, 1, &source, KZ_NULL, &clResult);
+        cluClErrorTest(clResult);
+        if(clResult == CL_SUCCESS)
+        {
+            clResult = clBuildProgram(build->program, 1, &testData->device, KZ_NULL, parallelCompilerBuildNotify_internal, build);
+            cluClErrorTest(clResult);
+        }
+
+        /* Callback is not called if the build could not be started. */
+        if(clResult != CL_SUCCESS && clResult != CL_BUILD_PROGRAM_FAILURE)
+        {
+            testData->programLatencies[testData->currentStep * PROGRAM_COUNT + i] = bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - build->startTime;
+            result = parallelCompilerCompleteBuild_internal(testData, KZ_FALSE);
+            kzsErrorForward(result);
+        }
+    }
+
+    result = kzsThreadLockWait(testData->lock, KZ_TRUE);
+    kzsErrorForward(result);
+
+    for(i = 0; i < PROGRAM_COUNT; ++i)
+    {
+        if(testData->builds[i].program != KZ_NULL)
+        {
+            clResult = clReleaseProgram(testData->builds[i].program);
+            cluClErrorTest(clResult);
+            testData->builds[i].program = KZ_NULL;
+        }
+    }
+
+    kzsSuccess();
+}
+
+
+kzsError parallelCompilerSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError parallelCompilerSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
+kzsError parallelCompilerSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError parallelCompilerSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+
+kzsError parallelCompilerSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    kzUint i;
+    kzUint maximumThreadCount;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct ParallelCompilerTestState *testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    testData->context = bfGetClContext(framework);
+    clResult = clGetContextInfo(testData->context, CL_CONTEXT_DEVICES, sizeof(cl_device_id), &testData->device, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    {
+        kzInt threadCountSetting;
+        result = settingGetInt(bfGetSettings(framework), "ParallelCompilerMaxThreads", &threadCountSetting);
+        kzsErrorForward(result);
+        maximumThreadCount = (kzUint)kzsClampi(threadCountSetting, 1, PROGRAM_COUNT);
+    }
+
+    /* Thread counts double until the maximum is reached. Last frame builds with callbacks. */
+    testData->stepCount = 1;
+    for(i = 1; i < maximumThreadCount; i *= 2)
+    {
+        ++testData->stepCount;
+    }
+    ++testData->stepCount;
+
+    result = kzcMemoryAllocArray(memoryManager, testData->threadCounts, testData->stepCount, "Parallel compiler thread counts");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->wallTimes, testData->stepCount, "Parallel compiler wall times");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->programLatencies, testData->stepCount * PROGRAM_COUNT, "Parallel compiler program latencies");
+    kzsErrorForward(result);
+
+    for(i = 0; i < testData->stepCount - 1; ++i)
+    {
+        testData->threadCounts[i] = kzsMinU(1u << i, maximumThreadCount);
+    }
+    testData->threadCounts[testData->stepCount - 1] = 0;
+
+    for(i = 0; i < PROGRAM_COUNT; ++i)
+    {
+        result = kzcFileReadTextFile(memoryManager, compilerProgramNames[i], &testData->programSources[i]);
+        kzsErrorForward(result);
+        testData->builds[i].program = KZ_NULL;
+    }
+
+    result = bfTimerCreate(memoryManager, &testData->timer);
+    kzsErrorForward(result);
+    result = kzsThreadLockCreate(&testData->lock);
+    kzsErrorForward(result);
+
+    testData->failedBuilds = 0;
+    testData->currentStep = 0;
+
+    bfSceneSetFrameCounter(scene, testData->stepCount);
+    bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
+
+    result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
+    kzsErrorForward(result);
+
+    {
+        struct KzuMaterialType* materialType;
+        result = kzuProjectLoaderLoadMaterial(bfGetProject(framework), "Materials/LoadBarTexture/IntervalSceneLoadBar", &testData->loadingMaterial);
+        kzsErrorForward(result);
+        materialType = kzuMaterialGetMaterialType(testData->loadingMaterial);
+        testData->loadingPropertyType = kzuMaterialTypeGetPropertyTypeByName(materialType, "LoadAmount");
+    }
+
+    kzsSuccess();
+}
+
+kzsError parallelCompilerSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint threadCount;
+    kzUint startTime;
+    struct ParallelCompilerTestState *testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    testData->currentStep = bfSceneGetFrameInitialCounterValue(scene) - bfSceneGetFrameCounterValue(scene);
+    threadCount = testData->threadCounts[testData->currentStep];
+
+    startTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer);
+    if(threadCount > 0)
+    {
+        result = parallelCompilerBuildWithThreads_internal(testData, threadCount);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = parallelCompilerBuildWithCallbacks_internal(testData);
+        kzsErrorForward(result);
+    }
+    testData->wallTimes[testData->currentStep] = bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - startTime;
+
+    {   
+        kzUint framesElapsed = bfSceneGetFrameCounterValue(scene);
+        struct KzuPropertyManager* propertyManager = kzuMaterialGetPropertyManager(testData->loadingMaterial);
+        kzFloat loadingAmount = 1.0f - framesElapsed / ((kzFloat)bfSceneGetFrameInitialCounterValue(scene));
+        result = kzuPropertyManagerSetFloat(propertyManager, testData->loadingMaterial, testData->loadingPropertyType, loadingAmount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError parallelCompilerSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    kzUint step;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct ParallelCompilerTestState *testData;
+    kzFloat serialWallTime;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    serialWallTime = (kzFloat)testData->wallTimes[0];
+
+    result = bfInfoAddInteger(memoryManager, testNode, "failedBuilds", (kzInt)testData->failedBuilds);
+    kzsErrorForward(result);
+
+    /* Scaling curve. Every step reports total wall time, speedup relative to single thread and per program latencies. */
+    for(step = 0; step < testData->stepCount; ++step)
+    {
+        struct XMLNode* stepNode;
+        struct XMLAttribute* threadsAttribute;
+        kzUint threadCount = testData->threadCounts[step];
+        kzUint* latencies = &testData->programLatencies[step * PROGRAM_COUNT];
+        kzUint latencySum = 0;
+        kzUint i;
+
+        for(i = 0; i < PROGRAM_COUNT; ++i)
+        {
+            latencySum += latencies[i];
+        }
+
+        result = XMLNodeCreateContainer(memoryManager, (threadCount > 0) ? "threadedBuild" : "callbackBuild", &stepNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, stepNode);
+        kzsErrorForward(result);
+        if(threadCount > 0)
+        {
+            result = XMLAttributeCreateInteger(memoryManager, "threads", (kzInt)threadCount, &threadsAttribute);
+            kzsErrorForward(result);
+            result = XMLNodeAddAttribute(stepNode, threadsAttribute);
+            kzsErrorForward(result);
+        }
+
+        result = bfInfoAddInteger(memoryManager, stepNode, "wallTime", (kzInt)testData->wallTimes[step]);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, stepNode, "speedup", 
+                                 (testData->wallTimes[step] > 0) ? serialWallTime / (kzFloat)testData->wallTimes[step] : 0.0f);
+        kzsErrorForward(result);
+        result = bfInfoAddScalar(memoryManager, stepNode, "averageProgramLatency", latencySum / (kzFloat)PROGRAM_COUNT);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, stepNode, "programLatencies", latencies, PROGRAM_COUNT);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError parallelCompilerSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint i;
+    struct ParallelCompilerTestState *testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(i = 0; i < PROGRAM_COUNT; ++i)
+    {
+        result = kzcStringDelete(testData->programSources[i]);
+        kzsErrorForward(result);
+    }
+
+    result = kzsThreadLockDelete(testData->lock);
+    kzsErrorForward(result);
+    result = bfTimerDelete(testData->timer);
+    kzsErrorForward(result);
+
+    result = kzcMemoryFreeArray(testData->programLatencies);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->wallTimes);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->threadCounts);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+
+kzsError parallelCompilerTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct BfScene* scene;
+    struct BfSceneConfiguration* configuration;
+    struct ParallelCompilerTestState *testData = KZ_NULL;
+
+    result = bfTestConfigurationInitialize(memoryManager, parallelCompilerSceneLoad, parallelCompilerSceneUpdate, KZ_NULL,
+        parallelCompilerSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
+    kzsErrorForward(result);
+    configuration->report_private = parallelCompilerSceneReport;
+
+    result = kzcMemoryAllocVariable(memoryManager, testData, "OpenCL parallel compiler test internal data");
+    kzsErrorForward(result);
+    result = bfSceneCreate(framework, configuration, "Parallel Compiler Test", "General", testData, &scene);
+    kzsErrorForward(result);
+
+    *out_scene = scene;
+    kzsSuccess();
+}
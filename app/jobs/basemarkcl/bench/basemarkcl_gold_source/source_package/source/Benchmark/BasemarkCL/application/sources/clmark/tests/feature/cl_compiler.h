@@ -16,6 +16,11 @@ struct BenchmarkFramework;
 
 
 kzsError compilerTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+/**
+ * Creates test building all programs concurrently. Programs are built from increasing number of worker threads,
+ * up to ParallelCompilerMaxThreads, and finally with asynchronous clBuildProgram completion callbacks.
+ */
+kzsError parallelCompilerTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
 
 
 #endif
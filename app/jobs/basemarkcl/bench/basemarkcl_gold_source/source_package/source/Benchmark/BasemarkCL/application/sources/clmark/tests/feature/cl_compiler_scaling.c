@@ -0,0 +1,437 @@
+/**
+* \file
+* OpenCL compiler scaling test. Builds generated programs of increasing size.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "cl_compiler_scaling.h"
+
+#include <benchmarkutil/bf_benchmark_framework.h>
+#include <benchmarkutil/scene/bf_scene.h>
+#include <benchmarkutil/settings/bf_settings.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
+
+#include <clutil/clu_program.h>
+#include <clutil/clu_util.h>
+
+#include <application/kza_application.h>
+
+#include <user/project/kzu_project_loader_material.h>
+#include <user/properties/kzu_property_manager.h>
+#include <user/properties/kzu_float_property.h>
+#include <user/material/kzu_material.h>
+#include <user/material/kzu_material_type.h>
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/util/string/kzc_string.h>
+#include <core/util/string/kzc_string_buffer.h>
+
+#include <system/wrappers/kzs_math.h>
+
+#include <clutil/clu_opencl_base.h>
+
+#include <clmark/test_definitions.h>
+
+
+/** Kinds of generated programs. */
+enum CompilerScalingFamily
+{
+    COMPILER_SCALING_HELPER_FUNCTIONS, /**< Chain of helper functions called from one kernel. */
+    COMPILER_SCALING_UNROLLED_LOOP, /**< Fully unrolled loop body in one kernel. */
+    COMPILER_SCALING_SWITCH_TABLE, /**< Large switch statement in one kernel. */
+    COMPILER_SCALING_KERNEL_COUNT, /**< Many small kernels in one program. */
+    COMPILER_SCALING_FAMILY_COUNT /**< Number of program kinds. */
+};
+
+/** Names of the program kinds in report. */
+static kzString compilerScalingFamilyNames[COMPILER_SCALING_FAMILY_COUNT] =
+{
+    "helperFunctions",
+    "unrolledLoop",
+    "switchTable",
+    "kernelCount"
+};
+
+/** Size of the smallest program of each kind. Size doubles on each step. */
+static const kzUint compilerScalingBaseSizes[COMPILER_SCALING_FAMILY_COUNT] =
+{
+    8,
+    32,
+    16,
+    4
+};
+
+
+/** Compiler scaling test state. */
+struct CompilerScalingTestState
+{
+    kzUint stepCount; /**< Number of sizes built of each program kind. */
+    kzMutableString* sources; /**< Generated sources, stepCount entries for each program kind. Generated before timing. */
+    kzUint* sizes; /**< Generator size parameter of each source. */
+    kzUint* sourceSizes; /**< Length of each source in bytes. */
+    kzUint* buildTimes; /**< Build time of each source in microseconds. */
+    kzUint* binarySizes; /**< Size of the built program binary in bytes. Zero if the binary is not available. */
+    kzUint* kernelCounts; /**< Number of kernels in each built program. */
+
+    struct BfTimer* timer; /**< Timer for measuring builds. */
+
+    struct KzuMaterial* loadingMaterial; /**< Material used to render progress bar. */
+    struct KzuPropertyType* loadingPropertyType; /**< Property driving progress bar position. */
+};
+
+
+/** Generates source of given kind and size. */
+static kzsError compilerScalingGenerateSource_internal(const struct KzcMemoryManager* memoryManager, enum CompilerScalingFamily family, kzUint size,
+                                                       kzMutableString* out_source);
+/**
+ * Fits the exponent of build time against source size in log-log space with least squares.
+ * Exponent near one means linear scaling, values clearly above one indicate super-linear compile time.
+ */
+static kzFloat compilerScalingCalculateExponent_internal(const kzUint* sourceSizes, const kzUint* buildTimes, kzUint count);
+
+
+static kzsError compilerScalingGenerateSource_internal(const struct KzcMemoryManager* memoryManager, enum CompilerScalingFamily family, kzUint size,
+                                                       kzMutableString* out_source)
+{
+    kzsError result;
+    kzUint i;
+    struct KzcStringBuffer* buffer;
+
+    result = kzcStringBufferCreate(memoryManager, size * 64 + 256, &buffer);
+    kzsErrorForward(result);
+
+    switch(family)
+    {
+        case COMPILER_SCALING_HELPER_FUNCTIONS:
+        {
+            result = kzcStringBufferAppend(buffer, "float helper0(float x)\n{\n    return x * 1.0001f + 0.5f;\n}\n");
+            kzsErrorForward(result);
+            for(i = 1; i < size; ++i)
+            {
+                result = kzcStringBufferAppendFormat(buffer, "float helper%u(float x)\n{\n    return helper%u(x) * 0.9999f + %u.0f;\n}\n", i, i - 1, i);
+                kzsErrorForward(result);
+            }
+            result = kzcStringBufferAppendFormat(buffer, "__kernel void scaling(__global float* data)\n{\n    int i = get_global_id(0);\n"
+                                                 "    data[i] = helper%u(data[i]);\n}\n", size - 1);
+            kzsErrorForward(result);
+            break;
+        }
+        case COMPILER_SCALING_UNROLLED_LOOP:
+        {
+            result = kzcStringBufferAppend(buffer, "__kernel void scaling(__global float* data)\n{\n    int i = get_global_id(0);\n    float v = data[i];\n");
+            kzsErrorForward(result);
+            for(i = 0; i < size; ++i)
+            {
+                result = kzcStringBufferAppendFormat(buffer, "    v = v * 1.0001f + data[(i + %u) & 1023];\n", i);
+                kzsErrorForward(result);
+            }
+            result = kzcStringBufferAppend(buffer, "    data[i] = v;\n}\n");
+            kzsErrorForward(result);
+            break;
+        }
+        case COMPILER_SCALING_SWITCH_TABLE:
+        {
+            result = kzcStringBufferAppendFormat(buffer, "__kernel void scaling(__global int* data)\n{\n    int i = get_global_id(0);\n    int v = data[i];\n"
+                                                 "    switch(v %% %u)\n    {\n", size);
+            kzsErrorForward(result);
+            for(i = 0; i < size; ++i)
+            {
+                result = kzcStringBufferAppendFormat(buffer, "        case %u: v = v * %u + %u; break;\n", i, i + 3, i * 7);
+                kzsErrorForward(result);
+            }
+            result = kzcStringBufferAppend(buffer, "        default: v = 0; break;\n    }\n    data[i] = v;\n}\n");
+            kzsErrorForward(result);
+            break;
+        }
+        case COMPILER_SCALING_KERNEL_COUNT:
+        {
+            for(i = 0; i < size; ++i)
+            {
+                result = kzcStringBufferAppendFormat(buffer, "__kernel void scaling%u(__global float* data)\n{\n    int i = get_global_id(0);\n"
+                                                     "    data[i] = data[i] * %u.0f + 1.0f;\n}\n", i, i + 1);
+                kzsErrorForward(result);
+            }
+            break;
+        }
+        case COMPILER_SCALING_FAMILY_COUNT:
+        default:
+        {
+            kzsErrorThrow(KZS_ERROR_ILLEGAL_ARGUMENT, "Invalid compiler scaling program kind");
+        }
+    }
+
+    result = kzcStringBufferToString(memoryManager, buffer, out_source);
+    kzsErrorForward(result);
+    result = kzcStringBufferDelete(buffer);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzFloat compilerScalingCalculateExponent_internal(const kzUint* sourceSizes, const kzUint* buildTimes, kzUint count)
+{
+    kzUint i;
+    kzFloat sumX = 0.0f;
+    kzFloat sumY = 0.0f;
+    kzFloat sumXX = 0.0f;
+    kzFloat sumXY = 0.0f;
+    kzFloat denominator;
+
+    for(i = 0; i < count; ++i)
+    {
+        kzFloat x = kzsLogEf((kzFloat)kzsMaxU(sourceSizes[i], 1));
+        kzFloat y = kzsLogEf((kzFloat)kzsMaxU(buildTimes[i], 1));
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+
+    denominator = count * sumXX - sumX * sumX;
+    return (count > 1 && denominator > 0.0f) ? (count * sumXY - sumX * sumY) / denominator : 0.0f;
+}
+
+
+kzsError compilerScalingSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError compilerScalingSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
+kzsError compilerScalingSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError compilerScalingSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+
+kzsError compilerScalingSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint family;
+    kzUint step;
+    kzUint programCount;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct CompilerScalingTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    {
+        kzInt stepCountSetting;
+        result = settingGetInt(bfGetSettings(framework), "CompilerScalingSteps", &stepCountSetting);
+        kzsErrorForward(result);
+        testData->stepCount = (kzUint)kzsClampi(stepCountSetting, 1, 16);
+    }
+    programCount = testData->stepCount * COMPILER_SCALING_FAMILY_COUNT;
+
+    result = kzcMemoryAllocArray(memoryManager, testData->sources, programCount, "Compiler scaling sources");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->sizes, programCount, "Compiler scaling sizes");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->sourceSizes, programCount, "Compiler scaling source sizes");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->buildTimes, programCount, "Compiler scaling build times");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->binarySizes, programCount, "Compiler scaling binary sizes");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->kernelCounts, programCount, "Compiler scaling kernel counts");
+    kzsErrorForward(result);
+
+    for(family = 0; family < COMPILER_SCALING_FAMILY_COUNT; ++family)
+    {
+        for(step = 0; step < testData->stepCount; ++step)
+        {
+            kzUint index = family * testData->stepCount + step;
+            testData->sizes[index] = compilerScalingBaseSizes[family] << step;
+            result = compilerScalingGenerateSource_internal(memoryManager, (enum CompilerScalingFamily)family, testData->sizes[index], &testData->sources[index]);
+            kzsErrorForward(result);
+            testData->sourceSizes[index] = kzcStringLength(testData->sources[index]);
+            testData->buildTimes[index] = 0;
+            testData->binarySizes[index] = 0;
+            testData->kernelCounts[index] = 0;
+        }
+    }
+
+    result = bfTimerCreate(memoryManager, &testData->timer);
+    kzsErrorForward(result);
+
+    bfSceneSetFrameCounter(scene, programCount);
+    bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
+
+    result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
+    kzsErrorForward(result);
+
+    {
+        struct KzuMaterialType* materialType;
+        result = kzuProjectLoaderLoadMaterial(bfGetProject(framework), "Materials/LoadBarTexture/IntervalSceneLoadBar", &testData->loadingMaterial);
+        kzsErrorForward(result);
+        materialType = kzuMaterialGetMaterialType(testData->loadingMaterial);
+        testData->loadingPropertyType = kzuMaterialTypeGetPropertyTypeByName(materialType, "LoadAmount");
+    }
+
+    kzsSuccess();
+}
+
+kzsError compilerScalingSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_program program;
+    kzUint index;
+    kzUint startTime;
+    struct CompilerScalingTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    index = bfSceneGetFrameInitialCounterValue(scene) - bfSceneGetFrameCounterValue(scene);
+
+    /* Program cache is bypassed, as it would hide the compiler. */
+    startTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer);
+    result = cluGetBuiltProgramFromStringWithOptions(bfGetMemoryManager(framework), KZ_NULL, testData->sources[index], COMPILER_FLAGS,
+                                                     bfGetClContext(framework), &program);
+    kzsErrorForward(result);
+    testData->buildTimes[index] = bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - startTime;
+
+    if(program != KZ_NULL)
+    {
+        cl_uint deviceCount = 0;
+        cl_uint kernelCount = 0;
+
+        clResult = clCreateKernelsInProgram(program, 0, KZ_NULL, &kernelCount);
+        if(clResult == CL_SUCCESS)
+        {
+            testData->kernelCounts[index] = kernelCount;
+        }
+        else
+        {
+            /* Kernels can not be created from a program that failed to build. */
+            bfSceneSetValidConfigurationData(scene, KZ_FALSE);
+        }
+
+        /* Binary size is used as a measure of the generated code. Only reported for single device contexts. */
+        clResult = clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(deviceCount), &deviceCount, KZ_NULL);
+        cluClErrorTest(clResult);
+        if(clResult == CL_SUCCESS && deviceCount == 1)
+        {
+            size_t binarySize = 0;
+            clResult = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binarySize), &binarySize, KZ_NULL);
+            cluClErrorTest(clResult);
+            testData->binarySizes[index] = (kzUint)binarySize;
+        }
+
+        clResult = clReleaseProgram(program);
+        cluClErrorTest(clResult);
+    }
+    else
+    {
+        bfSceneSetValidConfigurationData(scene, KZ_FALSE);
+    }
+
+    {
+        kzUint framesElapsed = bfSceneGetFrameCounterValue(scene);
+        struct KzuPropertyManager* propertyManager = kzuMaterialGetPropertyManager(testData->loadingMaterial);
+        kzFloat loadingAmount = 1.0f - framesElapsed / ((kzFloat)bfSceneGetFrameInitialCounterValue(scene));
+        result = kzuPropertyManagerSetFloat(propertyManager, testData->loadingMaterial, testData->loadingPropertyType, loadingAmount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError compilerScalingSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    kzUint family;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct CompilerScalingTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(family = 0; family < COMPILER_SCALING_FAMILY_COUNT; ++family)
+    {
+        struct XMLNode* familyNode;
+        struct XMLAttribute* nameAttribute;
+        kzUint first = family * testData->stepCount;
+
+        result = XMLNodeCreateContainer(memoryManager, "compileScaling", &familyNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, familyNode);
+        kzsErrorForward(result);
+        result = XMLAttributeCreateString(memoryManager, "generator", compilerScalingFamilyNames[family], &nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddAttribute(familyNode, nameAttribute);
+        kzsErrorForward(result);
+
+        result = bfInfoAddScalar(memoryManager, familyNode, "buildTimeExponent",
+                                 compilerScalingCalculateExponent_internal(&testData->sourceSizes[first], &testData->buildTimes[first], testData->stepCount));
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, familyNode, "generatorSizes", &testData->sizes[first], testData->stepCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, familyNode, "sourceSizes", &testData->sourceSizes[first], testData->stepCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, familyNode, "buildTimes", &testData->buildTimes[first], testData->stepCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, familyNode, "binarySizes", &testData->binarySizes[first], testData->stepCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, familyNode, "kernelCounts", &testData->kernelCounts[first], testData->stepCount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError compilerScalingSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint i;
+    struct CompilerScalingTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(i = 0; i < testData->stepCount * COMPILER_SCALING_FAMILY_COUNT; ++i)
+    {
+        result = kzcStringDelete(testData->sources[i]);
+        kzsErrorForward(result);
+    }
+
+    result = bfTimerDelete(testData->timer);
+    kzsErrorForward(result);
+
+    result = kzcMemoryFreeArray(testData->kernelCounts);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->binarySizes);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->buildTimes);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->sourceSizes);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->sizes);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->sources);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+
+kzsError compilerScalingTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct BfScene* scene;
+    struct BfSceneConfiguration* configuration;
+    struct CompilerScalingTestState* testData = KZ_NULL;
+
+    result = bfTestConfigurationInitialize(memoryManager, compilerScalingSceneLoad, compilerScalingSceneUpdate, KZ_NULL,
+        compilerScalingSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
+    kzsErrorForward(result);
+    configuration->report_private = compilerScalingSceneReport;
+
+    result = kzcMemoryAllocVariable(memoryManager, testData, "OpenCL compiler scaling test internal data");
+    kzsErrorForward(result);
+    result = bfSceneCreate(framework, configuration, "Compiler Scaling Test", "General", testData, &scene);
+    kzsErrorForward(result);
+
+    *out_scene = scene;
+    kzsSuccess();
+}
@@ -0,0 +1,23 @@
+/**
+* \file
+* OpenCL compiler scaling test. Builds generated programs of increasing size.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CL_COMPILER_SCALING_H
+#define CL_COMPILER_SCALING_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct BfScene;
+struct BenchmarkFramework;
+
+
+/** Create the compiler scaling test. */
+kzsError compilerScalingTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+
+
+#endif
@@ -0,0 +1,382 @@
+/**
+* \file
+* Hash map test. Compares the linear and grouped hash map tables of the engine core.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "cl_hash_map.h"
+
+#include <benchmarkutil/bf_benchmark_framework.h>
+#include <benchmarkutil/scene/bf_scene.h>
+#include <benchmarkutil/settings/bf_settings.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_score.h>
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
+
+#include <application/kza_application.h>
+
+#include <user/project/kzu_project_loader_material.h>
+#include <user/properties/kzu_property_manager.h>
+#include <user/properties/kzu_float_property.h>
+#include <user/material/kzu_material.h>
+#include <user/material/kzu_material_type.h>
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/util/collection/kzc_hash_map.h>
+#include <core/util/string/kzc_string.h>
+
+#include <system/wrappers/kzs_math.h>
+
+
+/** Number of measured map sizes. */
+#define HASH_MAP_SIZE_COUNT 3
+/** Number of compared table types. */
+#define HASH_MAP_TABLE_TYPE_COUNT 2
+
+
+/** Key types of the measured maps. */
+enum HashMapKeyType
+{
+    HASH_MAP_KEY_STRING, /**< String keys of the form "key<n>". */
+    HASH_MAP_KEY_POINTER, /**< Pointers to consecutive array elements. */
+    HASH_MAP_KEY_TYPE_COUNT /**< Number of key types. */
+};
+
+/** Measured map operations. Each round puts all keys to an empty map, gets them and removes them. */
+enum HashMapOperation
+{
+    HASH_MAP_OPERATION_PUT, /**< Adding a new key. */
+    HASH_MAP_OPERATION_GET, /**< Finding an existing key. */
+    HASH_MAP_OPERATION_REMOVE, /**< Removing an existing key. */
+    HASH_MAP_OPERATION_COUNT /**< Number of operations. */
+};
+
+/** Number of entries in the measured maps. */
+static const kzUint hashMapSizes[HASH_MAP_SIZE_COUNT] = {16, 1000, 20000};
+
+/** Compared table types. */
+static const enum KzcHashMapTableType hashMapTableTypes[HASH_MAP_TABLE_TYPE_COUNT] = {KZC_HASH_MAP_TABLE_TYPE_LINEAR, KZC_HASH_MAP_TABLE_TYPE_GROUPED};
+
+/** Names of the key types in report. */
+static kzString hashMapKeyTypeNames[HASH_MAP_KEY_TYPE_COUNT] = {"string", "pointer"};
+
+/** Names of the results in report for each table type and operation. */
+static kzString hashMapResultNames[HASH_MAP_TABLE_TYPE_COUNT][HASH_MAP_OPERATION_COUNT] =
+{
+    {"linearPut", "linearGet", "linearRemove"},
+    {"groupedPut", "groupedGet", "groupedRemove"}
+};
+
+
+/** Hash map test state. */
+struct HashMapTestState
+{
+    struct KzcMemoryManager* memoryManager; /**< Memory manager for the maps. */
+
+    kzUint* items; /**< Items whose addresses are the pointer keys and the values of all maps. */
+    kzMutableString* stringKeys; /**< String keys. */
+    const void** keys[HASH_MAP_KEY_TYPE_COUNT]; /**< Keys of each key type. */
+
+    kzUint roundCount; /**< Number of measured rounds of each map. */
+    kzUint* samples; /**< Time of each round and operation in nanoseconds. Reordered when medians are calculated. */
+
+    struct BfTimer* timer; /**< Timer for measuring. */
+
+    struct KzuMaterial* loadingMaterial; /**< Material used to render progress bar. */
+    struct KzuPropertyType* loadingPropertyType; /**< Property driving progress bar position. */
+};
+
+
+/** Returns the samples of given measurement, table type and operation. */
+static kzUint* hashMapGetSamples_internal(const struct HashMapTestState* testData, kzUint measurement, kzUint tableTypeIndex, kzUint operation);
+/** Measures one round of operations on a new map and stores the times in nanoseconds. */
+static kzsError hashMapMeasureRound_internal(const struct HashMapTestState* testData, kzUint keyType, kzUint size,
+                                             enum KzcHashMapTableType tableType, kzUint* out_times);
+
+
+static kzUint* hashMapGetSamples_internal(const struct HashMapTestState* testData, kzUint measurement, kzUint tableTypeIndex, kzUint operation)
+{
+    return &testData->samples[((measurement * HASH_MAP_TABLE_TYPE_COUNT + tableTypeIndex) * HASH_MAP_OPERATION_COUNT + operation) * testData->roundCount];
+}
+
+static kzsError hashMapMeasureRound_internal(const struct HashMapTestState* testData, kzUint keyType, kzUint size,
+                                             enum KzcHashMapTableType tableType, kzUint* out_times)
+{
+    kzsError result;
+    struct KzcHashMap* map;
+    struct KzcHashMapConfiguration configuration = (keyType == HASH_MAP_KEY_STRING) ? KZC_HASH_MAP_CONFIGURATION_STRING :
+                                                                                      KZC_HASH_MAP_CONFIGURATION_POINTER;
+    const void** keys = testData->keys[keyType];
+    kzUint foundCount = 0;
+    kzUint startTime;
+    kzUint i;
+
+    configuration.tableType = tableType;
+
+    result = kzcHashMapCreate(testData->memoryManager, configuration, &map);
+    kzsErrorForward(result);
+
+    startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+    for(i = 0; i < size; ++i)
+    {
+        result = kzcHashMapPut(map, keys[i], &testData->items[i]);
+        kzsErrorForward(result);
+    }
+    out_times[HASH_MAP_OPERATION_PUT] = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+
+    startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+    for(i = 0; i < size; ++i)
+    {
+        void* value;
+        if(kzcHashMapGet(map, keys[i], &value) && value == &testData->items[i])
+        {
+            ++foundCount;
+        }
+    }
+    out_times[HASH_MAP_OPERATION_GET] = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+
+    startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+    for(i = 0; i < size; ++i)
+    {
+        result = kzcHashMapRemove(map, keys[i]);
+        kzsErrorForward(result);
+    }
+    out_times[HASH_MAP_OPERATION_REMOVE] = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+
+    kzsErrorTest(foundCount == size && kzcHashMapGetSize(map) == 0, KZS_ERROR_ILLEGAL_OPERATION, "Hash map returned wrong entries");
+
+    result = kzcHashMapDelete(map);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+
+kzsError hashMapSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError hashMapSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
+kzsError hashMapSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError hashMapSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+
+kzsError hashMapSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint i;
+    kzUint maximumSize = hashMapSizes[HASH_MAP_SIZE_COUNT - 1];
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct HashMapTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    testData->memoryManager = memoryManager;
+
+    result = kzcMemoryAllocArray(memoryManager, testData->items, maximumSize, "Hash map test items");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->stringKeys, maximumSize, "Hash map test string keys");
+    kzsErrorForward(result);
+    for(i = 0; i < HASH_MAP_KEY_TYPE_COUNT; ++i)
+    {
+        result = kzcMemoryAllocArray(memoryManager, testData->keys[i], maximumSize, "Hash map test keys");
+        kzsErrorForward(result);
+    }
+
+    for(i = 0; i < maximumSize; ++i)
+    {
+        testData->items[i] = i;
+
+        result = kzcStringFormat(memoryManager, "key%u", &testData->stringKeys[i], i);
+        kzsErrorForward(result);
+
+        testData->keys[HASH_MAP_KEY_STRING][i] = testData->stringKeys[i];
+        testData->keys[HASH_MAP_KEY_POINTER][i] = &testData->items[i];
+    }
+
+    {
+        kzInt roundCountSetting;
+        result = settingGetInt(bfGetSettings(framework), "HashMapRounds", &roundCountSetting);
+        kzsErrorForward(result);
+        testData->roundCount = (kzUint)kzsClampi(roundCountSetting, 3, 1000);
+    }
+
+    result = kzcMemoryAllocArray(memoryManager, testData->samples,
+                                 HASH_MAP_KEY_TYPE_COUNT * HASH_MAP_SIZE_COUNT * HASH_MAP_TABLE_TYPE_COUNT * HASH_MAP_OPERATION_COUNT * testData->roundCount,
+                                 "Hash map test samples");
+    kzsErrorForward(result);
+
+    result = bfTimerCreate(memoryManager, &testData->timer);
+    kzsErrorForward(result);
+
+    /* Each frame measures both table types with one key type and map size. */
+    bfSceneSetFrameCounter(scene, HASH_MAP_KEY_TYPE_COUNT * HASH_MAP_SIZE_COUNT);
+    bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
+
+    result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
+    kzsErrorForward(result);
+
+    {
+        struct KzuMaterialType* materialType;
+        result = kzuProjectLoaderLoadMaterial(bfGetProject(framework), "Materials/LoadBarTexture/IntervalSceneLoadBar", &testData->loadingMaterial);
+        kzsErrorForward(result);
+        materialType = kzuMaterialGetMaterialType(testData->loadingMaterial);
+        testData->loadingPropertyType = kzuMaterialTypeGetPropertyTypeByName(materialType, "LoadAmount");
+    }
+
+    kzsSuccess();
+}
+
+kzsError hashMapSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint measurement;
+    kzUint keyType;
+    kzUint size;
+    kzUint round;
+    kzUint tableTypeIndex;
+    kzUint operation;
+    kzUint times[HASH_MAP_OPERATION_COUNT];
+    struct HashMapTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    measurement = bfSceneGetFrameInitialCounterValue(scene) - bfSceneGetFrameCounterValue(scene);
+    keyType = measurement / HASH_MAP_SIZE_COUNT;
+    size = hashMapSizes[measurement % HASH_MAP_SIZE_COUNT];
+
+    /* First round of each table type is discarded to warm up the caches and the memory pools. */
+    for(tableTypeIndex = 0; tableTypeIndex < HASH_MAP_TABLE_TYPE_COUNT; ++tableTypeIndex)
+    {
+        result = hashMapMeasureRound_internal(testData, keyType, size, hashMapTableTypes[tableTypeIndex], times);
+        kzsErrorForward(result);
+    }
+
+    /* Rounds of the table types alternate, so that both are equally affected by changes in the system state. */
+    for(round = 0; round < testData->roundCount; ++round)
+    {
+        for(tableTypeIndex = 0; tableTypeIndex < HASH_MAP_TABLE_TYPE_COUNT; ++tableTypeIndex)
+        {
+            result = hashMapMeasureRound_internal(testData, keyType, size, hashMapTableTypes[tableTypeIndex], times);
+            kzsErrorForward(result);
+
+            for(operation = 0; operation < HASH_MAP_OPERATION_COUNT; ++operation)
+            {
+                hashMapGetSamples_internal(testData, measurement, tableTypeIndex, operation)[round] = times[operation];
+            }
+        }
+    }
+
+    {
+        kzUint framesElapsed = bfSceneGetFrameCounterValue(scene);
+        struct KzuPropertyManager* propertyManager = kzuMaterialGetPropertyManager(testData->loadingMaterial);
+        kzFloat loadingAmount = 1.0f - framesElapsed / ((kzFloat)bfSceneGetFrameInitialCounterValue(scene));
+        result = kzuPropertyManagerSetFloat(propertyManager, testData->loadingMaterial, testData->loadingPropertyType, loadingAmount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError hashMapSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    kzUint measurement;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct HashMapTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(measurement = 0; measurement < HASH_MAP_KEY_TYPE_COUNT * HASH_MAP_SIZE_COUNT; ++measurement)
+    {
+        struct XMLNode* measurementNode;
+        struct XMLAttribute* keyTypeAttribute;
+        kzUint size = hashMapSizes[measurement % HASH_MAP_SIZE_COUNT];
+        kzUint tableTypeIndex;
+        kzUint operation;
+
+        result = XMLNodeCreateContainer(memoryManager, "hashMap", &measurementNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, measurementNode);
+        kzsErrorForward(result);
+
+        result = XMLAttributeCreateString(memoryManager, "keyType", hashMapKeyTypeNames[measurement / HASH_MAP_SIZE_COUNT], &keyTypeAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddAttribute(measurementNode, keyTypeAttribute);
+        kzsErrorForward(result);
+
+        result = bfInfoAddInteger(memoryManager, measurementNode, "entries", (kzInt)size);
+        kzsErrorForward(result);
+
+        /* Results are median nanoseconds per operation. */
+        for(tableTypeIndex = 0; tableTypeIndex < HASH_MAP_TABLE_TYPE_COUNT; ++tableTypeIndex)
+        {
+            for(operation = 0; operation < HASH_MAP_OPERATION_COUNT; ++operation)
+            {
+                kzUint* samples = hashMapGetSamples_internal(testData, measurement, tableTypeIndex, operation);
+                kzFloat roundTime = bfScoreCalculateMedian(samples, testData->roundCount);
+                result = bfInfoAddScalar(memoryManager, measurementNode, hashMapResultNames[tableTypeIndex][operation], roundTime / (kzFloat)size);
+                kzsErrorForward(result);
+            }
+        }
+    }
+
+    kzsSuccess();
+}
+
+kzsError hashMapSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint i;
+    struct HashMapTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = bfTimerDelete(testData->timer);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->samples);
+    kzsErrorForward(result);
+
+    for(i = 0; i < hashMapSizes[HASH_MAP_SIZE_COUNT - 1]; ++i)
+    {
+        result = kzcStringDelete(testData->stringKeys[i]);
+        kzsErrorForward(result);
+    }
+    for(i = 0; i < HASH_MAP_KEY_TYPE_COUNT; ++i)
+    {
+        result = kzcMemoryFreeArray(testData->keys[i]);
+        kzsErrorForward(result);
+    }
+    result = kzcMemoryFreeArray(testData->stringKeys);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->items);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+
+kzsError hashMapTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct BfScene* scene;
+    struct BfSceneConfiguration* configuration;
+    struct HashMapTestState* testData = KZ_NULL;
+
+    result = bfTestConfigurationInitialize(memoryManager, hashMapSceneLoad, hashMapSceneUpdate, KZ_NULL,
+        hashMapSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
+    kzsErrorForward(result);
+    configuration->report_private = hashMapSceneReport;
+
+    result = kzcMemoryAllocVariable(memoryManager, testData, "Hash map test internal data");
+    kzsErrorForward(result);
+    result = bfSceneCreate(framework, configuration, "Hash Map Test", "General", testData, &scene);
+    kzsErrorForward(result);
+
+    *out_scene = scene;
+    kzsSuccess();
+}
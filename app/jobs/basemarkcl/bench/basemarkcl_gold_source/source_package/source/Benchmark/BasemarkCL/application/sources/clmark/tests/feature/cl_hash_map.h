@@ -0,0 +1,23 @@
+/**
+* \file
+* Hash map test. Compares the linear and grouped hash map tables of the engine core.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CL_HASH_MAP_H
+#define CL_HASH_MAP_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct BfScene;
+struct BenchmarkFramework;
+
+
+/** Create the hash map test. */
+kzsError hashMapTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+
+
+#endif
@@ -197,7 +197,7 @@ kzsError juliaSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
             result = bfValidateFile(framework, "data/julia.cl", JULIA_HASH, &isValid);
             kzsErrorForward(result);
             resourcesAreValid &= isValid;
-            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/julia.cl", KZ_FALSE, compilerSettings, testData->context, &testData->juliaProgram, &binary);
+            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/julia.cl", KZ_FALSE, compilerSettings, testData->context, &testData->juliaProgram, &binary);
             kzsErrorForward(result);
             bfSceneSetUseProgramBinary(scene, binary);
         }
@@ -0,0 +1,443 @@
+/**
+* \file
+* Kernel launch and synchronization overhead test. Measures dispatch costs with empty kernels.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "cl_launch_overhead.h"
+
+#include <benchmarkutil/bf_benchmark_framework.h>
+#include <benchmarkutil/scene/bf_scene.h>
+#include <benchmarkutil/settings/bf_settings.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_score.h>
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
+
+#include <clutil/clu_program.h>
+#include <clutil/clu_util.h>
+
+#include <application/kza_application.h>
+
+#include <user/project/kzu_project_loader_material.h>
+#include <user/properties/kzu_property_manager.h>
+#include <user/properties/kzu_float_property.h>
+#include <user/material/kzu_material.h>
+#include <user/material/kzu_material_type.h>
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/util/string/kzc_string.h>
+#include <core/util/string/kzc_string_buffer.h>
+
+#include <system/wrappers/kzs_math.h>
+
+#include <clutil/clu_opencl_base.h>
+
+#include <clmark/test_definitions.h>
+
+
+/** Number of kernels enqueued for each throughput sample. */
+#define LAUNCH_OVERHEAD_BATCH_SIZE 256
+/** Number of kernels with different argument counts. Kernel n has 2^n arguments. */
+#define LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT 5
+
+
+/** Measured dispatch operations. */
+enum LaunchOverheadMeasurement
+{
+    LAUNCH_OVERHEAD_ENQUEUE, /**< Host time of a single clEnqueueNDRangeKernel call without event. Queue is drained untimed between samples. */
+    LAUNCH_OVERHEAD_THROUGHPUT, /**< Time per kernel of a batch of enqueues without events, including the final clFinish. */
+    LAUNCH_OVERHEAD_THROUGHPUT_EVENTS, /**< Same as throughput, with an event created and released for each kernel. */
+    LAUNCH_OVERHEAD_FINISH, /**< Enqueue of a single kernel followed by clFinish. */
+    LAUNCH_OVERHEAD_WAIT_FOR_EVENTS, /**< Enqueue of a single kernel with event followed by clFlush and clWaitForEvents. */
+    LAUNCH_OVERHEAD_SET_ARGUMENTS, /**< Setting all arguments of a kernel, one measurement for each argument count. */
+    LAUNCH_OVERHEAD_MEASUREMENT_COUNT = LAUNCH_OVERHEAD_SET_ARGUMENTS + LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT /**< Number of measurements. */
+};
+
+/** Names of the measurements in report. Argument measurements are named by their argument count. */
+static kzString launchOverheadMeasurementNames[LAUNCH_OVERHEAD_SET_ARGUMENTS] =
+{
+    "enqueue",
+    "enqueueThroughput",
+    "enqueueThroughputWithEvents",
+    "finishRoundTrip",
+    "waitForEventsRoundTrip"
+};
+
+/** Reported percentiles of each measurement. */
+static const kzUint launchOverheadPercentiles[] = {0, 50, 90, 99, 100};
+
+/** Names of the reported percentiles. */
+static kzString launchOverheadPercentileNames[] = {"minimum", "median", "percentile90", "percentile99", "maximum"};
+
+
+/** Launch overhead test state. */
+struct LaunchOverheadTestState
+{
+    cl_context context; /**< OpenCL context. */
+    cl_device_id device; /**< OpenCL device. */
+    cl_command_queue queue; /**< Command queue without profiling, which would add to the overhead. */
+    cl_program program; /**< Program containing the empty kernels. */
+    cl_kernel emptyKernel; /**< Kernel without arguments. */
+    cl_kernel argumentKernels[LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT]; /**< Empty kernels with 1, 2, 4, ... integer arguments. */
+
+    kzUint sampleCount; /**< Number of samples of each measurement. */
+    kzUint* samples; /**< Samples of each measurement in nanoseconds. Reordered when percentiles are calculated. */
+
+    struct BfTimer* timer; /**< Timer for measuring. */
+
+    struct KzuMaterial* loadingMaterial; /**< Material used to render progress bar. */
+    struct KzuPropertyType* loadingPropertyType; /**< Property driving progress bar position. */
+};
+
+
+/** Generates source of the empty kernels. */
+static kzsError launchOverheadGenerateSource_internal(const struct KzcMemoryManager* memoryManager, kzMutableString* out_source);
+/** Takes one sample of given measurement in nanoseconds. */
+static kzsError launchOverheadMeasure_internal(const struct LaunchOverheadTestState* testData, kzUint measurement, kzUint* out_time);
+
+
+static kzsError launchOverheadGenerateSource_internal(const struct KzcMemoryManager* memoryManager, kzMutableString* out_source)
+{
+    kzsError result;
+    kzUint i;
+    kzUint n;
+    struct KzcStringBuffer* buffer;
+
+    result = kzcStringBufferCreate(memoryManager, 1024, &buffer);
+    kzsErrorForward(result);
+
+    result = kzcStringBufferAppend(buffer, "__kernel void empty()\n{\n}\n");
+    kzsErrorForward(result);
+
+    for(i = 0; i < LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT; ++i)
+    {
+        kzUint argumentCount = 1u << i;
+        result = kzcStringBufferAppendFormat(buffer, "__kernel void arguments%u(", argumentCount);
+        kzsErrorForward(result);
+        for(n = 0; n < argumentCount; ++n)
+        {
+            result = kzcStringBufferAppendFormat(buffer, "%sint a%u", (n > 0) ? ", " : "", n);
+            kzsErrorForward(result);
+        }
+        result = kzcStringBufferAppend(buffer, ")\n{\n}\n");
+        kzsErrorForward(result);
+    }
+
+    result = kzcStringBufferToString(memoryManager, buffer, out_source);
+    kzsErrorForward(result);
+    result = kzcStringBufferDelete(buffer);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError launchOverheadMeasure_internal(const struct LaunchOverheadTestState* testData, kzUint measurement, kzUint* out_time)
+{
+    cl_int clResult;
+    size_t globalWorkSize = 1;
+    kzUint startTime;
+    kzUint time;
+    kzUint i;
+
+    switch(measurement)
+    {
+        case LAUNCH_OVERHEAD_ENQUEUE:
+        {
+            startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+            clResult = clEnqueueNDRangeKernel(testData->queue, testData->emptyKernel, 1, KZ_NULL, &globalWorkSize, KZ_NULL, 0, KZ_NULL, KZ_NULL);
+            time = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+            cluClErrorTest(clResult);
+            clResult = clFinish(testData->queue);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case LAUNCH_OVERHEAD_THROUGHPUT:
+        case LAUNCH_OVERHEAD_THROUGHPUT_EVENTS:
+        {
+            kzBool useEvents = (measurement == LAUNCH_OVERHEAD_THROUGHPUT_EVENTS);
+            startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+            for(i = 0; i < LAUNCH_OVERHEAD_BATCH_SIZE; ++i)
+            {
+                cl_event event;
+                clResult = clEnqueueNDRangeKernel(testData->queue, testData->emptyKernel, 1, KZ_NULL, &globalWorkSize, KZ_NULL, 0, KZ_NULL,
+                                                  useEvents ? &event : KZ_NULL);
+                cluClErrorTest(clResult);
+                if(useEvents)
+                {
+                    clResult = clReleaseEvent(event);
+                    cluClErrorTest(clResult);
+                }
+            }
+            clResult = clFinish(testData->queue);
+            cluClErrorTest(clResult);
+            time = (bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime) / LAUNCH_OVERHEAD_BATCH_SIZE;
+            break;
+        }
+        case LAUNCH_OVERHEAD_FINISH:
+        {
+            startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+            clResult = clEnqueueNDRangeKernel(testData->queue, testData->emptyKernel, 1, KZ_NULL, &globalWorkSize, KZ_NULL, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            clResult = clFinish(testData->queue);
+            cluClErrorTest(clResult);
+            time = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+            break;
+        }
+        case LAUNCH_OVERHEAD_WAIT_FOR_EVENTS:
+        {
+            cl_event event;
+            startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+            clResult = clEnqueueNDRangeKernel(testData->queue, testData->emptyKernel, 1, KZ_NULL, &globalWorkSize, KZ_NULL, 0, KZ_NULL, &event);
+            cluClErrorTest(clResult);
+            clResult = clFlush(testData->queue);
+            cluClErrorTest(clResult);
+            clResult = clWaitForEvents(1, &event);
+            cluClErrorTest(clResult);
+            time = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+            clResult = clReleaseEvent(event);
+            cluClErrorTest(clResult);
+            break;
+        }
+        default:
+        {
+            kzUint kernelIndex = measurement - LAUNCH_OVERHEAD_SET_ARGUMENTS;
+            cl_uint argumentCount = 1u << kernelIndex;
+            cl_uint argument;
+            cl_int value = (cl_int)measurement;
+
+            kzsErrorTest(kernelIndex < LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT, KZS_ERROR_ILLEGAL_ARGUMENT, "Invalid launch overhead measurement");
+
+            startTime = bfTimerGetElapsedTimeInNanoSeconds(testData->timer);
+            for(argument = 0; argument < argumentCount; ++argument)
+            {
+                clResult = clSetKernelArg(testData->argumentKernels[kernelIndex], argument, sizeof(value), &value);
+                cluClErrorTest(clResult);
+            }
+            time = bfTimerGetElapsedTimeInNanoSeconds(testData->timer) - startTime;
+            break;
+        }
+    }
+
+    *out_time = time;
+    kzsSuccess();
+}
+
+
+kzsError launchOverheadSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError launchOverheadSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
+kzsError launchOverheadSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError launchOverheadSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+
+kzsError launchOverheadSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    kzUint i;
+    kzMutableString source;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct LaunchOverheadTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    testData->context = bfGetClContext(framework);
+    clResult = clGetContextInfo(testData->context, CL_CONTEXT_DEVICES, sizeof(cl_device_id), &testData->device, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    testData->queue = clCreateCommandQueue(testData->context, testData->device, 0, &clResult);
+    cluClErrorTest(clResult);
+
+    result = launchOverheadGenerateSource_internal(memoryManager, &source);
+    kzsErrorForward(result);
+    result = cluGetBuiltProgramFromStringWithOptions(memoryManager, bfGetProgramCache(framework), source, COMPILER_FLAGS, testData->context,
+                                                     &testData->program);
+    kzsErrorForward(result);
+    result = kzcStringDelete(source);
+    kzsErrorForward(result);
+    kzsErrorTest(testData->program != KZ_NULL, KZS_ERROR_ILLEGAL_OPERATION, "Failed to build launch overhead kernels");
+
+    testData->emptyKernel = clCreateKernel(testData->program, "empty", &clResult);
+    cluClErrorTest(clResult);
+    for(i = 0; i < LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT; ++i)
+    {
+        kzMutableString kernelName;
+        result = kzcStringFormat(memoryManager, "arguments%u", &kernelName, 1u << i);
+        kzsErrorForward(result);
+        testData->argumentKernels[i] = clCreateKernel(testData->program, kernelName, &clResult);
+        cluClErrorTest(clResult);
+        result = kzcStringDelete(kernelName);
+        kzsErrorForward(result);
+    }
+
+    {
+        kzInt sampleCountSetting;
+        result = settingGetInt(bfGetSettings(framework), "LaunchOverheadSamples", &sampleCountSetting);
+        kzsErrorForward(result);
+        testData->sampleCount = (kzUint)kzsClampi(sampleCountSetting, 10, 100000);
+    }
+
+    result = kzcMemoryAllocArray(memoryManager, testData->samples, testData->sampleCount * LAUNCH_OVERHEAD_MEASUREMENT_COUNT, "Launch overhead samples");
+    kzsErrorForward(result);
+
+    result = bfTimerCreate(memoryManager, &testData->timer);
+    kzsErrorForward(result);
+
+    /* Each frame takes all samples of one measurement. */
+    bfSceneSetFrameCounter(scene, LAUNCH_OVERHEAD_MEASUREMENT_COUNT);
+    bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
+
+    result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
+    kzsErrorForward(result);
+
+    {
+        struct KzuMaterialType* materialType;
+        result = kzuProjectLoaderLoadMaterial(bfGetProject(framework), "Materials/LoadBarTexture/IntervalSceneLoadBar", &testData->loadingMaterial);
+        kzsErrorForward(result);
+        materialType = kzuMaterialGetMaterialType(testData->loadingMaterial);
+        testData->loadingPropertyType = kzuMaterialTypeGetPropertyTypeByName(materialType, "LoadAmount");
+    }
+
+    kzsSuccess();
+}
+
+kzsError launchOverheadSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint measurement;
+    kzUint warmupTime;
+    kzUint i;
+    struct LaunchOverheadTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    measurement = bfSceneGetFrameInitialCounterValue(scene) - bfSceneGetFrameCounterValue(scene);
+
+    /* First sample is discarded, as it includes lazy kernel setup in many runtimes. */
+    result = launchOverheadMeasure_internal(testData, measurement, &warmupTime);
+    kzsErrorForward(result);
+
+    for(i = 0; i < testData->sampleCount; ++i)
+    {
+        result = launchOverheadMeasure_internal(testData, measurement, &testData->samples[measurement * testData->sampleCount + i]);
+        kzsErrorForward(result);
+    }
+
+    {
+        kzUint framesElapsed = bfSceneGetFrameCounterValue(scene);
+        struct KzuPropertyManager* propertyManager = kzuMaterialGetPropertyManager(testData->loadingMaterial);
+        kzFloat loadingAmount = 1.0f - framesElapsed / ((kzFloat)bfSceneGetFrameInitialCounterValue(scene));
+        result = kzuPropertyManagerSetFloat(propertyManager, testData->loadingMaterial, testData->loadingPropertyType, loadingAmount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError launchOverheadSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    kzUint measurement;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct LaunchOverheadTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(measurement = 0; measurement < LAUNCH_OVERHEAD_MEASUREMENT_COUNT; ++measurement)
+    {
+        struct XMLNode* measurementNode;
+        struct XMLAttribute* nameAttribute;
+        kzUint* samples = &testData->samples[measurement * testData->sampleCount];
+        kzUint i;
+
+        result = XMLNodeCreateContainer(memoryManager, "launchOverhead", &measurementNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, measurementNode);
+        kzsErrorForward(result);
+
+        if(measurement < LAUNCH_OVERHEAD_SET_ARGUMENTS)
+        {
+            result = XMLAttributeCreateString(memoryManager, "measurement", launchOverheadMeasurementNames[measurement], &nameAttribute);
+            kzsErrorForward(result);
+        }
+        else
+        {
+            kzMutableString name;
+            result = kzcStringFormat(memoryManager, "setKernelArguments%u", &name, 1u << (measurement - LAUNCH_OVERHEAD_SET_ARGUMENTS));
+            kzsErrorForward(result);
+            result = XMLAttributeCreateString(memoryManager, "measurement", name, &nameAttribute);
+            kzsErrorForward(result);
+            result = kzcStringDelete(name);
+            kzsErrorForward(result);
+        }
+        result = XMLNodeAddAttribute(measurementNode, nameAttribute);
+        kzsErrorForward(result);
+
+        /* Percentiles are in nanoseconds. */
+        for(i = 0; i < sizeof(launchOverheadPercentiles) / sizeof(launchOverheadPercentiles[0]); ++i)
+        {
+            kzUint value = bfScoreCalculatePercentile(samples, testData->sampleCount, launchOverheadPercentiles[i]);
+            result = bfInfoAddInteger(memoryManager, measurementNode, launchOverheadPercentileNames[i], (kzInt)value);
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+kzsError launchOverheadSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    kzUint i;
+    struct LaunchOverheadTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = bfTimerDelete(testData->timer);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->samples);
+    kzsErrorForward(result);
+
+    for(i = 0; i < LAUNCH_OVERHEAD_ARGUMENT_KERNEL_COUNT; ++i)
+    {
+        clResult = clReleaseKernel(testData->argumentKernels[i]);
+        cluClErrorTest(clResult);
+    }
+    clResult = clReleaseKernel(testData->emptyKernel);
+    cluClErrorTest(clResult);
+    clResult = clReleaseProgram(testData->program);
+    cluClErrorTest(clResult);
+    clResult = clReleaseCommandQueue(testData->queue);
+    cluClErrorTest(clResult);
+
+    kzsSuccess();
+}
+
+
+kzsError launchOverheadTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct BfScene* scene;
+    struct BfSceneConfiguration* configuration;
+    struct LaunchOverheadTestState* testData = KZ_NULL;
+
+    result = bfTestConfigurationInitialize(memoryManager, launchOverheadSceneLoad, launchOverheadSceneUpdate, KZ_NULL,
+        launchOverheadSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
+    kzsErrorForward(result);
+    configuration->report_private = launchOverheadSceneReport;
+
+    result = kzcMemoryAllocVariable(memoryManager, testData, "OpenCL launch overhead test internal data");
+    kzsErrorForward(result);
+    result = bfSceneCreate(framework, configuration, "Launch Overhead Test", "General", testData, &scene);
+    kzsErrorForward(result);
+
+    *out_scene = scene;
+    kzsSuccess();
+}
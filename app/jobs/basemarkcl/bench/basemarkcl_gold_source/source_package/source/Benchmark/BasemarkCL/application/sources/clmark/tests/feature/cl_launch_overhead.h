@@ -0,0 +1,23 @@
+/**
+* \file
+* Kernel launch and synchronization overhead test. Measures dispatch costs with empty kernels.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CL_LAUNCH_OVERHEAD_H
+#define CL_LAUNCH_OVERHEAD_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct BfScene;
+struct BenchmarkFramework;
+
+
+/** Create the launch overhead test. */
+kzsError launchOverheadTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+
+
+#endif
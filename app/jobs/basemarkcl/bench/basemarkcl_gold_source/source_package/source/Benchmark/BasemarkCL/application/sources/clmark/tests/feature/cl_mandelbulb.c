@@ -185,7 +185,7 @@ kzsError mandelbulbSceneLoad(struct BenchmarkFramework* framework, struct BfScen
         result = bfValidateFile(framework, "data/mandelbulb.cl", MANDELBULB_HASH, &isValid);
         kzsErrorForward(result);
         bfSceneSetValidConfigurationData(scene, isValid);
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/mandelbulb.cl", KZ_FALSE, compilerSettings, testData->context, &testData->mandelbulbProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/mandelbulb.cl", KZ_FALSE, compilerSettings, testData->context, &testData->mandelbulbProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
@@ -0,0 +1,664 @@
+/**
+* \file
+* Host/device memory bandwidth test. Measures transfer paths over a sweep of sizes.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "cl_memory_bandwidth.h"
+
+#include <benchmarkutil/bf_benchmark_framework.h>
+#include <benchmarkutil/scene/bf_scene.h>
+#include <benchmarkutil/settings/bf_settings.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_timer.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
+
+#include <clutil/clu_util.h>
+
+#include <application/kza_application.h>
+
+#include <user/project/kzu_project_loader_material.h>
+#include <user/properties/kzu_property_manager.h>
+#include <user/properties/kzu_float_property.h>
+#include <user/material/kzu_material.h>
+#include <user/material/kzu_material_type.h>
+
+#include <core/memory/kzc_memory_manager.h>
+
+#include <system/wrappers/kzs_math.h>
+#include <system/wrappers/kzs_memory.h>
+
+#include <clutil/clu_opencl_base.h>
+
+
+/** Smallest transfer size in bytes. Size doubles on each step. */
+#define MEMORY_BANDWIDTH_MIN_SIZE (4 * 1024)
+/** Largest transfer size in bytes. */
+#define MEMORY_BANDWIDTH_MAX_SIZE (256 * 1024 * 1024)
+/** Bytes moved for each measurement. Small transfers are repeated up to this amount. */
+#define MEMORY_BANDWIDTH_TARGET_BYTES (64 * 1024 * 1024)
+/** Minimum number of transfers in each measurement. */
+#define MEMORY_BANDWIDTH_MIN_ITERATIONS 3
+/** Maximum number of transfers in each measurement. Allows the smallest size to reach the target bytes. */
+#define MEMORY_BANDWIDTH_MAX_ITERATIONS (MEMORY_BANDWIDTH_TARGET_BYTES / MEMORY_BANDWIDTH_MIN_SIZE)
+/** Row pitch in bytes of the rectangular copies. */
+#define MEMORY_BANDWIDTH_RECT_ROW_PITCH 4096
+
+
+/** Measured transfer paths. */
+enum MemoryBandwidthTransfer
+{
+    MEMORY_BANDWIDTH_WRITE_PAGEABLE, /**< clEnqueueWriteBuffer from pageable host memory. */
+    MEMORY_BANDWIDTH_READ_PAGEABLE, /**< clEnqueueReadBuffer to pageable host memory. */
+    MEMORY_BANDWIDTH_WRITE_PINNED, /**< clEnqueueWriteBuffer from mapped CL_MEM_ALLOC_HOST_PTR memory. */
+    MEMORY_BANDWIDTH_READ_PINNED, /**< clEnqueueReadBuffer to mapped CL_MEM_ALLOC_HOST_PTR memory. */
+    MEMORY_BANDWIDTH_MAP_WRITE, /**< Map for writing, copy from host memory and unmap. */
+    MEMORY_BANDWIDTH_MAP_READ, /**< Map for reading, copy to host memory and unmap. */
+    MEMORY_BANDWIDTH_COPY_BUFFER, /**< clEnqueueCopyBuffer between device buffers. */
+    MEMORY_BANDWIDTH_COPY_BUFFER_RECT, /**< clEnqueueCopyBufferRect of half of each row between device buffers. */
+    MEMORY_BANDWIDTH_WRITE_IMAGE, /**< clEnqueueWriteImage of RGBA-8888 image from pageable host memory. */
+    MEMORY_BANDWIDTH_READ_IMAGE, /**< clEnqueueReadImage of RGBA-8888 image to pageable host memory. */
+    MEMORY_BANDWIDTH_TRANSFER_COUNT /**< Number of transfer paths. */
+};
+
+/** Names of the transfer paths in report. */
+static kzString memoryBandwidthTransferNames[MEMORY_BANDWIDTH_TRANSFER_COUNT] =
+{
+    "writeBufferPageable",
+    "readBufferPageable",
+    "writeBufferPinned",
+    "readBufferPinned",
+    "mapWrite",
+    "mapRead",
+    "copyBuffer",
+    "copyBufferRect",
+    "writeImage",
+    "readImage"
+};
+
+
+/** Memory bandwidth test state. */
+struct MemoryBandwidthTestState
+{
+    cl_context context; /**< OpenCL context. */
+    cl_device_id device; /**< OpenCL device. */
+    cl_command_queue queue; /**< Command queue for transfers. */
+
+    kzUint sizeCount; /**< Number of transfer sizes. */
+    kzUint* sizes; /**< Transfer sizes in bytes. */
+    kzUint* bandwidths; /**< Bandwidth of each transfer path and size in megabytes per second. Zero if not measured. */
+    kzUint* latencies; /**< Fastest single transfer of each transfer path and size in microseconds. */
+    kzUint maxAllocationSize; /**< Largest buffer the device allows. */
+    kzBool imageSupport; /**< Does device support images. */
+    kzUint maxImageWidth; /**< Maximum width of 2D image. */
+    kzUint maxImageHeight; /**< Maximum height of 2D image. */
+
+    /* Resources of the current size, created when measuring of the size starts. */
+    kzBool resourcesValid; /**< Were all buffers of the current size created. */
+    void* hostMemory; /**< Pageable host memory. Allocated outside memory manager, as the largest sizes exceed its pool. */
+    cl_mem pinnedBuffer; /**< Host allocated buffer providing pinned host memory. */
+    void* pinnedMemory; /**< Mapped pointer to pinnedBuffer. */
+    cl_mem sourceBuffer; /**< Device buffer. */
+    cl_mem destinationBuffer; /**< Device buffer for copies. */
+    cl_mem image; /**< Device image, KZ_NULL if images are not supported at current size. */
+    kzUint imageWidth; /**< Width of image. */
+    kzUint imageHeight; /**< Height of image. */
+
+    struct BfTimer* timer; /**< Timer for measuring transfers. */
+
+    struct KzuMaterial* loadingMaterial; /**< Material used to render progress bar. */
+    struct KzuPropertyType* loadingPropertyType; /**< Property driving progress bar position. */
+};
+
+
+/** Creates host memory, buffers and image used for transfers of given size. Resources are left invalid if the device can not allocate them. */
+static kzsError memoryBandwidthCreateResources_internal(struct MemoryBandwidthTestState* testData, kzUint size);
+/** Releases resources created for current size. */
+static kzsError memoryBandwidthReleaseResources_internal(struct MemoryBandwidthTestState* testData);
+/** Runs one blocking transfer of given path. Returns number of bytes moved, zero if path is not available at this size. */
+static kzsError memoryBandwidthTransfer_internal(const struct MemoryBandwidthTestState* testData, enum MemoryBandwidthTransfer transfer,
+                                                 kzUint size, kzUint* out_bytes);
+
+
+static kzsError memoryBandwidthCreateResources_internal(struct MemoryBandwidthTestState* testData, kzUint size)
+{
+    cl_int clResult = CL_SUCCESS;
+    kzBool valid = KZ_TRUE;
+
+    testData->hostMemory = KZ_NULL;
+    testData->pinnedBuffer = KZ_NULL;
+    testData->pinnedMemory = KZ_NULL;
+    testData->sourceBuffer = KZ_NULL;
+    testData->destinationBuffer = KZ_NULL;
+    testData->image = KZ_NULL;
+
+    /* Allocation failures are not errors, largest sizes are expected to fail on small devices. */
+    if(size > testData->maxAllocationSize)
+    {
+        valid = KZ_FALSE;
+    }
+
+    if(valid)
+    {
+        testData->hostMemory = kzsMalloc(size);
+        valid = (testData->hostMemory != KZ_NULL);
+    }
+    if(valid)
+    {
+        kzsMemset(testData->hostMemory, 0x5a, size);
+        testData->pinnedBuffer = clCreateBuffer(testData->context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size, KZ_NULL, &clResult);
+        valid = (clResult == CL_SUCCESS);
+    }
+    if(valid)
+    {
+        /* Mapped host allocated buffer is the portable way to get page locked memory for transfers. */
+        testData->pinnedMemory = clEnqueueMapBuffer(testData->queue, testData->pinnedBuffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size,
+                                                    0, KZ_NULL, KZ_NULL, &clResult);
+        valid = (clResult == CL_SUCCESS);
+    }
+    if(valid)
+    {
+        testData->sourceBuffer = clCreateBuffer(testData->context, CL_MEM_READ_WRITE, size, KZ_NULL, &clResult);
+        valid = (clResult == CL_SUCCESS);
+    }
+    if(valid)
+    {
+        testData->destinationBuffer = clCreateBuffer(testData->context, CL_MEM_READ_WRITE, size, KZ_NULL, &clResult);
+        valid = (clResult == CL_SUCCESS);
+    }
+    if(valid)
+    {
+        /* Force the buffers to be resident on the device before timing. Devices allocating lazily report running out of memory only here. */
+        clResult = clEnqueueWriteBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, 0, size, testData->hostMemory, 0, KZ_NULL, KZ_NULL);
+        if(clResult == CL_SUCCESS)
+        {
+            clResult = clEnqueueCopyBuffer(testData->queue, testData->sourceBuffer, testData->destinationBuffer, 0, 0, size, 0, KZ_NULL, KZ_NULL);
+        }
+        if(clResult == CL_SUCCESS)
+        {
+            clResult = clFinish(testData->queue);
+        }
+        if(clResult == CL_MEM_OBJECT_ALLOCATION_FAILURE || clResult == CL_OUT_OF_RESOURCES)
+        {
+            valid = KZ_FALSE;
+        }
+        else
+        {
+            cluClErrorTest(clResult);
+        }
+    }
+
+    /* Image is as square as possible. Sizes exceeding the device limits are skipped. */
+    if(valid && testData->imageSupport)
+    {
+        kzUint texelCount = size / 4;
+        kzUint width = 1;
+        kzUint height;
+        while(width * width < texelCount)
+        {
+            width *= 2;
+        }
+        height = texelCount / width;
+
+        if(width <= testData->maxImageWidth && height <= testData->maxImageHeight)
+        {
+            cl_image_format format;
+            format.image_channel_order = CL_RGBA;
+            format.image_channel_data_type = CL_UNORM_INT8;
+            testData->image = clCreateImage2D(testData->context, CL_MEM_READ_WRITE, &format, width, height, 0, KZ_NULL, &clResult);
+            if(clResult == CL_SUCCESS)
+            {
+                testData->imageWidth = width;
+                testData->imageHeight = height;
+            }
+            else
+            {
+                testData->image = KZ_NULL;
+            }
+        }
+    }
+
+    testData->resourcesValid = valid;
+    kzsSuccess();
+}
+
+static kzsError memoryBandwidthReleaseResources_internal(struct MemoryBandwidthTestState* testData)
+{
+    cl_int clResult;
+
+    if(testData->image != KZ_NULL)
+    {
+        clResult = clReleaseMemObject(testData->image);
+        cluClErrorTest(clResult);
+        testData->image = KZ_NULL;
+    }
+    if(testData->destinationBuffer != KZ_NULL)
+    {
+        clResult = clReleaseMemObject(testData->destinationBuffer);
+        cluClErrorTest(clResult);
+        testData->destinationBuffer = KZ_NULL;
+    }
+    if(testData->sourceBuffer != KZ_NULL)
+    {
+        clResult = clReleaseMemObject(testData->sourceBuffer);
+        cluClErrorTest(clResult);
+        testData->sourceBuffer = KZ_NULL;
+    }
+    if(testData->pinnedMemory != KZ_NULL)
+    {
+        clResult = clEnqueueUnmapMemObject(testData->queue, testData->pinnedBuffer, testData->pinnedMemory, 0, KZ_NULL, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clFinish(testData->queue);
+        cluClErrorTest(clResult);
+        testData->pinnedMemory = KZ_NULL;
+    }
+    if(testData->pinnedBuffer != KZ_NULL)
+    {
+        clResult = clReleaseMemObject(testData->pinnedBuffer);
+        cluClErrorTest(clResult);
+        testData->pinnedBuffer = KZ_NULL;
+    }
+    if(testData->hostMemory != KZ_NULL)
+    {
+        kzsFree(testData->hostMemory);
+        testData->hostMemory = KZ_NULL;
+    }
+
+    testData->resourcesValid = KZ_FALSE;
+    kzsSuccess();
+}
+
+static kzsError memoryBandwidthTransfer_internal(const struct MemoryBandwidthTestState* testData, enum MemoryBandwidthTransfer transfer,
+                                                 kzUint size, kzUint* out_bytes)
+{
+    cl_int clResult;
+    kzUint bytes = size;
+
+    switch(transfer)
+    {
+        case MEMORY_BANDWIDTH_WRITE_PAGEABLE:
+        {
+            clResult = clEnqueueWriteBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, 0, size, testData->hostMemory, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_READ_PAGEABLE:
+        {
+            clResult = clEnqueueReadBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, 0, size, testData->hostMemory, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_WRITE_PINNED:
+        {
+            clResult = clEnqueueWriteBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, 0, size, testData->pinnedMemory, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_READ_PINNED:
+        {
+            clResult = clEnqueueReadBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, 0, size, testData->pinnedMemory, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_MAP_WRITE:
+        case MEMORY_BANDWIDTH_MAP_READ:
+        {
+            /* Data is copied through the mapping, so the transfer can not be deferred past unmap. */
+            kzBool write = (transfer == MEMORY_BANDWIDTH_MAP_WRITE);
+            void* mapped = clEnqueueMapBuffer(testData->queue, testData->sourceBuffer, CL_TRUE, write ? CL_MAP_WRITE : CL_MAP_READ, 0, size,
+                                              0, KZ_NULL, KZ_NULL, &clResult);
+            cluClErrorTest(clResult);
+            if(write)
+            {
+                kzsMemcpy(mapped, testData->hostMemory, size);
+            }
+            else
+            {
+                kzsMemcpy(testData->hostMemory, mapped, size);
+            }
+            clResult = clEnqueueUnmapMemObject(testData->queue, testData->sourceBuffer, mapped, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_COPY_BUFFER:
+        {
+            clResult = clEnqueueCopyBuffer(testData->queue, testData->sourceBuffer, testData->destinationBuffer, 0, 0, size, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            break;
+        }
+        case MEMORY_BANDWIDTH_COPY_BUFFER_RECT:
+        {
+            /* Left half of each row is copied to right half of the row, giving strided access on both sides. */
+            size_t rowPitch = kzsMinU(size, MEMORY_BANDWIDTH_RECT_ROW_PITCH);
+            size_t sourceOrigin[3] = {0, 0, 0};
+            size_t destinationOrigin[3];
+            size_t region[3];
+            destinationOrigin[0] = rowPitch / 2;
+            destinationOrigin[1] = 0;
+            destinationOrigin[2] = 0;
+            region[0] = rowPitch / 2;
+            region[1] = size / rowPitch;
+            region[2] = 1;
+            clResult = clEnqueueCopyBufferRect(testData->queue, testData->sourceBuffer, testData->destinationBuffer, sourceOrigin, destinationOrigin,
+                                               region, rowPitch, 0, rowPitch, 0, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+            bytes = (kzUint)(region[0] * region[1]);
+            break;
+        }
+        case MEMORY_BANDWIDTH_WRITE_IMAGE:
+        case MEMORY_BANDWIDTH_READ_IMAGE:
+        {
+            if(testData->image != KZ_NULL)
+            {
+                size_t origin[3] = {0, 0, 0};
+                size_t region[3];
+                region[0] = testData->imageWidth;
+                region[1] = testData->imageHeight;
+                region[2] = 1;
+                if(transfer == MEMORY_BANDWIDTH_WRITE_IMAGE)
+                {
+                    clResult = clEnqueueWriteImage(testData->queue, testData->image, CL_TRUE, origin, region, 0, 0, testData->hostMemory, 0, KZ_NULL, KZ_NULL);
+                }
+                else
+                {
+                    clResult = clEnqueueReadImage(testData->queue, testData->image, CL_TRUE, origin, region, 0, 0, testData->hostMemory, 0, KZ_NULL, KZ_NULL);
+                }
+                cluClErrorTest(clResult);
+                bytes = testData->imageWidth * testData->imageHeight * 4;
+            }
+            else
+            {
+                bytes = 0;
+            }
+            break;
+        }
+        case MEMORY_BANDWIDTH_TRANSFER_COUNT:
+        default:
+        {
+            kzsErrorThrow(KZS_ERROR_ILLEGAL_ARGUMENT, "Invalid memory bandwidth transfer");
+        }
+    }
+
+    /* Non-blocking commands are finished here so that each transfer is timed to completion. */
+    if(bytes > 0)
+    {
+        clResult = clFinish(testData->queue);
+        cluClErrorTest(clResult);
+    }
+
+    *out_bytes = bytes;
+    kzsSuccess();
+}
+
+
+kzsError memoryBandwidthSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError memoryBandwidthSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
+kzsError memoryBandwidthSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError memoryBandwidthSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+
+kzsError memoryBandwidthSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    kzUint i;
+    kzUint maxSize;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct MemoryBandwidthTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    testData->context = bfGetClContext(framework);
+    clResult = clGetContextInfo(testData->context, CL_CONTEXT_DEVICES, sizeof(cl_device_id), &testData->device, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    /* Profiling is not enabled, transfers are timed on host to include the runtime overhead. */
+    testData->queue = clCreateCommandQueue(testData->context, testData->device, 0, &clResult);
+    cluClErrorTest(clResult);
+
+    {
+        cl_ulong maxAllocationSize;
+        cl_bool imageSupport;
+        size_t maxImageWidth;
+        size_t maxImageHeight;
+        clResult = clGetDeviceInfo(testData->device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(maxAllocationSize), &maxAllocationSize, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clGetDeviceInfo(testData->device, CL_DEVICE_IMAGE_SUPPORT, sizeof(imageSupport), &imageSupport, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clGetDeviceInfo(testData->device, CL_DEVICE_IMAGE2D_MAX_WIDTH, sizeof(maxImageWidth), &maxImageWidth, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clGetDeviceInfo(testData->device, CL_DEVICE_IMAGE2D_MAX_HEIGHT, sizeof(maxImageHeight), &maxImageHeight, KZ_NULL);
+        cluClErrorTest(clResult);
+        testData->maxAllocationSize = (kzUint)((maxAllocationSize > MEMORY_BANDWIDTH_MAX_SIZE) ? MEMORY_BANDWIDTH_MAX_SIZE : maxAllocationSize);
+        testData->imageSupport = (imageSupport != CL_FALSE);
+        testData->maxImageWidth = (kzUint)maxImageWidth;
+        testData->maxImageHeight = (kzUint)maxImageHeight;
+    }
+
+    {
+        kzInt maxSizeSetting;
+        result = settingGetInt(bfGetSettings(framework), "MemoryBandwidthMaxSize", &maxSizeSetting);
+        kzsErrorForward(result);
+        maxSize = (kzUint)kzsClampi(maxSizeSetting, 1, MEMORY_BANDWIDTH_MAX_SIZE / (1024 * 1024)) * 1024 * 1024;
+    }
+
+    testData->sizeCount = 0;
+    for(i = MEMORY_BANDWIDTH_MIN_SIZE; i <= maxSize; i *= 2)
+    {
+        ++testData->sizeCount;
+    }
+
+    result = kzcMemoryAllocArray(memoryManager, testData->sizes, testData->sizeCount, "Memory bandwidth sizes");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->bandwidths, testData->sizeCount * MEMORY_BANDWIDTH_TRANSFER_COUNT, "Memory bandwidths");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, testData->latencies, testData->sizeCount * MEMORY_BANDWIDTH_TRANSFER_COUNT, "Memory bandwidth latencies");
+    kzsErrorForward(result);
+
+    for(i = 0; i < testData->sizeCount; ++i)
+    {
+        testData->sizes[i] = MEMORY_BANDWIDTH_MIN_SIZE << i;
+    }
+    for(i = 0; i < testData->sizeCount * MEMORY_BANDWIDTH_TRANSFER_COUNT; ++i)
+    {
+        testData->bandwidths[i] = 0;
+        testData->latencies[i] = 0;
+    }
+
+    testData->resourcesValid = KZ_FALSE;
+    testData->hostMemory = KZ_NULL;
+    testData->pinnedBuffer = KZ_NULL;
+    testData->pinnedMemory = KZ_NULL;
+    testData->sourceBuffer = KZ_NULL;
+    testData->destinationBuffer = KZ_NULL;
+    testData->image = KZ_NULL;
+
+    result = bfTimerCreate(memoryManager, &testData->timer);
+    kzsErrorForward(result);
+
+    /* Each frame measures all transfer paths of one size. */
+    bfSceneSetFrameCounter(scene, testData->sizeCount);
+    bfSceneDisableFromOverallScore(scene);
+    bfSceneDisableAdaptiveRunLength(scene);
+
+    result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/ProgressBar");
+    kzsErrorForward(result);
+
+    {
+        struct KzuMaterialType* materialType;
+        result = kzuProjectLoaderLoadMaterial(bfGetProject(framework), "Materials/LoadBarTexture/IntervalSceneLoadBar", &testData->loadingMaterial);
+        kzsErrorForward(result);
+        materialType = kzuMaterialGetMaterialType(testData->loadingMaterial);
+        testData->loadingPropertyType = kzuMaterialTypeGetPropertyTypeByName(materialType, "LoadAmount");
+    }
+
+    kzsSuccess();
+}
+
+kzsError memoryBandwidthSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
+{
+    kzsError result;
+    kzUint sizeIndex;
+    kzUint size;
+    kzUint transfer;
+    struct MemoryBandwidthTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    sizeIndex = bfSceneGetFrameInitialCounterValue(scene) - bfSceneGetFrameCounterValue(scene);
+    size = testData->sizes[sizeIndex];
+
+    result = memoryBandwidthCreateResources_internal(testData, size);
+    kzsErrorForward(result);
+
+    if(testData->resourcesValid)
+    {
+        kzUint iterationCount = kzsClampi(MEMORY_BANDWIDTH_TARGET_BYTES / size, MEMORY_BANDWIDTH_MIN_ITERATIONS, MEMORY_BANDWIDTH_MAX_ITERATIONS);
+
+        for(transfer = 0; transfer < MEMORY_BANDWIDTH_TRANSFER_COUNT; ++transfer)
+        {
+            kzUint index = transfer * testData->sizeCount + sizeIndex;
+            kzUint bytes;
+            kzUint totalTime = 0;
+            kzUint fastestTime = KZ_UINT_MAXIMUM;
+            kzUint iteration;
+
+            /* First transfer is not timed, as it may include lazy allocation and migration of the buffers. */
+            result = memoryBandwidthTransfer_internal(testData, (enum MemoryBandwidthTransfer)transfer, size, &bytes);
+            kzsErrorForward(result);
+
+            for(iteration = 0; iteration < iterationCount && bytes > 0; ++iteration)
+            {
+                kzUint startTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer);
+                kzUint elapsedTime;
+                result = memoryBandwidthTransfer_internal(testData, (enum MemoryBandwidthTransfer)transfer, size, &bytes);
+                kzsErrorForward(result);
+                elapsedTime = bfTimerGetElapsedTimeInMicroSeconds(testData->timer) - startTime;
+                totalTime += elapsedTime;
+                fastestTime = kzsMinU(fastestTime, elapsedTime);
+            }
+
+            if(bytes > 0)
+            {
+                /* Bytes per microsecond is megabytes per second. */
+                kzFloat bandwidth = (kzFloat)bytes * iterationCount / kzsMaxU(totalTime, 1);
+                testData->bandwidths[index] = (kzUint)bandwidth;
+                testData->latencies[index] = fastestTime;
+            }
+        }
+    }
+
+    result = memoryBandwidthReleaseResources_internal(testData);
+    kzsErrorForward(result);
+
+    {
+        kzUint framesElapsed = bfSceneGetFrameCounterValue(scene);
+        struct KzuPropertyManager* propertyManager = kzuMaterialGetPropertyManager(testData->loadingMaterial);
+        kzFloat loadingAmount = 1.0f - framesElapsed / ((kzFloat)bfSceneGetFrameInitialCounterValue(scene));
+        result = kzuPropertyManagerSetFloat(propertyManager, testData->loadingMaterial, testData->loadingPropertyType, loadingAmount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError memoryBandwidthSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    kzUint transfer;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct MemoryBandwidthTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    for(transfer = 0; transfer < MEMORY_BANDWIDTH_TRANSFER_COUNT; ++transfer)
+    {
+        struct XMLNode* transferNode;
+        struct XMLAttribute* nameAttribute;
+        kzUint first = transfer * testData->sizeCount;
+        kzUint peakBandwidth = 0;
+        kzUint i;
+
+        for(i = 0; i < testData->sizeCount; ++i)
+        {
+            peakBandwidth = kzsMaxU(peakBandwidth, testData->bandwidths[first + i]);
+        }
+
+        result = XMLNodeCreateContainer(memoryManager, "memoryBandwidth", &transferNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, transferNode);
+        kzsErrorForward(result);
+        result = XMLAttributeCreateString(memoryManager, "transfer", memoryBandwidthTransferNames[transfer], &nameAttribute);
+        kzsErrorForward(result);
+        result = XMLNodeAddAttribute(transferNode, nameAttribute);
+        kzsErrorForward(result);
+
+        /* Latency of the smallest transfer is dominated by the fixed cost of a command. */
+        result = bfInfoAddScalar(memoryManager, transferNode, "peakBandwidthGBs", peakBandwidth / 1000.0f);
+        kzsErrorForward(result);
+        result = bfInfoAddInteger(memoryManager, transferNode, "smallTransferLatency", (kzInt)testData->latencies[first]);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, transferNode, "sizes", testData->sizes, testData->sizeCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, transferNode, "bandwidthMBs", &testData->bandwidths[first], testData->sizeCount);
+        kzsErrorForward(result);
+        result = bfInfoAddSeries(memoryManager, transferNode, "latencies", &testData->latencies[first], testData->sizeCount);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError memoryBandwidthSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene)
+{
+    kzsError result;
+    cl_int clResult;
+    struct MemoryBandwidthTestState* testData;
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = memoryBandwidthReleaseResources_internal(testData);
+    kzsErrorForward(result);
+
+    clResult = clReleaseCommandQueue(testData->queue);
+    cluClErrorTest(clResult);
+
+    result = bfTimerDelete(testData->timer);
+    kzsErrorForward(result);
+
+    result = kzcMemoryFreeArray(testData->latencies);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->bandwidths);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(testData->sizes);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+
+kzsError memoryBandwidthTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
+    struct BfScene* scene;
+    struct BfSceneConfiguration* configuration;
+    struct MemoryBandwidthTestState* testData = KZ_NULL;
+
+    result = bfTestConfigurationInitialize(memoryManager, memoryBandwidthSceneLoad, memoryBandwidthSceneUpdate, KZ_NULL,
+        memoryBandwidthSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
+    kzsErrorForward(result);
+    configuration->report_private = memoryBandwidthSceneReport;
+
+    result = kzcMemoryAllocVariable(memoryManager, testData, "OpenCL memory bandwidth test internal data");
+    kzsErrorForward(result);
+    result = bfSceneCreate(framework, configuration, "Memory Bandwidth Test", "General", testData, &scene);
+    kzsErrorForward(result);
+
+    *out_scene = scene;
+    kzsSuccess();
+}
@@ -0,0 +1,23 @@
+/**
+* \file
+* Host/device memory bandwidth test. Measures transfer paths over a sweep of sizes.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CL_MEMORY_BANDWIDTH_H
+#define CL_MEMORY_BANDWIDTH_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct BfScene;
+struct BenchmarkFramework;
+
+
+/** Create the memory bandwidth test. */
+kzsError memoryBandwidthTestCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+
+
+#endif
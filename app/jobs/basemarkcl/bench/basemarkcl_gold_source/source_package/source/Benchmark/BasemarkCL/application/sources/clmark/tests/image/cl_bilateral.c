@@ -55,7 +55,7 @@ kzsError initBilateral(struct BenchmarkFramework* framework, struct BfScene* sce
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/bilateral.cl", KZ_FALSE, compilerSettings, context, &filter->bilateralProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/bilateral.cl", KZ_FALSE, compilerSettings, context, &filter->bilateralProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
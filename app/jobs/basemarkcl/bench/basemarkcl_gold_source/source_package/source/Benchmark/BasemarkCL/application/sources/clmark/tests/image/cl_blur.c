@@ -68,7 +68,7 @@ kzsError initBlur( struct BenchmarkFramework* framework, struct BfScene* scene,
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/separable_convolution2d.cl", KZ_FALSE, compilerSettings, context, &filter->blurProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/separable_convolution2d.cl", KZ_FALSE, compilerSettings, context, &filter->blurProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
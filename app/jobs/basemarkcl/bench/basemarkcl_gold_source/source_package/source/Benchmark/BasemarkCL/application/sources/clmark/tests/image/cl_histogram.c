@@ -75,7 +75,7 @@ kzsError initHistogram(struct BenchmarkFramework* framework, struct BfScene* sce
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/histogram.cl", KZ_FALSE, compilerSettings, context, &filter->histogramProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/histogram.cl", KZ_FALSE, compilerSettings, context, &filter->histogramProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
@@ -40,6 +40,7 @@
 #include <clutil/clu_kernel.h>
 #include <clutil/clu_util.h>
 #include <clutil/clu_image.h>
+#include <clutil/clu_image_cache.h>
 #include <clutil/clu_profiler.h>
 
 #include <clmark/test_definitions.h>
@@ -69,6 +70,16 @@ const kzString imageTestImagePaths[IMAGE_TEST_IMAGE_COUNT] =
     "data/photo5.png"
 };
 
+/** MD5 hashes of the image test images. */
+const kzString imageTestImageHashes[IMAGE_TEST_IMAGE_COUNT] = 
+{
+    IMAGE_TEST_HASH1,
+    IMAGE_TEST_HASH2,
+    IMAGE_TEST_HASH3,
+    IMAGE_TEST_HASH4,
+    IMAGE_TEST_HASH5
+};
+
 
 struct ImageTestData
 {
@@ -80,6 +91,7 @@ struct ImageTestData
     cl_mem originalImage; /**< Unmodified image for tests which do not iterate the used filter */
     cl_mem testImage; /**< Original image where the picture is initially loaded */
     struct KzcImage* kzTestImage;
+    struct CluCachedImage* cachedTestImage; /**< Test image mapped from image cache. KZ_NULL if test image is loaded as kzTestImage. */
     cl_mem outputImage; /**< Filtered image which is actually displayed */
 
     kzBool useImagePreloading; /**< Is image preloading enabled. */
@@ -127,6 +139,15 @@ kzsError sharpeningSceneLoad(struct BenchmarkFramework* framework, struct BfScen
 kzsError sharpeningSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
 kzsError sharpeningSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
 
+/** Loads test image of given index, either from preloaded images, from image cache or by decoding the PNG file. */
+static kzsError imageSceneLoadTestImage_internal(struct BenchmarkFramework* framework, struct ImageTestData* testData, kzUint imageIndex);
+/** Releases current test image. */
+static kzsError imageSceneReleaseTestImage_internal(const struct ImageTestData* testData);
+/** Returns RGBA-8888 pixels of current test image. */
+static void* imageSceneGetTestImageData_internal(const struct ImageTestData* testData);
+/** Creates texture of the unprocessed current test image. */
+static kzsError imageSceneCreateOriginalTexture_internal(const struct BenchmarkFramework* framework, const struct ImageTestData* testData, struct KzcTexture** out_texture);
+
 
 /* Basic initialization every image test frame needs */
 void cleanAndAcquire( struct ImageTestData ** testData, struct BfScene* scene, cl_int *clResult ) 
@@ -497,16 +518,7 @@ kzsError imageSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
             for(i = 0; i < IMAGE_TEST_IMAGE_COUNT; ++i)
             {
                 kzBool isValid;
-                kzString hash;
-                switch(i)
-                {
-                    case 0: hash = IMAGE_TEST_HASH1; break;
-                    case 1: hash = IMAGE_TEST_HASH2; break;
-                    case 2: hash = IMAGE_TEST_HASH3; break;
-                    case 3: hash = IMAGE_TEST_HASH4; break;
-                    default: hash = IMAGE_TEST_HASH5; break;
-                }
-                result = bfValidateFile(framework, imageTestImagePaths[i], hash, &isValid);
+                result = bfValidateFile(framework, imageTestImagePaths[i], imageTestImageHashes[i], &isValid);
                 kzsErrorForward(result); 
                 validImages &= isValid;
             }
@@ -514,16 +526,8 @@ kzsError imageSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
         }
     }
 
-    if(testData->useImagePreloading)
-    {
-        testData->kzTestImage= testData->preloadedImages[0];
-        testData->testImage = testData->preloadedImageBuffers[0];
-    }
-    else
-    { 
-        result = cluImageLoadPNG(framework, imageTestImagePaths[0], testData->context, &testData->testImage, &testData->kzTestImage, testData->scaling);
-        kzsErrorForward(result);
-    }
+    result = imageSceneLoadTestImage_internal(framework, testData, 0);
+    kzsErrorForward(result);
 
     result = cluGetImageSize(testData->testImage, imsize);
     kzsErrorForward(result);
@@ -563,8 +567,7 @@ kzsError imageSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
         }
 #endif
 
-        result = kzcTextureCreateFromImage(kzuProjectGetResourceManager(bfGetProject(framework)), KZC_RESOURCE_MEMORY_TYPE_GPU_ONLY, 
-            KZC_TEXTURE_FILTER_BILINEAR, KZC_TEXTURE_WRAP_REPEAT, KZC_TEXTURE_COMPRESSION_NONE, testData->kzTestImage, &testData->textureOriginal);
+        result = imageSceneCreateOriginalTexture_internal(framework, testData, &testData->textureOriginal);
         kzsErrorForward(result);
 
 #if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
@@ -576,7 +579,7 @@ kzsError imageSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
             cl_image_format format;
             format.image_channel_order = CL_RGBA;
             format.image_channel_data_type = CL_UNORM_INT8;
-            testData->originalImage = clCreateImage2D(testData->context, CL_MEM_COPY_HOST_PTR|CL_MEM_READ_ONLY, &format, width, height, width * 4, kzcImageGetData(testData->kzTestImage), &clResult);
+            testData->originalImage = clCreateImage2D(testData->context, CL_MEM_COPY_HOST_PTR|CL_MEM_READ_ONLY, &format, width, height, width * 4, imageSceneGetTestImageData_internal(testData), &clResult);
             cluClErrorTest(clResult);
         }
 #endif
@@ -643,9 +646,7 @@ kzsError imageSceneUninitialize(struct BenchmarkFramework* framework, struct BfS
     }
     else
     {
-        result = kzcImageDelete(testData->kzTestImage);
-        kzsErrorForward(result);
-        result = clReleaseMemObject(testData->testImage);
+        result = imageSceneReleaseTestImage_internal(testData);
         kzsErrorForward(result);
     }
     
@@ -834,32 +835,19 @@ kzsError imageSceneRender(struct BenchmarkFramework* framework, struct BfScene*
         testData->activeImage = imageIndex;
 
         /* Release old image. */
-        {
-            result = kzcImageDelete(testData->kzTestImage);
-            kzsErrorForward(result);
-            result = clReleaseMemObject(testData->testImage);
-            kzsErrorForward(result);
-        }
+        result = imageSceneReleaseTestImage_internal(testData);
+        kzsErrorForward(result);
 
         /* Change the image in render function as this is not timed. */
         {
-            if(testData->useImagePreloading)
-            {
-                testData->testImage = testData->preloadedImageBuffers[imageIndex];
-                testData->kzTestImage = testData->preloadedImages[imageIndex];
-            }
-            else
-            {
-                result = cluImageLoadPNG(framework, imageTestImagePaths[imageIndex], testData->context, &testData->testImage, &testData->kzTestImage, testData->scaling);
-                kzsErrorForward(result); 
-            }
+            result = imageSceneLoadTestImage_internal(framework, testData, imageIndex);
+            kzsErrorForward(result);
             {
                 clResult = clReleaseMemObject(testData->originalImage);
                 cluClErrorTest(clResult);
                 result = kzcTextureDelete(testData->textureOriginal);
                 kzsErrorForward(result);
-                result = kzcTextureCreateFromImage(kzuProjectGetResourceManager(bfGetProject(framework)), KZC_RESOURCE_MEMORY_TYPE_GPU_ONLY, 
-                    KZC_TEXTURE_FILTER_BILINEAR, KZC_TEXTURE_WRAP_REPEAT, KZC_TEXTURE_COMPRESSION_NONE, testData->kzTestImage, &testData->textureOriginal);
+                result = imageSceneCreateOriginalTexture_internal(framework, testData, &testData->textureOriginal);
                 kzsErrorForward(result);
                 testData->originalImage = clCreateFromGLTexture2D(testData->context, CL_MEM_READ_ONLY, KZS_GL_TEXTURE_2D, 0, kzcTextureGetTextureHandle(testData->textureOriginal), &result);
                 cluClErrorTest(result);
@@ -896,3 +884,96 @@ kzsError imageSceneRender(struct BenchmarkFramework* framework, struct BfScene*
 
     kzsSuccess();
 }
+
+static kzsError imageSceneLoadTestImage_internal(struct BenchmarkFramework* framework, struct ImageTestData* testData, kzUint imageIndex)
+{
+    kzsError result;
+    struct CluImageCache* imageCache = bfGetImageCache(framework);
+
+    testData->cachedTestImage = KZ_NULL;
+    if(testData->useImagePreloading)
+    {
+        testData->testImage = testData->preloadedImageBuffers[imageIndex];
+        testData->kzTestImage = testData->preloadedImages[imageIndex];
+    }
+    else if(imageCache != KZ_NULL)
+    {
+        /* Decoded pixels are mapped from the cache and used by OpenCL in place, so no PNG is decoded and no copy is kept in memory. */
+        testData->kzTestImage = KZ_NULL;
+        result = cluImageCacheLoadPNG(imageCache, imageTestImagePaths[imageIndex], imageTestImageHashes[imageIndex], testData->scaling, testData->context,
+                                      &testData->testImage, &testData->cachedTestImage);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = cluImageLoadPNG(framework, imageTestImagePaths[imageIndex], testData->context, &testData->testImage, &testData->kzTestImage, testData->scaling);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+static kzsError imageSceneReleaseTestImage_internal(const struct ImageTestData* testData)
+{
+    kzsError result;
+    cl_int clResult;
+
+    if(testData->cachedTestImage != KZ_NULL)
+    {
+        /* Device may access the mapped pixels until the queued commands have completed. */
+        clResult = clFinish(testData->queue);
+        cluClErrorTest(clResult);
+        clResult = clReleaseMemObject(testData->testImage);
+        cluClErrorTest(clResult);
+        result = cluCachedImageDelete(testData->cachedTestImage);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = kzcImageDelete(testData->kzTestImage);
+        kzsErrorForward(result);
+        clResult = clReleaseMemObject(testData->testImage);
+        cluClErrorTest(clResult);
+    }
+
+    kzsSuccess();
+}
+
+static void* imageSceneGetTestImageData_internal(const struct ImageTestData* testData)
+{
+    void* data;
+    if(testData->cachedTestImage != KZ_NULL)
+    {
+        data = cluCachedImageGetData(testData->cachedTestImage);
+    }
+    else
+    {
+        data = kzcImageGetData(testData->kzTestImage);
+    }
+    return data;
+}
+
+static kzsError imageSceneCreateOriginalTexture_internal(const struct BenchmarkFramework* framework, const struct ImageTestData* testData, struct KzcTexture** out_texture)
+{
+    kzsError result;
+    struct KzcTexture* texture;
+    struct KzcResourceManager* resourceManager = kzuProjectGetResourceManager(bfGetProject(framework));
+
+    if(testData->cachedTestImage != KZ_NULL)
+    {
+        struct KzcTextureDescriptor descriptor;
+        kzcTextureDescriptorSet(cluCachedImageGetWidth(testData->cachedTestImage), cluCachedImageGetHeight(testData->cachedTestImage), KZC_TEXTURE_FORMAT_RGBA,
+                                KZC_TEXTURE_FILTER_BILINEAR, KZC_TEXTURE_WRAP_REPEAT, KZC_TEXTURE_COMPRESSION_NONE, &descriptor);
+        result = kzcTextureCreate(resourceManager, KZC_RESOURCE_MEMORY_TYPE_GPU_ONLY, &descriptor, cluCachedImageGetData(testData->cachedTestImage), &texture);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = kzcTextureCreateFromImage(resourceManager, KZC_RESOURCE_MEMORY_TYPE_GPU_ONLY, 
+            KZC_TEXTURE_FILTER_BILINEAR, KZC_TEXTURE_WRAP_REPEAT, KZC_TEXTURE_COMPRESSION_NONE, testData->kzTestImage, &texture);
+        kzsErrorForward(result);
+    }
+
+    *out_texture = texture;
+    kzsSuccess();
+}
@@ -56,7 +56,7 @@ kzsError initMedian(struct BenchmarkFramework* framework, struct BfScene* scene,
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/median.cl", KZ_FALSE, compilerSettings, context, &filter->medianProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/median.cl", KZ_FALSE, compilerSettings, context, &filter->medianProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
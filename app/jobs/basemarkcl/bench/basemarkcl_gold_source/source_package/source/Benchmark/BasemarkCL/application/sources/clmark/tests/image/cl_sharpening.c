@@ -63,7 +63,7 @@ kzsError initSharpening(struct BenchmarkFramework* framework, struct BfScene* sc
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/convolution2d.cl", KZ_FALSE, compilerSettings, context, &filter->sharpeningProgram, &binaryA);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/convolution2d.cl", KZ_FALSE, compilerSettings, context, &filter->sharpeningProgram, &binaryA);
         kzsErrorForward(result);
         filter->sharpeningKernel = clCreateKernel(filter->sharpeningProgram, "convolutionNaive2dFloat", &clResult);
         cluClErrorTest(clResult);
@@ -73,7 +73,7 @@ kzsError initSharpening(struct BenchmarkFramework* framework, struct BfScene* sc
         {
             bfSceneSetValidConfigurationData(scene, isValid);
         }
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/basic_image_operations.cl", KZ_FALSE, compilerSettings, context, &filter->basicImageOperationsProgram, &binaryB);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/basic_image_operations.cl", KZ_FALSE, compilerSettings, context, &filter->basicImageOperationsProgram, &binaryB);
         kzsErrorForward(result);
         filter->addConstantMultiplyKernel = clCreateKernel(filter->basicImageOperationsProgram, "addConstantMultiply", &clResult);
         cluClErrorTest(clResult);
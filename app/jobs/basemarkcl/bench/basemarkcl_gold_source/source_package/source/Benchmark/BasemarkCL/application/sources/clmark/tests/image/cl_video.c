@@ -7,6 +7,10 @@
 #include <benchmarkutil/scene/bf_scene.h>
 #include <benchmarkutil/util/bf_util.h>
 #include <benchmarkutil/util/bf_file_validator.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_report.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/settings/bf_settings.h>
 
 #include <application/kza_application.h>
 
@@ -48,6 +52,11 @@
 #include "cl_image_common.h"
 
 
+/** Size of the decoded video frames. */
+#define VIDEO_WIDTH 512
+#define VIDEO_HEIGHT 512
+
+
 struct ImageTestData
 {
     cl_context context; /**< OpenCL context. */
@@ -75,6 +84,14 @@ struct ImageTestData
     struct KzcTexture *textureOriginal; /**< Unprocessed video frame */
     struct VideoUtil *video; /**< Video utils state */
 
+    cl_mem uploadBuffers[VIDEO_DEFAULT_BUFFER_COUNT]; /**< Host accessible buffers the video is decoded into. */
+    kzByte* uploadPointers[VIDEO_DEFAULT_BUFFER_COUNT]; /**< Current mappings of the upload buffers. */
+    cl_event uploadMapEvent; /**< Event of mapping the last uploaded buffer again, or KZ_NULL. */
+
+    enum VideoPixelFormat uploadFormat; /**< Pixel format of the uploaded frames. */
+    cl_program yuvConversionProgram; /**< Color conversion program. Used only with YUV upload. */
+    cl_kernel yuvConversionKernel; /**< Color conversion kernel. Used only with YUV upload. */
+    cl_mem originalImage; /**< Unprocessed video frame texture, updated on the device with YUV upload. KZ_NULL if not used. */
 };
 
 
@@ -103,6 +120,10 @@ kzsError sharpeningVideoSceneUninitialize(struct BenchmarkFramework* framework,
 kzsError videoSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene, enum ImageTestType type);
 kzsError videoSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
 kzsError videoSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError videoSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
+
+/** Waits until the last uploaded buffer is mapped again, so that the decoder can write to it. */
+static kzsError videoSceneWaitUploadMap_internal(struct ImageTestData* testData);
 
 
 /** Basic initialization every image test frame needs */
@@ -439,7 +460,35 @@ kzsError videoSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
     }
 
     bfSceneSetFrameCounter(scene, 387);
-    videoInit(framework, "data/movie1.mpeg", 512, 512, &testData->video);
+
+    {
+        kzInt uploadFormat;
+        result = settingGetInt(bfGetSettings(framework), "VideoUploadFormat", &uploadFormat);
+        kzsErrorForward(result);
+        testData->uploadFormat = (uploadFormat == 1) ? VIDEO_PIXEL_FORMAT_YUV420 : VIDEO_PIXEL_FORMAT_RGBA;
+        testData->yuvConversionProgram = KZ_NULL;
+        testData->yuvConversionKernel = KZ_NULL;
+        testData->originalImage = KZ_NULL;
+    }
+
+    /* Video is decoded ahead straight into host accessible buffers, so that the upload needs no copy on the host. */
+    {
+        kzUint i;
+        cl_int clResult;
+        size_t uploadSize = videoCalculateFrameSize(testData->uploadFormat, VIDEO_WIDTH, VIDEO_HEIGHT);
+        for(i = 0; i < VIDEO_DEFAULT_BUFFER_COUNT; ++i)
+        {
+            testData->uploadBuffers[i] = clCreateBuffer(testData->context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, uploadSize, KZ_NULL, &clResult);
+            cluClErrorTest(clResult);
+            testData->uploadPointers[i] = (kzByte*)clEnqueueMapBuffer(testData->queue, testData->uploadBuffers[i], CL_TRUE, CL_MAP_READ | CL_MAP_WRITE,
+                                                                      0, uploadSize, 0, KZ_NULL, KZ_NULL, &clResult);
+            cluClErrorTest(clResult);
+        }
+        testData->uploadMapEvent = KZ_NULL;
+    }
+    result = videoInit(framework, "data/movie1.mpeg", VIDEO_WIDTH, VIDEO_HEIGHT, testData->uploadFormat, VIDEO_DEFAULT_BUFFER_COUNT, testData->uploadPointers,
+                       &testData->video);
+    kzsErrorForward(result);
 
     result = cluImageLoadPNG(framework, "data/movie1_first_frame.png", testData->context, &testData->testImage, &testData->kzTestImage, 0);
     kzsErrorForward(result); 
@@ -459,6 +508,24 @@ kzsError videoSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
         bfSceneSetValidConfigurationData(scene, isValid1 == KZ_TRUE && isValid2 == KZ_TRUE);
     }
 
+    if(testData->uploadFormat == VIDEO_PIXEL_FORMAT_YUV420)
+    {
+        kzBool binary;
+        kzBool isValid;
+        cl_int clResult;
+        result = bfValidateFile(framework, "data/yuv_conversion.cl", YUV_CONVERSION_HASH, &isValid);
+        kzsErrorForward(result);
+        if(bfSceneGetValidConfigurationData(scene))
+        {
+            bfSceneSetValidConfigurationData(scene, isValid);
+        }
+        result = cluGetBuiltProgramFromFileWithOptions(memoryManager, bfGetProgramCache(framework), "data/yuv_conversion.cl", KZ_FALSE, COMPILER_FLAGS,
+                                                       testData->context, &testData->yuvConversionProgram, &binary);
+        kzsErrorForward(result);
+        testData->yuvConversionKernel = clCreateKernel(testData->yuvConversionProgram, "yuv420ToRgba", &clResult);
+        cluClErrorTest(clResult);
+    }
+
     {    
         struct KzcTextureDescriptor descriptor;
 
@@ -495,6 +562,16 @@ kzsError videoSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
             KZC_TEXTURE_FILTER_BILINEAR, KZC_TEXTURE_WRAP_CLAMP, KZC_TEXTURE_COMPRESSION_NONE, testData->kzTestImage, &testData->textureOriginal);
         kzsErrorForward(result);
 
+#if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
+        /* With YUV upload RGBA frames exist only on the device, so the unprocessed frame is copied to its texture there. */
+        if(testData->uploadFormat == VIDEO_PIXEL_FORMAT_YUV420)
+        {
+            cl_int clResult;
+            testData->originalImage = clCreateFromGLTexture2D(testData->context, CL_MEM_WRITE_ONLY, KZS_GL_TEXTURE_2D, 0, kzcTextureGetTextureHandle(testData->textureOriginal), &clResult);
+            cluClErrorTest(clResult);
+        }
+#endif
+
         {
             cl_int clResult;
             cl_image_format format;
@@ -534,14 +611,19 @@ kzsError videoSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sc
     }
     /* Grab the first frame of the video */
     {
-        void *data; 
         result = videoNextFrame(framework, testData->video);
         kzsErrorForward(result);
-        data = videoGetFramePointer(testData->video);
 
-        result = kzcTextureUpdateData(testData->textureOriginal, data);
-        kzsErrorForward(result);
+        if(testData->uploadFormat == VIDEO_PIXEL_FORMAT_RGBA)
+        {
+            result = kzcTextureUpdateData(testData->textureOriginal, videoGetFramePointer(testData->video));
+            kzsErrorForward(result);
+        }
     }
+
+    /* Waiting for the first frame is part of loading. */
+    result = videoResetStatistics(testData->video);
+    kzsErrorForward(result);
     kzsSuccess();
 }
 
@@ -551,32 +633,144 @@ kzsError videoSceneRender(struct BenchmarkFramework* framework, struct BfScene*
     void *data; 
     kzsError result;
     testData = bfSceneGetUserData(scene);
-    result = videoNextFrame(framework, testData->video);
-    kzsErrorForward(result);
-    data = videoGetFramePointer(testData->video);
 
-    result = kzcTextureUpdateData(testData->textureOriginal, data);
+    /* Uploaded frame is given back to the decoder with its new mapping. */
+    result = videoSceneWaitUploadMap_internal(testData);
     kzsErrorForward(result);
+    result = videoReleaseFrame(testData->video, testData->uploadPointers[videoGetFrameIndex(testData->video)]);
+    kzsErrorForward(result);
+    result = videoAcquireFrame(testData->video);
+    kzsErrorForward(result);
+
+    if(testData->uploadFormat == VIDEO_PIXEL_FORMAT_RGBA)
+    {
+        data = videoGetFramePointer(testData->video);
+        result = kzcTextureUpdateData(testData->textureOriginal, data);
+        kzsErrorForward(result);
+    }
     kzsSuccess();
 }
 
 kzsError videoSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene)
 {
     struct ImageTestData *testData = NULL;
+    kzsError result;
     cl_int clResult;
-    struct KzcMemoryManager *memoryManager;
+    cl_event curEvent;
+    kzUint bufferIndex;
+    struct CluProfiler *profiler = bfSceneGetProfiler(scene);
 
     size_t imorigin[3] = {0, 0, 0};
-    size_t imrect[3] = {512, 512, 1};
-    void *data;
+    size_t imrect[3] = {VIDEO_WIDTH, VIDEO_HEIGHT, 1};
     testData = bfSceneGetUserData(scene);
     kzsAssert(kzcIsValidPointer(testData));
-    memoryManager = bfGetMemoryManager(framework);
-   
-    data = videoGetFramePointer(testData->video);
-    
-    clResult = clEnqueueWriteImage(testData->queue, testData->testImage, 0, imorigin, imrect, 0, 0, data, 0, NULL, NULL);
+
+    result = videoSceneWaitUploadMap_internal(testData);
+    kzsErrorForward(result);
+
+    /* Unmapping makes the decoded frame visible to the device without a host copy. Buffer is mapped again without waiting,
+       and the decoder gets it back when the frame has been rendered. */
+    bufferIndex = videoGetFrameIndex(testData->video);
+    clResult = clEnqueueUnmapMemObject(testData->queue, testData->uploadBuffers[bufferIndex], testData->uploadPointers[bufferIndex], 0, KZ_NULL, KZ_NULL);
     cluClErrorTest(clResult);
+    if(testData->uploadFormat == VIDEO_PIXEL_FORMAT_YUV420)
+    {
+        cl_int frameWidth = VIDEO_WIDTH;
+        cl_int frameHeight = VIDEO_HEIGHT;
+        result = cluSetKernelArguments(testData->yuvConversionKernel, sizeof(cl_mem), &testData->testImage, sizeof(cl_mem), &testData->uploadBuffers[bufferIndex],
+                                       sizeof(cl_int), &frameWidth, sizeof(cl_int), &frameHeight);
+        kzsErrorForward(result);
+        clResult = clEnqueueNDRangeKernel(testData->queue, testData->yuvConversionKernel, 2, KZ_NULL, imrect, KZ_NULL, 0, KZ_NULL, &curEvent);
+        cluClErrorTest(clResult);
+        cluProfilerAddEvent(profiler, "yuv420ToRgba", curEvent);
+
+        if(testData->originalImage != KZ_NULL)
+        {
+#if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
+            clResult = clEnqueueAcquireGLObjects(testData->queue, 1, &testData->originalImage, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+#endif
+            clResult = clEnqueueCopyImage(testData->queue, testData->testImage, testData->originalImage, imorigin, imorigin, imrect, 0, KZ_NULL, &curEvent);
+            cluClErrorTest(clResult);
+            cluProfilerAddEvent(profiler, "copy original frame", curEvent);
+#if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
+            clResult = clEnqueueReleaseGLObjects(testData->queue, 1, &testData->originalImage, 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+#endif
+        }
+    }
+    else
+    {
+        clResult = clEnqueueCopyBufferToImage(testData->queue, testData->uploadBuffers[bufferIndex], testData->testImage, 0, imorigin, imrect, 0, KZ_NULL, &curEvent);
+        cluClErrorTest(clResult);
+        cluProfilerAddEvent(profiler, "video upload", curEvent);
+    }
+    testData->uploadPointers[bufferIndex] = (kzByte*)clEnqueueMapBuffer(testData->queue, testData->uploadBuffers[bufferIndex], CL_FALSE, CL_MAP_READ | CL_MAP_WRITE,
+                                                                       0, videoCalculateFrameSize(testData->uploadFormat, VIDEO_WIDTH, VIDEO_HEIGHT),
+                                                                       0, KZ_NULL, &testData->uploadMapEvent, &clResult);
+    cluClErrorTest(clResult);
+
+    kzsSuccess();
+}
+
+static kzsError videoSceneWaitUploadMap_internal(struct ImageTestData* testData)
+{
+    cl_int clResult;
+
+    if(testData->uploadMapEvent != KZ_NULL)
+    {
+        clResult = clWaitForEvents(1, &testData->uploadMapEvent);
+        cluClErrorTest(clResult);
+        clResult = clReleaseEvent(testData->uploadMapEvent);
+        cluClErrorTest(clResult);
+        testData->uploadMapEvent = KZ_NULL;
+    }
+
+    kzsSuccess();
+}
+
+kzsError videoSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct ImageTestData *testData;
+    kzUint decodedFrameCount;
+    kzUint decodeTime;
+    kzUint conversionTime;
+    kzUint frameSize;
+    kzUint frameCount = bfReportLoggerGetFrameCount(bfGetReportLogger(framework));
+
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = videoGetDecodeStatistics(testData->video, &decodedFrameCount, &decodeTime, &conversionTime);
+    kzsErrorForward(result);
+    frameSize = videoCalculateFrameSize(testData->uploadFormat, VIDEO_WIDTH, VIDEO_HEIGHT);
+
+    {
+        struct XMLNode* formatNode;
+        result = XMLNodeCreateString(memoryManager, "uploadFormat", (testData->uploadFormat == VIDEO_PIXEL_FORMAT_YUV420) ? "yuv420" : "rgba", &formatNode);
+        kzsErrorForward(result);
+        result = XMLNodeAddChild(testNode, formatNode);
+        kzsErrorForward(result);
+    }
+    /* Every frame uploads one video frame. */
+    result = bfInfoAddInteger(memoryManager, testNode, "uploadBytesPerFrame", (kzInt)frameSize);
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "uploadedMegabytes", (kzFloat)((kzDouble)frameSize * frameCount / (1024.0 * 1024.0)));
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "averageHostConversionTime", (decodedFrameCount > 0) ? (kzFloat)conversionTime / (kzFloat)decodedFrameCount : 0.0f);
+    kzsErrorForward(result);
+
+    /* Decoding runs on its own thread, so these are not part of the frame times. Stalls mean the decoder could not keep up. */
+    result = bfInfoAddInteger(memoryManager, testNode, "decodedFrames", (kzInt)decodedFrameCount);
+    kzsErrorForward(result);
+    result = bfInfoAddScalar(memoryManager, testNode, "averageDecodeTime", (decodedFrameCount > 0) ? (kzFloat)decodeTime / (kzFloat)decodedFrameCount : 0.0f);
+    kzsErrorForward(result);
+    result = bfInfoAddInteger(memoryManager, testNode, "decodeStalls", (kzInt)videoGetStallCount(testData->video));
+    kzsErrorForward(result);
+    result = bfInfoAddInteger(memoryManager, testNode, "decodeStallTime", (kzInt)videoGetStallTime(testData->video));
+    kzsErrorForward(result);
 
     kzsSuccess();
 }
@@ -589,7 +783,38 @@ kzsError videoSceneUninitialize(struct BenchmarkFramework* framework, struct BfS
     kzsAssert(kzcIsValidPointer(testData));
     result = clFinish(testData->queue);
     kzsErrorForward(result);
-    videoUnitialize(framework, testData->video);
+    result = videoUnitialize(framework, testData->video);
+    kzsErrorForward(result);
+    result = videoSceneWaitUploadMap_internal(testData);
+    kzsErrorForward(result);
+    {
+        kzUint i;
+        cl_int clResult;
+        if(testData->yuvConversionKernel != KZ_NULL)
+        {
+            clResult = clReleaseKernel(testData->yuvConversionKernel);
+            cluClErrorTest(clResult);
+            clResult = clReleaseProgram(testData->yuvConversionProgram);
+            cluClErrorTest(clResult);
+        }
+        if(testData->originalImage != KZ_NULL)
+        {
+            clResult = clReleaseMemObject(testData->originalImage);
+            cluClErrorTest(clResult);
+        }
+        for(i = 0; i < VIDEO_DEFAULT_BUFFER_COUNT; ++i)
+        {
+            clResult = clEnqueueUnmapMemObject(testData->queue, testData->uploadBuffers[i], testData->uploadPointers[i], 0, KZ_NULL, KZ_NULL);
+            cluClErrorTest(clResult);
+        }
+        clResult = clFinish(testData->queue);
+        cluClErrorTest(clResult);
+        for(i = 0; i < VIDEO_DEFAULT_BUFFER_COUNT; ++i)
+        {
+            clResult = clReleaseMemObject(testData->uploadBuffers[i]);
+            cluClErrorTest(clResult);
+        }
+    }
     result = imageVSceneUninitialize(framework, scene);
     kzsErrorForward(result);
     kzsSuccess();
@@ -644,6 +869,7 @@ kzsError sharpeningVideoCreate(struct BenchmarkFramework* framework, struct BfSc
     result = bfTestConfigurationInitialize(memoryManager, sharpeningVideoSceneLoad, sharpeningVideoSceneUpdate, videoSceneRender,
         sharpeningVideoSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
+    configuration->report_private = videoSceneReport;
 
     result = kzcMemoryAllocVariable(memoryManager, testData, "Sharpnening test internal data");
     kzsErrorForward(result);
@@ -665,6 +891,7 @@ kzsError blurVideoCreate(struct BenchmarkFramework* framework, struct BfScene**
     result = bfTestConfigurationInitialize(memoryManager, blurVideoSceneLoad, blurVideoSceneUpdate, videoSceneRender,
         blurVideoSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
+    configuration->report_private = videoSceneReport;
 
     result = kzcMemoryAllocVariable(memoryManager,testData,"Blur test internal data");
     kzsErrorForward(result);
@@ -686,6 +913,7 @@ kzsError histogramVideoCreate(struct BenchmarkFramework* framework, struct BfSce
     result = bfTestConfigurationInitialize(memoryManager, histogramVideoSceneLoad, histogramVideoSceneUpdate, videoSceneRender,
         histogramVideoSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
+    configuration->report_private = videoSceneReport;
 
     result = kzcMemoryAllocVariable(memoryManager, testData, "Histogram test internal data");
     kzsErrorForward(result);
@@ -707,6 +935,7 @@ kzsError bilateralVideoCreate(struct BenchmarkFramework* framework, struct BfSce
     result = bfTestConfigurationInitialize(memoryManager, bilateralVideoSceneLoad, bilateralVideoSceneUpdate, videoSceneRender,
         bilateralVideoSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
+    configuration->report_private = videoSceneReport;
 
     result = kzcMemoryAllocVariable(memoryManager, testData, "Bilateral test internal data");
     kzsErrorForward(result);
@@ -728,6 +957,7 @@ kzsError medianVideoCreate(struct BenchmarkFramework* framework, struct BfScene*
     result = bfTestConfigurationInitialize(memoryManager, medianVideoSceneLoad, medianVideoSceneUpdate, videoSceneRender,
         medianVideoSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
+    configuration->report_private = videoSceneReport;
 
     result = kzcMemoryAllocVariable(memoryManager, testData, "Video noise reduction test internal data");
     kzsErrorForward(result);
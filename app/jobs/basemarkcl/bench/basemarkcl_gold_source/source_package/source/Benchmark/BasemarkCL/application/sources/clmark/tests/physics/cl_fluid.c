@@ -18,6 +18,9 @@
 #include <clutil/clu_kernel.h>
 #include <clutil/clu_util.h>
 #include <clutil/clu_profiler.h>
+#include <clutil/clu_work_group_tuner.h>
+
+#include <clmark/tests/physics/cl_physics_scaling.h>
 
 #include <application/kza_application.h>
 
@@ -111,16 +114,21 @@ struct FluidTestState
 
     size_t image_size[3]; /**< Image size for buffers. */
     size_t* localWorkSize; /**< Local work size. Read from configuration file. */
+    struct CluWorkGroupTuner* workGroupTuner; /**< Tuner of the local work sizes. KZ_NULL if the scene runs with default sizes. */
 
     struct CluProfiler *profiler; /**< Clu profiler */    
 
     kzFloat addedDensity; /**< Amount of density added for each addition step. */
+
+    kzUint gridSize; /**< Side length of the grid in a scaling run. Zero for the default size of the profile. */
+    kzUint workingSetSize; /**< Bytes of device memory used by the simulation grids. */
 };
 
 
 kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
 kzsError fluidSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
 kzsError fluidSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError fluidSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
 static kzsError diffuse(const struct FluidTestState *testData, kzInt b, struct FloatBuffer* x, struct FloatBuffer* x0, kzFloat diff, kzFloat dt);
 static kzsError diffuseSolve(const struct FluidTestState* testData, kzInt b, struct FloatBuffer* x, struct FloatBuffer* x0, kzFloat a, kzFloat c);
 static kzsError advect(const struct FluidTestState *testData, kzInt b, struct FloatBuffer* d, struct FloatBuffer* d0, struct FloatBuffer* u, struct FloatBuffer* v, kzFloat dt);
@@ -145,7 +153,6 @@ static kzsError addSource(const struct FluidTestState *testData, struct FloatBuf
 #else
 
     kzsError result;
-    cl_int clResult;
     cl_event curEvent;
 
     result = cluSetKernelArguments(testData->fluidKernels[5],
@@ -154,8 +161,8 @@ static kzsError addSource(const struct FluidTestState *testData, struct FloatBuf
         sizeof(cl_float), &dt);
     kzsErrorForward(result);
 
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->fluidKernels[5], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fluidKernels[5], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "addSource", curEvent);
 
 #endif
@@ -309,7 +316,6 @@ static kzsError advect(const struct FluidTestState *testData, kzInt b, struct Fl
     }
 #else
     {  
-        cl_int clResult;
         cl_event curEvent;
 
         result = cluSetKernelArguments(testData->fluidKernels[2],
@@ -321,8 +327,8 @@ static kzsError advect(const struct FluidTestState *testData, kzInt b, struct Fl
             );
         kzsErrorForward(result);
 
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fluidKernels[2], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fluidKernels[2], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "advect", curEvent);
     }
 #endif
@@ -581,8 +587,8 @@ static kzsError applyForces(const struct FluidTestState *testData, kzUint frame,
             );
         kzsErrorForward(result);
 
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fluidKernels[7], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fluidKernels[7], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "addForcesAndDensity", curEvent);
     }
 #else
@@ -635,6 +641,11 @@ KZ_CALLBACK kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct
             testData->addedDensity = 50.0f;
         }
     }
+    if(testData->gridSize != 0)
+    {
+        FLUID_GRID_SIZE = (kzInt)testData->gridSize;
+        bfSceneDisableFromOverallScore(scene);
+    }
 
     testData->image_size[0] = (kzUint)FLUID_GRID_SIZE;
     testData->image_size[1] = (kzUint)FLUID_GRID_SIZE;
@@ -644,13 +655,14 @@ KZ_CALLBACK kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct
     
     clResult = clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(cl_device_id), &testData->device, NULL);
     cluClErrorTest(clResult);
-    /* Create command queue based on configuration */
+    testData->workGroupTuner = bfSceneGetWorkGroupTuner(framework, scene);
+    /* Create command queue based on configuration. Work-group tuner measures the launches with event profiling. */
     {
         cl_command_queue_properties cqProperties = 0;
         struct CluProfiler *profiler;
         profiler = bfSceneGetProfiler(scene);
 
-        if(profiler->profilingEnabled)
+        if(profiler->profilingEnabled || bfSceneIsWorkGroupProfilingRequired(framework, scene))
         {
             cqProperties = CL_QUEUE_PROFILING_ENABLE;
         }
@@ -672,7 +684,8 @@ KZ_CALLBACK kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct
         result = cluGetProgramBinaryExists(memoryManager, kernelPath, &binaryProgramExists);
         kzsErrorForward(result);
 
-        if(binaryProgramExists)
+        /* Binary program has the grid size of the profile built in. */
+        if(binaryProgramExists && testData->gridSize == 0)
         {
             kzBool binary;
             result = cluLoadProgramFromFile(memoryManager, kernelPath, KZ_FALSE, context, &testData->fluidProgram, &binary);
@@ -694,7 +707,7 @@ KZ_CALLBACK kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct
             result = kzcStringFormat(bfGetMemoryManager(framework), "#define GRID_SIZE %d\n%s", &kernelSource, FLUID_GRID_SIZE, kernelSourceFromFile);
             kzsErrorForward(result);
             
-            result = cluGetBuiltProgramFromStringWithOptions(memoryManager, kernelSource, compilerSettings, context, &testData->fluidProgram);
+            result = cluGetBuiltProgramFromStringWithOptions(memoryManager, bfGetProgramCache(framework), kernelSource, compilerSettings, context, &testData->fluidProgram);
             kzsErrorForward(result);
 
             result = kzcStringDelete(kernelSourceFromFile);
@@ -749,6 +762,9 @@ KZ_CALLBACK kzsError fluidSceneLoad(struct BenchmarkFramework* framework, struct
         kzsErrorForward(result);
         result = cluFloatBufferCreate(memoryManager, NEW_VELOCITIES_BUFFER_ITEMS * NEW_VELOCITIES_BUFFER_ITEM_SIZE, bufferContext, &testData->newVelocities);
         kzsErrorForward(result);
+
+        /* Seven float grids and the RGBA output image. */
+        testData->workingSetSize = testData->bufferSize * (7 * sizeof(cl_float) + 4);
     }
 
 #if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
@@ -837,8 +853,8 @@ KZ_CALLBACK kzsError fluidSceneUpdate(struct BenchmarkFramework* framework, kzUi
             );
         kzsErrorForward(result);
         
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fluidKernels[0], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fluidKernels[0], 2, NULL, testData->image_size, testData->localWorkSize, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "visualizeDensity", curEvent);
 
 #if KZ_OPENGL_VERSION != KZ_OPENGL_NONE        
@@ -928,7 +944,30 @@ KZ_CALLBACK kzsError fluidSceneUninitialize(struct BenchmarkFramework* framework
     kzsSuccess();
 }
 
+KZ_CALLBACK kzsError fluidSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    struct FluidTestState *testData;
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = physicsScalingReport(framework, testNode, "cell", testData->bufferSize, testData->workingSetSize);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
 kzsError fluidCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+
+    result = fluidCreateWithGridSize(framework, 0, out_scene);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError fluidCreateWithGridSize(const struct BenchmarkFramework* framework, kzUint gridSize, struct BfScene** out_scene)
 {
     kzsError result;
     struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
@@ -940,10 +979,28 @@ kzsError fluidCreate(const struct BenchmarkFramework* framework, struct BfScene*
         fluidSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
 
+    /* Only the scenes of a problem-size sweep report their size and throughput. */
+    configuration->report_private = (gridSize != 0) ? fluidSceneReport : KZ_NULL;
+
     result = kzcMemoryAllocVariable(memoryManager,testData,"Fluid test internal data");
     kzsErrorForward(result);
-    result = bfSceneCreate(framework, configuration, "Fluid Operations Test", "Physics", testData, &scene);
-    kzsErrorForward(result);
+    testData->gridSize = gridSize;
+    if(gridSize != 0)
+    {
+        kzMutableString sceneName;
+        result = kzcStringFormat(memoryManager, "Fluid Operations Test (grid %u)", &sceneName, gridSize);
+        kzsErrorForward(result);
+        result = bfSceneCreate(framework, configuration, sceneName, "Physics", testData, &scene);
+        kzsErrorForward(result);
+        result = kzcStringDelete(sceneName);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = bfSceneCreate(framework, configuration, "Fluid Operations Test", "Physics", testData, &scene);
+        kzsErrorForward(result);
+    }
+    bfSceneEnableWorkGroupTuning(scene);
 
     *out_scene = scene;
     kzsSuccess();
@@ -19,6 +19,8 @@ struct BenchmarkFramework;
 
 /** Create fluid test. */
 kzsError fluidCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene);
+/** Create fluid test running on a grid of given side length. Scaling runs are not part of the overall score. */
+kzsError fluidCreateWithGridSize(const struct BenchmarkFramework* framework, kzUint gridSize, struct BfScene** out_scene);
 
 
 #endif
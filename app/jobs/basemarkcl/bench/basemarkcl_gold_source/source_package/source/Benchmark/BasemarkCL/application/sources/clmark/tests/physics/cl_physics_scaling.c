@@ -0,0 +1,99 @@
+/**
+* \file
+* Problem-size scaling sweeps of the physics tests.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "cl_physics_scaling.h"
+
+#include <benchmarkutil/bf_benchmark_framework.h>
+#include <benchmarkutil/settings/bf_settings.h>
+#include <benchmarkutil/report/bf_info.h>
+#include <benchmarkutil/report/bf_report.h>
+#include <benchmarkutil/report/bf_score.h>
+#include <benchmarkutil/report/xml/bf_xml_node.h>
+#include <benchmarkutil/report/xml/bf_xml_attribute.h>
+
+#include <core/memory/kzc_memory_manager.h>
+#include <core/util/string/kzc_string.h>
+
+
+kzsError physicsScalingGetSizes(const struct BenchmarkFramework* framework, kzString settingName, kzUint* sizes, kzUint* out_sizeCount)
+{
+    kzsError result;
+    kzString sizeList;
+    kzUint sizeCount = 0;
+
+    result = settingGetString(bfGetSettings(framework), settingName, &sizeList);
+    kzsErrorForward(result);
+
+    if(kzcStringLength(sizeList) > 0)
+    {
+        kzUint stringCount;
+        kzMutableString* strings;
+        kzUint i;
+
+        result = kzcStringSplit(bfGetMemoryManager(framework), sizeList, ",", &stringCount, &strings);
+        kzsErrorForward(result);
+        for(i = 0; i < stringCount; ++i)
+        {
+            kzInt size = kzcStringToInt(kzcStringTrim(strings[i]));
+            if(size > 0 && sizeCount < PHYSICS_SCALING_MAXIMUM_SIZES)
+            {
+                sizes[sizeCount++] = (kzUint)size;
+            }
+            result = kzcStringDelete(strings[i]);
+            kzsErrorForward(result);
+        }
+        result = kzcMemoryFreeArray(strings);
+        kzsErrorForward(result);
+    }
+
+    *out_sizeCount = sizeCount;
+    kzsSuccess();
+}
+
+kzsError physicsScalingReport(const struct BenchmarkFramework* framework, const struct XMLNode* testNode, kzString elementName,
+                              kzUint elementCount, kzUint workingSetSize)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(testNode);
+    struct BfReportLogger* reportLogger = bfGetReportLogger(framework);
+    struct BfScoreStatistics statistics;
+    kzUint* frameTimes;
+    kzUint frameCount;
+    struct XMLNode* scalingNode;
+    struct XMLAttribute* elementAttribute;
+    kzDouble throughput = 0.0;
+
+    result = bfReportLoggerGetScoredFrameTimes(reportLogger, memoryManager, &frameTimes, &frameCount);
+    kzsErrorForward(result);
+    result = bfScoreCalculateStatistics(memoryManager, frameTimes, frameCount, bfGetScoreConfiguration(framework), &statistics);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(frameTimes);
+    kzsErrorForward(result);
+
+    /* Each frame advances the whole problem by one time step. Frame times are in microseconds. */
+    if(statistics.geometricMean > 0.0f)
+    {
+        throughput = (kzDouble)elementCount * 1000000.0 / (kzDouble)statistics.geometricMean;
+    }
+
+    result = XMLNodeCreateContainer(memoryManager, "scaling", &scalingNode);
+    kzsErrorForward(result);
+    result = XMLAttributeCreateString(memoryManager, "element", elementName, &elementAttribute);
+    kzsErrorForward(result);
+    result = XMLNodeAddAttribute(scalingNode, elementAttribute);
+    kzsErrorForward(result);
+    result = XMLNodeAddChild(testNode, scalingNode);
+    kzsErrorForward(result);
+
+    result = bfInfoAddInteger(memoryManager, scalingNode, "problemSize", (kzInt)elementCount);
+    kzsErrorForward(result);
+    result = bfInfoAddInteger(memoryManager, scalingNode, "workingSetSize", (kzInt)workingSetSize);
+    kzsErrorForward(result);
+    /* Millions of elements per second keeps the value in the range of a float with useful precision. */
+    result = bfInfoAddScalar(memoryManager, scalingNode, "throughput", (kzFloat)(throughput / 1000000.0));
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
@@ -0,0 +1,34 @@
+/**
+* \file
+* Problem-size scaling sweeps of the physics tests.
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CL_PHYSICS_SCALING_H
+#define CL_PHYSICS_SCALING_H
+
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/** Maximum number of problem sizes in one sweep. */
+#define PHYSICS_SCALING_MAXIMUM_SIZES 16
+
+
+/* Forward declarations. */
+struct BenchmarkFramework;
+struct XMLNode;
+
+
+/** Reads comma separated list of problem sizes from given setting. Values below one are skipped. */
+kzsError physicsScalingGetSizes(const struct BenchmarkFramework* framework, kzString settingName, kzUint* sizes, kzUint* out_sizeCount);
+
+/**
+* Adds problem size, device working-set size and throughput of a physics scene under its report node.
+* Throughput is elements processed per second over the geometric mean frame time.
+*/
+kzsError physicsScalingReport(const struct BenchmarkFramework* framework, const struct XMLNode* testNode, kzString elementName,
+                              kzUint elementCount, kzUint workingSetSize);
+
+
+#endif
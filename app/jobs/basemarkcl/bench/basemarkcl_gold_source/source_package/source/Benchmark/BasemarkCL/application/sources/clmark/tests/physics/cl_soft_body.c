@@ -46,6 +46,7 @@
 #include <clutil/clu_profiler.h>
 
 #include <clmark/test_definitions.h>
+#include <clmark/tests/physics/cl_physics_scaling.h>
 
 
 #include "dynamic_mesh.h"
@@ -146,6 +147,9 @@ struct SoftBodyTestState
     struct CluProfiler *profiler; /**< Clu profiler */
 
     size_t workGroupSize[2]; /**< Workgroup size. */
+
+    kzUint particlesPerSide; /**< Side length of the cloth in a scaling run. Zero for the default size of the profile. */
+    kzUint workingSetSize; /**< Bytes of device memory used by the particle, neighbour and face buffers. */
 };
 
 
@@ -155,6 +159,7 @@ kzsError softBodyScenePreUpdate(struct BenchmarkFramework* framework, struct BfS
 kzsError softBodyScenePostUpdate(struct BenchmarkFramework* framework, struct BfScene* scene);
 kzsError softBodySceneRender(struct BenchmarkFramework* framework, struct BfScene* scene);
 kzsError softBodySceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError softBodySceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
 kzsError softBodyAccumulateForces(struct BenchmarkFramework* framework, struct SoftBodyTestState* testData);
 kzsError softBodyIntegrate(struct BenchmarkFramework* framework, struct SoftBodyTestState* testData);
 kzsError softBodySatisfyConstraints(struct BenchmarkFramework* framework, struct BfScene* scene, struct SoftBodyTestState* testData);
@@ -552,6 +557,11 @@ KZ_CALLBACK kzsError softBodySceneLoad(struct BenchmarkFramework* framework, str
             REST_LENGTH = 0.2f;
         }
     }
+    if(testData->particlesPerSide != 0)
+    {
+        PARTICLES_PER_SIDE = (kzInt)testData->particlesPerSide;
+        bfSceneDisableFromOverallScore(scene);
+    }
 
     result = kzaApplicationSetScenePath(bfGetApplication(framework), "Scenes/soft_body");
     kzsErrorForward(result);
@@ -688,8 +698,8 @@ KZ_CALLBACK kzsError softBodySceneLoad(struct BenchmarkFramework* framework, str
         result = cluGetProgramBinaryExists(memoryManager, kernelPath, &binaryProgramExists);
         kzsErrorForward(result);
         
-        /* If binary kernel is available use it. */
-        if(binaryProgramExists)
+        /* If binary kernel is available use it. Binary has the particle count of the profile built in. */
+        if(binaryProgramExists && testData->particlesPerSide == 0)
         {
             kzBool binary;
             result = cluLoadProgramFromFile(memoryManager, kernelPath, KZ_FALSE, context, &testData->softBodyProgram, &binary);
@@ -729,7 +739,7 @@ KZ_CALLBACK kzsError softBodySceneLoad(struct BenchmarkFramework* framework, str
                 cluClErrorTest(clResult);
             }
 
-            result = cluGetBuiltProgramFromStringWithOptions(memoryManager, kernelSource, compilerSettings, context, &testData->softBodyProgram);        
+            result = cluGetBuiltProgramFromStringWithOptions(memoryManager, bfGetProgramCache(framework), kernelSource, compilerSettings, context, &testData->softBodyProgram);        
             kzsErrorForward(result);        
             result = kzcStringDelete(kernelSourceFromFile);        
             kzsErrorForward(result);        
@@ -830,6 +840,8 @@ KZ_CALLBACK kzsError softBodySceneLoad(struct BenchmarkFramework* framework, str
 
     {
         kzUint size = PARTICLE_COUNT * sizeof(struct KzcVector4);
+        testData->workingSetSize = 3 * size + testData->particleNeighbourBufferSize + INDEX_COUNT / 3 * sizeof(struct KzcVector4) +
+                                   PARTICLE_COUNT * 8 * sizeof(kzUint) + PARTICLE_COUNT / 8 * sizeof(kzUint);
 #ifndef CPU
         {
             cl_int errorCode;
@@ -1222,7 +1234,30 @@ KZ_CALLBACK kzsError softBodySceneUninitialize(struct BenchmarkFramework* framew
     kzsSuccess();
 }
 
+KZ_CALLBACK kzsError softBodySceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    struct SoftBodyTestState *testData;
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = physicsScalingReport(framework, testNode, "particle", PARTICLE_COUNT, testData->workingSetSize);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
 kzsError softBodyCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+
+    result = softBodyCreateWithParticlesPerSide(framework, 0, out_scene);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError softBodyCreateWithParticlesPerSide(struct BenchmarkFramework* framework, kzUint particlesPerSide, struct BfScene** out_scene)
 {
     kzsError result;
     struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
@@ -1234,10 +1269,32 @@ kzsError softBodyCreate(struct BenchmarkFramework* framework, struct BfScene** o
         softBodySceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, softBodyScenePreUpdate, softBodyScenePostUpdate, &configuration);
     kzsErrorForward(result);
     
+    /* Only the scenes of a problem-size sweep report their size and throughput. */
+    configuration->report_private = (particlesPerSide != 0) ? softBodySceneReport : KZ_NULL;
+
     result = kzcMemoryAllocVariable(memoryManager, testData, "Soft body test internal data");
     kzsErrorForward(result);
-    result = bfSceneCreate(framework, configuration, "Soft Body Test", "Physics", testData, &scene);
-    kzsErrorForward(result);
+    /* Constraint offsets split the cloth into groups of eight particles, so the side is rounded down to a multiple of eight. */
+    testData->particlesPerSide = particlesPerSide - particlesPerSide % 8;
+    if(particlesPerSide != 0 && testData->particlesPerSide == 0)
+    {
+        testData->particlesPerSide = 8;
+    }
+    if(testData->particlesPerSide != 0)
+    {
+        kzMutableString sceneName;
+        result = kzcStringFormat(memoryManager, "Soft Body Test (%u x %u particles)", &sceneName, testData->particlesPerSide, testData->particlesPerSide);
+        kzsErrorForward(result);
+        result = bfSceneCreate(framework, configuration, sceneName, "Physics", testData, &scene);
+        kzsErrorForward(result);
+        result = kzcStringDelete(sceneName);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = bfSceneCreate(framework, configuration, "Soft Body Test", "Physics", testData, &scene);
+        kzsErrorForward(result);
+    }
 
     *out_scene = scene;
     kzsSuccess();
@@ -18,6 +18,8 @@ struct BenchmarkFramework;
 
 /** Create soft body test. */
 kzsError softBodyCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene);
+/** Create soft body test with given particles per cloth side, rounded down to a multiple of eight. Scaling runs are not part of the overall score. */
+kzsError softBodyCreateWithParticlesPerSide(struct BenchmarkFramework* framework, kzUint particlesPerSide, struct BfScene** out_scene);
 
 
 #endif
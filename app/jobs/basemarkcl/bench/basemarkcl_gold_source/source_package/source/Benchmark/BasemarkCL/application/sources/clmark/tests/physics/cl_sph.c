@@ -53,8 +53,10 @@
 #include <clutil/clu_util.h>
 #include <clutil/clu_image.h>
 #include <clutil/clu_profiler.h>
+#include <clutil/clu_work_group_tuner.h>
 
 #include <clmark/test_definitions.h>
+#include <clmark/tests/physics/cl_physics_scaling.h>
 
 #include <math.h>
 
@@ -68,6 +70,7 @@ kzsError sphSceneRender(struct BenchmarkFramework* framework, struct BfScene* sc
 kzsError sphSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
 kzsError sphSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
 kzsError sphSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError sphSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
 kzsError sphSortParticles(struct SphTestData *testData);
 kzsError sphResetScene(struct SphTestData *testData);
 
@@ -153,10 +156,14 @@ struct SphTestData
     struct CluProfiler *profiler; /**< Clu profiler */
 
     size_t* localWorkSize; /**< Local work size. Read from configuration file. */
+    struct CluWorkGroupTuner* workGroupTuner; /**< Tuner of the local work sizes. KZ_NULL if the scene runs with default sizes. */
 
     cl_float offset; /* Parameters to control display of the fluid */
     cl_float scale;
     cl_float yoffset;
+
+    kzUint particleLog2; /**< Base two logarithm of the particle count in a scaling run. Zero for the default count of the profile. */
+    kzUint workingSetSize; /**< Bytes of device memory used by the particle and voxel buffers. */
 };
 
 /* Cubic root does not exist on certain libc implementations */
@@ -291,16 +298,22 @@ kzsError sphSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scen
             VOXEL_COUNT_Z = 32;
         }
     }
+    if(testData->particleLog2 != 0)
+    {
+        PARTICLE_LOG2 = (kzInt)testData->particleLog2;
+        bfSceneDisableFromOverallScore(scene);
+    }
 
 
     testData->profiler = bfSceneGetProfiler(scene);
-    /* Create command queue based on configuration */
+    testData->workGroupTuner = bfSceneGetWorkGroupTuner(framework, scene);
+    /* Create command queue based on configuration. Work-group tuner measures the launches with event profiling. */
     {
         cl_command_queue_properties cqProperties = 0;
         struct CluProfiler *profiler;
         profiler = bfSceneGetProfiler(scene);
 
-        if(profiler->profilingEnabled)
+        if(profiler->profilingEnabled || bfSceneIsWorkGroupProfilingRequired(framework, scene))
         {
             cqProperties = CL_QUEUE_PROFILING_ENABLE;
         }
@@ -360,7 +373,7 @@ kzsError sphSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scen
         result = bfValidateFile(framework, "data/sph.cl", SPH_HASH, &isValid);
         kzsErrorForward(result);
         bfSceneSetValidConfigurationData(scene, isValid);
-        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/sph.cl", KZ_FALSE, compilerSettings, testData->context, &testData->sphProgram, &binary);
+        result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/sph.cl", KZ_FALSE, compilerSettings, testData->context, &testData->sphProgram, &binary);
         kzsErrorForward(result);
         bfSceneSetUseProgramBinary(scene, binary);
     }
@@ -442,6 +455,9 @@ kzsError sphSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scen
     cluClErrorTest(clResult);
 
 
+    testData->workingSetSize = PARTICLE_COUNT * (2 * sizeof(cl_uint2) + 5 * sizeof(cl_float4) + sizeof(cl_float)) +
+                               2 * sizeof(cl_int) * VOXEL_COUNT_X * VOXEL_COUNT_Y * VOXEL_COUNT_Z;
+
     testData->voxelCount[0] = VOXEL_COUNT_X;
     testData->voxelCount[1] = VOXEL_COUNT_Y;
     testData->voxelCount[2] = VOXEL_COUNT_Z;
@@ -617,31 +633,31 @@ kzsError sphSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime,
 
     /* Sorting based approach for O(nlog^2n) complexity */
     
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->updateKeys, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->updateKeys, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "updateKeys", curEvent);
     result = sphSortParticles(testData);
     kzsErrorForward(result);
 
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->sortPostProcess, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->sortPostProcess, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "sortPostProcess", curEvent);
 
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->clearVoxels, 1, NULL, &vcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->clearVoxels, 1, NULL, &vcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "clearVoxels ", curEvent);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->setVoxels, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->setVoxels, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "setVoxels ", curEvent);
 
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->calculateDensity, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->calculateDensity, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "calculateDensity ", curEvent);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->calculateAcceleration, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->calculateAcceleration, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "calculateAcceleration ", curEvent);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->integrate, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->integrate, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "integrate ", curEvent);
 
 #if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
@@ -692,8 +708,8 @@ kzsError sphSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime,
             sizeof(cl_float), &testData->offset,
             sizeof(cl_float), &testData->scale);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->updateVBO, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
-        cluClErrorTest(clResult); 
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->updateVBO, 1, NULL, &pcount, testData->localWorkSize, 0, NULL, &curEvent);
+        kzsErrorForward(result); 
         cluProfilerAddEvent(testData->profiler, "updateVBO ", curEvent);
     }
     
@@ -796,7 +812,30 @@ kzsError sphSceneUninitialize(struct BenchmarkFramework* framework, struct BfSce
     kzsSuccess();
 }
 
+KZ_CALLBACK kzsError sphSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    struct SphTestData *testData;
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = physicsScalingReport(framework, testNode, "particle", PARTICLE_COUNT, testData->workingSetSize);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
 kzsError sphCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+
+    result = sphCreateWithParticleCount(framework, 0, out_scene);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError sphCreateWithParticleCount(const struct BenchmarkFramework* framework, kzUint particleCount, struct BfScene** out_scene)
 {
     kzsError result;
     struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
@@ -808,11 +847,34 @@ kzsError sphCreate(const struct BenchmarkFramework* framework, struct BfScene**
         sphSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
 
+    /* Only the scenes of a problem-size sweep report their size and throughput. */
+    configuration->report_private = (particleCount != 0) ? sphSceneReport : KZ_NULL;
+
     /* TOOD: space after comma. */
     result = kzcMemoryAllocVariable(memoryManager, testData,"Smoothed particle hydrodynamics test internal data");
     kzsErrorForward(result);
-    result = bfSceneCreate(framework, configuration, "Smoothed Particle Hydrodynamics Test", "Physics", testData, &scene);
-    kzsErrorForward(result);
+    /* Bitonic sort requires power of two particle count, so the count is rounded down. */
+    testData->particleLog2 = (particleCount != 0) ? 1 : 0;
+    while((particleCount >> (testData->particleLog2 + 1)) != 0)
+    {
+        ++testData->particleLog2;
+    }
+    if(testData->particleLog2 != 0)
+    {
+        kzMutableString sceneName;
+        result = kzcStringFormat(memoryManager, "Smoothed Particle Hydrodynamics Test (%u particles)", &sceneName, 1u << testData->particleLog2);
+        kzsErrorForward(result);
+        result = bfSceneCreate(framework, configuration, sceneName, "Physics", testData, &scene);
+        kzsErrorForward(result);
+        result = kzcStringDelete(sceneName);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = bfSceneCreate(framework, configuration, "Smoothed Particle Hydrodynamics Test", "Physics", testData, &scene);
+        kzsErrorForward(result);
+    }
+    bfSceneEnableWorkGroupTuning(scene);
 
     *out_scene = scene;
     kzsSuccess();
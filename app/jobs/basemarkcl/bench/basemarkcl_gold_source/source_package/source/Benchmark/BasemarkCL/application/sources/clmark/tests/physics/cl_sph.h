@@ -18,6 +18,8 @@ struct BenchmarkFramework;
 
 /** Create fluid test. */
 kzsError sphCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene);
+/** Create fluid test with given particle count, rounded down to a power of two. Scaling runs are not part of the overall score. */
+kzsError sphCreateWithParticleCount(const struct BenchmarkFramework* framework, kzUint particleCount, struct BfScene** out_scene);
 
 
 #endif
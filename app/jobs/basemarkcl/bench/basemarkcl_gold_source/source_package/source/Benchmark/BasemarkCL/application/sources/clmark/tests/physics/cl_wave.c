@@ -3,6 +3,7 @@
 * OpenCL FFT wave simulation.
 * Copyright 2011 by Rightware. All rights reserved.
 */
+#include "cl_wave.h"
 #include "dynamic_mesh.h"
 
 #include <benchmarkutil/bf_benchmark_framework.h>
@@ -44,9 +45,11 @@
 #include <clutil/clu_kernel.h>
 #include <clutil/clu_util.h>
 #include <clutil/clu_profiler.h>
+#include <clutil/clu_work_group_tuner.h>
 #include <clutil/clu_opencl_base.h>
 
 #include <clmark/test_definitions.h>
+#include <clmark/tests/physics/cl_physics_scaling.h>
 
 
 
@@ -118,10 +121,14 @@ struct WaveTestData
     struct CluProfiler *profiler; /**< Clu profiler */
 
     size_t* localWorkSize; /**< Local work size. Read from configuration file. */
+    struct CluWorkGroupTuner* workGroupTuner; /**< Tuner of the local work sizes. KZ_NULL if the scene runs with default sizes. */
     size_t* localWorkSizeFFT; /**< Local work size. Read from configuration file. */
 
     cl_float dt; /**< deltaT which is applied at every iteration */
     kzUint dropRate; /**< How many frames are skipped between adding drops */
+
+    kzUint sideLog2; /**< Base two logarithm of the grid side length in a scaling run. Zero for the default size of the profile. */
+    kzUint workingSetSize; /**< Bytes of device memory used by the height fields. */
 };
 
 
@@ -129,6 +136,7 @@ kzsError waveSceneRender(struct BenchmarkFramework* framework, struct BfScene* s
 kzsError waveSceneLoad(struct BenchmarkFramework* framework, struct BfScene* scene);
 kzsError waveSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime, struct BfScene* scene);
 kzsError waveSceneUninitialize(struct BenchmarkFramework* framework, struct BfScene* scene);
+kzsError waveSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode);
 
 /** Applies dispersion to the frequency domain heightfield. */
 kzsError applyDispersion(struct WaveTestData* testData, cl_float time);
@@ -195,7 +203,6 @@ kzsError fft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
     size_t gcsize[2];
     cl_uint i;
     cl_event curEvent;
-    cl_int clResult;
     kzsError result;
     grsize[0] = SIDE_LENGTH/2;
     grsize[1] = SIDE_LENGTH;
@@ -207,14 +214,14 @@ kzsError fft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
         cl_int inputint = i;
         result = cluSetKernelArguments(testData->fft2dRow ,sizeof(cl_mem), &target, sizeof(cl_mem), &tempbuffer, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         inputint = inputint << 1;
         cluProfilerAddEvent(testData->profiler, "fft2dRow", curEvent);
         result = cluSetKernelArguments(testData->fft2dRow, sizeof(cl_mem), &tempbuffer, sizeof(cl_mem), &target, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "fft2dRow", curEvent);
     }
     for(i = 1; i <= (SIDE_LENGTH/2); i = i << 2)
@@ -222,14 +229,14 @@ kzsError fft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
         cl_int inputint = i;
         result = cluSetKernelArguments(testData->fft2dColumn, sizeof(cl_mem), &target, sizeof(cl_mem), &tempbuffer, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "fft2dColumn", curEvent);
         inputint = inputint << 1;
         result = cluSetKernelArguments(testData->fft2dColumn, sizeof(cl_mem), &tempbuffer, sizeof(cl_mem), &target, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->fft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->fft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "fft2dColumn", curEvent);
     }
     kzsSuccess();
@@ -241,7 +248,6 @@ kzsError ifft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
     size_t gcsize[2];
     cl_uint i;
     cl_event curEvent;
-    cl_int clResult;
     kzsError result;
     grsize[0] = SIDE_LENGTH/2;
     grsize[1] = SIDE_LENGTH;
@@ -253,13 +259,14 @@ kzsError ifft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
         cl_int inputint = i;
         result = cluSetKernelArguments(testData->ifft2dColumn, sizeof(cl_mem), &target, sizeof(cl_mem), &tempbuffer, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->ifft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->ifft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "ifft2dColumn", curEvent);
         inputint = inputint << 1;
         result = cluSetKernelArguments(testData->ifft2dColumn, sizeof(cl_mem), &tempbuffer, sizeof(cl_mem), &target, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->ifft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->ifft2dColumn, 2, NULL, gcsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "ifft2dColumn", curEvent);
     }
     for(i = 1; i <= (SIDE_LENGTH/2); i = i << 2)
@@ -267,14 +274,14 @@ kzsError ifft(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffer)
         cl_int inputint = i;
         result = cluSetKernelArguments(testData->ifft2dRow ,sizeof(cl_mem), &target, sizeof(cl_mem), &tempbuffer, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->ifft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->ifft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "ifft2dColumn", curEvent);
         inputint = inputint << 1;
         result = cluSetKernelArguments(testData->ifft2dRow, sizeof(cl_mem), &tempbuffer, sizeof(cl_mem), &target, sizeof(cl_int), &inputint);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->ifft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->ifft2dRow, 2, NULL, grsize, testData->localWorkSizeFFT, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "ifft2dColumn", curEvent);
     }
 
@@ -287,7 +294,6 @@ kzsError addDrop(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffe
 
     cl_int x, y;
     cl_float fx, fy;
-    cl_int clResult;
     size_t gsize[2];
     kzsError result;
     cl_event curEvent;
@@ -300,8 +306,8 @@ kzsError addDrop(struct WaveTestData * testData, cl_mem target, cl_mem tempbuffe
     fy = (cl_float) y;
     result = cluSetKernelArguments(testData->addDrop, sizeof(cl_mem), &target, sizeof(cl_float), &fx, sizeof(cl_float), &fy);
     kzsErrorForward(result);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->addDrop, 2, NULL, gsize, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->addDrop, 2, NULL, gsize, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "addDrop", curEvent);
 
     kzsSuccess();
@@ -347,7 +353,7 @@ kzsError generateInitialHeightfield(struct BenchmarkFramework* framework, struct
 kzsError applyDispersion(struct WaveTestData * testData, cl_float time)
 {
     size_t dsize[2];
-    cl_int clResult;
+    kzsError result;
     cl_event curEvent;
     dsize[0] = SIDE_LENGTH;
     dsize[1] = SIDE_LENGTH;
@@ -355,8 +361,8 @@ kzsError applyDispersion(struct WaveTestData * testData, cl_float time)
         sizeof(cl_mem), &testData->frequencyDomainHeightField, 
         sizeof(cl_mem), &testData->frequencyDomainHeightField, 
         sizeof(cl_float), &time);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->dispersion, 2, NULL, dsize, testData->localWorkSize, 0, NULL, &curEvent);
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->dispersion, 2, NULL, dsize, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "dispersion", curEvent);
     kzsSuccess();
 }
@@ -367,7 +373,6 @@ kzsError generateSpatialDomainField(struct BenchmarkFramework* framework, struct
     size_t dsize[2];
     kzsError result;
 
-    cl_int clResult;
     dsize[0] = SIDE_LENGTH;
     dsize[1] = SIDE_LENGTH;
 
@@ -386,8 +391,8 @@ kzsError generateSpatialDomainField(struct BenchmarkFramework* framework, struct
                     sizeof(cl_mem), &testData->frequencyDomainHeightField, 
                     sizeof(cl_int), &boundarySize);
         kzsErrorForward(result);
-        clResult = clEnqueueNDRangeKernel(testData->queue, testData->zeroBoundaries, 2, NULL, dsize, testData->localWorkSize, 0, NULL, &curEvent);
-        cluClErrorTest(clResult);
+        result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->zeroBoundaries, 2, NULL, dsize, testData->localWorkSize, 0, NULL, &curEvent);
+        kzsErrorForward(result);
         cluProfilerAddEvent(testData->profiler, "zeroBoundaries", curEvent);
     }
   
@@ -474,17 +479,24 @@ kzsError waveSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sce
             VBO_SIDE = 250;
         }
     }
+    if(testData->sideLog2 != 0)
+    {
+        SIDE_LOG2 = testData->sideLog2;
+        bfSceneDisableFromOverallScore(scene);
+    }
+    testData->workingSetSize = 3 * sizeof(cl_float2) * GRID_SIZE;
     
 
     clResult = clGetContextInfo(testData->context,CL_CONTEXT_DEVICES,sizeof(cl_device_id),&testData->device,NULL);
     cluClErrorTest(clResult);
-    /* Create command queue based on configuration */
+    testData->workGroupTuner = bfSceneGetWorkGroupTuner(framework, scene);
+    /* Create command queue based on configuration. Work-group tuner measures the launches with event profiling. */
     {
         cl_command_queue_properties cqProperties = 0;
         struct CluProfiler *profiler;
         profiler = bfSceneGetProfiler(scene);
 
-        if(profiler->profilingEnabled)
+        if(profiler->profilingEnabled || bfSceneIsWorkGroupProfilingRequired(framework, scene))
         {
             cqProperties = CL_QUEUE_PROFILING_ENABLE;
         }
@@ -521,12 +533,12 @@ kzsError waveSceneLoad(struct BenchmarkFramework* framework, struct BfScene* sce
             result = bfValidateFile(framework, "data/wave_simulation.cl", WAVE_SIMULATION_HASH, &isWaveValid);
             kzsErrorForward(result);
 
-            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/wave_simulation.cl", KZ_FALSE, compilerSettings, testData->context, &testData->waveProgram, &binaryA);
+            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/wave_simulation.cl", KZ_FALSE, compilerSettings, testData->context, &testData->waveProgram, &binaryA);
             kzsErrorForward(result);
 
             result = bfValidateFile(framework, "data/fft.cl", FFT_HASH, &isFftValid);
             kzsErrorForward(result);
-            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), "data/fft.cl", KZ_FALSE, compilerSettings, testData->context, &testData->fftProgram, &binaryB);
+            result = cluGetBuiltProgramFromFileWithOptions(bfGetMemoryManager(framework), bfGetProgramCache(framework), "data/fft.cl", KZ_FALSE, compilerSettings, testData->context, &testData->fftProgram, &binaryB);
             kzsErrorForward(result);
         }
         bfSceneSetValidConfigurationData(scene, isFftValid & isWaveValid);
@@ -713,8 +725,8 @@ kzsError waveSceneUpdate(struct BenchmarkFramework* framework, kzUint deltaTime,
         sizeof(cl_mem), &testData->vertexBufferObjectCLBuffer,
         sizeof(cl_int), &instride);
     kzsErrorForward(result);
-    clResult = clEnqueueNDRangeKernel(testData->queue, testData->updateVbo, 2, NULL, vsize, testData->localWorkSize, 0, NULL, &curEvent );
-    cluClErrorTest(clResult);
+    result = cluWorkGroupTunerEnqueueNDRangeKernel(testData->workGroupTuner, testData->queue, testData->updateVbo, 2, NULL, vsize, testData->localWorkSize, 0, NULL, &curEvent);
+    kzsErrorForward(result);
     cluProfilerAddEvent(testData->profiler, "updateVbo", curEvent);
 #endif
 
@@ -860,7 +872,30 @@ kzsError waveSceneUninitialize(struct BenchmarkFramework* framework, struct BfSc
     kzsSuccess();
 }
 
-kzsError waveCreate(struct BenchmarkFramework* framework, struct BfScene** out_scene)
+kzsError waveSceneReport(struct BenchmarkFramework* framework, struct BfScene* scene, struct XMLNode* testNode)
+{
+    kzsError result;
+    struct WaveTestData *testData;
+    testData = bfSceneGetUserData(scene);
+    kzsAssert(kzcIsValidPointer(testData));
+
+    result = physicsScalingReport(framework, testNode, "gridPoint", GRID_SIZE, testData->workingSetSize);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError waveCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene)
+{
+    kzsError result;
+
+    result = waveCreateWithSideLength(framework, 0, out_scene);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError waveCreateWithSideLength(const struct BenchmarkFramework* framework, kzUint sideLength, struct BfScene** out_scene)
 {
     kzsError result;
     struct KzcMemoryManager* memoryManager = bfGetMemoryManager(framework);
@@ -872,10 +907,33 @@ kzsError waveCreate(struct BenchmarkFramework* framework, struct BfScene** out_s
         waveSceneUninitialize, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, KZ_NULL, &configuration);
     kzsErrorForward(result);
 
+    /* Only the scenes of a problem-size sweep report their size and throughput. */
+    configuration->report_private = (sideLength != 0) ? waveSceneReport : KZ_NULL;
+
     result = kzcMemoryAllocVariable(memoryManager, testData,"FFT wave simulation test internal data");
     kzsErrorForward(result);
-    result = bfSceneCreate(framework, configuration, "Wave Simulation Test", "Physics", testData, &scene);
-    kzsErrorForward(result);
+    /* FFT requires power of two side length, so the length is rounded down. */
+    testData->sideLog2 = (sideLength != 0) ? 1 : 0;
+    while((sideLength >> (testData->sideLog2 + 1)) != 0)
+    {
+        ++testData->sideLog2;
+    }
+    if(testData->sideLog2 != 0)
+    {
+        kzMutableString sceneName;
+        result = kzcStringFormat(memoryManager, "Wave Simulation Test (grid %u)", &sceneName, 1u << testData->sideLog2);
+        kzsErrorForward(result);
+        result = bfSceneCreate(framework, configuration, sceneName, "Physics", testData, &scene);
+        kzsErrorForward(result);
+        result = kzcStringDelete(sceneName);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = bfSceneCreate(framework, configuration, "Wave Simulation Test", "Physics", testData, &scene);
+        kzsErrorForward(result);
+    }
+    bfSceneEnableWorkGroupTuning(scene);
 
     *out_scene = scene;
     kzsSuccess();
@@ -18,6 +18,8 @@ struct BenchmarkFramework;
 
 /** Create wave test. */
 kzsError waveCreate(const struct BenchmarkFramework* framework, struct BfScene** out_scene);
+/** Create wave test with given grid side length, rounded down to a power of two. Scaling runs are not part of the overall score. */
+kzsError waveCreateWithSideLength(const struct BenchmarkFramework* framework, kzUint sideLength, struct BfScene** out_scene);
 
 
 #endif
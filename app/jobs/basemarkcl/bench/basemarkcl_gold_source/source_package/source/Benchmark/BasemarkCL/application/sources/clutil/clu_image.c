@@ -90,37 +90,48 @@ kzsError cluCreateAndBindGlImage(struct BenchmarkFramework* framework, kzUint wi
     kzsSuccess();
 }
 
-kzsError cluImageLoadPNG(struct BenchmarkFramework* framework, kzString path, cl_context context,cl_mem* out_image, struct KzcImage **out_kzImage, kzUint scale)
+kzsError cluImageDecodePNG(const struct KzcMemoryManager* memoryManager, kzString path, kzUint scale, struct KzcImage** out_kzImage)
 {
-    cl_image_format imformat;
     kzsError result;
-    cl_int clResult;
     struct KzcInputStream* stream;
     struct KzcImage* image;
-    cl_mem inputImage;
-    cl_uchar* imdata;
-    kzUint imageWidth;
-    kzUint imageHeight;
-    struct KzcMemoryManager* manager = bfGetMemoryManager(framework);
 
-    result = kzcInputStreamCreateFromFile(manager, path, KZC_IO_STREAM_ENDIANNESS_PLATFORM, &stream);
+    result = kzcInputStreamCreateFromFile(memoryManager, path, KZC_IO_STREAM_ENDIANNESS_PLATFORM, &stream);
     kzsErrorForward(result);
-    result = kzcImageLoadPNG(manager, stream, &image);
+    result = kzcImageLoadPNG(memoryManager, stream, &image);
     kzsErrorForward(result);
     result = kzcImageConvert(image, KZC_IMAGE_DATA_FORMAT_RGBA_8888);
     kzsErrorForward(result);
     result = kzcInputStreamDelete(stream);
     kzsErrorForward(result);
 
-    imageWidth = kzcImageGetWidth(image);
-    imageHeight = kzcImageGetHeight(image);
     if(scale > 0)
     {
-        imageWidth = imageWidth / scale;
-        imageHeight = imageHeight / scale;
-        result = kzcImageResize(image, imageWidth, imageHeight, KZC_IMAGE_RESIZE_FILTER_NEAREST_NEIGHBOR);
+        result = kzcImageResize(image, kzcImageGetWidth(image) / scale, kzcImageGetHeight(image) / scale, KZC_IMAGE_RESIZE_FILTER_NEAREST_NEIGHBOR);
         kzsErrorForward(result);
     }
+
+    *out_kzImage = image;
+    kzsSuccess();
+}
+
+kzsError cluImageLoadPNG(struct BenchmarkFramework* framework, kzString path, cl_context context,cl_mem* out_image, struct KzcImage **out_kzImage, kzUint scale)
+{
+    cl_image_format imformat;
+    kzsError result;
+    cl_int clResult;
+    struct KzcImage* image;
+    cl_mem inputImage;
+    cl_uchar* imdata;
+    kzUint imageWidth;
+    kzUint imageHeight;
+    struct KzcMemoryManager* manager = bfGetMemoryManager(framework);
+
+    result = cluImageDecodePNG(manager, path, scale, &image);
+    kzsErrorForward(result);
+
+    imageWidth = kzcImageGetWidth(image);
+    imageHeight = kzcImageGetHeight(image);
     imdata = kzcImageGetData(image);
     imformat.image_channel_order = CL_RGBA;
     imformat.image_channel_data_type = CL_UNORM_INT8;
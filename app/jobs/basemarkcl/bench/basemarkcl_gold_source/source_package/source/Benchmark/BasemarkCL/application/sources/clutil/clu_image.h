@@ -23,6 +23,9 @@ struct BenchmarkFramework;
 /* Gets the image width and height and places them into sizes[0] and [1] respectively */
 kzsError cluGetImageSize(cl_mem image, size_t *sizes);
 
+/* Load a png and convert it into RGBA-8888. If scale > 0 resize the image by dividing the size by scale */
+kzsError cluImageDecodePNG(const struct KzcMemoryManager* memoryManager, kzString path, kzUint scale, struct KzcImage** out_kzImage);
+
 /* Load a png, convert it into RGBA-8888 and generate an OpenCL Image of it. If scale > 0 resize the image by dividing the size by scale */
 kzsError cluImageLoadPNG(struct BenchmarkFramework* framework, kzString path, cl_context context,cl_mem* out_image, struct KzcImage **out_kzImage, kzUint scale);
 
@@ -0,0 +1,410 @@
+/**
+* \file
+* Persistent on-disk cache of decoded images.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "clu_image_cache.h"
+
+#include <clutil/clu_image.h>
+#include <clutil/clu_util.h>
+
+#include <core/util/image/kzc_image.h>
+#include <core/util/io/kzc_file.h>
+#include <core/util/io/kzc_output_stream.h>
+#include <core/util/string/kzc_string.h>
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/kzs_error_codes.h>
+#include <system/wrappers/kzs_memory.h>
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+#define CLU_IMAGE_CACHE_MAGIC "CLUIC001" /**< Identifier and version of cache entry format. */
+#define CLU_IMAGE_CACHE_MAGIC_LENGTH 8 /**< Length of the entry identifier. */
+/** Entry header consists of identifier, width and height. Header is padded to a page, so that the mapped pixels are page aligned. */
+#define CLU_IMAGE_CACHE_HEADER_SIZE 4096
+/** Bytes per RGBA-8888 pixel. */
+#define CLU_IMAGE_CACHE_PIXEL_SIZE 4
+
+
+struct CluImageCache
+{
+    kzMutableString directory; /**< Directory of cache entries. */
+    kzUint hitCount; /**< Number of images loaded from cache since last reset. */
+    kzUint missCount; /**< Number of images decoded into cache since last reset. */
+};
+
+struct CluCachedImage
+{
+    void* mapping; /**< Start of the mapped entry file. */
+    kzUint mappingSize; /**< Size of the mapping in bytes. */
+    kzUint width; /**< Image width. */
+    kzUint height; /**< Image height. */
+};
+
+
+/** Maps given entry, decoding the image into it first if it is not cached yet. Updates the hit and miss counts. */
+static kzsError cluImageCacheLoadEntry_internal(struct CluImageCache* cache, kzString path, kzString entryPath, kzUint scale,
+                                                struct CluCachedImage** out_cachedImage);
+/** Decodes image and writes it to given entry file. */
+static kzsError cluImageCacheDecodeEntry_internal(const struct KzcMemoryManager* memoryManager, kzString path, kzString entryPath, kzUint scale);
+/** Writes decoded image to given entry file. */
+static kzsError cluImageCacheWriteEntry_internal(const struct KzcMemoryManager* memoryManager, kzString entryPath, const struct KzcImage* image);
+/** Maps given entry file. Returns KZ_NULL cached image if the entry does not exist or is not valid. */
+static kzsError cluImageCacheMapEntry_internal(const struct KzcMemoryManager* memoryManager, kzString entryPath, struct CluCachedImage** out_cachedImage);
+/** Unmaps memory mapped with cluImageCacheMapFile_internal. */
+static void cluImageCacheUnmapFile_internal(void* mapping, kzUint size);
+/** Maps file privately, so that writes to the mapped pages are not stored to the file. Returns KZ_NULL on failure. */
+static void* cluImageCacheMapFile_internal(kzString path, kzUint* out_size);
+
+
+kzsError cluImageCacheCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluImageCache** out_cache)
+{
+    kzsError result;
+    struct CluImageCache* cache;
+
+    result = kzcMemoryAllocVariable(memoryManager, cache, "Image cache");
+    kzsErrorForward(result);
+
+    result = kzcStringCopy(memoryManager, directory, &cache->directory);
+    kzsErrorForward(result);
+    cache->hitCount = 0;
+    cache->missCount = 0;
+
+    /* Failure is ignored here, as the directory usually exists already. Missing directory is reported when storing entries. */
+    {
+#ifdef WIN32
+        kzInt mkdirResult = (kzInt)_mkdir(directory);
+#else
+        kzInt mkdirResult = (kzInt)mkdir(directory, 0755);
+#endif
+        KZ_UNUSED_RETURN_VALUE(mkdirResult);
+    }
+
+    *out_cache = cache;
+    kzsSuccess();
+}
+
+kzsError cluImageCacheDelete(struct CluImageCache* cache)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    result = kzcStringDelete(cache->directory);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeVariable(cache);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError cluImageCacheLoadPNG(struct CluImageCache* cache, kzString path, kzString hash, kzUint scale, cl_context context,
+                              cl_mem* out_image, struct CluCachedImage** out_cachedImage)
+{
+    kzsError result;
+    cl_int clResult;
+    struct KzcMemoryManager* memoryManager;
+    kzMutableString entryPath;
+    struct CluCachedImage* cachedImage;
+    cl_image_format imageFormat;
+    cl_mem image;
+    kzsError loadResult;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    memoryManager = kzcMemoryGetManager(cache);
+
+    result = kzcStringFormat(memoryManager, "%s/%s_%u.rgba", &entryPath, cache->directory, hash, scale);
+    kzsErrorForward(result);
+
+    /* Entry path is freed before forwarding any error of the lookup. */
+    loadResult = cluImageCacheLoadEntry_internal(cache, path, entryPath, scale, &cachedImage);
+    result = kzcStringDelete(entryPath);
+    kzsErrorForward(result);
+    kzsErrorForward(loadResult);
+
+    imageFormat.image_channel_order = CL_RGBA;
+    imageFormat.image_channel_data_type = CL_UNORM_INT8;
+    image = clCreateImage2D(context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, &imageFormat, (size_t)cachedImage->width, (size_t)cachedImage->height,
+                            (size_t)(cachedImage->width * CLU_IMAGE_CACHE_PIXEL_SIZE), cluCachedImageGetData(cachedImage), &clResult);
+    if(clResult != CL_SUCCESS)
+    {
+        result = cluCachedImageDelete(cachedImage);
+        kzsErrorForward(result);
+    }
+    cluClErrorTest(clResult);
+
+    *out_image = image;
+    *out_cachedImage = cachedImage;
+    kzsSuccess();
+}
+
+kzsError cluCachedImageDelete(struct CluCachedImage* cachedImage)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(cachedImage));
+
+    cluImageCacheUnmapFile_internal(cachedImage->mapping, cachedImage->mappingSize);
+
+    result = kzcMemoryFreeVariable(cachedImage);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzUint cluCachedImageGetWidth(const struct CluCachedImage* cachedImage)
+{
+    kzsAssert(kzcIsValidPointer(cachedImage));
+    return cachedImage->width;
+}
+
+kzUint cluCachedImageGetHeight(const struct CluCachedImage* cachedImage)
+{
+    kzsAssert(kzcIsValidPointer(cachedImage));
+    return cachedImage->height;
+}
+
+void* cluCachedImageGetData(const struct CluCachedImage* cachedImage)
+{
+    kzsAssert(kzcIsValidPointer(cachedImage));
+    return (kzByte*)cachedImage->mapping + CLU_IMAGE_CACHE_HEADER_SIZE;
+}
+
+void cluImageCacheResetStatistics(struct CluImageCache* cache)
+{
+    kzsAssert(kzcIsValidPointer(cache));
+    cache->hitCount = 0;
+    cache->missCount = 0;
+}
+
+kzUint cluImageCacheGetHitCount(const struct CluImageCache* cache)
+{
+    kzsAssert(kzcIsValidPointer(cache));
+    return cache->hitCount;
+}
+
+kzUint cluImageCacheGetMissCount(const struct CluImageCache* cache)
+{
+    kzsAssert(kzcIsValidPointer(cache));
+    return cache->missCount;
+}
+
+static kzsError cluImageCacheLoadEntry_internal(struct CluImageCache* cache, kzString path, kzString entryPath, kzUint scale,
+                                                struct CluCachedImage** out_cachedImage)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(cache);
+    struct CluCachedImage* cachedImage;
+
+    result = cluImageCacheMapEntry_internal(memoryManager, entryPath, &cachedImage);
+    kzsErrorForward(result);
+
+    if(cachedImage != KZ_NULL)
+    {
+        ++cache->hitCount;
+    }
+    else
+    {
+        ++cache->missCount;
+        kzcLogDebug("Decoding '%s' to image cache '%s'", path, entryPath);
+
+        result = cluImageCacheDecodeEntry_internal(memoryManager, path, entryPath, scale);
+        kzsErrorForward(result);
+
+        result = cluImageCacheMapEntry_internal(memoryManager, entryPath, &cachedImage);
+        kzsErrorForward(result);
+        kzsErrorTest(cachedImage != KZ_NULL, KZS_ERROR_FILE_OPERATION_FAILED, "Failed to map image cache entry");
+    }
+
+    *out_cachedImage = cachedImage;
+    kzsSuccess();
+}
+
+static kzsError cluImageCacheDecodeEntry_internal(const struct KzcMemoryManager* memoryManager, kzString path, kzString entryPath, kzUint scale)
+{
+    kzsError result;
+    kzsError writeResult;
+    struct KzcImage* decodedImage;
+
+    result = cluImageDecodePNG(memoryManager, path, scale, &decodedImage);
+    kzsErrorForward(result);
+
+    /* Decoded image is freed also if writing the entry fails, for example when the disk is full. */
+    writeResult = cluImageCacheWriteEntry_internal(memoryManager, entryPath, decodedImage);
+    result = kzcImageDelete(decodedImage);
+    kzsErrorForward(result);
+    kzsErrorForward(writeResult);
+
+    kzsSuccess();
+}
+
+static kzsError cluImageCacheWriteEntry_internal(const struct KzcMemoryManager* memoryManager, kzString entryPath, const struct KzcImage* image)
+{
+    kzsError result;
+    struct KzcOutputStream* stream;
+    kzByte* header;
+    kzUint width = kzcImageGetWidth(image);
+    kzUint height = kzcImageGetHeight(image);
+    kzUint dataSize = width * height * CLU_IMAGE_CACHE_PIXEL_SIZE;
+    kzUint writtenCount;
+    kzsError writeResult;
+    kzBool headerComplete;
+    kzBool dataComplete = KZ_FALSE;
+
+    result = kzcMemoryAllocPointer(memoryManager, &header, CLU_IMAGE_CACHE_HEADER_SIZE, "Image cache entry header");
+    kzsErrorForward(result);
+    kzsMemset(header, 0, CLU_IMAGE_CACHE_HEADER_SIZE);
+    kzsMemcpy(header, CLU_IMAGE_CACHE_MAGIC, CLU_IMAGE_CACHE_MAGIC_LENGTH);
+    kzsMemcpy(&header[CLU_IMAGE_CACHE_MAGIC_LENGTH], &width, sizeof(kzUint));
+    kzsMemcpy(&header[CLU_IMAGE_CACHE_MAGIC_LENGTH + sizeof(kzUint)], &height, sizeof(kzUint));
+
+    result = kzcOutputStreamCreateToFile(memoryManager, entryPath, KZC_IO_STREAM_ENDIANNESS_PLATFORM, &stream);
+    kzsErrorIf(result)
+    {
+        kzsError freeResult = kzcMemoryFreePointer(header);
+        kzsErrorForward(freeResult);
+        kzsErrorForward(result);
+    }
+
+    /* Stream and header are released before a failed write is reported. */
+    writeResult = kzcOutputStreamWrite(stream, CLU_IMAGE_CACHE_HEADER_SIZE, header, &writtenCount);
+    headerComplete = (writtenCount == CLU_IMAGE_CACHE_HEADER_SIZE);
+    if(writeResult == KZS_SUCCESS && headerComplete)
+    {
+        writeResult = kzcOutputStreamWrite(stream, dataSize, (const kzByte*)kzcImageGetData(image), &writtenCount);
+        dataComplete = (writtenCount == dataSize);
+    }
+
+    result = kzcOutputStreamDelete(stream);
+    kzsErrorForward(result);
+    result = kzcMemoryFreePointer(header);
+    kzsErrorForward(result);
+
+    kzsErrorForward(writeResult);
+    kzsErrorTest(headerComplete && dataComplete, KZS_ERROR_FILE_OPERATION_FAILED, "Failed to write image cache entry");
+
+    kzsSuccess();
+}
+
+static kzsError cluImageCacheMapEntry_internal(const struct KzcMemoryManager* memoryManager, kzString entryPath, struct CluCachedImage** out_cachedImage)
+{
+    kzsError result;
+    struct CluCachedImage* cachedImage = KZ_NULL;
+
+    if(kzcFileExists(entryPath))
+    {
+        kzUint size;
+        kzByte* mapping = (kzByte*)cluImageCacheMapFile_internal(entryPath, &size);
+        kzBool validEntry = KZ_FALSE;
+        kzUint width = 0;
+        kzUint height = 0;
+
+        if(mapping != KZ_NULL && size >= CLU_IMAGE_CACHE_HEADER_SIZE)
+        {
+            kzUint i;
+            kzsMemcpy(&width, &mapping[CLU_IMAGE_CACHE_MAGIC_LENGTH], sizeof(kzUint));
+            kzsMemcpy(&height, &mapping[CLU_IMAGE_CACHE_MAGIC_LENGTH + sizeof(kzUint)], sizeof(kzUint));
+
+            validEntry = (width > 0 && height > 0 && size == CLU_IMAGE_CACHE_HEADER_SIZE + width * height * CLU_IMAGE_CACHE_PIXEL_SIZE);
+            for(i = 0; i < CLU_IMAGE_CACHE_MAGIC_LENGTH; ++i)
+            {
+                validEntry &= (kzBool)(mapping[i] == (kzByte)CLU_IMAGE_CACHE_MAGIC[i]);
+            }
+        }
+
+        if(validEntry)
+        {
+            result = kzcMemoryAllocVariable(memoryManager, cachedImage, "Cached image");
+            kzsErrorForward(result);
+            cachedImage->mapping = mapping;
+            cachedImage->mappingSize = size;
+            cachedImage->width = width;
+            cachedImage->height = height;
+        }
+        else
+        {
+            /* Entry is truncated or written by another version. */
+            if(mapping != KZ_NULL)
+            {
+                cluImageCacheUnmapFile_internal(mapping, size);
+            }
+            {
+                kzInt removeResult = (kzInt)remove(entryPath);
+                KZ_UNUSED_RETURN_VALUE(removeResult);
+            }
+            kzcLogDebug("Removed invalid image cache entry '%s'", entryPath);
+        }
+    }
+
+    *out_cachedImage = cachedImage;
+    kzsSuccess();
+}
+
+static void* cluImageCacheMapFile_internal(kzString path, kzUint* out_size)
+{
+    void* mapping = KZ_NULL;
+    kzUint size = 0;
+#ifdef WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, KZ_NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, KZ_NULL);
+    if(file != INVALID_HANDLE_VALUE)
+    {
+        DWORD fileSize = GetFileSize(file, KZ_NULL);
+        if(fileSize != INVALID_FILE_SIZE && fileSize > 0)
+        {
+            HANDLE fileMapping = CreateFileMappingA(file, KZ_NULL, PAGE_WRITECOPY, 0, 0, KZ_NULL);
+            if(fileMapping != KZ_NULL)
+            {
+                /* View keeps the file mapped after the handles are closed. */
+                mapping = MapViewOfFile(fileMapping, FILE_MAP_COPY, 0, 0, 0);
+                size = (kzUint)fileSize;
+                CloseHandle(fileMapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fileDescriptor = open(path, O_RDONLY);
+    if(fileDescriptor >= 0)
+    {
+        struct stat fileStatus;
+        if(fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+        {
+            size = (kzUint)fileStatus.st_size;
+            mapping = mmap(KZ_NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+            if(mapping == MAP_FAILED)
+            {
+                mapping = KZ_NULL;
+            }
+        }
+        close(fileDescriptor);
+    }
+#endif
+    *out_size = size;
+    return mapping;
+}
+
+static void cluImageCacheUnmapFile_internal(void* mapping, kzUint size)
+{
+#ifdef WIN32
+    KZ_UNUSED_PARAMETER(size);
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, (size_t)size);
+#endif
+}
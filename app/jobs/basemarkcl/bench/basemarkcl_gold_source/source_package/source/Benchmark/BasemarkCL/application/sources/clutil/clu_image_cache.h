@@ -0,0 +1,68 @@
+/**
+* \file
+* Persistent on-disk cache of decoded images.
+*
+* Each image is stored as raw RGBA-8888 pixels in an entry file named after the MD5 of the source image file and the
+* scale it was loaded with. Entries are memory mapped and handed to OpenCL with CL_MEM_USE_HOST_PTR, so loading an
+* image does not decode PNG nor allocate memory from the memory manager. Pages are mapped copy-on-write, so kernels
+* writing to the image never modify the entry file.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CLU_IMAGE_CACHE_H
+#define CLU_IMAGE_CACHE_H
+
+#include "clu_opencl_base.h"
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/**
+* \struct CluImageCache
+* Decoded image cache and its hit statistics.
+*/
+struct CluImageCache;
+
+/**
+* \struct CluCachedImage
+* Image mapped from the cache.
+*/
+struct CluCachedImage;
+
+
+/** Creates image cache storing its entries to given directory. Directory is created if it does not exist. */
+kzsError cluImageCacheCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluImageCache** out_cache);
+/** Deletes image cache. Cached entries are left on disk. Images loaded from the cache must be deleted before. */
+kzsError cluImageCacheDelete(struct CluImageCache* cache);
+
+/**
+* Loads PNG image as RGBA-8888 through the cache and creates an OpenCL image using the mapped pixels. Hash is the MD5 of
+* the PNG file, which identifies the entry. On cache miss the PNG is decoded and the entry is written before mapping it.
+* If scale > 0 the image is resized by dividing its size by scale.
+*/
+kzsError cluImageCacheLoadPNG(struct CluImageCache* cache, kzString path, kzString hash, kzUint scale, cl_context context,
+                              cl_mem* out_image, struct CluCachedImage** out_cachedImage);
+/** Unmaps cached image. The OpenCL image created from it must be released before. */
+kzsError cluCachedImageDelete(struct CluCachedImage* cachedImage);
+
+/** Returns width of cached image. */
+kzUint cluCachedImageGetWidth(const struct CluCachedImage* cachedImage);
+/** Returns height of cached image. */
+kzUint cluCachedImageGetHeight(const struct CluCachedImage* cachedImage);
+/** Returns the mapped RGBA-8888 pixels of cached image. */
+void* cluCachedImageGetData(const struct CluCachedImage* cachedImage);
+
+/** Resets cache hit and miss counters. */
+void cluImageCacheResetStatistics(struct CluImageCache* cache);
+/** Returns number of images loaded from cache since last reset. */
+kzUint cluImageCacheGetHitCount(const struct CluImageCache* cache);
+/** Returns number of images decoded into the cache since last reset. */
+kzUint cluImageCacheGetMissCount(const struct CluImageCache* cache);
+
+
+#endif
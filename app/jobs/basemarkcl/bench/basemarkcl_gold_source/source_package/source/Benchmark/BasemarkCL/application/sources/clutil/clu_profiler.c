@@ -6,26 +6,100 @@
 #include "clu_profiler.h"
 
 #include <core/memory/kzc_memory_manager.h>
+#include <core/util/io/kzc_output_stream.h>
+#include <core/util/io/kzc_input_stream.h>
 #include <core/debug/kzc_log.h>
 
+#include <system/kzs_error_codes.h>
+#include <system/thread/kzs_thread.h>
+#include <system/wrappers/kzs_string.h>
+
 #include <stdio.h>
 
 
-kzsError cluProfilerCreate(const struct KzcMemoryManager* manager, size_t maxEvents, kzBool profilingEnabled, struct CluProfiler **out_profiler)
+#define CLU_PROFILER_TRACE_MAGIC "CLUTRC01" /**< Identifier and version of the binary trace format. */
+#define CLU_PROFILER_TRACE_MAGIC_LENGTH 8 /**< Length of the trace identifier. */
+#define CLU_PROFILER_RECORD_END 0 /**< Trace record ending the trace. */
+#define CLU_PROFILER_RECORD_NAME 1 /**< Trace record defining a description: id, length and characters. */
+#define CLU_PROFILER_RECORD_EVENT 2 /**< Trace record of an event: description id, frame, queued, submit, start and end times. */
+#define CLU_PROFILER_RING_FRAMES 4 /**< Capacity of the ring in initial frame event list sizes. */
+#define CLU_PROFILER_DRAIN_BATCH 64 /**< Maximum number of events the drain thread takes from the ring at once. */
+#define CLU_PROFILER_OTHER_KERNELS "Other" /**< Name of the statistics combining descriptions beyond the maximum. */
+
+
+/** Calculates the device busy time and span of the resolved events. Busy time excludes overlap and gaps between commands. */
+static void cluProfilerUpdateDeviceTimes_internal(struct CluProfiler *profiler, size_t eventCount);
+/** Doubles the capacity of the frame event lists. */
+static kzsError cluProfilerGrowEventLists_internal(struct CluProfiler *profiler);
+/** Adds the events of the frame to the ring. Events that do not fit are released and counted as dropped. */
+static kzsError cluProfilerQueueFrameEvents_internal(struct CluProfiler *profiler);
+/** Thread function resolving events from the ring and writing them to the trace until stop is requested and the ring is empty. */
+static kzsError cluProfilerDrain_internal(void* userData);
+/** Resolves one event, writes it to the trace, adds it to the per-kernel statistics and releases it. The event is released also on error. */
+static kzsError cluProfilerTraceEvent_internal(struct CluProfiler *profiler, const struct CluProfilerTraceEvent* traceEvent);
+/** Waits for an event and gets its profiling timestamps. */
+static kzsError cluProfilerResolveEvent_internal(cl_event event, cl_ulong* out_queued, cl_ulong* out_submit, cl_ulong* out_start, cl_ulong* out_end);
+/** Returns time in microseconds from base time to given device timestamp. Negative if the timestamp is before the base time. */
+static kzDouble cluProfilerGetRelativeTime_internal(cl_ulong time, cl_ulong baseTime);
+/** Writes 64-bit value to trace as two 32-bit values, high part first. */
+static kzsError cluProfilerWriteU64_internal(struct KzcOutputStream* outputStream, cl_ulong value);
+/** Reads 64-bit value written with cluProfilerWriteU64_internal. */
+static kzsError cluProfilerReadU64_internal(struct KzcInputStream* inputStream, cl_ulong* out_value);
+/** Writes string to JSON output, escaping quotes, backslashes and control characters. */
+static kzsError cluProfilerWriteJsonString_internal(struct KzcOutputStream* outputStream, kzString string);
+
+
+kzsError cluProfilerCreate(const struct KzcMemoryManager* manager, size_t maxEvents, kzBool deviceTimingEnabled, kzBool traceEnabled, struct CluProfiler **out_profiler)
 {
     struct CluProfiler *profiler;
     kzsError result;
 
+    kzsAssert(maxEvents > 0);
+
     result = kzcMemoryAllocVariable(manager, profiler, "cluProfiler");
     kzsErrorForward(result);
     profiler->maxEvents = maxEvents;
     profiler->eventCount = 0;
-    profiler->profilingEnabled = profilingEnabled;
+    profiler->profilingEnabled = deviceTimingEnabled || traceEnabled;
+    profiler->deviceTimingEnabled = deviceTimingEnabled;
+    profiler->traceEnabled = traceEnabled;
+    profiler->deviceBusyTime = 0;
+    profiler->deviceSpanTime = 0;
+    profiler->deviceEventCount = 0;
+    profiler->frameIndex = 0;
+    profiler->eventListGrowCount = 0;
+    profiler->ring = KZ_NULL;
+    profiler->ringCapacity = 0;
+    profiler->ringHead = 0;
+    profiler->ringCount = 0;
+    profiler->stopRequested = KZ_FALSE;
+    profiler->ringLock = KZ_NULL;
+    profiler->drainThread = KZ_NULL;
+    profiler->droppedEventCount = 0;
+    profiler->traceStream = KZ_NULL;
+    profiler->kernelStatistics = KZ_NULL;
+    profiler->kernelCount = 0;
+    profiler->tracedEventCount = 0;
 
     result = kzcMemoryAllocArray(manager, profiler->eventList, maxEvents, "List of cl_events for profiler");
     kzsErrorForward(result);
     result = kzcMemoryAllocArray(manager, profiler->stringList, maxEvents, "List description strings for profiler");
     kzsErrorForward(result);
+    result = kzcMemoryAllocArray(manager, profiler->eventStartList, maxEvents, "List of event start times for profiler");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(manager, profiler->eventEndList, maxEvents, "List of event end times for profiler");
+    kzsErrorForward(result);
+
+    if(traceEnabled)
+    {
+        profiler->ringCapacity = maxEvents * CLU_PROFILER_RING_FRAMES;
+        result = kzcMemoryAllocArray(manager, profiler->ring, profiler->ringCapacity, "Profiler trace ring");
+        kzsErrorForward(result);
+        result = kzcMemoryAllocArray(manager, profiler->kernelStatistics, CLU_PROFILER_MAXIMUM_KERNELS, "Profiler kernel statistics");
+        kzsErrorForward(result);
+        result = kzsThreadLockCreate(&profiler->ringLock);
+        kzsErrorForward(result);
+    }
 
     *out_profiler = profiler;
     kzsSuccess();
@@ -34,54 +108,698 @@ kzsError cluProfilerCreate(const struct KzcMemoryManager* manager, size_t maxEve
 kzsError cluProfilerDelete(struct CluProfiler *profiler)
 {
     kzsError result;
+
+    result = cluProfilerEndTrace(profiler);
+    kzsErrorForward(result);
+
+    if(profiler->traceEnabled)
+    {
+        result = kzsThreadLockDelete(profiler->ringLock);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(profiler->kernelStatistics);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(profiler->ring);
+        kzsErrorForward(result);
+    }
+
     result = kzcMemoryFreeArray(profiler->eventList);
     kzsErrorForward(result);
     result = kzcMemoryFreeArray(profiler->stringList);
     kzsErrorForward(result);
+    result = kzcMemoryFreeArray(profiler->eventStartList);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(profiler->eventEndList);
+    kzsErrorForward(result);
     result = kzcMemoryFreeVariable(profiler);
     kzsErrorForward(result);
     kzsSuccess();
 }
 
-kzsError cluProfilerLogEvents(struct CluProfiler *profiler)
+kzsError cluProfilerEndFrame(struct CluProfiler *profiler)
 {
-    cl_ulong cQueued = 0;
-    cl_ulong cSubmit = 0;
-    cl_ulong cStart = 0;
-    cl_ulong cEnd = 0;
-    kzChar logstring[512];
+    kzsError result;
     size_t i;
-    size_t Events = profiler->eventCount;
+    size_t eventCount = profiler->eventCount;
     cl_int clResult;
-    for(i = 0; i < Events; i++)
-    {   
-        clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), &cQueued, NULL);
-        cluClErrorTest(clResult);
-        clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), &cSubmit, NULL);
-        cluClErrorTest(clResult);
-        clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &cStart, NULL);
-        cluClErrorTest(clResult);
-        clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &cEnd, NULL);
-        cluClErrorTest(clResult);
-        clResult = clReleaseEvent(profiler->eventList[i]); /* Consider if it's wise to release the events here. As of now however this is good enough. */
-        cluClErrorTest(clResult);
-        sprintf(logstring, "PROFILING %s %llu %llu %llu %llu", profiler->stringList[i], cQueued, cSubmit, cStart, cEnd);
-        kzsLog(KZS_LOG_LEVEL_INFO, (kzString)logstring);
+
+    if(profiler->deviceTimingEnabled)
+    {
+        if(eventCount > 0)
+        {
+            clResult = clWaitForEvents((cl_uint)eventCount, profiler->eventList);
+            cluClErrorTest(clResult);
+        }
+        for(i = 0; i < eventCount; i++)
+        {
+            clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &profiler->eventStartList[i], NULL);
+            cluClErrorTest(clResult);
+            clResult = clGetEventProfilingInfo(profiler->eventList[i], CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &profiler->eventEndList[i], NULL);
+            cluClErrorTest(clResult);
+        }
+        cluProfilerUpdateDeviceTimes_internal(profiler, eventCount);
     }
+
+    if(profiler->drainThread != KZ_NULL)
+    {
+        /* The drain thread releases the events after resolving them. */
+        result = cluProfilerQueueFrameEvents_internal(profiler);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        for(i = 0; i < eventCount; i++)
+        {
+            clResult = clReleaseEvent(profiler->eventList[i]);
+            cluClErrorTest(clResult);
+        }
+    }
+
     profiler->eventCount = 0;
+    ++profiler->frameIndex;
     kzsSuccess();
 }
 
+static void cluProfilerUpdateDeviceTimes_internal(struct CluProfiler *profiler, size_t eventCount)
+{
+    size_t i;
+    cl_ulong busyTime = 0;
+    cl_ulong firstStart;
+    cl_ulong lastEnd;
+    cl_ulong intervalStart;
+    cl_ulong intervalEnd;
+    cl_ulong* starts = profiler->eventStartList;
+    cl_ulong* ends = profiler->eventEndList;
+
+    if(eventCount == 0)
+    {
+        profiler->deviceBusyTime = 0;
+        profiler->deviceSpanTime = 0;
+        profiler->deviceEventCount = 0;
+        return;
+    }
+
+    /* Sort intervals by start time. Events from in-order queues are nearly sorted already, so insertion sort is enough. */
+    for(i = 1; i < eventCount; ++i)
+    {
+        cl_ulong start = starts[i];
+        cl_ulong end = ends[i];
+        size_t j = i;
+        while(j > 0 && starts[j - 1] > start)
+        {
+            starts[j] = starts[j - 1];
+            ends[j] = ends[j - 1];
+            --j;
+        }
+        starts[j] = start;
+        ends[j] = end;
+    }
+
+    /* Sum the union of the intervals, so that overlapping commands are counted only once. */
+    firstStart = starts[0];
+    lastEnd = ends[0];
+    intervalStart = starts[0];
+    intervalEnd = ends[0];
+    for(i = 1; i < eventCount; ++i)
+    {
+        if(starts[i] > intervalEnd)
+        {
+            busyTime += intervalEnd - intervalStart;
+            intervalStart = starts[i];
+            intervalEnd = ends[i];
+        }
+        else if(ends[i] > intervalEnd)
+        {
+            intervalEnd = ends[i];
+        }
+        if(ends[i] > lastEnd)
+        {
+            lastEnd = ends[i];
+        }
+    }
+    busyTime += intervalEnd - intervalStart;
+
+    profiler->deviceBusyTime = busyTime;
+    profiler->deviceSpanTime = lastEnd - firstStart;
+    profiler->deviceEventCount = eventCount;
+}
+
+static kzsError cluProfilerGrowEventLists_internal(struct CluProfiler *profiler)
+{
+    kzsError result;
+    struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(profiler);
+    size_t capacity = profiler->maxEvents * 2;
+    cl_event* eventList;
+    kzString* stringList;
+    cl_ulong* eventStartList;
+    cl_ulong* eventEndList;
+
+    result = kzcMemoryAllocArray(memoryManager, eventList, capacity, "List of cl_events for profiler");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, stringList, capacity, "List description strings for profiler");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, eventStartList, capacity, "List of event start times for profiler");
+    kzsErrorForward(result);
+    result = kzcMemoryAllocArray(memoryManager, eventEndList, capacity, "List of event end times for profiler");
+    kzsErrorForward(result);
+
+    /* Timestamps are resolved only when the frame ends, so only the events and descriptions need to be kept. */
+    kzsMemcpy(eventList, profiler->eventList, profiler->eventCount * sizeof(*eventList));
+    kzsMemcpy(stringList, profiler->stringList, profiler->eventCount * sizeof(*stringList));
+
+    result = kzcMemoryFreeArray(profiler->eventList);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(profiler->stringList);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(profiler->eventStartList);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeArray(profiler->eventEndList);
+    kzsErrorForward(result);
+
+    profiler->eventList = eventList;
+    profiler->stringList = stringList;
+    profiler->eventStartList = eventStartList;
+    profiler->eventEndList = eventEndList;
+    profiler->maxEvents = capacity;
+    ++profiler->eventListGrowCount;
+
+    kzsSuccess();
+}
+
+static kzsError cluProfilerQueueFrameEvents_internal(struct CluProfiler *profiler)
+{
+    kzsError result;
+    cl_int clResult;
+    size_t i = 0;
+
+    result = kzsThreadLockAcquire(profiler->ringLock);
+    kzsErrorForward(result);
+    while(i < profiler->eventCount && profiler->ringCount < profiler->ringCapacity)
+    {
+        struct CluProfilerTraceEvent* traceEvent = &profiler->ring[(profiler->ringHead + profiler->ringCount) % profiler->ringCapacity];
+        traceEvent->event = profiler->eventList[i];
+        traceEvent->description = profiler->stringList[i];
+        traceEvent->frame = profiler->frameIndex;
+        ++profiler->ringCount;
+        ++i;
+    }
+    result = kzsThreadLockSet(profiler->ringLock, KZ_TRUE, KZ_FALSE);
+    kzsErrorForward(result);
+    result = kzsThreadLockRelease(profiler->ringLock);
+    kzsErrorForward(result);
+
+    /* Waiting for the drain thread would add its work to the frame time, so the events that do not fit are dropped instead. */
+    for(; i < profiler->eventCount; ++i)
+    {
+        clResult = clReleaseEvent(profiler->eventList[i]);
+        cluClErrorTest(clResult);
+        ++profiler->droppedEventCount;
+    }
+
+    kzsSuccess();
+}
+
+static kzsError cluProfilerDrain_internal(void* userData)
+{
+    kzsError result;
+    struct CluProfiler* profiler = (struct CluProfiler*)userData;
+    struct CluProfilerTraceEvent batch[CLU_PROFILER_DRAIN_BATCH];
+    kzBool running = KZ_TRUE;
+
+    while(running)
+    {
+        size_t batchCount = 0;
+        size_t i;
+
+        result = kzsThreadLockAcquire(profiler->ringLock);
+        kzsErrorForward(result);
+        while(profiler->ringCount == 0 && !profiler->stopRequested)
+        {
+            result = kzsThreadLockWaitAndReset(profiler->ringLock, KZ_FALSE);
+            kzsErrorForward(result);
+        }
+        while(batchCount < CLU_PROFILER_DRAIN_BATCH && profiler->ringCount > 0)
+        {
+            batch[batchCount] = profiler->ring[profiler->ringHead];
+            profiler->ringHead = (profiler->ringHead + 1) % profiler->ringCapacity;
+            --profiler->ringCount;
+            ++batchCount;
+        }
+        running = !(profiler->stopRequested && profiler->ringCount == 0);
+        result = kzsThreadLockRelease(profiler->ringLock);
+        kzsErrorForward(result);
+
+        for(i = 0; i < batchCount; ++i)
+        {
+            result = cluProfilerTraceEvent_internal(profiler, &batch[i]);
+            if(result != KZS_SUCCESS)
+            {
+                /* Rest of the batch is no longer in the ring, so it is released here. */
+                for(++i; i < batchCount; ++i)
+                {
+                    cl_int clResult = clReleaseEvent(batch[i].event);
+                    KZ_UNUSED_RETURN_VALUE(clResult);
+                }
+            }
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static kzsError cluProfilerTraceEvent_internal(struct CluProfiler *profiler, const struct CluProfilerTraceEvent* traceEvent)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_ulong queued;
+    cl_ulong submit;
+    cl_ulong start;
+    cl_ulong end;
+    kzUint kernelIndex;
+    struct CluProfilerKernelStatistics* statistics;
+    kzsError resolveResult;
+
+    resolveResult = cluProfilerResolveEvent_internal(traceEvent->event, &queued, &submit, &start, &end);
+    clResult = clReleaseEvent(traceEvent->event);
+    kzsErrorForward(resolveResult);
+    cluClErrorTest(clResult);
+
+    /* Descriptions are usually string literals, so comparing pointers finds most of them. */
+    for(kernelIndex = 0; kernelIndex < profiler->kernelCount; ++kernelIndex)
+    {
+        kzString name = profiler->kernelStatistics[kernelIndex].name;
+        if(name == traceEvent->description || kzcStringIsEqual(name, traceEvent->description))
+        {
+            break;
+        }
+    }
+
+    if(kernelIndex == profiler->kernelCount)
+    {
+        kzString name = traceEvent->description;
+        if(profiler->kernelCount == CLU_PROFILER_MAXIMUM_KERNELS - 1)
+        {
+            name = CLU_PROFILER_OTHER_KERNELS;
+        }
+        if(profiler->kernelCount < CLU_PROFILER_MAXIMUM_KERNELS)
+        {
+            statistics = &profiler->kernelStatistics[profiler->kernelCount];
+            statistics->name = name;
+            statistics->count = 0;
+            statistics->totalTime = 0;
+            statistics->minimumTime = end - start;
+            statistics->maximumTime = end - start;
+            statistics->totalQueueTime = 0;
+            ++profiler->kernelCount;
+
+            result = kzcOutputStreamWriteU8(profiler->traceStream, CLU_PROFILER_RECORD_NAME);
+            kzsErrorForward(result);
+            result = kzcOutputStreamWriteU32(profiler->traceStream, kernelIndex);
+            kzsErrorForward(result);
+            result = kzcOutputStreamWriteU32(profiler->traceStream, kzcStringLength(name));
+            kzsErrorForward(result);
+            result = kzcOutputStreamWriteBytes(profiler->traceStream, kzcStringLength(name), (const kzByte*)name);
+            kzsErrorForward(result);
+        }
+        else
+        {
+            kernelIndex = CLU_PROFILER_MAXIMUM_KERNELS - 1;
+        }
+    }
+
+    statistics = &profiler->kernelStatistics[kernelIndex];
+    ++statistics->count;
+    statistics->totalTime += end - start;
+    statistics->totalQueueTime += start - queued;
+    if(end - start < statistics->minimumTime)
+    {
+        statistics->minimumTime = end - start;
+    }
+    if(end - start > statistics->maximumTime)
+    {
+        statistics->maximumTime = end - start;
+    }
+
+    result = kzcOutputStreamWriteU8(profiler->traceStream, CLU_PROFILER_RECORD_EVENT);
+    kzsErrorForward(result);
+    result = kzcOutputStreamWriteU32(profiler->traceStream, kernelIndex);
+    kzsErrorForward(result);
+    result = kzcOutputStreamWriteU32(profiler->traceStream, traceEvent->frame);
+    kzsErrorForward(result);
+    result = cluProfilerWriteU64_internal(profiler->traceStream, queued);
+    kzsErrorForward(result);
+    result = cluProfilerWriteU64_internal(profiler->traceStream, submit);
+    kzsErrorForward(result);
+    result = cluProfilerWriteU64_internal(profiler->traceStream, start);
+    kzsErrorForward(result);
+    result = cluProfilerWriteU64_internal(profiler->traceStream, end);
+    kzsErrorForward(result);
+
+    ++profiler->tracedEventCount;
+    kzsSuccess();
+}
+
+static kzsError cluProfilerResolveEvent_internal(cl_event event, cl_ulong* out_queued, cl_ulong* out_submit, cl_ulong* out_start, cl_ulong* out_end)
+{
+    cl_int clResult;
+
+    /* Commands of the frame may still be executing, but waiting here does not affect the timed frames. */
+    clResult = clWaitForEvents(1, &event);
+    cluClErrorTest(clResult);
+    clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED, sizeof(cl_ulong), out_queued, NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_SUBMIT, sizeof(cl_ulong), out_submit, NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), out_start, NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), out_end, NULL);
+    cluClErrorTest(clResult);
+
+    kzsSuccess();
+}
 
 kzsError cluProfilerAddEvent_private(struct CluProfiler *profiler, kzString description, cl_event profilingEvent)
 {
-    if(profiler->eventCount < profiler->maxEvents)
-    {  
-        profiler->eventList[profiler->eventCount] = profilingEvent;
-        profiler->stringList[profiler->eventCount] = description;
-        profiler->eventCount += 1;
+    kzsError result;
+
+    if(profiler->eventCount == profiler->maxEvents)
+    {
+        result = cluProfilerGrowEventLists_internal(profiler);
+        kzsErrorForward(result);
+    }
+
+    profiler->eventList[profiler->eventCount] = profilingEvent;
+    profiler->stringList[profiler->eventCount] = description;
+    profiler->eventCount += 1;
+
+    kzsSuccess();
+}
+
+kzBool cluProfilerHasDeviceTimes(const struct CluProfiler *profiler)
+{
+    return profiler->deviceEventCount > 0;
+}
+
+kzUint cluProfilerGetDeviceBusyTime(const struct CluProfiler *profiler)
+{
+    return (kzUint)(profiler->deviceBusyTime / 1000);
+}
+
+kzUint cluProfilerGetDeviceSpanTime(const struct CluProfiler *profiler)
+{
+    return (kzUint)(profiler->deviceSpanTime / 1000);
+}
+
+kzsError cluProfilerBeginTrace(struct CluProfiler *profiler, kzString tracePath)
+{
+    kzsError result;
+
+    if(profiler->traceEnabled)
+    {
+        result = cluProfilerEndTrace(profiler);
+        kzsErrorForward(result);
+
+        result = kzcOutputStreamCreateToFile(kzcMemoryGetManager(profiler), tracePath, KZC_IO_STREAM_ENDIANNESS_LITTLE_ENDIAN, &profiler->traceStream);
+        kzsErrorForward(result);
+        result = kzcOutputStreamWriteBytes(profiler->traceStream, CLU_PROFILER_TRACE_MAGIC_LENGTH, (const kzByte*)CLU_PROFILER_TRACE_MAGIC);
+        kzsErrorForward(result);
+
+        profiler->frameIndex = 0;
+        profiler->eventListGrowCount = 0;
+        profiler->ringHead = 0;
+        profiler->ringCount = 0;
+        profiler->stopRequested = KZ_FALSE;
+        profiler->droppedEventCount = 0;
+        profiler->kernelCount = 0;
+        profiler->tracedEventCount = 0;
+
+        result = kzsThreadLockSet(profiler->ringLock, KZ_FALSE, KZ_TRUE);
+        kzsErrorForward(result);
+        result = kzsThreadCreate(cluProfilerDrain_internal, profiler, KZ_FALSE, &profiler->drainThread);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
+kzsError cluProfilerEndTrace(struct CluProfiler *profiler)
+{
+    kzsError result;
+
+    if(profiler->drainThread != KZ_NULL)
+    {
+        kzsError drainResult;
+
+        result = kzsThreadLockAcquire(profiler->ringLock);
+        kzsErrorForward(result);
+        profiler->stopRequested = KZ_TRUE;
+        result = kzsThreadLockSet(profiler->ringLock, KZ_TRUE, KZ_FALSE);
+        kzsErrorForward(result);
+        result = kzsThreadLockRelease(profiler->ringLock);
+        kzsErrorForward(result);
+
+        result = kzsThreadJoin(profiler->drainThread);
+        kzsErrorForward(result);
+        drainResult = kzsThreadGetExitResult(profiler->drainThread);
+        result = kzsThreadDelete(profiler->drainThread);
+        kzsErrorForward(result);
+        profiler->drainThread = KZ_NULL;
+
+        /* Drain thread stops at the first error and leaves the rest of the events in the ring. */
+        while(profiler->ringCount > 0)
+        {
+            cl_int clResult = clReleaseEvent(profiler->ring[profiler->ringHead].event);
+            KZ_UNUSED_RETURN_VALUE(clResult);
+            profiler->ringHead = (profiler->ringHead + 1) % profiler->ringCapacity;
+            --profiler->ringCount;
+        }
+
+        result = kzcOutputStreamWriteU8(profiler->traceStream, CLU_PROFILER_RECORD_END);
+        kzsErrorForward(result);
+        result = kzcOutputStreamDelete(profiler->traceStream);
+        kzsErrorForward(result);
+        profiler->traceStream = KZ_NULL;
+
+        kzsErrorForward(drainResult);
+
+        if(profiler->droppedEventCount > 0 || profiler->eventListGrowCount > 0)
+        {
+            kzcLogDebug("Profiler dropped %u events from trace and grew frame event lists %u times", profiler->droppedEventCount, profiler->eventListGrowCount);
+        }
     }
 
     kzsSuccess();
+}
+
+kzBool cluProfilerIsTracing(const struct CluProfiler *profiler)
+{
+    return profiler->drainThread != KZ_NULL;
+}
+
+kzUint cluProfilerGetKernelCount(const struct CluProfiler *profiler)
+{
+    return profiler->kernelCount;
+}
+
+const struct CluProfilerKernelStatistics* cluProfilerGetKernelStatistics(const struct CluProfiler *profiler, kzUint index)
+{
+    kzsAssert(index < profiler->kernelCount);
+    return &profiler->kernelStatistics[index];
+}
+
+kzUint cluProfilerGetDroppedEventCount(const struct CluProfiler *profiler)
+{
+    return profiler->droppedEventCount;
+}
+
+static kzsError cluProfilerWriteU64_internal(struct KzcOutputStream* outputStream, cl_ulong value)
+{
+    kzsError result;
 
+    result = kzcOutputStreamWriteU32(outputStream, (kzU32)(value >> 32));
+    kzsErrorForward(result);
+    result = kzcOutputStreamWriteU32(outputStream, (kzU32)(value & 0xFFFFFFFFu));
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError cluProfilerReadU64_internal(struct KzcInputStream* inputStream, cl_ulong* out_value)
+{
+    kzsError result;
+    kzU32 high;
+    kzU32 low;
+
+    result = kzcInputStreamReadU32(inputStream, &high);
+    kzsErrorForward(result);
+    result = kzcInputStreamReadU32(inputStream, &low);
+    kzsErrorForward(result);
+
+    *out_value = ((cl_ulong)high << 32) | (cl_ulong)low;
+    kzsSuccess();
+}
+
+static kzsError cluProfilerWriteJsonString_internal(struct KzcOutputStream* outputStream, kzString string)
+{
+    kzsError result;
+    kzUint i;
+    kzUint length = kzcStringLength(string);
+
+    result = kzcOutputStreamWriteU8(outputStream, (kzU8)'"');
+    kzsErrorForward(result);
+    for(i = 0; i < length; ++i)
+    {
+        kzChar character = string[i];
+        if(character == '"' || character == '\\')
+        {
+            result = kzcOutputStreamWriteU8(outputStream, (kzU8)'\\');
+            kzsErrorForward(result);
+        }
+        else if((kzU8)character < 0x20)
+        {
+            character = ' ';
+        }
+        result = kzcOutputStreamWriteU8(outputStream, (kzU8)character);
+        kzsErrorForward(result);
+    }
+    result = kzcOutputStreamWriteU8(outputStream, (kzU8)'"');
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzDouble cluProfilerGetRelativeTime_internal(cl_ulong time, cl_ulong baseTime)
+{
+    return (time >= baseTime) ? (kzDouble)(time - baseTime) / 1000.0 : -(kzDouble)(baseTime - time) / 1000.0;
+}
+
+kzsError cluProfilerConvertTraceToJson(const struct KzcMemoryManager* manager, kzString tracePath, kzString jsonPath)
+{
+    kzsError result;
+    struct KzcInputStream* inputStream;
+    struct KzcOutputStream* outputStream;
+    kzMutableString names[CLU_PROFILER_MAXIMUM_KERNELS];
+    kzByte magic[CLU_PROFILER_TRACE_MAGIC_LENGTH];
+    kzUint nameCount = 0;
+    kzUint eventCount = 0;
+    cl_ulong baseTime = 0;
+    kzBool ended = KZ_FALSE;
+    kzString header = "{\"traceEvents\":[";
+    kzString footer = "\n],\"displayTimeUnit\":\"ns\"}\n";
+    kzUint i;
+
+    result = kzcInputStreamCreateFromFile(manager, tracePath, KZC_IO_STREAM_ENDIANNESS_LITTLE_ENDIAN, &inputStream);
+    kzsErrorForward(result);
+    result = kzcInputStreamReadBytes(inputStream, CLU_PROFILER_TRACE_MAGIC_LENGTH, magic);
+    kzsErrorForward(result);
+    for(i = 0; i < CLU_PROFILER_TRACE_MAGIC_LENGTH; ++i)
+    {
+        kzsErrorTest(magic[i] == (kzByte)CLU_PROFILER_TRACE_MAGIC[i], KZS_ERROR_ILLEGAL_ARGUMENT, "Unknown profiler trace format");
+    }
+
+    result = kzcOutputStreamCreateToFile(manager, jsonPath, KZC_IO_STREAM_ENDIANNESS_UNSPECIFIED, &outputStream);
+    kzsErrorForward(result);
+    result = kzcOutputStreamWriteBytes(outputStream, kzcStringLength(header), (const kzByte*)header);
+    kzsErrorForward(result);
+
+    while(!ended)
+    {
+        kzU8 recordType;
+        result = kzcInputStreamReadU8(inputStream, &recordType);
+        kzsErrorForward(result);
+
+        switch(recordType)
+        {
+            case CLU_PROFILER_RECORD_NAME:
+            {
+                kzU32 id;
+                kzU32 length;
+                result = kzcInputStreamReadU32(inputStream, &id);
+                kzsErrorForward(result);
+                result = kzcInputStreamReadU32(inputStream, &length);
+                kzsErrorForward(result);
+                kzsErrorTest(id == nameCount && id < CLU_PROFILER_MAXIMUM_KERNELS, KZS_ERROR_ILLEGAL_ARGUMENT, "Invalid name in profiler trace");
+                result = kzcStringAllocate(manager, length, &names[id]);
+                kzsErrorForward(result);
+                result = kzcInputStreamReadBytes(inputStream, length, (kzByte*)names[id]);
+                kzsErrorForward(result);
+                names[id][length] = '\0';
+                ++nameCount;
+                break;
+            }
+
+            case CLU_PROFILER_RECORD_EVENT:
+            {
+                kzU32 id;
+                kzU32 frame;
+                cl_ulong queued;
+                cl_ulong submit;
+                cl_ulong start;
+                cl_ulong end;
+                kzChar line[256];
+
+                result = kzcInputStreamReadU32(inputStream, &id);
+                kzsErrorForward(result);
+                result = kzcInputStreamReadU32(inputStream, &frame);
+                kzsErrorForward(result);
+                result = cluProfilerReadU64_internal(inputStream, &queued);
+                kzsErrorForward(result);
+                result = cluProfilerReadU64_internal(inputStream, &submit);
+                kzsErrorForward(result);
+                result = cluProfilerReadU64_internal(inputStream, &start);
+                kzsErrorForward(result);
+                result = cluProfilerReadU64_internal(inputStream, &end);
+                kzsErrorForward(result);
+                kzsErrorTest(id < nameCount, KZS_ERROR_ILLEGAL_ARGUMENT, "Undefined name in profiler trace");
+
+                /* Chrome trace timestamps are in microseconds. Device timestamps are made relative to the first queued command. Commands
+                   of other queues may have earlier timestamps, which are negative. */
+                if(eventCount == 0)
+                {
+                    baseTime = queued;
+                }
+
+                result = kzcOutputStreamWriteBytes(outputStream, (eventCount == 0) ? 2 : 3, (const kzByte*)((eventCount == 0) ? "\n{" : ",\n{"));
+                kzsErrorForward(result);
+                result = kzcOutputStreamWriteBytes(outputStream, 7, (const kzByte*)"\"name\":");
+                kzsErrorForward(result);
+                result = cluProfilerWriteJsonString_internal(outputStream, names[id]);
+                kzsErrorForward(result);
+                sprintf(line, ",\"cat\":\"opencl\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"queued\":%.3f,\"submit\":%.3f}}",
+                        cluProfilerGetRelativeTime_internal(start, baseTime), cluProfilerGetRelativeTime_internal(end, start), (kzUint)frame,
+                        cluProfilerGetRelativeTime_internal(queued, baseTime), cluProfilerGetRelativeTime_internal(submit, baseTime));
+                result = kzcOutputStreamWriteBytes(outputStream, kzcStringLength(line), (const kzByte*)line);
+                kzsErrorForward(result);
+
+                ++eventCount;
+                break;
+            }
+
+            case CLU_PROFILER_RECORD_END:
+            {
+                ended = KZ_TRUE;
+                break;
+            }
+
+            default:
+            {
+                kzsErrorThrow(KZS_ERROR_ILLEGAL_ARGUMENT, "Invalid record in profiler trace");
+            }
+        }
+    }
+
+    result = kzcOutputStreamWriteBytes(outputStream, kzcStringLength(footer), (const kzByte*)footer);
+    kzsErrorForward(result);
+    result = kzcOutputStreamDelete(outputStream);
+    kzsErrorForward(result);
+    result = kzcInputStreamDelete(inputStream);
+    kzsErrorForward(result);
+
+    for(i = 0; i < nameCount; ++i)
+    {
+        result = kzcStringDelete(names[i]);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
 }
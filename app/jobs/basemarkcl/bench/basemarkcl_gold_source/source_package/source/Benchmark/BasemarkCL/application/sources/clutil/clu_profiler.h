@@ -17,18 +17,76 @@
 #include <system/wrappers/kzs_memory.h>
 
 
-struct CluProfiler 
+/** Maximum number of distinct event descriptions in the per-kernel statistics. Further descriptions are combined. */
+#define CLU_PROFILER_MAXIMUM_KERNELS 128
+
+
+/* Forward declarations. */
+struct KzcOutputStream;
+struct KzsThread;
+struct KzsThreadLock;
+
+
+/** Aggregated statistics of the traced events with the same description. Times are in nanoseconds. */
+struct CluProfilerKernelStatistics
+{
+    kzString name; /**< Description of the events. */
+    kzUint count; /**< Number of events. */
+    cl_ulong totalTime; /**< Sum of execution times from command start to end. */
+    cl_ulong minimumTime; /**< Shortest execution time. */
+    cl_ulong maximumTime; /**< Longest execution time. */
+    cl_ulong totalQueueTime; /**< Sum of times from command enqueue to start. */
+};
+
+/** Event handed from a finished frame to the trace drain thread. */
+struct CluProfilerTraceEvent
+{
+    cl_event event; /**< Event, released by the drain thread. */
+    kzString description; /**< Description of the event. */
+    kzUint frame; /**< Index of the frame the event belongs to. */
+};
+
+struct CluProfiler
 {
-    size_t maxEvents;
+    size_t maxEvents; /**< Capacity of the frame event lists. The lists grow if a frame has more events. */
     size_t eventCount;
-    kzBool profilingEnabled;
+    kzBool profilingEnabled; /**< Events are collected and command queues are created with profiling enabled. */
+    kzBool deviceTimingEnabled; /**< Device times of each frame are resolved when the frame ends. */
+    kzBool traceEnabled; /**< Collected events are drained to a trace file on a background thread. */
     kzString *stringList;
     cl_event *eventList;
+    cl_ulong *eventStartList; /**< Command start timestamps of the collected events, used for device timing. */
+    cl_ulong *eventEndList; /**< Command end timestamps of the collected events, used for device timing. */
+    cl_ulong deviceBusyTime; /**< Time device was executing commands during last ended frame, in nanoseconds. */
+    cl_ulong deviceSpanTime; /**< Time from first command start to last command end during last ended frame, in nanoseconds. */
+    size_t deviceEventCount; /**< Number of events whose device times were resolved for last ended frame. */
+    kzUint frameIndex; /**< Number of frames ended since the trace was started. */
+    kzUint eventListGrowCount; /**< Number of times the frame event lists were grown. */
+
+    struct CluProfilerTraceEvent* ring; /**< Events waiting for the drain thread. */
+    size_t ringCapacity; /**< Capacity of the ring. */
+    size_t ringHead; /**< Index of the oldest event in the ring. */
+    size_t ringCount; /**< Number of events in the ring. */
+    kzBool stopRequested; /**< Drain thread exits when the ring is empty. */
+    struct KzsThreadLock* ringLock; /**< Protects the ring. Set when events are added or stop is requested. */
+    struct KzsThread* drainThread; /**< Thread resolving the events and writing the trace, or KZ_NULL if no trace is running. */
+    kzUint droppedEventCount; /**< Number of events released without tracing because the ring was full. */
+
+    struct KzcOutputStream* traceStream; /**< Binary trace file, written only by the drain thread. */
+    struct CluProfilerKernelStatistics* kernelStatistics; /**< Per-kernel statistics, written only by the drain thread. */
+    kzUint kernelCount; /**< Number of used per-kernel statistics. */
+    kzUint tracedEventCount; /**< Number of events written to the trace. */
 };
 
 
-kzsError cluProfilerCreate(const struct KzcMemoryManager* manager, size_t maxEvents, kzBool profilingEnabled, struct CluProfiler **out_profiler);
+/**
+* Creates profiler. Events are collected if deviceTimingEnabled or traceEnabled is KZ_TRUE. With device timing the device
+* timestamps of each frame are resolved in cluProfilerEndFrame. With trace the events are drained on a background thread
+* between cluProfilerBeginTrace and cluProfilerEndTrace. maxEvents is the initial number of events per frame.
+*/
+kzsError cluProfilerCreate(const struct KzcMemoryManager* manager, size_t maxEvents, kzBool deviceTimingEnabled, kzBool traceEnabled, struct CluProfiler **out_profiler);
 
+/** Deletes profiler. Running trace is ended first. */
 kzsError cluProfilerDelete(struct CluProfiler *profiler);
 
 #define cluProfilerAddEvent(profiler_param, description_param, event_param) \
@@ -36,9 +94,46 @@ kzsError cluProfilerDelete(struct CluProfiler *profiler);
     if(profiler_param->profilingEnabled) {kzsError cResult = cluProfilerAddEvent_private(profiler_param, description_param, event_param); kzsErrorForward(cResult);} else {cl_int errResult = clReleaseEvent(event_param); cluClErrorTest(errResult);} \
 }
 
+/**
+* Adds event to the current frame. The profiler takes ownership of the event. The description is not copied, so it must stay
+* valid as long as the profiler is used, because the drain thread and the per-kernel statistics refer to it. Use string literals.
+*/
 kzsError cluProfilerAddEvent_private(struct CluProfiler *profiler, kzString description, cl_event profilingEvent);
 
-kzsError cluProfilerLogEvents(struct CluProfiler *profiler);
+/**
+* Ends the frame. Resolves the device times of the frame if device timing is enabled, and hands the collected events to the
+* drain thread if a trace is running. Otherwise the events are released. The frame never waits for the drain thread: if the
+* ring is full, the remaining events of the frame are released without tracing and counted as dropped. Call this outside of the
+* timed part of the frame.
+*/
+kzsError cluProfilerEndFrame(struct CluProfiler *profiler);
+
+/**
+* Returns KZ_TRUE if device times were resolved for last ended frame. Device times of a frame with very short commands can be
+* zero, so use this instead of the times to tell if the frame has device data.
+*/
+kzBool cluProfilerHasDeviceTimes(const struct CluProfiler *profiler);
+/** Returns the time in microseconds the device was busy executing the events of last ended frame. */
+kzUint cluProfilerGetDeviceBusyTime(const struct CluProfiler *profiler);
+/** Returns the time in microseconds from first event start to last event end of last ended frame. */
+kzUint cluProfilerGetDeviceSpanTime(const struct CluProfiler *profiler);
+
+/** Starts writing binary trace of the events to given file. Does nothing if trace is not enabled. Clears per-kernel statistics. */
+kzsError cluProfilerBeginTrace(struct CluProfiler *profiler, kzString tracePath);
+/** Waits until all events are drained, stops the drain thread and closes the trace file. Does nothing if no trace is running. */
+kzsError cluProfilerEndTrace(struct CluProfiler *profiler);
+/** Returns KZ_TRUE if a trace is running. */
+kzBool cluProfilerIsTracing(const struct CluProfiler *profiler);
+
+/** Returns the number of per-kernel statistics of the last trace. */
+kzUint cluProfilerGetKernelCount(const struct CluProfiler *profiler);
+/** Returns per-kernel statistics of the last trace. */
+const struct CluProfilerKernelStatistics* cluProfilerGetKernelStatistics(const struct CluProfiler *profiler, kzUint index);
+/** Returns the number of events dropped from the last trace because the drain thread could not keep up. */
+kzUint cluProfilerGetDroppedEventCount(const struct CluProfiler *profiler);
+
+/** Converts binary trace file to Chrome trace event JSON, which can be opened in chrome://tracing. */
+kzsError cluProfilerConvertTraceToJson(const struct KzcMemoryManager* manager, kzString tracePath, kzString jsonPath);
 
 
 #endif
@@ -13,6 +13,12 @@
 #include <system/debug/kzs_error.h>
 
 #include <clutil/clu_util.h>
+#include <clutil/clu_program_cache.h>
+
+
+/** Builds program from source, using program cache if given. Program name identifies the cache slot and can be KZ_NULL. */
+static kzsError cluBuildProgramFromSource_internal(struct CluProgramCache* cache, kzString programName, kzString kernelSource, kzString options,
+                                                   cl_context context, cl_program *out_program);
 
 
 kzsError cluGetProgramBinaryExists(const struct KzcMemoryManager* manager, kzString path, kzBool* out_exists)
@@ -98,51 +104,103 @@ kzsError cluGetBuiltProgramFromFile(const struct KzcMemoryManager* manager, kzSt
     kzsError result;
     kzString options = "";
     kzBool binary;
-    result = cluGetBuiltProgramFromFileWithOptions(manager, path, onlyOnline, options, context, out_program, &binary);
+    result = cluGetBuiltProgramFromFileWithOptions(manager, KZ_NULL, path, onlyOnline, options, context, out_program, &binary);
     kzsErrorForward(result);
     if(out_binary != KZ_NULL) *out_binary = binary;
     kzsSuccess();
 }
 
-kzsError cluGetBuiltProgramFromFileWithOptions(const struct KzcMemoryManager* manager, kzString path, kzBool onlyOnline, kzString options, cl_context context, cl_program *out_program, kzBool* out_binary)
+kzsError cluGetBuiltProgramFromFileWithOptions(const struct KzcMemoryManager* manager, struct CluProgramCache* cache, kzString path, kzBool onlyOnline, kzString options,
+                                               cl_context context, cl_program *out_program, kzBool* out_binary)
 {
     kzsError result;
     cl_int clResult;
     cl_program program;
     kzBool binary;
+    kzBool binaryExists;
 
-    result = cluLoadProgramFromFile(manager, path, onlyOnline, context, &program, &binary);
+    result = cluGetProgramBinaryExists(manager, path, &binaryExists);
     kzsErrorForward(result);
-    clResult = clBuildProgram(program, 0, NULL, options, NULL, NULL);
-    if(clResult == CL_BUILD_PROGRAM_FAILURE)
+
+    /* Hand-placed binaries take precedence over the cache. */
+    if(cache != KZ_NULL && (onlyOnline || !binaryExists))
     {
-        kzsError prResult;
-        prResult = cluPrintBuildLog(program);
-        kzsErrorForward(prResult);
+        kzMutableString kernelSource;
+        result = kzcFileReadTextFile(manager, path, &kernelSource);
+        kzsErrorForward(result);
+        result = cluBuildProgramFromSource_internal(cache, path, kernelSource, options, context, &program);
+        kzsErrorForward(result);
+        result = kzcStringDelete(kernelSource);
+        kzsErrorForward(result);
+        binary = KZ_FALSE;
+    }
+    else
+    {
+        result = cluLoadProgramFromFile(manager, path, onlyOnline, context, &program, &binary);
+        kzsErrorForward(result);
+        clResult = clBuildProgram(program, 0, NULL, options, NULL, NULL);
+        if(clResult == CL_BUILD_PROGRAM_FAILURE)
+        {
+            kzsError prResult;
+            prResult = cluPrintBuildLog(program);
+            kzsErrorForward(prResult);
+        }
+        cluClErrorTest(clResult);
     }
-    cluClErrorTest(clResult);
 
     if(out_binary != KZ_NULL) *out_binary = binary;
     *out_program = program;
     kzsSuccess();
 }
 
-kzsError cluGetBuiltProgramFromStringWithOptions(const struct KzcMemoryManager* manager, kzString kernelSource, kzString options, cl_context context, cl_program *out_program)
+kzsError cluGetBuiltProgramFromStringWithOptions(const struct KzcMemoryManager* manager, struct CluProgramCache* cache, kzString kernelSource, kzString options,
+                                                 cl_context context, cl_program *out_program)
 {
-    cl_int clResult;
+    kzsError result;
     cl_program program;
 
-    program = clCreateProgramWithSource(context, 1, &kernelSource, KZ_NULL, &clResult);    
-    cluClErrorTest(clResult);
+    KZ_UNUSED_PARAMETER(manager);
+
+    result = cluBuildProgramFromSource_internal(cache, KZ_NULL, kernelSource, options, context, &program);
+    kzsErrorForward(result);
+
+    *out_program = program;
+    kzsSuccess();
+}
+
+static kzsError cluBuildProgramFromSource_internal(struct CluProgramCache* cache, kzString programName, kzString kernelSource, kzString options,
+                                                   cl_context context, cl_program *out_program)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_program program = KZ_NULL;
 
-    clResult = clBuildProgram(program, 0, NULL, options, NULL, NULL);
-    if(clResult == CL_BUILD_PROGRAM_FAILURE)
+    if(cache != KZ_NULL)
     {
-        kzsError prResult; 
-        prResult = cluPrintBuildLog(program);
-        kzsErrorForward(prResult);
+        result = cluProgramCacheLoad(cache, context, programName, kernelSource, options, &program);
+        kzsErrorForward(result);
+    }
+
+    if(program == KZ_NULL)
+    {
+        program = clCreateProgramWithSource(context, 1, &kernelSource, KZ_NULL, &clResult);    
+        cluClErrorTest(clResult);
+
+        clResult = clBuildProgram(program, 0, NULL, options, NULL, NULL);
+        if(clResult == CL_BUILD_PROGRAM_FAILURE)
+        {
+            kzsError prResult; 
+            prResult = cluPrintBuildLog(program);
+            kzsErrorForward(prResult);
+        }
+        cluClErrorTest(clResult);
+
+        if(cache != KZ_NULL && clResult == CL_SUCCESS)
+        {
+            result = cluProgramCacheStore(cache, context, programName, kernelSource, options, program);
+            kzsErrorForward(result);
+        }
     }
-    cluClErrorTest(clResult);
 
     *out_program = program;
     kzsSuccess();
@@ -13,6 +13,7 @@
 
 /* Predeclarations. */
 struct KzcMemoryManager;
+struct CluProgramCache;
 
 
 
@@ -25,11 +26,19 @@ kzsError cluLoadProgramFromFile(const struct KzcMemoryManager* manager, kzString
 /** Load a program source from file and build it at all devices defined for the context */
 kzsError cluGetBuiltProgramFromFile(const struct KzcMemoryManager* manager, kzString path, kzBool onlyOnline, cl_context context, cl_program* out_program, kzBool* out_binary);
 
-/** Load a program source from file and build it at all devices defined for the context using the supplied build options */
-kzsError cluGetBuiltProgramFromFileWithOptions(const struct KzcMemoryManager* manager, kzString path, kzBool onlyOnline, kzString options, cl_context context, cl_program* out_program, kzBool* out_binary);
+/**
+* Load a program source from file and build it at all devices defined for the context using the supplied build options.
+* If program cache is given, the built binary is loaded from or stored to the cache. Cache can be KZ_NULL.
+*/
+kzsError cluGetBuiltProgramFromFileWithOptions(const struct KzcMemoryManager* manager, struct CluProgramCache* cache, kzString path, kzBool onlyOnline, kzString options,
+                                               cl_context context, cl_program* out_program, kzBool* out_binary);
 
-/** Build an OpenCL kernel from a given string and returns a built program. The program is by default built for all devices bound to the supplied context. */
-kzsError cluGetBuiltProgramFromStringWithOptions(const struct KzcMemoryManager* manager, kzString kernelSource, kzString options, cl_context context, cl_program *out_program);
+/**
+* Build an OpenCL kernel from a given string and returns a built program. The program is by default built for all devices bound to the supplied context.
+* If program cache is given, the built binary is loaded from or stored to the cache. Cache can be KZ_NULL.
+*/
+kzsError cluGetBuiltProgramFromStringWithOptions(const struct KzcMemoryManager* manager, struct CluProgramCache* cache, kzString kernelSource, kzString options,
+                                                 cl_context context, cl_program *out_program);
 
 /** Print a build log of a program which has failed to build. */
 kzsError cluPrintBuildLog(cl_program program);
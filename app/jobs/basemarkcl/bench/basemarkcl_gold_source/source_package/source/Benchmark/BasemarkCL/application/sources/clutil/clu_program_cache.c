@@ -0,0 +1,596 @@
+/**
+* \file
+* Persistent on-disk cache of built OpenCL program binaries.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "clu_program_cache.h"
+
+#include <benchmarkutil/util/md5.h>
+
+#include <clutil/clu_util.h>
+
+#include <core/util/io/kzc_file.h>
+#include <core/util/string/kzc_string.h>
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/thread/kzs_thread.h>
+#include <system/wrappers/kzs_memory.h>
+#include <system/wrappers/kzs_string.h>
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+
+#define CLU_PROGRAM_CACHE_MAGIC "CLUPC001" /**< Identifier and version of cache entry format. */
+#define CLU_PROGRAM_CACHE_MAGIC_LENGTH 8 /**< Length of the entry identifier. */
+#define CLU_PROGRAM_CACHE_DIGEST_LENGTH 16 /**< Length of MD5 digest. */
+/** Entry header consists of identifier, source digest and binary size. */
+#define CLU_PROGRAM_CACHE_HEADER_SIZE (CLU_PROGRAM_CACHE_MAGIC_LENGTH + CLU_PROGRAM_CACHE_DIGEST_LENGTH + sizeof(kzUint))
+#define CLU_PROGRAM_CACHE_ENTRY_SUFFIX ".bin" /**< File name suffix of cache entries. */
+#define CLU_PROGRAM_CACHE_ENTRY_SUFFIX_LENGTH 4 /**< Length of the entry suffix. */
+#define CLU_PROGRAM_CACHE_PATH_LENGTH 1024 /**< Maximum length of entry paths scanned when pruning, including terminator. */
+#define CLU_PROGRAM_CACHE_MAXIMUM_SIZE (64 * 1024 * 1024) /**< Total size of entries kept when the cache is created. */
+
+
+struct CluProgramCache
+{
+    kzMutableString directory; /**< Directory of cache entries. */
+    struct KzsThreadLock* lock; /**< Serializes entry file access and counter updates, as programs may be built from several threads. */
+    kzUint hitCount; /**< Number of programs loaded from cache since last reset. */
+    kzUint missCount; /**< Number of programs not found from cache since last reset. */
+};
+
+
+/** Gets the device of the context. Out single device is KZ_FALSE if the context has several devices. */
+static kzsError cluProgramCacheGetDevice_internal(cl_context context, cl_device_id* out_device, kzBool* out_singleDevice);
+/** Calculates the source digest and path of the cache slot. */
+static kzsError cluProgramCacheGetEntry_internal(const struct CluProgramCache* cache, cl_device_id device, kzString programName, kzString source,
+                                                 kzString options, md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzMutableString* out_path);
+/** Loads a program from the cache slot. Out program is KZ_NULL on cache miss. Cache lock must not be held. */
+static kzsError cluProgramCacheLoad_internal(const struct CluProgramCache* cache, cl_context context, cl_device_id device, kzString entryPath,
+                                             const md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzString options, cl_program* out_program);
+/**
+* Reads the entry file of a cache slot. Out data is KZ_NULL if the entry does not exist, or if it is corrupted or built from other
+* source, in which case it is removed. Cache lock must be held.
+*/
+static kzsError cluProgramCacheReadEntry_internal(const struct CluProgramCache* cache, kzString entryPath,
+                                                  const md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzUint* out_size, kzByte** out_data);
+/** Creates and builds a program from binary. Out program is KZ_NULL if the driver rejects the binary. */
+static kzsError cluProgramCacheBuildProgram_internal(cl_context context, cl_device_id device, kzString options, const kzByte* binary, kzUint binarySize,
+                                                     cl_program* out_program);
+/** Writes an entry to the cache slot. Cache lock must not be held. */
+static kzsError cluProgramCacheWriteEntry_internal(const struct CluProgramCache* cache, kzString entryPath, kzUint size, const kzByte* data);
+/** Removes the entry of a cache slot that the driver rejected. Cache lock must not be held. */
+static kzsError cluProgramCacheRemoveEntry_internal(const struct CluProgramCache* cache, kzString entryPath);
+/**
+* Finds the least recently used entry of the directory. Out total size is the size of all entries. Returns KZ_FALSE if there are
+* no entries. Out oldest path must have room for CLU_PROGRAM_CACHE_PATH_LENGTH characters.
+*/
+static kzBool cluProgramCacheFindOldestEntry_internal(kzString directory, kzUint* out_totalSize, kzMutableString out_oldestPath);
+/** Removes least recently used entries until the entries fit in CLU_PROGRAM_CACHE_MAXIMUM_SIZE. */
+static void cluProgramCachePrune_internal(const struct CluProgramCache* cache);
+/** Writes digest as hexadecimal string to given buffer of at least 33 characters. */
+static void cluProgramCacheDigestToString_internal(const md5_byte_t digest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzMutableString out_string);
+
+
+kzsError cluProgramCacheCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluProgramCache** out_cache)
+{
+    kzsError result;
+    struct CluProgramCache* cache;
+
+    result = kzcMemoryAllocVariable(memoryManager, cache, "Program cache");
+    kzsErrorForward(result);
+
+    result = kzcStringCopy(memoryManager, directory, &cache->directory);
+    kzsErrorForward(result);
+    result = kzsThreadLockCreate(&cache->lock);
+    kzsErrorForward(result);
+    cache->hitCount = 0;
+    cache->missCount = 0;
+
+    /* Failure is ignored here, as the directory usually exists already. Missing directory is reported when storing entries. */
+    {
+#ifdef WIN32
+        kzInt mkdirResult = (kzInt)_mkdir(directory);
+#else
+        kzInt mkdirResult = (kzInt)mkdir(directory, 0755);
+#endif
+        KZ_UNUSED_RETURN_VALUE(mkdirResult);
+    }
+
+    /* Entries of changed options, drivers or unnamed sources are never overwritten, so they are pruned here. */
+    cluProgramCachePrune_internal(cache);
+
+    *out_cache = cache;
+    kzsSuccess();
+}
+
+kzsError cluProgramCacheDelete(struct CluProgramCache* cache)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    result = kzsThreadLockDelete(cache->lock);
+    kzsErrorForward(result);
+    result = kzcStringDelete(cache->directory);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeVariable(cache);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheGetDevice_internal(cl_context context, cl_device_id* out_device, kzBool* out_singleDevice)
+{
+    cl_int clResult;
+    cl_device_id deviceIds[10];
+    size_t returnSize = 0;
+
+    clResult = clGetContextInfo(context, CL_CONTEXT_DEVICES, 10 * sizeof(cl_device_id), &deviceIds, &returnSize);
+    cluClErrorTest(clResult);
+
+    *out_device = deviceIds[0];
+    *out_singleDevice = (returnSize == sizeof(cl_device_id));
+    kzsSuccess();
+}
+
+static void cluProgramCacheDigestToString_internal(const md5_byte_t digest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzMutableString out_string)
+{
+    kzUint i;
+    for(i = 0; i < CLU_PROGRAM_CACHE_DIGEST_LENGTH; ++i)
+    {
+        sprintf(&out_string[i * 2], "%02x", (kzUint)digest[i]);
+    }
+    out_string[CLU_PROGRAM_CACHE_DIGEST_LENGTH * 2] = '\0';
+}
+
+static kzsError cluProgramCacheGetEntry_internal(const struct CluProgramCache* cache, cl_device_id device, kzString programName, kzString source,
+                                                 kzString options, md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzMutableString* out_path)
+{
+    kzsError result;
+    cl_int clResult;
+    kzChar deviceName[256];
+    kzChar driverVersion[256];
+    kzChar sourceDigestString[CLU_PROGRAM_CACHE_DIGEST_LENGTH * 2 + 1];
+    kzChar slotDigestString[CLU_PROGRAM_CACHE_DIGEST_LENGTH * 2 + 1];
+    md5_byte_t slotDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH];
+    md5_state_t md5state;
+    kzString separator = "\n";
+
+    clResult = clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(deviceName), deviceName, KZ_NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetDeviceInfo(device, CL_DRIVER_VERSION, sizeof(driverVersion), driverVersion, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    md5_init(&md5state);
+    md5_append(&md5state, (const md5_byte_t*)source, (kzInt)kzsStrlen(source));
+    md5_finish(&md5state, sourceDigest);
+    cluProgramCacheDigestToString_internal(sourceDigest, sourceDigestString);
+
+    /* Named programs keep their slot when the source changes, so that the stale entry is overwritten. The source digest in the
+       entry header tells if the entry is up to date. */
+    md5_init(&md5state);
+    md5_append(&md5state, (const md5_byte_t*)deviceName, (kzInt)kzsStrlen(deviceName));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+    md5_append(&md5state, (const md5_byte_t*)driverVersion, (kzInt)kzsStrlen(driverVersion));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+    md5_append(&md5state, (const md5_byte_t*)options, (kzInt)kzsStrlen(options));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+    if(programName != KZ_NULL)
+    {
+        md5_append(&md5state, (const md5_byte_t*)programName, (kzInt)kzsStrlen(programName));
+    }
+    else
+    {
+        md5_append(&md5state, (const md5_byte_t*)sourceDigestString, CLU_PROGRAM_CACHE_DIGEST_LENGTH * 2);
+    }
+    md5_finish(&md5state, slotDigest);
+    cluProgramCacheDigestToString_internal(slotDigest, slotDigestString);
+
+    result = kzcStringFormat(kzcMemoryGetManager(cache), "%s/%s" CLU_PROGRAM_CACHE_ENTRY_SUFFIX, out_path, cache->directory, slotDigestString);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzsError cluProgramCacheLoad(struct CluProgramCache* cache, cl_context context, kzString programName, kzString source, kzString options, cl_program* out_program)
+{
+    kzsError result;
+    cl_program program = KZ_NULL;
+    cl_device_id device;
+    kzBool singleDevice;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    result = cluProgramCacheGetDevice_internal(context, &device, &singleDevice);
+    kzsErrorForward(result);
+
+    if(singleDevice)
+    {
+        kzsError loadResult;
+        md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH];
+        kzMutableString entryPath;
+
+        result = cluProgramCacheGetEntry_internal(cache, device, programName, source, options, sourceDigest, &entryPath);
+        kzsErrorForward(result);
+
+        loadResult = cluProgramCacheLoad_internal(cache, context, device, entryPath, sourceDigest, options, &program);
+
+        result = kzcStringDelete(entryPath);
+        kzsErrorForward(result);
+        kzsErrorForward(loadResult);
+    }
+
+    result = kzsThreadLockAcquire(cache->lock);
+    kzsErrorForward(result);
+    if(program != KZ_NULL)
+    {
+        ++cache->hitCount;
+    }
+    else
+    {
+        ++cache->missCount;
+    }
+    result = kzsThreadLockRelease(cache->lock);
+    kzsErrorForward(result);
+
+    *out_program = program;
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheLoad_internal(const struct CluProgramCache* cache, cl_context context, cl_device_id device, kzString entryPath,
+                                             const md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzString options, cl_program* out_program)
+{
+    kzsError result;
+    kzsError readResult;
+    cl_program program = KZ_NULL;
+    kzUint size;
+    kzByte* data;
+
+    /* Only the entry file is accessed under the lock, so that programs of several threads are built concurrently. */
+    result = kzsThreadLockAcquire(cache->lock);
+    kzsErrorForward(result);
+
+    readResult = cluProgramCacheReadEntry_internal(cache, entryPath, sourceDigest, &size, &data);
+
+    result = kzsThreadLockRelease(cache->lock);
+    kzsErrorForward(result);
+    kzsErrorForward(readResult);
+
+    if(data != KZ_NULL)
+    {
+        kzsError buildResult = cluProgramCacheBuildProgram_internal(context, device, options, &data[CLU_PROGRAM_CACHE_HEADER_SIZE],
+                                                                    size - CLU_PROGRAM_CACHE_HEADER_SIZE, &program);
+
+        result = kzcMemoryFreePointer(data);
+        kzsErrorForward(result);
+        kzsErrorForward(buildResult);
+
+        if(program == KZ_NULL)
+        {
+            result = cluProgramCacheRemoveEntry_internal(cache, entryPath);
+            kzsErrorForward(result);
+        }
+        else
+        {
+            kzcLogDebug("Using cached program binary '%s'", entryPath);
+        }
+    }
+
+    *out_program = program;
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheReadEntry_internal(const struct CluProgramCache* cache, kzString entryPath,
+                                                  const md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH], kzUint* out_size, kzByte** out_data)
+{
+    kzsError result;
+    kzUint size = 0;
+    kzByte* data = KZ_NULL;
+
+    if(kzcFileExists(entryPath))
+    {
+        kzBool validEntry = KZ_FALSE;
+
+        result = kzcFileReadBinaryFile(kzcMemoryGetManager(cache), entryPath, &size, &data);
+        kzsErrorForward(result);
+
+        if(size > CLU_PROGRAM_CACHE_HEADER_SIZE)
+        {
+            kzUint i;
+            kzUint binarySize;
+            kzsMemcpy(&binarySize, &data[CLU_PROGRAM_CACHE_MAGIC_LENGTH + CLU_PROGRAM_CACHE_DIGEST_LENGTH], sizeof(kzUint));
+
+            validEntry = (binarySize == size - CLU_PROGRAM_CACHE_HEADER_SIZE);
+            for(i = 0; i < CLU_PROGRAM_CACHE_MAGIC_LENGTH; ++i)
+            {
+                validEntry &= (kzBool)(data[i] == (kzByte)CLU_PROGRAM_CACHE_MAGIC[i]);
+            }
+            for(i = 0; i < CLU_PROGRAM_CACHE_DIGEST_LENGTH; ++i)
+            {
+                validEntry &= (kzBool)(data[CLU_PROGRAM_CACHE_MAGIC_LENGTH + i] == sourceDigest[i]);
+            }
+        }
+
+        if(validEntry)
+        {
+            /* Modification time tells the least recently used entries when pruning. */
+#ifdef WIN32
+            kzInt utimeResult = (kzInt)_utime(entryPath, KZ_NULL);
+#else
+            kzInt utimeResult = (kzInt)utime(entryPath, KZ_NULL);
+#endif
+            KZ_UNUSED_RETURN_VALUE(utimeResult);
+        }
+        else
+        {
+            /* Entry is corrupted or built from an older source of the program. */
+            kzInt removeResult = (kzInt)remove(entryPath);
+            KZ_UNUSED_RETURN_VALUE(removeResult);
+            kzcLogDebug("Removed stale program cache entry '%s'", entryPath);
+
+            result = kzcMemoryFreePointer(data);
+            kzsErrorForward(result);
+            data = KZ_NULL;
+        }
+    }
+
+    *out_size = size;
+    *out_data = data;
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheBuildProgram_internal(cl_context context, cl_device_id device, kzString options, const kzByte* binary, kzUint binarySize,
+                                                     cl_program* out_program)
+{
+    cl_int clResult;
+    cl_int clBinaryStatus = CL_SUCCESS;
+    cl_program program;
+    size_t lengths[1];
+    const unsigned char* binaries[1];
+
+    lengths[0] = binarySize;
+    binaries[0] = (const unsigned char*)binary;
+
+    program = clCreateProgramWithBinary(context, 1, &device, lengths, binaries, &clBinaryStatus, &clResult);
+    if(clResult == CL_SUCCESS && clBinaryStatus == CL_SUCCESS)
+    {
+        clResult = clBuildProgram(program, 1, &device, options, KZ_NULL, KZ_NULL);
+    }
+    if(program != KZ_NULL && (clResult != CL_SUCCESS || clBinaryStatus != CL_SUCCESS))
+    {
+        clResult = clReleaseProgram(program);
+        cluClErrorTest(clResult);
+        program = KZ_NULL;
+    }
+
+    *out_program = program;
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheRemoveEntry_internal(const struct CluProgramCache* cache, kzString entryPath)
+{
+    kzsError result;
+    kzInt removeResult;
+
+    result = kzsThreadLockAcquire(cache->lock);
+    kzsErrorForward(result);
+    removeResult = (kzInt)remove(entryPath);
+    result = kzsThreadLockRelease(cache->lock);
+    kzsErrorForward(result);
+
+    KZ_UNUSED_RETURN_VALUE(removeResult);
+    kzcLogDebug("Removed program cache entry rejected by the driver '%s'", entryPath);
+
+    kzsSuccess();
+}
+
+kzsError cluProgramCacheStore(struct CluProgramCache* cache, cl_context context, kzString programName, kzString source, kzString options, cl_program program)
+{
+    kzsError result;
+    cl_device_id device;
+    kzBool singleDevice;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    result = cluProgramCacheGetDevice_internal(context, &device, &singleDevice);
+    kzsErrorForward(result);
+
+    if(singleDevice)
+    {
+        cl_int clResult;
+        size_t binarySize = 0;
+
+        clResult = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &binarySize, KZ_NULL);
+        cluClErrorTest(clResult);
+
+        if(binarySize > 0)
+        {
+            kzsError writeResult;
+            md5_byte_t sourceDigest[CLU_PROGRAM_CACHE_DIGEST_LENGTH];
+            kzMutableString entryPath;
+            kzByte* data;
+            unsigned char* binary;
+            kzUint size = CLU_PROGRAM_CACHE_HEADER_SIZE + (kzUint)binarySize;
+            kzUint storedBinarySize = (kzUint)binarySize;
+
+            result = kzcMemoryAllocPointer(kzcMemoryGetManager(cache), &data, size, "Program cache entry");
+            kzsErrorForward(result);
+
+            binary = (unsigned char*)&data[CLU_PROGRAM_CACHE_HEADER_SIZE];
+            clResult = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary, KZ_NULL);
+            if(clResult != CL_SUCCESS)
+            {
+                result = kzcMemoryFreePointer(data);
+                kzsErrorForward(result);
+                cluClErrorTest(clResult);
+            }
+
+            kzsMemcpy(data, CLU_PROGRAM_CACHE_MAGIC, CLU_PROGRAM_CACHE_MAGIC_LENGTH);
+            kzsMemcpy(&data[CLU_PROGRAM_CACHE_MAGIC_LENGTH + CLU_PROGRAM_CACHE_DIGEST_LENGTH], &storedBinarySize, sizeof(kzUint));
+
+            writeResult = cluProgramCacheGetEntry_internal(cache, device, programName, source, options, sourceDigest, &entryPath);
+            if(writeResult == KZS_SUCCESS)
+            {
+                kzsMemcpy(&data[CLU_PROGRAM_CACHE_MAGIC_LENGTH], sourceDigest, CLU_PROGRAM_CACHE_DIGEST_LENGTH);
+
+                writeResult = cluProgramCacheWriteEntry_internal(cache, entryPath, size, data);
+
+                result = kzcStringDelete(entryPath);
+                kzsErrorForward(result);
+            }
+
+            result = kzcMemoryFreePointer(data);
+            kzsErrorForward(result);
+            kzsErrorForward(writeResult);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static kzsError cluProgramCacheWriteEntry_internal(const struct CluProgramCache* cache, kzString entryPath, kzUint size, const kzByte* data)
+{
+    kzsError result;
+    kzsError writeResult;
+
+    result = kzsThreadLockAcquire(cache->lock);
+    kzsErrorForward(result);
+
+    writeResult = kzcFileWriteBinaryFile(kzcMemoryGetManager(cache), entryPath, size, data);
+
+    result = kzsThreadLockRelease(cache->lock);
+    kzsErrorForward(result);
+    kzsErrorForward(writeResult);
+
+    kzcLogDebug("Stored program binary to cache '%s'", entryPath);
+    kzsSuccess();
+}
+
+static kzBool cluProgramCacheFindOldestEntry_internal(kzString directory, kzUint* out_totalSize, kzMutableString out_oldestPath)
+{
+    kzBool found = KZ_FALSE;
+    kzUint totalSize = 0;
+    kzUint directoryLength = kzsStrlen(directory);
+#ifdef WIN32
+    kzChar pattern[CLU_PROGRAM_CACHE_PATH_LENGTH];
+
+    if(directoryLength + 2 + CLU_PROGRAM_CACHE_ENTRY_SUFFIX_LENGTH < CLU_PROGRAM_CACHE_PATH_LENGTH)
+    {
+        WIN32_FIND_DATAA findData;
+        HANDLE findHandle;
+        FILETIME oldestTime;
+
+        sprintf(pattern, "%s/*" CLU_PROGRAM_CACHE_ENTRY_SUFFIX, directory);
+        findHandle = FindFirstFileA(pattern, &findData);
+        if(findHandle != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                if(directoryLength + 1 + kzsStrlen(findData.cFileName) < CLU_PROGRAM_CACHE_PATH_LENGTH)
+                {
+                    totalSize += (kzUint)findData.nFileSizeLow;
+                    if(!found || CompareFileTime(&findData.ftLastWriteTime, &oldestTime) < 0)
+                    {
+                        oldestTime = findData.ftLastWriteTime;
+                        sprintf(out_oldestPath, "%s/%s", directory, findData.cFileName);
+                        found = KZ_TRUE;
+                    }
+                }
+            } while(FindNextFileA(findHandle, &findData));
+            FindClose(findHandle);
+        }
+    }
+#else
+    DIR* directoryStream = opendir(directory);
+
+    if(directoryStream != KZ_NULL)
+    {
+        kzChar entryPath[CLU_PROGRAM_CACHE_PATH_LENGTH];
+        time_t oldestTime = 0;
+        struct dirent* entry;
+
+        while((entry = readdir(directoryStream)) != KZ_NULL)
+        {
+            kzUint nameLength = kzsStrlen(entry->d_name);
+            struct stat entryStat;
+
+            if(nameLength > CLU_PROGRAM_CACHE_ENTRY_SUFFIX_LENGTH && directoryLength + 1 + nameLength < CLU_PROGRAM_CACHE_PATH_LENGTH &&
+               kzsStrcmp(&entry->d_name[nameLength - CLU_PROGRAM_CACHE_ENTRY_SUFFIX_LENGTH], CLU_PROGRAM_CACHE_ENTRY_SUFFIX) == 0)
+            {
+                sprintf(entryPath, "%s/%s", directory, entry->d_name);
+                if(stat(entryPath, &entryStat) == 0 && S_ISREG(entryStat.st_mode))
+                {
+                    totalSize += (kzUint)entryStat.st_size;
+                    if(!found || entryStat.st_mtime < oldestTime)
+                    {
+                        oldestTime = entryStat.st_mtime;
+                        kzsStrcpy(out_oldestPath, entryPath);
+                        found = KZ_TRUE;
+                    }
+                }
+            }
+        }
+        closedir(directoryStream);
+    }
+#endif
+
+    *out_totalSize = totalSize;
+    return found;
+}
+
+static void cluProgramCachePrune_internal(const struct CluProgramCache* cache)
+{
+    kzChar oldestPath[CLU_PROGRAM_CACHE_PATH_LENGTH];
+    kzUint totalSize;
+
+    while(cluProgramCacheFindOldestEntry_internal(cache->directory, &totalSize, oldestPath) && totalSize > CLU_PROGRAM_CACHE_MAXIMUM_SIZE)
+    {
+        if(remove(oldestPath) != 0)
+        {
+            break;
+        }
+        kzcLogDebug("Removed least recently used program cache entry '%s'", oldestPath);
+    }
+}
+
+kzsError cluProgramCacheResetStatistics(struct CluProgramCache* cache)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(cache));
+
+    result = kzsThreadLockAcquire(cache->lock);
+    kzsErrorForward(result);
+    cache->hitCount = 0;
+    cache->missCount = 0;
+    result = kzsThreadLockRelease(cache->lock);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+kzUint cluProgramCacheGetHitCount(const struct CluProgramCache* cache)
+{
+    kzsAssert(kzcIsValidPointer(cache));
+    return cache->hitCount;
+}
+
+kzUint cluProgramCacheGetMissCount(const struct CluProgramCache* cache)
+{
+    kzsAssert(kzcIsValidPointer(cache));
+    return cache->missCount;
+}
@@ -0,0 +1,57 @@
+/**
+* \file
+* Persistent on-disk cache of built OpenCL program binaries.
+*
+* Each program occupies one slot file named after the MD5 of the device name, driver version, build options and
+* program name, so a changed source overwrites the entry of the previous source. The entry stores the MD5 of the source,
+* which is verified on load. Entries that fail verification or are rejected by the driver are removed and rebuilt.
+* Entries of changed options and drivers are never overwritten, so when the cache is created, least recently used entries
+* are removed until all entries fit in 64 MB.
+*
+* Only the entry files are accessed under a lock, so the cache can be used from several threads and the programs are
+* built concurrently.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CLU_PROGRAM_CACHE_H
+#define CLU_PROGRAM_CACHE_H
+
+#include "clu_opencl_base.h"
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/**
+* \struct CluProgramCache
+* Program binary cache and its hit statistics.
+*/
+struct CluProgramCache;
+
+
+/** Creates program cache storing its entries to given directory. Directory is created if it does not exist. */
+kzsError cluProgramCacheCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluProgramCache** out_cache);
+/** Deletes program cache. Cached entries are left on disk. */
+kzsError cluProgramCacheDelete(struct CluProgramCache* cache);
+
+/**
+* Tries to create a built program from cached binary. Program name identifies the cache slot and can be KZ_NULL,
+* in which case the source itself identifies the slot. Returns KZ_NULL program on cache miss.
+*/
+kzsError cluProgramCacheLoad(struct CluProgramCache* cache, cl_context context, kzString programName, kzString source, kzString options, cl_program* out_program);
+/** Stores binary of a built program to the cache. Programs built for several devices are not cached. */
+kzsError cluProgramCacheStore(struct CluProgramCache* cache, cl_context context, kzString programName, kzString source, kzString options, cl_program program);
+
+/** Resets cache hit and miss counters. */
+kzsError cluProgramCacheResetStatistics(struct CluProgramCache* cache);
+/** Returns number of cache hits since last reset. Read when no builds are in progress. */
+kzUint cluProgramCacheGetHitCount(const struct CluProgramCache* cache);
+/** Returns number of cache misses since last reset. */
+kzUint cluProgramCacheGetMissCount(const struct CluProgramCache* cache);
+
+
+#endif
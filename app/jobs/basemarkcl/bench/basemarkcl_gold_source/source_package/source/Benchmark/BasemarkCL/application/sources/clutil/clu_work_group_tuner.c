@@ -0,0 +1,647 @@
+/**
+* \file
+* Work-group size autotuner with per-device results persisted on disk.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#include "clu_work_group_tuner.h"
+
+#include <benchmarkutil/util/md5.h>
+
+#include <clutil/clu_util.h>
+
+#include <core/util/io/kzc_file.h>
+#include <core/util/string/kzc_string.h>
+#include <core/util/collection/kzc_dynamic_array.h>
+#include <core/memory/kzc_memory_manager.h>
+#include <core/debug/kzc_log.h>
+
+#include <system/wrappers/kzs_memory.h>
+#include <system/wrappers/kzs_string.h>
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+
+#define CLU_WORK_GROUP_TUNER_DIGEST_LENGTH 16 /**< Length of MD5 digest. */
+#define CLU_WORK_GROUP_TUNER_MAXIMUM_VALUES 32 /**< Maximum number of candidate sizes in one dimension. */
+#define CLU_WORK_GROUP_TUNER_MAXIMUM_CANDIDATES 64 /**< Maximum number of candidate local sizes measured in one search. */
+#define CLU_WORK_GROUP_TUNER_REPEAT_COUNT 3 /**< Number of timed launches of each candidate. The fastest one is used. */
+
+
+struct CluWorkGroupTuner
+{
+    kzMutableString directory; /**< Directory of stored results. */
+    struct KzcDynamicArray* results; /**< Results of the launch configurations since last reset, struct CluWorkGroupTunerResult*. */
+    kzBool searchEnabled; /**< Launch configurations without stored result are searched. */
+    kzUint hitCount; /**< Number of results loaded from disk since last reset. */
+    kzUint searchCount; /**< Number of searches since last reset. */
+};
+
+
+/** Finds the result of a launch configuration. Returns KZ_NULL if the configuration has not been launched since last reset. */
+static struct CluWorkGroupTunerResult* cluWorkGroupTunerFindResult_internal(const struct CluWorkGroupTuner* tuner, cl_kernel kernel, cl_uint dimensions,
+                                                                           const size_t* globalWorkSize);
+/**
+* Finds a result unbound by cluWorkGroupTunerUnbindKernels with the kernel name and global work size of a launch, and binds it to
+* the kernel of the launch. Returns KZ_NULL if there is no such result.
+*/
+static struct CluWorkGroupTunerResult* cluWorkGroupTunerRebindResult_internal(const struct CluWorkGroupTuner* tuner, cl_kernel kernel, kzString kernelName,
+                                                                             cl_uint dimensions, const size_t* globalWorkSize);
+/** Calculates the path of the stored result of a launch configuration. */
+static kzsError cluWorkGroupTunerGetPath_internal(const struct CluWorkGroupTuner* tuner, cl_device_id device, cl_kernel kernel, kzString kernelName,
+                                                  cl_uint dimensions, const size_t* globalWorkSize, kzMutableString* out_path);
+/** Loads stored result. Returns KZ_FALSE if there is no valid result at the path. */
+static kzsError cluWorkGroupTunerLoad_internal(const struct CluWorkGroupTuner* tuner, kzString path, struct CluWorkGroupTunerResult* tunerResult, kzBool* out_loaded);
+/** Stores result to given path. */
+static kzsError cluWorkGroupTunerStore_internal(const struct CluWorkGroupTuner* tuner, kzString path, const struct CluWorkGroupTunerResult* tunerResult);
+/** Measures candidate local sizes and the given local size, and stores the fastest one to the result. */
+static kzsError cluWorkGroupTunerSearch_internal(cl_command_queue queue, cl_device_id device, const size_t* globalWorkOffset, const size_t* localWorkSize,
+                                                 struct CluWorkGroupTunerResult* tunerResult);
+/** Measures execution time of the kernel with given local size. Out time is zero if the driver rejects the local size. */
+static kzsError cluWorkGroupTunerMeasure_internal(cl_command_queue queue, cl_kernel kernel, cl_uint dimensions, const size_t* globalWorkOffset,
+                                                  const size_t* globalWorkSize, const size_t* localWorkSize, kzUint* out_time);
+/** Writes digest as hexadecimal string to given buffer of at least 33 characters. */
+static void cluWorkGroupTunerDigestToString_internal(const md5_byte_t digest[CLU_WORK_GROUP_TUNER_DIGEST_LENGTH], kzMutableString out_string);
+
+
+kzsError cluWorkGroupTunerCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluWorkGroupTuner** out_tuner)
+{
+    kzsError result;
+    struct CluWorkGroupTuner* tuner;
+
+    result = kzcMemoryAllocVariable(memoryManager, tuner, "Work-group tuner");
+    kzsErrorForward(result);
+
+    result = kzcStringCopy(memoryManager, directory, &tuner->directory);
+    kzsErrorForward(result);
+    result = kzcDynamicArrayCreate(memoryManager, &tuner->results);
+    kzsErrorForward(result);
+    tuner->searchEnabled = KZ_FALSE;
+    tuner->hitCount = 0;
+    tuner->searchCount = 0;
+
+    /* Failure is ignored here, as the directory usually exists already. Missing directory is reported when storing results. */
+    {
+#ifdef WIN32
+        kzInt mkdirResult = (kzInt)_mkdir(directory);
+#else
+        kzInt mkdirResult = (kzInt)mkdir(directory, 0755);
+#endif
+        KZ_UNUSED_RETURN_VALUE(mkdirResult);
+    }
+
+    *out_tuner = tuner;
+    kzsSuccess();
+}
+
+kzsError cluWorkGroupTunerDelete(struct CluWorkGroupTuner* tuner)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(tuner));
+
+    result = cluWorkGroupTunerReset(tuner);
+    kzsErrorForward(result);
+    result = kzcDynamicArrayDelete(tuner->results);
+    kzsErrorForward(result);
+    result = kzcStringDelete(tuner->directory);
+    kzsErrorForward(result);
+    result = kzcMemoryFreeVariable(tuner);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static void cluWorkGroupTunerDigestToString_internal(const md5_byte_t digest[CLU_WORK_GROUP_TUNER_DIGEST_LENGTH], kzMutableString out_string)
+{
+    kzUint i;
+    for(i = 0; i < CLU_WORK_GROUP_TUNER_DIGEST_LENGTH; ++i)
+    {
+        sprintf(&out_string[i * 2], "%02x", (kzUint)digest[i]);
+    }
+    out_string[CLU_WORK_GROUP_TUNER_DIGEST_LENGTH * 2] = '\0';
+}
+
+static struct CluWorkGroupTunerResult* cluWorkGroupTunerFindResult_internal(const struct CluWorkGroupTuner* tuner, cl_kernel kernel, cl_uint dimensions,
+                                                                           const size_t* globalWorkSize)
+{
+    struct CluWorkGroupTunerResult* foundResult = KZ_NULL;
+    kzUint i;
+
+    for(i = 0; i < kzcDynamicArrayGetSize(tuner->results) && foundResult == KZ_NULL; ++i)
+    {
+        struct CluWorkGroupTunerResult* tunerResult = (struct CluWorkGroupTunerResult*)kzcDynamicArrayGet(tuner->results, i);
+        if(tunerResult->kernel == kernel && tunerResult->dimensions == dimensions)
+        {
+            kzBool sameSize = KZ_TRUE;
+            cl_uint dimension;
+            for(dimension = 0; dimension < dimensions; ++dimension)
+            {
+                sameSize &= (kzBool)(tunerResult->globalWorkSize[dimension] == globalWorkSize[dimension]);
+            }
+            if(sameSize)
+            {
+                foundResult = tunerResult;
+            }
+        }
+    }
+
+    return foundResult;
+}
+
+static struct CluWorkGroupTunerResult* cluWorkGroupTunerRebindResult_internal(const struct CluWorkGroupTuner* tuner, cl_kernel kernel, kzString kernelName,
+                                                                             cl_uint dimensions, const size_t* globalWorkSize)
+{
+    struct CluWorkGroupTunerResult* foundResult = KZ_NULL;
+    kzUint i;
+
+    /* Results are in launch order, so kernels reloaded and launched in the same order get back their own results. */
+    for(i = 0; i < kzcDynamicArrayGetSize(tuner->results) && foundResult == KZ_NULL; ++i)
+    {
+        struct CluWorkGroupTunerResult* tunerResult = (struct CluWorkGroupTunerResult*)kzcDynamicArrayGet(tuner->results, i);
+        if(tunerResult->kernel == KZ_NULL && tunerResult->dimensions == dimensions && kzcStringIsEqual(tunerResult->kernelName, kernelName))
+        {
+            kzBool sameSize = KZ_TRUE;
+            cl_uint dimension;
+            for(dimension = 0; dimension < dimensions; ++dimension)
+            {
+                sameSize &= (kzBool)(tunerResult->globalWorkSize[dimension] == globalWorkSize[dimension]);
+            }
+            if(sameSize)
+            {
+                tunerResult->kernel = kernel;
+                foundResult = tunerResult;
+            }
+        }
+    }
+
+    return foundResult;
+}
+
+static kzsError cluWorkGroupTunerGetPath_internal(const struct CluWorkGroupTuner* tuner, cl_device_id device, cl_kernel kernel, kzString kernelName,
+                                                  cl_uint dimensions, const size_t* globalWorkSize, kzMutableString* out_path)
+{
+    kzsError result;
+    cl_int clResult;
+    cl_program program;
+    cl_uint programDeviceCount = 0;
+    kzChar deviceName[256];
+    kzChar driverVersion[256];
+    kzChar sizeString[64];
+    kzChar digestString[CLU_WORK_GROUP_TUNER_DIGEST_LENGTH * 2 + 1];
+    md5_byte_t digest[CLU_WORK_GROUP_TUNER_DIGEST_LENGTH];
+    md5_state_t md5state;
+    kzString separator = "\n";
+    size_t binarySize = 0;
+    cl_uint dimension;
+
+    clResult = clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(deviceName), deviceName, KZ_NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetDeviceInfo(device, CL_DRIVER_VERSION, sizeof(driverVersion), driverVersion, KZ_NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetKernelInfo(kernel, CL_KERNEL_PROGRAM, sizeof(program), &program, KZ_NULL);
+    cluClErrorTest(clResult);
+
+    md5_init(&md5state);
+    md5_append(&md5state, (const md5_byte_t*)deviceName, (kzInt)kzsStrlen(deviceName));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+    md5_append(&md5state, (const md5_byte_t*)driverVersion, (kzInt)kzsStrlen(driverVersion));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+    md5_append(&md5state, (const md5_byte_t*)kernelName, (kzInt)kzsStrlen(kernelName));
+    md5_append(&md5state, (const md5_byte_t*)separator, 1);
+
+    /* Program binary identifies the kernel code and build options. Programs of several devices are identified by their source. */
+    clResult = clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(programDeviceCount), &programDeviceCount, KZ_NULL);
+    cluClErrorTest(clResult);
+    if(programDeviceCount == 1)
+    {
+        clResult = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &binarySize, KZ_NULL);
+        cluClErrorTest(clResult);
+    }
+    if(binarySize > 0)
+    {
+        unsigned char* binary;
+
+        result = kzcMemoryAllocPointer(kzcMemoryGetManager(tuner), &binary, (kzUint)binarySize, "Work-group tuner program binary");
+        kzsErrorForward(result);
+        clResult = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary, KZ_NULL);
+        cluClErrorTest(clResult);
+        md5_append(&md5state, (const md5_byte_t*)binary, (kzInt)binarySize);
+        result = kzcMemoryFreePointer(binary);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        size_t sourceSize = 0;
+        clResult = clGetProgramInfo(program, CL_PROGRAM_SOURCE, 0, KZ_NULL, &sourceSize);
+        cluClErrorTest(clResult);
+        if(sourceSize > 0)
+        {
+            kzChar* source;
+
+            result = kzcMemoryAllocPointer(kzcMemoryGetManager(tuner), &source, (kzUint)sourceSize, "Work-group tuner program source");
+            kzsErrorForward(result);
+            clResult = clGetProgramInfo(program, CL_PROGRAM_SOURCE, sourceSize, source, KZ_NULL);
+            cluClErrorTest(clResult);
+            md5_append(&md5state, (const md5_byte_t*)source, (kzInt)sourceSize);
+            result = kzcMemoryFreePointer(source);
+            kzsErrorForward(result);
+        }
+    }
+
+    for(dimension = 0; dimension < dimensions; ++dimension)
+    {
+        sprintf(sizeString, "\n%u", (kzUint)globalWorkSize[dimension]);
+        md5_append(&md5state, (const md5_byte_t*)sizeString, (kzInt)kzsStrlen(sizeString));
+    }
+    md5_finish(&md5state, digest);
+    cluWorkGroupTunerDigestToString_internal(digest, digestString);
+
+    result = kzcStringFormat(kzcMemoryGetManager(tuner), "%s/%s.wgs", out_path, tuner->directory, digestString);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+static kzsError cluWorkGroupTunerLoad_internal(const struct CluWorkGroupTuner* tuner, kzString path, struct CluWorkGroupTunerResult* tunerResult, kzBool* out_loaded)
+{
+    kzsError result;
+    kzBool loaded = KZ_FALSE;
+
+    if(kzcFileExists(path))
+    {
+        kzMutableString content;
+        kzUint localWorkSize[3];
+        kzUint defaultTime;
+        kzUint tunedTime;
+
+        result = kzcFileReadTextFile(kzcMemoryGetManager(tuner), path, &content);
+        kzsErrorForward(result);
+
+        if(sscanf(content, "%u %u %u %u %u", &localWorkSize[0], &localWorkSize[1], &localWorkSize[2], &defaultTime, &tunedTime) == 5)
+        {
+            cl_uint dimension;
+            loaded = KZ_TRUE;
+            for(dimension = 0; dimension < 3; ++dimension)
+            {
+                tunerResult->localWorkSize[dimension] = (size_t)localWorkSize[dimension];
+                /* Zero means the given local size, which can not be combined with explicit sizes. */
+                loaded &= (kzBool)((dimension >= tunerResult->dimensions) || ((localWorkSize[0] == 0) == (localWorkSize[dimension] == 0)));
+            }
+            tunerResult->defaultTime = defaultTime;
+            tunerResult->tunedTime = tunedTime;
+        }
+
+        result = kzcStringDelete(content);
+        kzsErrorForward(result);
+
+        if(!loaded)
+        {
+            kzInt removeResult = (kzInt)remove(path);
+            KZ_UNUSED_RETURN_VALUE(removeResult);
+            kzcLogDebug("Removed invalid work-group tuner result '%s'", path);
+        }
+    }
+
+    *out_loaded = loaded;
+    kzsSuccess();
+}
+
+static kzsError cluWorkGroupTunerStore_internal(const struct CluWorkGroupTuner* tuner, kzString path, const struct CluWorkGroupTunerResult* tunerResult)
+{
+    kzsError result;
+    kzChar line[128];
+    kzString lines[1];
+
+    sprintf(line, "%u %u %u %u %u", (kzUint)tunerResult->localWorkSize[0], (kzUint)tunerResult->localWorkSize[1], (kzUint)tunerResult->localWorkSize[2],
+            tunerResult->defaultTime, tunerResult->tunedTime);
+    lines[0] = line;
+
+    result = kzcFileWriteTextFile(kzcMemoryGetManager(tuner), path, 1, lines);
+    kzsErrorForward(result);
+    kzcLogDebug("Stored work-group tuner result '%s'", path);
+
+    kzsSuccess();
+}
+
+static kzsError cluWorkGroupTunerMeasure_internal(cl_command_queue queue, cl_kernel kernel, cl_uint dimensions, const size_t* globalWorkOffset,
+                                                  const size_t* globalWorkSize, const size_t* localWorkSize, kzUint* out_time)
+{
+    cl_int clResult;
+    kzUint fastestTime = 0;
+    kzUint i;
+
+    /* First launch is a warm-up, and it also tells whether the driver accepts the local size. */
+    for(i = 0; i <= CLU_WORK_GROUP_TUNER_REPEAT_COUNT; ++i)
+    {
+        cl_event event;
+        cl_ulong startTime = 0;
+        cl_ulong endTime = 0;
+
+        clResult = clEnqueueNDRangeKernel(queue, kernel, dimensions, globalWorkOffset, globalWorkSize, localWorkSize, 0, KZ_NULL, &event);
+        if(clResult != CL_SUCCESS)
+        {
+            fastestTime = 0;
+            break;
+        }
+        clResult = clWaitForEvents(1, &event);
+        cluClErrorTest(clResult);
+        clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(cl_ulong), &startTime, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(cl_ulong), &endTime, KZ_NULL);
+        cluClErrorTest(clResult);
+        clResult = clReleaseEvent(event);
+        cluClErrorTest(clResult);
+
+        if(i > 0)
+        {
+            /* Zero time is reserved for rejected sizes. */
+            kzUint time = (endTime > startTime) ? (kzUint)(endTime - startTime) : 1;
+            if(fastestTime == 0 || time < fastestTime)
+            {
+                fastestTime = time;
+            }
+        }
+    }
+
+    *out_time = fastestTime;
+    kzsSuccess();
+}
+
+static kzsError cluWorkGroupTunerSearch_internal(cl_command_queue queue, cl_device_id device, const size_t* globalWorkOffset, const size_t* localWorkSize,
+                                                 struct CluWorkGroupTunerResult* tunerResult)
+{
+    kzsError result;
+    cl_int clResult;
+    size_t maximumWorkGroupSize = 0;
+    size_t preferredMultiple = 1;
+    size_t maximumItemSizes[3] = {1, 1, 1};
+    size_t values[3][CLU_WORK_GROUP_TUNER_MAXIMUM_VALUES];
+    kzUint valueCounts[3] = {1, 1, 1};
+    size_t candidates[CLU_WORK_GROUP_TUNER_MAXIMUM_CANDIDATES][3];
+    kzUint candidateCount = 0;
+    kzBool requireMultiple;
+    cl_uint dimension;
+    kzUint i;
+
+    clResult = clGetKernelWorkGroupInfo(tunerResult->kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(size_t), &maximumWorkGroupSize, KZ_NULL);
+    cluClErrorTest(clResult);
+    clResult = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(maximumItemSizes), maximumItemSizes, KZ_NULL);
+    cluClErrorTest(clResult);
+    /* Preferred multiple is not available on OpenCL 1.0 devices, where any size is treated as preferred. */
+    clResult = clGetKernelWorkGroupInfo(tunerResult->kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof(size_t), &preferredMultiple, KZ_NULL);
+    if(clResult != CL_SUCCESS || preferredMultiple == 0)
+    {
+        preferredMultiple = 1;
+    }
+
+    /* Values of each dimension are powers of two and power of two multiples of the preferred multiple, which divide the global size. */
+    values[0][0] = values[1][0] = values[2][0] = 1;
+    for(dimension = 0; dimension < tunerResult->dimensions; ++dimension)
+    {
+        size_t value;
+        valueCounts[dimension] = 0;
+        for(value = 1; value <= maximumWorkGroupSize && value <= maximumItemSizes[dimension]; value *= 2)
+        {
+            size_t multipleValue = value * preferredMultiple;
+            if(tunerResult->globalWorkSize[dimension] % value == 0 && valueCounts[dimension] < CLU_WORK_GROUP_TUNER_MAXIMUM_VALUES)
+            {
+                values[dimension][valueCounts[dimension]++] = value;
+            }
+            if((preferredMultiple & (preferredMultiple - 1)) != 0 && multipleValue <= maximumWorkGroupSize && multipleValue <= maximumItemSizes[dimension] &&
+               tunerResult->globalWorkSize[dimension] % multipleValue == 0 && valueCounts[dimension] < CLU_WORK_GROUP_TUNER_MAXIMUM_VALUES)
+            {
+                values[dimension][valueCounts[dimension]++] = multipleValue;
+            }
+        }
+    }
+
+    /* Work-group sizes which are not multiples of the preferred multiple are tried only when the global size allows nothing else. */
+    for(requireMultiple = KZ_TRUE; candidateCount == 0; requireMultiple = KZ_FALSE)
+    {
+        kzUint x;
+        for(x = 0; x < valueCounts[0]; ++x)
+        {
+            kzUint y;
+            for(y = 0; y < valueCounts[1]; ++y)
+            {
+                kzUint z;
+                for(z = 0; z < valueCounts[2]; ++z)
+                {
+                    size_t groupSize = values[0][x] * values[1][y] * values[2][z];
+                    if(groupSize <= maximumWorkGroupSize && (!requireMultiple || groupSize % preferredMultiple == 0) &&
+                       candidateCount < CLU_WORK_GROUP_TUNER_MAXIMUM_CANDIDATES)
+                    {
+                        candidates[candidateCount][0] = values[0][x];
+                        candidates[candidateCount][1] = values[1][y];
+                        candidates[candidateCount][2] = values[2][z];
+                        ++candidateCount;
+                    }
+                }
+            }
+        }
+        if(!requireMultiple)
+        {
+            break;
+        }
+    }
+
+    result = cluWorkGroupTunerMeasure_internal(queue, tunerResult->kernel, tunerResult->dimensions, globalWorkOffset, tunerResult->globalWorkSize,
+                                               localWorkSize, &tunerResult->defaultTime);
+    kzsErrorForward(result);
+
+    tunerResult->tunedTime = tunerResult->defaultTime;
+    tunerResult->candidateCount = candidateCount;
+    for(i = 0; i < candidateCount; ++i)
+    {
+        kzUint time;
+        result = cluWorkGroupTunerMeasure_internal(queue, tunerResult->kernel, tunerResult->dimensions, globalWorkOffset, tunerResult->globalWorkSize,
+                                                   candidates[i], &time);
+        kzsErrorForward(result);
+
+        if(time > 0 && (tunerResult->tunedTime == 0 || time < tunerResult->tunedTime))
+        {
+            tunerResult->tunedTime = time;
+            tunerResult->localWorkSize[0] = candidates[i][0];
+            tunerResult->localWorkSize[1] = (tunerResult->dimensions > 1) ? candidates[i][1] : 0;
+            tunerResult->localWorkSize[2] = (tunerResult->dimensions > 2) ? candidates[i][2] : 0;
+        }
+    }
+
+    kzsSuccess();
+}
+
+kzsError cluWorkGroupTunerEnqueueNDRangeKernel(struct CluWorkGroupTuner* tuner, cl_command_queue queue, cl_kernel kernel, cl_uint dimensions,
+                                               const size_t* globalWorkOffset, const size_t* globalWorkSize, const size_t* localWorkSize,
+                                               cl_uint eventWaitListCount, const cl_event* eventWaitList, cl_event* out_event)
+{
+    kzsError result;
+    cl_int clResult;
+    const size_t* launchLocalWorkSize = localWorkSize;
+
+    kzsAssert(dimensions >= 1 && dimensions <= 3);
+
+    if(tuner != KZ_NULL)
+    {
+        struct CluWorkGroupTunerResult* tunerResult;
+
+        kzsAssert(kzcIsValidPointer(tuner));
+
+        tunerResult = cluWorkGroupTunerFindResult_internal(tuner, kernel, dimensions, globalWorkSize);
+        if(tunerResult == KZ_NULL)
+        {
+            kzChar kernelName[256];
+
+            clResult = clGetKernelInfo(kernel, CL_KERNEL_FUNCTION_NAME, sizeof(kernelName), kernelName, KZ_NULL);
+            cluClErrorTest(clResult);
+
+            tunerResult = cluWorkGroupTunerRebindResult_internal(tuner, kernel, kernelName, dimensions, globalWorkSize);
+            if(tunerResult == KZ_NULL)
+            {
+                struct KzcMemoryManager* memoryManager = kzcMemoryGetManager(tuner);
+                cl_device_id device;
+                kzMutableString path;
+                kzBool loaded;
+                cl_uint dimension;
+
+                clResult = clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device, KZ_NULL);
+                cluClErrorTest(clResult);
+
+                result = kzcMemoryAllocVariable(memoryManager, tunerResult, "Work-group tuner result");
+                kzsErrorForward(result);
+                result = kzcStringCopy(memoryManager, kernelName, &tunerResult->kernelName);
+                kzsErrorForward(result);
+                tunerResult->kernel = kernel;
+                tunerResult->dimensions = dimensions;
+                for(dimension = 0; dimension < 3; ++dimension)
+                {
+                    tunerResult->globalWorkSize[dimension] = (dimension < dimensions) ? globalWorkSize[dimension] : 1;
+                    tunerResult->localWorkSize[dimension] = 0;
+                }
+                tunerResult->defaultTime = 0;
+                tunerResult->tunedTime = 0;
+                tunerResult->candidateCount = 0;
+
+                result = cluWorkGroupTunerGetPath_internal(tuner, device, kernel, kernelName, dimensions, globalWorkSize, &path);
+                kzsErrorForward(result);
+                result = cluWorkGroupTunerLoad_internal(tuner, path, tunerResult, &loaded);
+                kzsErrorForward(result);
+
+                if(loaded)
+                {
+                    ++tuner->hitCount;
+                }
+                else if(tuner->searchEnabled)
+                {
+                    cl_command_queue_properties queueProperties = 0;
+                    clResult = clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES, sizeof(queueProperties), &queueProperties, KZ_NULL);
+                    cluClErrorTest(clResult);
+
+                    if((queueProperties & CL_QUEUE_PROFILING_ENABLE) != 0)
+                    {
+                        /* Commands of the caller must not be included in the measurements. */
+                        clResult = clFinish(queue);
+                        cluClErrorTest(clResult);
+
+                        result = cluWorkGroupTunerSearch_internal(queue, device, globalWorkOffset, localWorkSize, tunerResult);
+                        kzsErrorForward(result);
+                        result = cluWorkGroupTunerStore_internal(tuner, path, tunerResult);
+                        kzsErrorForward(result);
+                        ++tuner->searchCount;
+                    }
+                    else
+                    {
+                        kzcLogDebug("Work-group size of kernel '%s' not tuned, as command queue does not have profiling enabled", kernelName);
+                    }
+                }
+
+                result = kzcStringDelete(path);
+                kzsErrorForward(result);
+                result = kzcDynamicArrayAdd(tuner->results, tunerResult);
+                kzsErrorForward(result);
+            }
+        }
+
+        if(tunerResult->localWorkSize[0] != 0)
+        {
+            launchLocalWorkSize = tunerResult->localWorkSize;
+        }
+    }
+
+    clResult = clEnqueueNDRangeKernel(queue, kernel, dimensions, globalWorkOffset, globalWorkSize, launchLocalWorkSize, eventWaitListCount, eventWaitList, out_event);
+    cluClErrorTest(clResult);
+
+    kzsSuccess();
+}
+
+void cluWorkGroupTunerSetSearchEnabled(struct CluWorkGroupTuner* tuner, kzBool enabled)
+{
+    kzsAssert(kzcIsValidPointer(tuner));
+    tuner->searchEnabled = enabled;
+}
+
+void cluWorkGroupTunerUnbindKernels(const struct CluWorkGroupTuner* tuner)
+{
+    kzUint i;
+
+    kzsAssert(kzcIsValidPointer(tuner));
+
+    for(i = 0; i < kzcDynamicArrayGetSize(tuner->results); ++i)
+    {
+        struct CluWorkGroupTunerResult* tunerResult = (struct CluWorkGroupTunerResult*)kzcDynamicArrayGet(tuner->results, i);
+        tunerResult->kernel = KZ_NULL;
+    }
+}
+
+kzsError cluWorkGroupTunerReset(struct CluWorkGroupTuner* tuner)
+{
+    kzsError result;
+    kzUint i;
+
+    kzsAssert(kzcIsValidPointer(tuner));
+
+    for(i = 0; i < kzcDynamicArrayGetSize(tuner->results); ++i)
+    {
+        struct CluWorkGroupTunerResult* tunerResult = (struct CluWorkGroupTunerResult*)kzcDynamicArrayGet(tuner->results, i);
+        result = kzcStringDelete(tunerResult->kernelName);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeVariable(tunerResult);
+        kzsErrorForward(result);
+    }
+    kzcDynamicArrayClear(tuner->results);
+    tuner->hitCount = 0;
+    tuner->searchCount = 0;
+
+    kzsSuccess();
+}
+
+kzUint cluWorkGroupTunerGetResultCount(const struct CluWorkGroupTuner* tuner)
+{
+    kzsAssert(kzcIsValidPointer(tuner));
+    return kzcDynamicArrayGetSize(tuner->results);
+}
+
+const struct CluWorkGroupTunerResult* cluWorkGroupTunerGetResult(const struct CluWorkGroupTuner* tuner, kzUint index)
+{
+    kzsAssert(kzcIsValidPointer(tuner));
+    return (const struct CluWorkGroupTunerResult*)kzcDynamicArrayGet(tuner->results, index);
+}
+
+kzUint cluWorkGroupTunerGetHitCount(const struct CluWorkGroupTuner* tuner)
+{
+    kzsAssert(kzcIsValidPointer(tuner));
+    return tuner->hitCount;
+}
+
+kzUint cluWorkGroupTunerGetSearchCount(const struct CluWorkGroupTuner* tuner)
+{
+    kzsAssert(kzcIsValidPointer(tuner));
+    return tuner->searchCount;
+}
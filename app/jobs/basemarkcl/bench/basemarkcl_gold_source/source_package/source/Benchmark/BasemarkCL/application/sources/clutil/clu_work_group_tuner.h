@@ -0,0 +1,81 @@
+/**
+* \file
+* Work-group size autotuner with per-device results persisted on disk.
+*
+* Kernel launches made through the tuner use the fastest local work size found for the kernel and global work size.
+* Candidates are multiples of CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE and powers of two limited by
+* CL_KERNEL_WORK_GROUP_SIZE and the device work item sizes, and each must divide the global work size. Candidates are
+* timed with event profiling on the command queue of the launch, so the queue must be created with profiling enabled.
+* Winners are stored to one file per launch configuration, named after the MD5 of the device name, driver version,
+* kernel name, program binary and global work size.
+*
+* Copyright 2011 by Rightware. All rights reserved.
+*/
+#ifndef CLU_WORK_GROUP_TUNER_H
+#define CLU_WORK_GROUP_TUNER_H
+
+#include "clu_opencl_base.h"
+
+#include <system/kzs_types.h>
+#include <system/debug/kzs_error.h>
+
+
+/* Forward declarations. */
+struct KzcMemoryManager;
+
+
+/** Local work size chosen for one kernel launch configuration. Times are in nanoseconds. */
+struct CluWorkGroupTunerResult
+{
+    cl_kernel kernel; /**< Kernel of the launch. Only valid until the results are reset. KZ_NULL while the result is unbound. */
+    kzMutableString kernelName; /**< Function name of the kernel. */
+    cl_uint dimensions; /**< Number of work dimensions. */
+    size_t globalWorkSize[3]; /**< Global work size of the launch. */
+    size_t localWorkSize[3]; /**< Chosen local work size. Zero if the size given by the caller is used. */
+    kzUint defaultTime; /**< Execution time with the local work size given by the caller. Zero if not measured. */
+    kzUint tunedTime; /**< Execution time with the chosen local work size. Zero if not measured. */
+    kzUint candidateCount; /**< Number of candidates measured. Zero if the result was loaded from disk or not searched. */
+};
+
+/**
+* \struct CluWorkGroupTuner
+* Work-group size search, its on-disk result store and the results of the launches since last reset.
+*/
+struct CluWorkGroupTuner;
+
+
+/** Creates work-group tuner storing its results to given directory. Directory is created if it does not exist. */
+kzsError cluWorkGroupTunerCreate(const struct KzcMemoryManager* memoryManager, kzString directory, struct CluWorkGroupTuner** out_tuner);
+/** Deletes work-group tuner. Stored results are left on disk. */
+kzsError cluWorkGroupTunerDelete(struct CluWorkGroupTuner* tuner);
+
+/**
+* Enqueues kernel like clEnqueueNDRangeKernel, but with the tuned local work size. Tuner can be KZ_NULL, in which case
+* the given local work size is used. On the first launch of a kernel and global work size the result is loaded from disk,
+* or searched if search is enabled. Searching executes the kernel repeatedly with the arguments currently set.
+*/
+kzsError cluWorkGroupTunerEnqueueNDRangeKernel(struct CluWorkGroupTuner* tuner, cl_command_queue queue, cl_kernel kernel, cl_uint dimensions,
+                                               const size_t* globalWorkOffset, const size_t* globalWorkSize, const size_t* localWorkSize,
+                                               cl_uint eventWaitListCount, const cl_event* eventWaitList, cl_event* out_event);
+
+/** Enables or disables searching of launch configurations without a stored result. Disabled configurations use the given local size. */
+void cluWorkGroupTunerSetSearchEnabled(struct CluWorkGroupTuner* tuner, kzBool enabled);
+
+/**
+* Unbinds the results from their kernels, so that the kernels can be released and created again without losing the results.
+* An unbound result is bound to the next launched kernel with the same function name and global work size.
+*/
+void cluWorkGroupTunerUnbindKernels(const struct CluWorkGroupTuner* tuner);
+/** Removes the results of the launches and resets the statistics. Must be called before the kernels of the results are released. */
+kzsError cluWorkGroupTunerReset(struct CluWorkGroupTuner* tuner);
+/** Returns number of launch configurations since last reset. */
+kzUint cluWorkGroupTunerGetResultCount(const struct CluWorkGroupTuner* tuner);
+/** Returns the result of a launch configuration. */
+const struct CluWorkGroupTunerResult* cluWorkGroupTunerGetResult(const struct CluWorkGroupTuner* tuner, kzUint index);
+/** Returns number of results loaded from disk since last reset. */
+kzUint cluWorkGroupTunerGetHitCount(const struct CluWorkGroupTuner* tuner);
+/** Returns number of searches done since last reset. */
+kzUint cluWorkGroupTunerGetSearchCount(const struct CluWorkGroupTuner* tuner);
+
+
+#endif
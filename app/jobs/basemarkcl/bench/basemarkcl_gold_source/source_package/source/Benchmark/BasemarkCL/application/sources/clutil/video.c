@@ -1,13 +1,17 @@
 /* Video utility library. Uses avcodec
 * Copyright 2011 by Rightware. All rights reserved.
 */
+#include "video.h"
 
 #include <benchmarkutil/bf_benchmark_framework.h>
 #include <benchmarkutil/scene/bf_scene.h>
 #include <benchmarkutil/util/bf_util.h>
+#include <benchmarkutil/report/bf_timer.h>
 
 #include <core/memory/kzc_memory_manager.h>
 #include <system/wrappers/kzs_memory.h>
+#include <system/thread/kzs_thread.h>
+#include <system/kzs_error_codes.h>
 
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
@@ -16,16 +20,13 @@
 #include <system/kzs_types.h>
 #include <system/debug/kzs_error.h>
 
-/* TODO: Cleanup & don't use kzerror to pass runtime parameters etc */
-
-/* 
+/*
 Example on how the current videos have been encoded:
 ffmpeg -i ..\..\..\bin\data\StreetDance-Short-2D_800x480.mp4 -f mpeg -qmax 4 -qmin 1 -s 512x512 -y  ..\..\..\bin\data\movie3.mpeg
 */
 
 struct VideoUtil
 {
-    kzByte *buffer;
     AVFormatContext *formatContext;
     AVCodecContext *codecContext;
     AVCodec *codec;
@@ -36,18 +37,52 @@ struct VideoUtil
 
     kzUint width;
     kzUint height;
-    kzInt format;
+    enum VideoPixelFormat format; /**< Pixel format of the frame buffers. */
+    kzBool copyPlanes; /**< Decoded YUV planes are copied as they are, without scaling. */
     kzInt videoStream;
+    kzUint framesSinceRewind; /**< Frames decoded since the start of the video. Accessed only by the decoder thread. */
+
+    kzUint bufferCount; /**< Number of frame buffers in the ring. */
+    kzByte** buffers; /**< Frame buffers of the ring. */
+    kzBool ownsBuffers; /**< Frame buffers were allocated by the video util. */
+    kzUint ringHead; /**< Index of the oldest decoded frame, which is the acquired frame if there is one. */
+    kzUint readyCount; /**< Number of decoded frames not yet released, including the acquired frame. */
+    kzBool frameAcquired; /**< Consumer holds the frame at ring head. */
+    kzBool stopRequested; /**< Decoder thread exits as soon as possible. */
+    kzBool decoderFinished; /**< Decoder thread has exited, either on request or because of an error. */
+    struct KzsThreadLock* ringLock; /**< Protects the ring. Set when a frame has been decoded or the decoder has finished. */
+    struct KzsThreadLock* spaceLock; /**< Set when a frame has been released or stop has been requested. */
+    struct KzsThread* decoderThread; /**< Thread decoding the frames ahead. */
+
+    struct BfTimer* timer; /**< Timer for decode and stall times. */
+    kzUint decodedFrameCount; /**< Frames decoded since statistics reset. Protected by ring lock. */
+    kzUint decodeTime; /**< Time spent decoding since statistics reset, in microseconds. Protected by ring lock. */
+    kzUint conversionTime; /**< Part of decode time spent converting into the frame buffers, in microseconds. Protected by ring lock. */
+    kzUint stallCount; /**< Number of acquires that waited for the decoder. */
+    kzUint stallTime; /**< Time spent waiting for the decoder, in microseconds. */
 };
 
-/* TODO: Investigate if getting pointer to mapped memory area from opencl in order to decode the frame directly to the OpenCL device would be beneficial */
-kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUint width, kzUint height, struct VideoUtil **outVideo)
+
+/** Decoder thread function. */
+static kzsError videoDecoder_internal(void* userData);
+/** Decodes frames into free frame buffers until stop is requested. */
+static kzsError videoDecodeFrames_internal(struct VideoUtil *video);
+/** Decodes and scales the next frame of the video into given buffer. Rewinds the video at the end. Returns the conversion time in microseconds. */
+static kzsError videoDecodeFrame_internal(struct VideoUtil *video, kzByte* buffer, kzUint* out_conversionTime);
+/** Copies the planes of the decoded YUV 4:2:0 frame into given buffer. */
+static void videoCopyPlanes_internal(const struct VideoUtil *video, kzByte* buffer);
+
+
+kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUint width, kzUint height, enum VideoPixelFormat format,
+                   kzUint bufferCount, kzByte* const* buffers, struct VideoUtil **outVideo)
 {
     struct VideoUtil *video;
     struct KzcMemoryManager *memoryManager;
-    kzInt result;
+    kzsError result;
     kzUint i;
 
+    kzsErrorTest(bufferCount >= 2, KZS_ERROR_ILLEGAL_ARGUMENT, "Video decoding ahead requires at least two frame buffers");
+
     memoryManager = bfGetMemoryManager(framework);
     result = kzcMemoryAllocPointer(memoryManager, &video, sizeof(struct VideoUtil), "Video util state");
     kzsErrorForward(result);
@@ -56,11 +91,9 @@ kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUi
 
     /* TODO: Register only MPEG-1 codec and compile ffmpeg only with support for it */
     av_register_all();
-    
-    if(av_open_input_file(&video->formatContext, filename, NULL, 0, NULL) || av_find_stream_info(video->formatContext) < 0)
-    {
-        /* Die */
-    }
+
+    kzsErrorTest(av_open_input_file(&video->formatContext, filename, NULL, 0, NULL) == 0 && av_find_stream_info(video->formatContext) >= 0,
+                 KZS_ERROR_FILE_OPEN_FAILED, "Failed to open video file");
 
     video->videoStream = -1;
 
@@ -72,108 +105,388 @@ kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUi
             break;
         }
     }
-    if(video->videoStream == -1)
-    {
-        /* DIE! */
-    }
+    kzsErrorTest(video->videoStream != -1, KZS_ERROR_FILE_OPERATION_FAILED, "Video file has no video stream");
 
     video->codecContext = video->formatContext->streams[video->videoStream]->codec;
     video->width = width? width: video->codecContext->width;
     video->height = height? height: video->codecContext->height;
+    video->format = format;
     video->codec = avcodec_find_decoder(video->codecContext->codec_id);
-    
-    if(!video->codec ||
-        avcodec_open(video->codecContext, video->codec) < 0)
-    {
-        /* DIE */
-    }
+    kzsErrorTest(format != VIDEO_PIXEL_FORMAT_YUV420 || (video->width % 2 == 0 && video->height % 2 == 0), KZS_ERROR_ILLEGAL_ARGUMENT,
+                 "YUV 4:2:0 video frames must have even size");
 
+    kzsErrorTest(video->codec != NULL && avcodec_open(video->codecContext, video->codec) >= 0, KZS_ERROR_FILE_OPERATION_FAILED, "Failed to open video codec");
 
-    /* TODO: Check if we actually receive these */
     video->curFrame = avcodec_alloc_frame();
     video->convertedFrame = avcodec_alloc_frame();
-
-    kzcMemoryAllocPointer(memoryManager, &video->buffer, avpicture_get_size(PIX_FMT_RGBA, video->width, video->height), "Framebuffer");
+    kzsErrorTest(video->curFrame != NULL && video->convertedFrame != NULL, KZS_ERROR_OUT_OF_MEMORY, "Failed to allocate video frames");
 
     /* Init buffers */
-    avpicture_fill((AVPicture *) video->convertedFrame, video->buffer, PIX_FMT_RGBA, 
-        video->width, video->height);
+    video->bufferCount = bufferCount;
+    video->ownsBuffers = (buffers == KZ_NULL);
+    result = kzcMemoryAllocArray(memoryManager, video->buffers, bufferCount, "Video frame buffers");
+    kzsErrorForward(result);
+    for(i = 0; i < bufferCount; ++i)
+    {
+        if(video->ownsBuffers)
+        {
+            result = kzcMemoryAllocPointer(memoryManager, &video->buffers[i], videoCalculateFrameSize(format, video->width, video->height), "Framebuffer");
+            kzsErrorForward(result);
+        }
+        else
+        {
+            video->buffers[i] = buffers[i];
+        }
+    }
 
-    /* Init scale & convert */
-    video->scalingContext = sws_getContext(video->codecContext->width, video->codecContext->height, video->codecContext->pix_fmt,
-        video->width, video->height, PIX_FMT_RGBA, SWS_BICUBIC, NULL, NULL, NULL);
+    /* Init scale & convert. Native YUV 4:2:0 frames of the right size need neither. */
+    video->copyPlanes = (format == VIDEO_PIXEL_FORMAT_YUV420 && video->codecContext->pix_fmt == PIX_FMT_YUV420P &&
+                         video->width == (kzUint)video->codecContext->width && video->height == (kzUint)video->codecContext->height);
+    if(!video->copyPlanes)
+    {
+        video->scalingContext = sws_getContext(video->codecContext->width, video->codecContext->height, video->codecContext->pix_fmt,
+            video->width, video->height, (format == VIDEO_PIXEL_FORMAT_YUV420) ? PIX_FMT_YUV420P : PIX_FMT_RGBA, SWS_BICUBIC, NULL, NULL, NULL);
+        kzsErrorTest(video->scalingContext != NULL, KZS_ERROR_ILLEGAL_ARGUMENT, "Unsupported video scaling");
+    }
 
+    result = bfTimerCreate(memoryManager, &video->timer);
+    kzsErrorForward(result);
+
+    /* Start decoding ahead. */
+    result = kzsThreadLockCreate(&video->ringLock);
+    kzsErrorForward(result);
+    result = kzsThreadLockCreate(&video->spaceLock);
+    kzsErrorForward(result);
+    result = kzsThreadCreate(videoDecoder_internal, video, KZ_FALSE, &video->decoderThread);
+    kzsErrorForward(result);
 
     *outVideo = video;
     kzsSuccess();
 }
 
+static kzsError videoDecoder_internal(void* userData)
+{
+    kzsError result;
+    kzsError decodeResult;
+    struct VideoUtil* video = (struct VideoUtil*)userData;
+
+    decodeResult = videoDecodeFrames_internal(video);
+
+    /* Consumer waiting for a frame must not be left waiting if decoding fails. */
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    video->decoderFinished = KZ_TRUE;
+    result = kzsThreadLockSet(video->ringLock, KZ_TRUE, KZ_FALSE);
+    kzsErrorForward(result);
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+
+    kzsErrorForward(decodeResult);
+    kzsSuccess();
+}
+
+static kzsError videoDecodeFrames_internal(struct VideoUtil *video)
+{
+    kzsError result;
+    kzBool running = KZ_TRUE;
+
+    while(running)
+    {
+        kzByte* buffer = KZ_NULL;
 
-kzsError videoNext(struct BenchmarkFramework *framework, struct VideoUtil *video)
-{
-	AVPacket packet;
-	int finished = 0;
-	
-	/* Read a frame */
-	if(av_read_frame(video->formatContext, &packet) < 0)
-		return -1;
-	
-	/* Check if the packet comes from the correct stream */
-	if(packet.stream_index != video->videoStream) {
-		av_free_packet(&packet);
-		return -2;
-	}
-	
-    /*  Decode the next frame */
-	/*  TODO: Do not decode frames if we want to skip some */
-	avcodec_decode_video2(video->codecContext, video->curFrame, &finished, &packet);
-	
-	/* Does this packet complete a single frame? */
-	if(!finished) {
-		av_free_packet(&packet);
-		return -3;
-	}
-	
-
-    /* TODO: Figure out which format would allow us to skip the format conversion */
-	sws_scale(video->scalingContext, video->curFrame->data, video->curFrame->linesize, 
-		0, video->codecContext->height, video->convertedFrame->data, video->convertedFrame->linesize);
-	av_free_packet(&packet);
-	
+        result = kzsThreadLockAcquire(video->ringLock);
+        kzsErrorForward(result);
+        running = !video->stopRequested;
+        if(running && video->readyCount < video->bufferCount)
+        {
+            buffer = video->buffers[(video->ringHead + video->readyCount) % video->bufferCount];
+        }
+        result = kzsThreadLockRelease(video->ringLock);
+        kzsErrorForward(result);
 
+        if(running && buffer == KZ_NULL)
+        {
+            result = kzsThreadLockWaitAndReset(video->spaceLock, KZ_TRUE);
+            kzsErrorForward(result);
+        }
+        else if(running)
+        {
+            kzUint startTime = bfTimerGetElapsedTimeInMicroSeconds(video->timer);
+            kzUint decodeTime;
+            kzUint conversionTime;
+
+            /* Buffer is not visible to the consumer until it is counted as ready, so it is written without the lock. */
+            result = videoDecodeFrame_internal(video, buffer, &conversionTime);
+            kzsErrorForward(result);
+            decodeTime = bfTimerGetElapsedTimeInMicroSeconds(video->timer) - startTime;
+
+            result = kzsThreadLockAcquire(video->ringLock);
+            kzsErrorForward(result);
+            ++video->readyCount;
+            ++video->decodedFrameCount;
+            video->decodeTime += decodeTime;
+            video->conversionTime += conversionTime;
+            result = kzsThreadLockSet(video->ringLock, KZ_TRUE, KZ_FALSE);
+            kzsErrorForward(result);
+            result = kzsThreadLockRelease(video->ringLock);
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static kzsError videoDecodeFrame_internal(struct VideoUtil *video, kzByte* buffer, kzUint* out_conversionTime)
+{
+    kzBool frameDecoded = KZ_FALSE;
+
+    while(!frameDecoded)
+    {
+        AVPacket packet;
+
+        if(av_read_frame(video->formatContext, &packet) < 0)
+        {
+            /* End of video. Looping keeps the decoder ahead regardless of the frame count of the scene. */
+            kzsErrorTest(video->framesSinceRewind > 0, KZS_ERROR_FILE_OPERATION_FAILED, "Video has no decodable frames");
+            kzsErrorTest(av_seek_frame(video->formatContext, video->videoStream, 0, AVSEEK_FLAG_BACKWARD) >= 0,
+                         KZS_ERROR_FILE_OPERATION_FAILED, "Failed to rewind video");
+            avcodec_flush_buffers(video->codecContext);
+            video->framesSinceRewind = 0;
+        }
+        else
+        {
+            /* Check if the packet comes from the correct stream */
+            if(packet.stream_index == video->videoStream)
+            {
+                int finished = 0;
+                avcodec_decode_video2(video->codecContext, video->curFrame, &finished, &packet);
+
+                /* Does this packet complete a single frame? */
+                if(finished)
+                {
+                    kzUint startTime = bfTimerGetElapsedTimeInMicroSeconds(video->timer);
+                    if(video->copyPlanes)
+                    {
+                        videoCopyPlanes_internal(video, buffer);
+                    }
+                    else
+                    {
+                        avpicture_fill((AVPicture *) video->convertedFrame, buffer, (video->format == VIDEO_PIXEL_FORMAT_YUV420) ? PIX_FMT_YUV420P : PIX_FMT_RGBA,
+                            video->width, video->height);
+                        sws_scale(video->scalingContext, video->curFrame->data, video->curFrame->linesize,
+                            0, video->codecContext->height, video->convertedFrame->data, video->convertedFrame->linesize);
+                    }
+                    *out_conversionTime = bfTimerGetElapsedTimeInMicroSeconds(video->timer) - startTime;
+                    ++video->framesSinceRewind;
+                    frameDecoded = KZ_TRUE;
+                }
+            }
+            av_free_packet(&packet);
+        }
+    }
+
+    kzsSuccess();
+}
+
+static void videoCopyPlanes_internal(const struct VideoUtil *video, kzByte* buffer)
+{
+    kzUint plane;
+    kzByte* target = buffer;
+
+    /* Decoder rows may be padded, so the planes are copied row by row. */
+    for(plane = 0; plane < 3; ++plane)
+    {
+        kzUint planeWidth = (plane == 0) ? video->width : video->width / 2;
+        kzUint planeHeight = (plane == 0) ? video->height : video->height / 2;
+        kzUint row;
+        for(row = 0; row < planeHeight; ++row)
+        {
+            kzsMemcpy(target, video->curFrame->data[plane] + row * video->curFrame->linesize[plane], planeWidth);
+            target += planeWidth;
+        }
+    }
+}
+
+kzsError videoAcquireFrame(struct VideoUtil *video)
+{
+    kzsError result;
+    kzBool frameReady;
+
+    kzsAssert(kzcIsValidPointer(video));
+    kzsErrorTest(!video->frameAcquired, KZS_ERROR_ILLEGAL_OPERATION, "Previous video frame has not been released");
+
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    if(video->readyCount == 0 && !video->decoderFinished)
+    {
+        kzUint startTime = bfTimerGetElapsedTimeInMicroSeconds(video->timer);
+        while(video->readyCount == 0 && !video->decoderFinished)
+        {
+            result = kzsThreadLockWaitAndReset(video->ringLock, KZ_FALSE);
+            kzsErrorForward(result);
+        }
+        ++video->stallCount;
+        video->stallTime += bfTimerGetElapsedTimeInMicroSeconds(video->timer) - startTime;
+    }
+    frameReady = (video->readyCount > 0);
+    video->frameAcquired = frameReady;
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+
+    kzsErrorTest(frameReady, KZS_ERROR_THREAD_OPERATION_FAILED, "Video decoder has stopped");
+
+    kzsSuccess();
+}
+
+kzsError videoReleaseFrame(struct VideoUtil *video, kzByte* buffer)
+{
+    kzsError result;
+
+    kzsAssert(kzcIsValidPointer(video));
+    kzsErrorTest(video->frameAcquired, KZS_ERROR_ILLEGAL_OPERATION, "No video frame has been acquired");
+
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    if(buffer != KZ_NULL)
+    {
+        video->buffers[video->ringHead] = buffer;
+    }
+    video->ringHead = (video->ringHead + 1) % video->bufferCount;
+    --video->readyCount;
+    video->frameAcquired = KZ_FALSE;
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+
+    result = kzsThreadLockSet(video->spaceLock, KZ_TRUE, KZ_TRUE);
+    kzsErrorForward(result);
 
     kzsSuccess();
 }
 
 kzsError videoNextFrame(struct BenchmarkFramework *framework, struct VideoUtil *video)
 {
-    kzInt result;
+    kzsError result;
 
-    do 
-    {   
-    result = videoNext(framework, video);
-    
-    } while (result == -3 || result == -2);
+    if(video->frameAcquired)
+    {
+        result = videoReleaseFrame(video, KZ_NULL);
+        kzsErrorForward(result);
+    }
+    result = videoAcquireFrame(video);
+    kzsErrorForward(result);
 
-    return result;
+    kzsSuccess();
 }
 
 kzsError videoUnitialize(struct BenchmarkFramework *framework, struct VideoUtil *video)
 {
-    sws_freeContext(video->scalingContext);
+    kzsError result;
+    kzsError decodeResult;
+    kzUint i;
+
+    /* Stop the decoder before the buffers are freed. */
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    video->stopRequested = KZ_TRUE;
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+    result = kzsThreadLockSet(video->spaceLock, KZ_TRUE, KZ_TRUE);
+    kzsErrorForward(result);
+    result = kzsThreadJoin(video->decoderThread);
+    kzsErrorForward(result);
+    decodeResult = kzsThreadGetExitResult(video->decoderThread);
+    result = kzsThreadDelete(video->decoderThread);
+    kzsErrorForward(result);
+    result = kzsThreadLockDelete(video->spaceLock);
+    kzsErrorForward(result);
+    result = kzsThreadLockDelete(video->ringLock);
+    kzsErrorForward(result);
+    result = bfTimerDelete(video->timer);
+    kzsErrorForward(result);
+
+    if(video->scalingContext != NULL)
+    {
+        sws_freeContext(video->scalingContext);
+    }
     av_free(video->curFrame);
     av_free(video->convertedFrame);
 
     avcodec_close(video->codecContext);
     av_close_input_file(video->formatContext);
 
-    kzcMemoryFreePointer(video->buffer);
-    kzcMemoryFreePointer(video);
+    if(video->ownsBuffers)
+    {
+        for(i = 0; i < video->bufferCount; ++i)
+        {
+            result = kzcMemoryFreePointer(video->buffers[i]);
+            kzsErrorForward(result);
+        }
+    }
+    result = kzcMemoryFreeArray(video->buffers);
+    kzsErrorForward(result);
+    result = kzcMemoryFreePointer(video);
+    kzsErrorForward(result);
+
+    kzsErrorForward(decodeResult);
+    kzsSuccess();
+}
+
+
+kzUint videoCalculateFrameSize(enum VideoPixelFormat format, kzUint width, kzUint height)
+{
+    return (format == VIDEO_PIXEL_FORMAT_YUV420) ? width * height + 2 * (width / 2) * (height / 2) : width * height * 4;
+}
+
+kzByte* videoGetFramePointer(const struct VideoUtil* video)
+{
+    kzsAssert(video->frameAcquired);
+    return video->buffers[video->ringHead];
+}
+
+kzUint videoGetFrameIndex(const struct VideoUtil* video)
+{
+    kzsAssert(video->frameAcquired);
+    return video->ringHead;
+}
+
+kzsError videoResetStatistics(struct VideoUtil* video)
+{
+    kzsError result;
+
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    video->decodedFrameCount = 0;
+    video->decodeTime = 0;
+    video->conversionTime = 0;
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+    video->stallCount = 0;
+    video->stallTime = 0;
+
+    kzsSuccess();
+}
+
+kzsError videoGetDecodeStatistics(struct VideoUtil* video, kzUint* out_decodedFrameCount, kzUint* out_decodeTime, kzUint* out_conversionTime)
+{
+    kzsError result;
+
+    result = kzsThreadLockAcquire(video->ringLock);
+    kzsErrorForward(result);
+    *out_decodedFrameCount = video->decodedFrameCount;
+    *out_decodeTime = video->decodeTime;
+    *out_conversionTime = video->conversionTime;
+    result = kzsThreadLockRelease(video->ringLock);
+    kzsErrorForward(result);
+
     kzsSuccess();
 }
 
+kzUint videoGetStallCount(const struct VideoUtil* video)
+{
+    return video->stallCount;
+}
 
-kzByte* videoGetFramePointer(struct VideoUtil* video)
+kzUint videoGetStallTime(const struct VideoUtil* video)
 {
-    return video->buffer;    
+    return video->stallTime;
 }
@@ -9,28 +9,72 @@
 #include <system/debug/kzs_error.h>
 
 
+/** Default number of frames decoded ahead. */
+#define VIDEO_DEFAULT_BUFFER_COUNT 4
+
+
+/** Pixel formats of the decoded frames. */
+enum VideoPixelFormat
+{
+    VIDEO_PIXEL_FORMAT_RGBA, /**< Interleaved RGBA-8888, converted on the host. */
+    VIDEO_PIXEL_FORMAT_YUV420 /**< Planar YUV 4:2:0. Y plane is followed by U and V planes at half resolution. Width and height must be even. */
+};
+
+
 struct VideoUtil;
 struct BfScene;
 struct BenchmarkFramework;
 
 
-/** 
-* Init the video util and open a video file. The video is currently always converted to RGBA-8888 pixel format.
-* If width and height are 0 the size of the returned frame will be the same as source file
+/**
+* Init the video util and open a video file. The video is converted to given pixel format. YUV 4:2:0 frames of the same size
+* as the source are copied from the decoder as they are, without conversion.
+* If width and height are 0 the size of the returned frame will be the same as source file.
+* Frames are decoded ahead on a background thread into a ring of bufferCount frame buffers. If buffers is KZ_NULL the
+* buffers are allocated by the video util, otherwise given buffers of videoCalculateFrameSize bytes are used, for example
+* mapped OpenCL buffers. The video is looped when it ends.
 */
-kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUint width, kzUint height, struct VideoUtil **outVideo);
+kzsError videoInit(struct BenchmarkFramework *framework, kzString filename, kzUint width, kzUint height, enum VideoPixelFormat format,
+                   kzUint bufferCount, kzByte* const* buffers, struct VideoUtil **outVideo);
+
+/** Returns the size of a frame buffer in bytes for given pixel format and frame size. */
+kzUint videoCalculateFrameSize(enum VideoPixelFormat format, kzUint width, kzUint height);
 
-/** Grab the next frame. */
-kzsError videoNext(struct BenchmarkFramework *framework, struct VideoUtil *video);
+/**
+* Takes the next decoded frame for use. Waits for the decoder if no frame is ready, which is counted as a decode stall.
+* The frame stays valid until it is released with videoReleaseFrame.
+*/
+kzsError videoAcquireFrame(struct VideoUtil *video);
 
-/** Returns the next real frame */
+/**
+* Gives the acquired frame back to the decoder. If buffer is not KZ_NULL, it replaces the frame buffer, for example when an
+* OpenCL buffer has been mapped again to a different address.
+*/
+kzsError videoReleaseFrame(struct VideoUtil *video, kzByte* buffer);
+
+/** Releases the acquired frame, if any, and acquires the next frame. */
 kzsError videoNextFrame(struct BenchmarkFramework *framework, struct VideoUtil *video);
 
-/** Frees the internal data structures and closes the file handle */
+/** Stops the decoder, frees the internal data structures and closes the file handle */
 kzsError videoUnitialize(struct BenchmarkFramework *framework, struct VideoUtil *video);
 
-/** Return the pointer to the buffer which contains the decompressed and scaled frame */
-kzByte* videoGetFramePointer(struct VideoUtil* video);
+/** Return the pointer to the buffer which contains the acquired decompressed and scaled frame */
+kzByte* videoGetFramePointer(const struct VideoUtil* video);
+
+/** Returns the index of the buffer containing the acquired frame. */
+kzUint videoGetFrameIndex(const struct VideoUtil* video);
+
+/** Resets the decoding statistics. */
+kzsError videoResetStatistics(struct VideoUtil* video);
+/**
+* Gets the number of frames decoded and the time in microseconds spent decoding them since the statistics were reset.
+* Conversion time is the part of the decode time spent scaling and converting, or copying, the frames into the frame buffers.
+*/
+kzsError videoGetDecodeStatistics(struct VideoUtil* video, kzUint* out_decodedFrameCount, kzUint* out_decodeTime, kzUint* out_conversionTime);
+/** Returns the number of times a frame was not ready when acquired since the statistics were reset. */
+kzUint videoGetStallCount(const struct VideoUtil* video);
+/** Returns the time in microseconds spent waiting for frames since the statistics were reset. */
+kzUint videoGetStallTime(const struct VideoUtil* video);
 
 
 #endif
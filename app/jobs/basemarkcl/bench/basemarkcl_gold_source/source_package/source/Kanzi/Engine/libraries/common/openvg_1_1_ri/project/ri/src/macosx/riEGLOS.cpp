@@ -32,6 +32,7 @@
 
 #include "egl.h"
 #include "riImage.h"
+#include "riPthreadWorkerPool.h"
 #include <pthread.h>
 #include <sys/errno.h>
 
@@ -106,6 +107,7 @@ void OSReleaseMutex(void)
 	RI_UNREF(ret);
 }
 
+
 /*-------------------------------------------------------------------*//*!
 * \brief	
 * \param	
@@ -32,6 +32,7 @@
 
 #include "egl.h"
 #include "riImage.h"
+#include "riPthreadWorkerPool.h"
 
 namespace OpenVGRI
 {
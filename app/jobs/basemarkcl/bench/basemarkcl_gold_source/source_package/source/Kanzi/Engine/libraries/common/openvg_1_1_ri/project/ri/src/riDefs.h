@@ -116,6 +116,9 @@ RI_INLINE float	getFloatMax()
 #define RI_MAX_EDGES					262144
 #define RI_MAX_SAMPLES					32
 #define RI_NUM_TESSELLATED_SEGMENTS		256
+#define RI_MAX_WORKER_THREADS			64
+#define RI_RASTER_BAND_HEIGHT			16		//scanlines in one band of parallel rasterization
+#define RI_MIN_PARALLEL_RASTER_BANDS	4		//smaller fills are rasterized on the calling thread
 
 #define RI_DEBUG
 
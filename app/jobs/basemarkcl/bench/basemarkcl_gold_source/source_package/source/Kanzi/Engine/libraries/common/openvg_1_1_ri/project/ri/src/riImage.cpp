@@ -808,6 +808,34 @@ void Image::blit(const Surface* src, int sx, int sy, int dx, int dy, int w, int
 *//*-------------------------------------------------------------------*/
 
 Color Image::readPixel(int x, int y) const
+{
+	Color c;
+	c.unpack(readPackedPixel(x, y), m_desc);
+	return c;
+}
+
+/*-------------------------------------------------------------------*//*!
+* \brief	Writes the color to pixel (x,y). Internal color formats must
+*			match.
+* \param	
+* \return	
+* \note		
+*//*-------------------------------------------------------------------*/
+
+void Image::writePixel(int x, int y, const Color& c)
+{
+	RI_ASSERT(c.getInternalFormat() == m_desc.internalFormat);
+	writePackedPixel(x, y, c.pack(m_desc));
+}
+
+/*-------------------------------------------------------------------*//*!
+* \brief	Returns the packed value of pixel (x,y).
+* \param	
+* \return	
+* \note		
+*//*-------------------------------------------------------------------*/
+
+unsigned int Image::readPackedPixel(int x, int y) const
 {
 	RI_ASSERT(m_data);
 	RI_ASSERT(x >= 0 && x < m_width);
@@ -863,30 +891,25 @@ Color Image::readPixel(int x, int y) const
 		break;
 	}
 	}
-	Color c;
-	c.unpack(p, m_desc);
-	return c;
+	return p;
 }
 
 /*-------------------------------------------------------------------*//*!
-* \brief	Writes the color to pixel (x,y). Internal color formats must
-*			match.
+* \brief	Writes a packed value to pixel (x,y).
 * \param	
 * \return	
 * \note		
 *//*-------------------------------------------------------------------*/
 
-void Image::writePixel(int x, int y, const Color& c)
+void Image::writePackedPixel(int x, int y, unsigned int p)
 {
 	RI_ASSERT(m_data);
 	RI_ASSERT(x >= 0 && x < m_width);
 	RI_ASSERT(y >= 0 && y < m_height);
 	RI_ASSERT(m_referenceCount > 0);
-	RI_ASSERT(c.getInternalFormat() == m_desc.internalFormat);
     x += m_storageOffsetX;
     y += m_storageOffsetY;
 
-	unsigned int p = c.pack(m_desc);
 	RIuint8* scanline = m_data + y * m_stride;
 	switch(m_desc.bitsPerPixel)
 	{
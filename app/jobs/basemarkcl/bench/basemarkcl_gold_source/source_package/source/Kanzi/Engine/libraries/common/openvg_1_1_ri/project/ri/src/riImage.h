@@ -233,6 +233,8 @@ public:
 
 	Color				readPixel(int x, int y) const;
 	void				writePixel(int x, int y, const Color& c);
+	unsigned int		readPackedPixel(int x, int y) const;			//pixel (x,y) in the packed format of the image
+	void				writePackedPixel(int x, int y, unsigned int p);
 	void				writeFilteredPixel(int x, int y, const Color& c, VGbitfield channelMask);
 
 	RIfloat				readMaskPixel(int x, int y) const;		//can read any image format
@@ -305,6 +307,8 @@ public:
 
 	RI_INLINE Color		readSample(int x, int y, int sample) const                   { return m_image->readPixel(x*m_numSamples+sample, y); }
 	RI_INLINE void		writeSample(int x, int y, int sample, const Color& c)        { m_image->writePixel(x*m_numSamples+sample, y, c); }
+	RI_INLINE unsigned int	readPackedSample(int x, int y, int sample) const         { return m_image->readPackedPixel(x*m_numSamples+sample, y); }
+	RI_INLINE void		writePackedSample(int x, int y, int sample, unsigned int p)  { m_image->writePackedPixel(x*m_numSamples+sample, y, p); }
 
 	RIfloat				readMaskCoverage(int x, int y) const;
 	void				writeMaskCoverage(int x, int y, RIfloat m);
@@ -889,6 +889,89 @@ void PixelPipe::pixelPipe(int x, int y, RIfloat coverage, unsigned int sampleMas
     }
 }
 
+/*-------------------------------------------------------------------*//*!
+* \brief    Returns true if pixelPipe can be called concurrently for pixels
+*           of different scanlines.
+* \param    
+* \return   
+* \note     Writes touch only the pixel being processed, apart from the
+*           destination's mipmap valid flag which every writer clears to the
+*           same value. Images may build their mipmaps on first resample, so
+*           image drawing and pattern paint are processed on one thread.
+*//*-------------------------------------------------------------------*/
+
+bool PixelPipe::isThreadSafe() const
+{
+    RI_ASSERT(m_paint);
+    if(m_image)
+        return false;
+    if(m_paint->m_paintType == VG_PAINT_TYPE_PATTERN && m_paint->m_pattern)
+        return false;
+    return true;
+}
+
+/*-------------------------------------------------------------------*//*!
+* \brief    Applies paint, image drawing, masking and blending to a run of
+*           pixels [x, x+length[ on scanline y sharing the same coverage.
+* \param    
+* \return   
+* \note     When the paint color is the same for every pixel of the run,
+*           the result of a pixel depends only on its packed destination
+*           value. Only pixels whose destination differs from the previous
+*           one go through pixelPipe, the rest get the previous packed
+*           result. Opaque full coverage SRC and SRC_OVER runs don't depend
+*           on the destination at all and are written without reading it.
+*//*-------------------------------------------------------------------*/
+
+void PixelPipe::pixelPipeSpan(int x, int y, int length, RIfloat coverage, unsigned int sampleMask) const
+{
+    RI_ASSERT(length > 0);
+    RI_ASSERT(m_drawable);
+    RI_ASSERT(m_paint);
+
+    Surface* colorBuffer = m_drawable->getColorBuffer();
+    RI_ASSERT(colorBuffer);
+    bool constantPaint = m_paint->m_paintType == VG_PAINT_TYPE_COLOR || (m_paint->m_paintType == VG_PAINT_TYPE_PATTERN && !m_paint->m_pattern);
+    if(!constantPaint || m_image || m_drawable->getNumSamples() != 1 || (m_masking && m_drawable->getMaskBuffer()) ||
+       colorBuffer->getDescriptor().bitsPerPixel < 8)
+    {   //paint, image or mask vary per pixel, or samples are blended separately
+        for(int i=0;i<length;i++)
+            pixelPipe(x+i, y, coverage, sampleMask);
+        return;
+    }
+
+    bool ignoreDestination = false;
+    if(coverage == 1.0f && (m_blendMode == VG_BLEND_SRC || m_blendMode == VG_BLEND_SRC_OVER))
+    {   //SRC_OVER ignores the destination when the transformed paint alpha is one
+        Color s = m_paint->m_paintColor;
+        colorTransform(s);
+        ignoreDestination = m_blendMode == VG_BLEND_SRC || s.a == 1.0f;
+    }
+
+    unsigned int dst = colorBuffer->readPackedSample(x, y, 0);
+    pixelPipe(x, y, coverage, sampleMask);
+    unsigned int result = colorBuffer->readPackedSample(x, y, 0);
+    if(ignoreDestination)
+    {
+        for(int i=1;i<length;i++)
+            colorBuffer->writePackedSample(x+i, y, 0, result);
+        return;
+    }
+
+    for(int i=1;i<length;i++)
+    {
+        unsigned int d = colorBuffer->readPackedSample(x+i, y, 0);
+        if(d == dst)
+            colorBuffer->writePackedSample(x+i, y, 0, result);
+        else
+        {
+            dst = d;
+            pixelPipe(x+i, y, coverage, sampleMask);
+            result = colorBuffer->readPackedSample(x+i, y, 0);
+        }
+    }
+}
+
 //=======================================================================
     
 }   //namespace OpenVGRI
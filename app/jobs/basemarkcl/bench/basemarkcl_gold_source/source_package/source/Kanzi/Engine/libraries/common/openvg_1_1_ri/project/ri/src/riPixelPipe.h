@@ -108,6 +108,8 @@ public:
 	~PixelPipe();
 
 	void	pixelPipe(int x, int y, RIfloat coverage, unsigned int sampleMask) const;	//rasterizer calls this function for each pixel
+	void	pixelPipeSpan(int x, int y, int length, RIfloat coverage, unsigned int sampleMask) const;	//rasterizer calls this function for each run of pixels with constant coverage
+	bool	isThreadSafe() const;	//true if different scanlines can be processed in parallel
 
 	void	setDrawable(Drawable* drawable);
 	void	setBlendMode(VGBlendMode blendMode);
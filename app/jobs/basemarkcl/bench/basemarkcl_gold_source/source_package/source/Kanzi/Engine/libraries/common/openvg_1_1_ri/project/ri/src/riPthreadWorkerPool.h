@@ -0,0 +1,154 @@
+#ifndef __RIPTHREADWORKERPOOL_H
+#define __RIPTHREADWORKERPOOL_H
+
+/*------------------------------------------------------------------------
+ *
+ * OpenVG 1.1 Reference Implementation
+ * -----------------------------------
+ *
+ * Copyright (c) 2007 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and /or associated documentation files
+ * (the "Materials "), to deal in the Materials without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Materials,
+ * and to permit persons to whom the Materials are furnished to do so,
+ * subject to the following conditions: 
+ *
+ * The above copyright notice and this permission notice shall be included 
+ * in all copies or substantial portions of the Materials. 
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE MATERIALS OR
+ * THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ *
+ *//**
+ * \file
+ * \brief	pthread worker pool shared by the POSIX OS ports.
+ * \note	Defines OSGetNumWorkerThreads and OSRunParallel. Included once
+ *		by the riEGLOS.cpp of each port that rasterizes in parallel.
+ *//*-------------------------------------------------------------------*/
+
+#ifndef __RIDEFS_H
+#include "riDefs.h"
+#endif
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace OpenVGRI
+{
+
+/*-------------------------------------------------------------------*//*!
+* \brief	Fixed pool of worker threads for parallel rasterization.
+* \param	
+* \return	
+* \note		The pool is created on first use with one thread per processor,
+*			the calling thread included. Jobs are handed out in index order
+*			and OSRunParallel returns once all of them have finished.
+*//*-------------------------------------------------------------------*/
+
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t poolDispatchMutex = PTHREAD_MUTEX_INITIALIZER;	//one parallel run at a time
+static pthread_cond_t poolStart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolDone = PTHREAD_COND_INITIALIZER;
+static int poolNumThreads = -1;		//threads in addition to the calling thread, -1 before creation
+static unsigned int poolGeneration = 0;
+static int poolActive = 0;
+static void (*poolJob)(void* data, int index) = NULL;
+static void* poolData = NULL;
+static int poolCount = 0;
+static int poolNext = 0;
+
+static void runPoolJobs(void)
+{
+	for(;;)
+	{
+		pthread_mutex_lock(&poolMutex);
+		int index = poolNext++;
+		pthread_mutex_unlock(&poolMutex);
+		if(index >= poolCount)
+			return;
+		poolJob(poolData, index);
+	}
+}
+
+static void* poolWorker(void*)
+{
+	unsigned int generation = 0;
+	pthread_mutex_lock(&poolMutex);
+	for(;;)
+	{
+		while(poolGeneration == generation)
+			pthread_cond_wait(&poolStart, &poolMutex);
+		generation = poolGeneration;
+		pthread_mutex_unlock(&poolMutex);
+
+		runPoolJobs();
+
+		pthread_mutex_lock(&poolMutex);
+		if(--poolActive == 0)
+			pthread_cond_signal(&poolDone);
+	}
+	return NULL;
+}
+
+int OSGetNumWorkerThreads(void)
+{
+	pthread_mutex_lock(&poolDispatchMutex);
+	if(poolNumThreads < 0)
+	{
+		long numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+		int numThreads = RI_INT_MIN(RI_INT_MAX((int)numProcessors, 1), RI_MAX_WORKER_THREADS) - 1;
+		poolNumThreads = 0;
+		for(int i=0;i<numThreads;i++)
+		{
+			pthread_t thread;
+			if(pthread_create(&thread, NULL, poolWorker, NULL))
+				break;	//run with the threads created so far
+			pthread_detach(thread);
+			poolNumThreads++;
+		}
+	}
+	int numThreads = poolNumThreads + 1;
+	pthread_mutex_unlock(&poolDispatchMutex);
+	return numThreads;
+}
+
+void OSRunParallel(void (*job)(void* data, int index), void* data, int count)
+{
+	if(OSGetNumWorkerThreads() <= 1 || count <= 1)
+	{
+		for(int i=0;i<count;i++)
+			job(data, i);
+		return;
+	}
+
+	pthread_mutex_lock(&poolDispatchMutex);
+	pthread_mutex_lock(&poolMutex);
+	poolJob = job;
+	poolData = data;
+	poolCount = count;
+	poolNext = 0;
+	poolActive = poolNumThreads;
+	poolGeneration++;
+	pthread_cond_broadcast(&poolStart);
+	pthread_mutex_unlock(&poolMutex);
+
+	runPoolJobs();
+
+	pthread_mutex_lock(&poolMutex);
+	while(poolActive > 0)
+		pthread_cond_wait(&poolDone, &poolMutex);
+	pthread_mutex_unlock(&poolMutex);
+	pthread_mutex_unlock(&poolDispatchMutex);
+}
+
+}   //namespace OpenVGRI
+
+#endif /* __RIPTHREADWORKERPOOL_H */
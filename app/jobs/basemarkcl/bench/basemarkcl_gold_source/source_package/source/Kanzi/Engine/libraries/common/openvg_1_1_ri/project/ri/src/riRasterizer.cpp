@@ -37,6 +37,10 @@
 namespace OpenVGRI
 {
 
+//worker pool, implemented in the platform specific riEGLOS.cpp
+int OSGetNumWorkerThreads(void);
+void OSRunParallel(void (*job)(void* data, int index), void* data, int count);
+
 /*-------------------------------------------------------------------*//*!
 * \brief	Rasterizer constructor.
 * \param	
@@ -335,10 +339,6 @@ void Rasterizer::fill()
 	//  determine a run of pixels with constant coverage
 	//  call fill callback for each pixel of the run
 
-	int fillRuleMask = 1;
-	if(m_fillRule == VG_NON_ZERO)
-		fillRuleMask = -1;
-
     int bbminx = (int)floor(m_edgeMin.x);
     int bbminy = (int)floor(m_edgeMin.y);
     int bbmaxx = (int)floor(m_edgeMax.x)+1;
@@ -352,11 +352,168 @@ void Rasterizer::fill()
     if(ex > m_covMaxx) m_covMaxx = ex;
     if(ey > m_covMaxy) m_covMaxy = ey;
 
+	//sort edges by their starting y-coordinate. Edges enter the AET in this order and
+	//leave it once the pixel filters of the current scanline are past their end
+	m_edges.sort();
+
+	int numBands = (ey - sy + RI_RASTER_BAND_HEIGHT - 1) / RI_RASTER_BAND_HEIGHT;
+	int numThreads = OSGetNumWorkerThreads();
+	if(numThreads <= 1 || numBands < RI_MIN_PARALLEL_RASTER_BANDS || (m_pixelPipe && !m_pixelPipe->isThreadSafe()))
+	{	//fill the screen on the calling thread
+		fillRows(sx, ex, sy, ey, NULL, m_edges.size());	//throws bad_alloc
+		return;
+	}
+
+	//split the screen into bands of scanlines and bin the edges to the bands their pixel filters touch.
+	//each scanline is filled exactly as in the serial case, so the result doesn't depend on the number of threads
+	//first pass counts the edges of each band, second pass stores their indices in edge order
+	Array<int> binStart;
+	Array<int> binnedEdges;
+	binStart.resize(numBands+1);	//throws bad_alloc
+	for(int b=0;b<=numBands;b++)
+		binStart[b] = 0;
+	for(int pass=0;pass<2;pass++)
+	{
+		for(int e=0;e<m_edges.size();e++)
+		{
+			const Edge& ed = m_edges[e];
+			//conservative range of scanlines whose pixel filters the edge touches
+			RScalar firstRow = RI_MAX((RScalar)floor(ed.v0.y - m_sampleRadius - 0.5f), (RScalar)sy);
+			RScalar lastRow = RI_MIN((RScalar)ceil(ed.v1.y + m_sampleRadius - 0.5f), (RScalar)(ey - 1));
+			if(lastRow < firstRow)
+				continue;
+			int firstBand = ((int)firstRow - sy) / RI_RASTER_BAND_HEIGHT;
+			int lastBand = ((int)lastRow - sy) / RI_RASTER_BAND_HEIGHT;
+			for(int b=firstBand;b<=lastBand;b++)
+			{
+				if(pass == 0)
+					binStart[b+1]++;
+				else
+					binnedEdges[binStart[b]++] = e;
+			}
+		}
+		if(pass == 0)
+		{
+			for(int b=0;b<numBands;b++)
+				binStart[b+1] += binStart[b];
+			binnedEdges.resize(binStart[numBands]);	//throws bad_alloc
+		}
+	}
+	//second pass advanced each start to the start of the next band
+	for(int b=numBands;b>0;b--)
+		binStart[b] = binStart[b-1];
+	binStart[0] = 0;
+
+	BandJob job;
+	job.rasterizer = this;
+	job.sx = sx;
+	job.ex = ex;
+	job.sy = sy;
+	job.ey = ey;
+	job.binStart = &binStart;
+	job.binnedEdges = &binnedEdges;
+	job.outOfMemory = false;
+	OSRunParallel(fillBand, &job, numBands);
+	if(job.outOfMemory)
+		throw std::bad_alloc();
+}
+
+/*-------------------------------------------------------------------*//*!
+* \brief	Fills one band of scanlines. Called from the worker threads.
+* \param	
+* \return	
+* \note		
+*//*-------------------------------------------------------------------*/
+
+void Rasterizer::fillBand(void* data, int band)
+{
+	BandJob* job = (BandJob*)data;
+	int first = (*job->binStart)[band];
+	int numEdges = (*job->binStart)[band+1] - first;
+	if(!numEdges)
+		return;
+	int sy = job->sy + band * RI_RASTER_BAND_HEIGHT;
+	int ey = RI_INT_MIN(sy + RI_RASTER_BAND_HEIGHT, job->ey);
+	try
+	{
+		job->rasterizer->fillRows(job->sx, job->ex, sy, ey, &(*job->binnedEdges)[first], numEdges);	//throws bad_alloc
+	}
+	catch(std::bad_alloc)
+	{
+		job->outOfMemory = true;
+	}
+}
+
+/*-------------------------------------------------------------------*//*!
+* \brief	Fills scanlines [sy,ey[ between [sx,ex[ using the given edges,
+*			sorted by their starting y-coordinate. NULL edge indices
+*			means all edges.
+* \param	
+* \return	
+* \note		
+*//*-------------------------------------------------------------------*/
+
+void Rasterizer::fillRows(int sx, int ex, int sy, int ey, const int* edgeIndices, int numEdges) const
+{
+	int fillRuleMask = 1;
+	if(m_fillRule == VG_NON_ZERO)
+		fillRuleMask = -1;
+
 	//fill the screen
 	Array<ActiveEdge> aet;
 	Array<ScissorEdge> scissorAet;
+	int nextEdge = 0;
 	for(int j=sy;j<ey;j++)
 	{
+		RScalar cminy = (RScalar)j - m_sampleRadius + 0.5f;
+		RScalar cmaxy = (RScalar)j + m_sampleRadius + 0.5f;
+
+		//incremental AET: add the edges starting before the bottom of the pixel filters of this scanline
+		for(;nextEdge < numEdges;nextEdge++)
+		{
+			const Edge& ed = m_edges[edgeIndices ? edgeIndices[nextEdge] : nextEdge];
+			RI_ASSERT(ed.v0.y <= ed.v1.y);	//horizontal edges should have been dropped already
+			if(ed.v0.y > cmaxy)
+				break;
+			if(cminy >= ed.v1.y)
+				continue;	//edge ends before the first scanline of the fill
+
+			ActiveEdge ae;
+			ae.v0 = ed.v0;
+			ae.v1 = ed.v1;
+			ae.direction = ed.direction;
+			ae.n.set(ae.v0.y - ae.v1.y, ae.v1.x - ae.v0.x);	//edge normal
+			ae.cnst = ae.v0.x * ae.n.x + ae.v0.y * ae.n.y;	//distance of v0 from the origin along the edge normal
+			ae.dx = ae.v1.x - ae.v0.x;
+			ae.invdy = 1.0f / (ae.v1.y - ae.v0.y);
+			ae.bminx = RI_MIN(ae.v0.x, ae.v1.x);
+			ae.bmaxx = RI_MAX(ae.v0.x, ae.v1.x);
+			aet.push_back(ae);	//throws bad_alloc
+		}
+
+		//remove the edges ending above the pixel filters of this scanline, and step
+		//the min and max x-coordinates of the remaining edges to this scanline
+		int numActive = 0;
+		for(int e=0;e<aet.size();e++)
+		{
+			ActiveEdge& ae = aet[e];
+			if(cminy >= ae.v1.y)
+				continue;
+
+			RScalar sx = ae.v0.x + ae.dx * (cminy - ae.v0.y) * ae.invdy;
+			RScalar ex = ae.v0.x + ae.dx * (cmaxy - ae.v0.y) * ae.invdy;
+			sx = RI_CLAMP(sx, ae.bminx, ae.bmaxx);
+			ex = RI_CLAMP(ex, ae.bminx, ae.bmaxx);
+			ae.minx = RI_MIN(sx,ex);
+			ae.maxx = RI_MAX(sx,ex);
+			if(numActive != e)
+				aet[numActive] = ae;
+			numActive++;
+		}
+		aet.resize(numActive);
+		if(!aet.size())
+			continue;	//no edges on the whole scanline, skip it
+
 		//gather scissor edges intersecting this scanline
 		scissorAet.clear();
 		if( m_scissor )
@@ -371,44 +528,18 @@ void Rasterizer::fill()
 				continue;	//scissoring is on, but there are no scissor rectangles on this scanline
 		}
 
-		//simple AET: scan through all the edges and pick the ones intersecting this scanline
-		aet.clear();
-		for(int e=0;e<m_edges.size();e++)
+		//sort AET by edge minx. The order of the previous scanline is mostly preserved,
+		//so insertion sort runs in close to linear time
+		for(int e=1;e<aet.size();e++)
 		{
-			RScalar cminy = (RScalar)j - m_sampleRadius + 0.5f;
-			RScalar cmaxy = (RScalar)j + m_sampleRadius + 0.5f;
-			const Edge& ed = m_edges[e];
-			RI_ASSERT(ed.v0.y <= ed.v1.y);	//horizontal edges should have been dropped already
-
-			ActiveEdge ae;
-			ae.v0 = ed.v0;
-			ae.v1 = ed.v1;
-			ae.direction = ed.direction;
-
-			if(cmaxy >= ae.v0.y && cminy < ae.v1.y)
-			{
-				ae.n.set(ae.v0.y - ae.v1.y, ae.v1.x - ae.v0.x);	//edge normal
-				ae.cnst = ae.v0.x * ae.n.x + ae.v0.y * ae.n.y;	//distance of v0 from the origin along the edge normal
-				
-				//compute edge min and max x-coordinates for this scanline
-				Vector2 vd(ae.v1.x - ae.v0.x, ae.v1.y - ae.v0.y);
-				RScalar wl = 1.0f / vd.y;
-				RScalar sx = ae.v0.x + vd.x * (cminy - ae.v0.y) * wl;
-				RScalar ex = ae.v0.x + vd.x * (cmaxy - ae.v0.y) * wl;
-				RScalar bminx = RI_MIN(ae.v0.x, ae.v1.x);
-				RScalar bmaxx = RI_MAX(ae.v0.x, ae.v1.x);
-				sx = RI_CLAMP(sx, bminx, bmaxx);
-				ex = RI_CLAMP(ex, bminx, bmaxx);
-				ae.minx = RI_MIN(sx,ex);
-				ae.maxx = RI_MAX(sx,ex);
-				aet.push_back(ae);	//throws bad_alloc
-			}
+			if(!(aet[e] < aet[e-1]))
+				continue;
+			ActiveEdge ae = aet[e];
+			int k = e;
+			for(;k > 0 && ae < aet[k-1];k--)
+				aet[k] = aet[k-1];
+			aet[k] = ae;
 		}
-		if(!aet.size())
-			continue;	//no edges on the whole scanline, skip it
-
-		//sort AET by edge minx
-		aet.sort();
 		
 		//sort scissor AET by edge x
 		scissorAet.sort();
@@ -470,23 +601,32 @@ void Rasterizer::fill()
 			coverage /= m_sumWeights;
 			RI_ASSERT(coverage >= 0.0f && coverage <= 1.0f);
 
-			//fill a run of pixels with constant coverage
+			//fill a run of pixels with constant coverage. The run is split only where the scissor winding changes
 			if(sampleMask)
 			{
-				for(;i<endSpan;i++)
+				while(i<endSpan)
 				{
 					//update scissor winding number
 					while(scissorIndex < scissorAet.size() && scissorAet[scissorIndex].x <= i)
 						scissorWinding += scissorAet[scissorIndex++].direction;
 					RI_ASSERT(scissorWinding >= 0);
 
+					int endRun = endSpan;	//scissor winding is constant until the next scissor edge
+					if(scissorIndex < scissorAet.size())
+						endRun = RI_INT_MIN(endRun, scissorAet[scissorIndex].x);
+					RI_ASSERT(endRun > i);
+
 					if(scissorWinding)
                     {
                         if(m_covBuffer)
-                            m_covBuffer[j*m_vpwidth+i] |= (RIuint32)sampleMask;
+                        {
+                            for(int k=i;k<endRun;k++)
+                                m_covBuffer[j*m_vpwidth+k] |= (RIuint32)sampleMask;
+                        }
                         else
-                            m_pixelPipe->pixelPipe(i, j, coverage, sampleMask);
+                            m_pixelPipe->pixelPipeSpan(i, j, endRun - i, coverage, sampleMask);
                     }
+					i = endRun;
 				}
 			}
 			i = endSpan;
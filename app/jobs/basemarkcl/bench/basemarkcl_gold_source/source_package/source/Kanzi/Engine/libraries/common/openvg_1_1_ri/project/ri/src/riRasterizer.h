@@ -118,7 +118,7 @@ private:
 
 	struct ActiveEdge
 	{
-		ActiveEdge() : v0(), v1(), direction(0), minx(0.0f), maxx(0.0f), n(), cnst(0.0f) {}
+		ActiveEdge() : v0(), v1(), direction(0), minx(0.0f), maxx(0.0f), n(), cnst(0.0f), dx(0.0f), invdy(0.0f), bminx(0.0f), bmaxx(0.0f) {}
 		bool operator<(const ActiveEdge& e) const	{ return minx < e.minx; }
 		RVector2	v0;
 		RVector2	v1;
@@ -127,6 +127,10 @@ private:
 		RScalar		maxx;			//for the current scanline
 		RVector2	n;
 		RScalar		cnst;
+		RScalar		dx;				//x extent of the edge
+		RScalar		invdy;			//reciprocal of the y extent of the edge
+		RScalar		bminx;			//bounding box of the edge in x
+		RScalar		bmaxx;
 	};
 
 	struct Sample
@@ -137,7 +141,21 @@ private:
 		RScalar		weight;
 	};
 
+	struct BandJob
+	{
+		const Rasterizer*			rasterizer;
+		int							sx;
+		int							ex;
+		int							sy;
+		int							ey;
+		const Array<int>*			binStart;		//first index in binnedEdges of each band, numBands+1 items
+		const Array<int>*			binnedEdges;	//edge indices of the bands in edge order
+		volatile bool				outOfMemory;
+	};
+
     void                addBBox(const Vector2& v);
+	static void			fillBand(void* data, int band);
+	void				fillRows(int sx, int ex, int sy, int ey, const int* edgeIndices, int numEdges) const;	//throws bad_alloc
 
 	Array<Edge>				m_edges;
 	Array<ScissorEdge>		m_scissorEdges;
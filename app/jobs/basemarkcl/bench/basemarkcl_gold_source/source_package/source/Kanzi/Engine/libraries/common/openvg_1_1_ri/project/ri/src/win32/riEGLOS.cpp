@@ -88,6 +88,98 @@ void OSReleaseMutex(void)
 	RI_UNREF(ret);
 }
 
+/*-------------------------------------------------------------------*//*!
+* \brief	Fixed pool of worker threads for parallel rasterization.
+* \param	
+* \return	
+* \note		The pool is created on first use with one thread per processor,
+*			the calling thread included. Jobs are handed out in index order
+*			and OSRunParallel returns once all of them have finished.
+*//*-------------------------------------------------------------------*/
+
+static CRITICAL_SECTION poolDispatchLock;	//one parallel run at a time
+static HANDLE poolStart = NULL;		//semaphore released once per worker thread for each run
+static HANDLE poolDone = NULL;		//signaled by the last worker thread finishing a run
+static int poolNumThreads = -1;		//threads in addition to the calling thread, -1 before creation
+static void (*poolJob)(void* data, int index) = NULL;
+static void* poolData = NULL;
+static LONG poolCount = 0;
+static volatile LONG poolNext = 0;
+static volatile LONG poolActive = 0;
+
+static void runPoolJobs(void)
+{
+	for(;;)
+	{
+		LONG index = InterlockedIncrement(&poolNext) - 1;
+		if(index >= poolCount)
+			return;
+		poolJob(poolData, (int)index);
+	}
+}
+
+static DWORD WINAPI poolWorker(LPVOID)
+{
+	for(;;)
+	{
+		WaitForSingleObject(poolStart, INFINITE);
+		runPoolJobs();
+		if(InterlockedDecrement(&poolActive) == 0)
+			SetEvent(poolDone);
+	}
+	return 0;
+}
+
+int OSGetNumWorkerThreads(void)
+{
+	//the pool is created while holding the API mutex, so creation needs no lock of its own
+	if(poolNumThreads < 0)
+	{
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		int numThreads = RI_INT_MIN(RI_INT_MAX((int)info.dwNumberOfProcessors, 1), RI_MAX_WORKER_THREADS) - 1;
+		InitializeCriticalSection(&poolDispatchLock);
+		poolStart = CreateSemaphore(NULL, 0, RI_MAX_WORKER_THREADS, NULL);
+		poolDone = CreateEvent(NULL, FALSE, FALSE, NULL);	//auto-reset
+		poolNumThreads = 0;
+		if(poolStart && poolDone)
+		{
+			for(int i=0;i<numThreads;i++)
+			{
+				HANDLE thread = CreateThread(NULL, 0, poolWorker, NULL, 0, NULL);
+				if(!thread)
+					break;	//run with the threads created so far
+				CloseHandle(thread);
+				poolNumThreads++;
+			}
+		}
+	}
+	return poolNumThreads + 1;
+}
+
+void OSRunParallel(void (*job)(void* data, int index), void* data, int count)
+{
+	if(OSGetNumWorkerThreads() <= 1 || count <= 1)
+	{
+		for(int i=0;i<count;i++)
+			job(data, i);
+		return;
+	}
+
+	EnterCriticalSection(&poolDispatchLock);
+	poolJob = job;
+	poolData = data;
+	poolCount = count;
+	poolNext = 0;
+	poolActive = poolNumThreads;
+	ReleaseSemaphore(poolStart, poolNumThreads, NULL);
+
+	runPoolJobs();
+
+	WaitForSingleObject(poolDone, INFINITE);
+	LeaveCriticalSection(&poolDispatchLock);
+}
+
 static bool isBigEndian()
 {
 	static const RIuint32 v = 0x12345678u;
@@ -15,14 +15,14 @@
 #include <core/util/collection/kzc_balanced_tree.h>
 #include <core/util/string/kzc_string.h>
 #include <core/util/string/kzc_string_buffer.h>
+#include <core/debug/kzc_log.h>
 #include <core/kzc_error_codes.h>
 
 #include <system/wrappers/kzs_math.h>
 #include <system/debug/kzs_log.h>
 #include <system/kzs_error_codes.h>
 #include <system/kzs_system.h>
-
-/* TODO: Track and report memory fragmentation index */
+#include <system/thread/kzs_thread.h>
 
 /** If defined, this flag enables internal debug prints. */
 #define KZC_MEMORY_POOL_DEBUG_INTERNAL 0
@@ -57,6 +57,35 @@ struct KzcMemoryPoolBlock
 #endif
 };
 
+/**
+ * Slab of equally sized small allocations.
+ * A slab is allocated as a single block from the availability tree and divided into objects of its size class.
+ * Unlike tree allocations, the objects have no block header of their own.
+ */
+struct KzcMemoryPoolSlab
+{
+    struct KzcMemoryPoolSlab* previousSlab; /**< Previous slab in the list of slabs with free objects. */
+    struct KzcMemoryPoolSlab* nextSlab; /**< Next slab in the list of slabs with free objects. */
+    struct KzcMemoryPoolSizeClass* sizeClass; /**< Size class of the objects in this slab. */
+    void* freeObject; /**< First free object, KZ_NULL if the slab is full. Each free object stores pointer to the next one. */
+    kzByte* objects; /**< Start of the object data. */
+    kzByte* objectsEnd; /**< End of the object data. */
+    kzUint usedObjectCount; /**< Number of allocated objects in this slab. */
+};
+
+/** Segregated free lists for small allocations of one size. */
+struct KzcMemoryPoolSizeClass
+{
+    kzUint objectSize; /**< Size of the objects in bytes. */
+    kzUint objectsPerSlab; /**< Number of objects in one slab. */
+    struct KzcMemoryPoolSlab* availableSlabs; /**< Slabs with at least one free object. Full slabs are not linked anywhere. */
+    struct KzcMemoryPoolSlab* emptySlab; /**< One completely free slab kept in reserve, so that alternating allocations do not return slabs to the tree. */
+    kzUint slabCount; /**< Number of slabs, including the empty one. */
+    kzUint allocationCount; /**< Current number of allocated objects. */
+    kzUint peakAllocationCount; /**< Peak number of allocated objects. */
+    kzUint cumulativeAllocationCount; /**< Cumulative number of allocated objects. */
+};
+
 struct KzcMemoryPool
 {
     kzUint poolIndex; /**< Index of this pool in the containing memory manager. */
@@ -67,12 +96,26 @@ struct KzcMemoryPool
     kzUint treeNodeCount; /**< Number of tree nodes in use. */
     kzUint reservedTreeNodeCount; /**< Number of reserved tree nodes. */
     kzUint minimumEmptySize; /**< Minimum size of a continuous available memory block. Blocks smaller than this will be merged to the previous block. */
+    struct KzcMemoryPoolSizeClass sizeClasses[KZC_MEMORY_POOL_SIZE_CLASS_COUNT]; /**< Size classes for small allocations. */
+    struct KzcMemoryPoolSlab** slabTable; /**< Slab starting in each SLAB_SIZE page of the pool data, or KZ_NULL. The table is KZ_NULL if the pool does not use slabs. */
+    kzUint slabTableLength; /**< Number of entries in the slab table. */
+    struct KzsThreadLock* slabTableLock; /**< Lock for changing the slab table, so that it can be read without the lock of the memory manager. KZ_NULL if the pool does not use slabs. */
 };
 
 
 static const kzUint NODE_SIZE = sizeof(struct KzcBalancedTreeNode); /**< Size of a single availability tree node. */
 static const kzUint MINIMUM_EXTRA_NODE_COUNT = 10; /**< At least this many additional availability tree nodes must always fit in the pool. */
 static const kzUint INITIAL_NODE_COUNT = 16; /**< Initial number of reserved availability tree nodes. Must be greater than MINIMUM_EXTRA_NODE_COUNT. */
+static const kzUint SLAB_SIZE = 4096; /**< Size of a slab in bytes. This is also the page size of the slab table. */
+static const kzUint SLAB_MINIMUM_POOL_SLAB_COUNT = 16; /**< Pools smaller than this many slabs allocate everything from the availability tree. */
+static const kzUint SLAB_SIZE_CLASS_GRANULARITY = 8; /**< Granularity of the size class lookup table. */
+static const kzUint SLAB_OBJECT_SIZES[KZC_MEMORY_POOL_SIZE_CLASS_COUNT] = { 16, 24, 32, 48, 64, 96, 128 }; /**< Object sizes of the size classes. */
+/** Size class index for each SLAB_SIZE_CLASS_GRANULARITY bytes of allocation size up to KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE. Indexed by (size - 1) / SLAB_SIZE_CLASS_GRANULARITY. */
+static const kzUint SLAB_SIZE_CLASS_INDICES[] = { 0, 0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6 };
+
+
+static kzsError kzcMemoryPoolFreeBlock_internal(struct KzcMemoryPool* pool, void* pointer);
+static kzsError kzcMemoryPoolReleaseSlab_internal(struct KzcMemoryPool* pool, struct KzcMemoryPoolSlab* slab);
 
 
 /**
@@ -386,6 +429,7 @@ kzsError kzcMemoryManagerCreatePool(const struct KzcMemoryManager* parentManager
     struct KzcMemoryPoolBlock* initialBlock;
     struct KzcBalancedTreeNode* initialNode;
     struct KzcByteWriteBuffer poolBuffer;
+    kzUint i;
 
     /* Requirements */
     kzsAssert(INITIAL_NODE_COUNT > MINIMUM_EXTRA_NODE_COUNT);
@@ -431,6 +475,42 @@ kzsError kzcMemoryManagerCreatePool(const struct KzcMemoryManager* parentManager
     pool->reservedTreeNodeCount = INITIAL_NODE_COUNT;
     pool->minimumEmptySize = minimumEmptySize + sizeof(struct KzcMemoryPoolBlock);
 
+    /* Initialize the size classes for small allocations. */
+    for (i = 0; i < KZC_MEMORY_POOL_SIZE_CLASS_COUNT; ++i)
+    {
+        struct KzcMemoryPoolSizeClass* sizeClass = &pool->sizeClasses[i];
+        sizeClass->objectSize = SLAB_OBJECT_SIZES[i];
+        sizeClass->objectsPerSlab = (SLAB_SIZE - sizeof(struct KzcMemoryPoolSlab)) / SLAB_OBJECT_SIZES[i];
+        sizeClass->availableSlabs = KZ_NULL;
+        sizeClass->emptySlab = KZ_NULL;
+        sizeClass->slabCount = 0;
+        sizeClass->allocationCount = 0;
+        sizeClass->peakAllocationCount = 0;
+        sizeClass->cumulativeAllocationCount = 0;
+    }
+
+    /* Slab table has an entry for each SLAB_SIZE page of the data. Debug builds leave it out so that small allocations
+       come from the availability tree and keep their descriptions for the leak dumps. */
+    pool->slabTable = KZ_NULL;
+    pool->slabTableLength = 0;
+    pool->slabTableLock = KZ_NULL;
+#ifndef KZC_MEMORY_DEBUG
+    if (dataSize >= SLAB_SIZE * SLAB_MINIMUM_POOL_SLAB_COUNT)
+    {
+        pool->slabTableLength = dataSize / SLAB_SIZE + 1;
+        result = kzcMemoryAllocArray(parentManager, pool->slabTable, pool->slabTableLength, "Memory pool slab table");
+        kzsErrorForward(result);
+
+        result = kzsThreadLockCreate(&pool->slabTableLock);
+        kzsErrorForward(result);
+
+        for (i = 0; i < pool->slabTableLength; ++i)
+        {
+            pool->slabTable[i] = KZ_NULL;
+        }
+    }
+#endif
+
 
     /* Allocate initial node for the availability tree pointing to the initial empty block. */
     result = kzcMemoryPoolAllocateTreeNode_internal(pool, initialBlock, &initialNode);
@@ -455,6 +535,19 @@ kzsError kzcMemoryManagerDeletePool(struct KzcMemoryPool* pool)
 {
     kzsError result;
     struct KzcBalancedTreeNode* removeNode;
+    kzUint i;
+
+    /* Return the reserved empty slabs to the tree so that only slabs with allocated objects remain. */
+    for (i = 0; i < KZC_MEMORY_POOL_SIZE_CLASS_COUNT; ++i)
+    {
+        struct KzcMemoryPoolSizeClass* sizeClass = &pool->sizeClasses[i];
+        if (sizeClass->emptySlab != KZ_NULL)
+        {
+            result = kzcMemoryPoolReleaseSlab_internal(pool, sizeClass->emptySlab);
+            kzsErrorForward(result);
+            sizeClass->emptySlab = KZ_NULL;
+        }
+    }
 
     kzsAssert(pool->lastBlock->treeNode != KZ_NULL);
 
@@ -498,13 +591,23 @@ kzsError kzcMemoryManagerDeletePool(struct KzcMemoryPool* pool)
     result = kzcBalancedTreeDeleteManaged(pool->availabilityTree);
     kzsErrorForward(result);
 
+    if (pool->slabTable != KZ_NULL)
+    {
+        result = kzsThreadLockDelete(pool->slabTableLock);
+        kzsErrorForward(result);
+
+        result = kzcMemoryFreeArray(pool->slabTable);
+        kzsErrorForward(result);
+    }
+
     result = kzcMemoryFreePointer(pool);
     kzsErrorForward(result);
 
     kzsSuccess();
 }
 
-kzsError kzcMemoryPoolAlloc(struct KzcMemoryPool* pool, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
+/** Allocates given amount of memory from the availability tree. */
+static kzsError kzcMemoryPoolAllocBlock_internal(struct KzcMemoryPool* pool, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
 {
     kzsError result;
     void* pointer;
@@ -718,7 +821,8 @@ static void kzcMemoryPoolMergeThree_internal(struct KzcMemoryPool* pool, struct
 #endif
 }
 
-kzsError kzcMemoryPoolFree(struct KzcMemoryPool* pool, void* pointer)
+/** Frees memory allocated from the availability tree. */
+static kzsError kzcMemoryPoolFreeBlock_internal(struct KzcMemoryPool* pool, void* pointer)
 {
     kzsError result;
     struct KzcMemoryPoolBlock* block;
@@ -823,6 +927,318 @@ kzsError kzcMemoryPoolFree(struct KzcMemoryPool* pool, void* pointer)
     kzsSuccess();
 }
 
+/** Adds a slab to the front of the list of slabs with free objects. */
+static void kzcMemoryPoolLinkSlab_internal(struct KzcMemoryPoolSizeClass* sizeClass, struct KzcMemoryPoolSlab* slab)
+{
+    slab->previousSlab = KZ_NULL;
+    slab->nextSlab = sizeClass->availableSlabs;
+    if (sizeClass->availableSlabs != KZ_NULL)
+    {
+        sizeClass->availableSlabs->previousSlab = slab;
+    }
+    sizeClass->availableSlabs = slab;
+}
+
+/** Removes a slab from the list of slabs with free objects. */
+static void kzcMemoryPoolUnlinkSlab_internal(struct KzcMemoryPoolSizeClass* sizeClass, struct KzcMemoryPoolSlab* slab)
+{
+    if (slab->previousSlab != KZ_NULL)
+    {
+        slab->previousSlab->nextSlab = slab->nextSlab;
+    }
+    else
+    {
+        kzsAssert(sizeClass->availableSlabs == slab);
+        sizeClass->availableSlabs = slab->nextSlab;
+    }
+    if (slab->nextSlab != KZ_NULL)
+    {
+        slab->nextSlab->previousSlab = slab->previousSlab;
+    }
+    slab->previousSlab = KZ_NULL;
+    slab->nextSlab = KZ_NULL;
+}
+
+/** Gets the index of the slab table page containing the given pointer. */
+static kzUint kzcMemoryPoolGetSlabPage_internal(const struct KzcMemoryPool* pool, const void* pointer)
+{
+    kzUint page = (kzUint)((const kzByte*)pointer - pool->data) / SLAB_SIZE;
+    kzsAssert(page < pool->slabTableLength);
+    return page;
+}
+
+/** Allocates a new slab for the given size class from the availability tree. */
+static kzsError kzcMemoryPoolCreateSlab_internal(struct KzcMemoryPool* pool, struct KzcMemoryPoolSizeClass* sizeClass, struct KzcMemoryPoolSlab** out_slab)
+{
+    kzsError result;
+    void* pointer;
+    struct KzcMemoryPoolSlab* slab;
+    kzByte* object;
+    kzUint page;
+    kzUint i;
+
+    result = kzcMemoryPoolAllocBlock_internal(pool, SLAB_SIZE, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE("Memory pool slab"));
+    kzsErrorForward(result);
+
+    slab = (struct KzcMemoryPoolSlab*)pointer;
+    slab->previousSlab = KZ_NULL;
+    slab->nextSlab = KZ_NULL;
+    slab->sizeClass = sizeClass;
+    slab->objects = (kzByte*)slab + sizeof(*slab);
+    slab->objectsEnd = slab->objects + sizeClass->objectsPerSlab * sizeClass->objectSize;
+    slab->usedObjectCount = 0;
+
+    /* Chain the objects to the free list in address order. */
+    slab->freeObject = KZ_NULL;
+    object = slab->objectsEnd;
+    for (i = 0; i < sizeClass->objectsPerSlab; ++i)
+    {
+        object -= sizeClass->objectSize;
+        *(void**)(void*)object = slab->freeObject;
+        slab->freeObject = object;
+    }
+
+    /* Slab blocks are larger than a page, so no other slab can start in the same page. */
+    page = kzcMemoryPoolGetSlabPage_internal(pool, slab);
+    kzsAssert(pool->slabTable[page] == KZ_NULL);
+
+    result = kzsThreadLockAcquire(pool->slabTableLock);
+    kzsErrorForward(result);
+
+    pool->slabTable[page] = slab;
+
+    result = kzsThreadLockRelease(pool->slabTableLock);
+    kzsErrorForward(result);
+
+    ++sizeClass->slabCount;
+
+    *out_slab = slab;
+    kzsSuccess();
+}
+
+/** Returns the memory of an empty slab to the availability tree. */
+static kzsError kzcMemoryPoolReleaseSlab_internal(struct KzcMemoryPool* pool, struct KzcMemoryPoolSlab* slab)
+{
+    kzsError result;
+    kzUint page = kzcMemoryPoolGetSlabPage_internal(pool, slab);
+
+    kzsAssert(slab->usedObjectCount == 0);
+    kzsAssert(pool->slabTable[page] == slab);
+
+    /* The entry is cleared before the slab memory is reused, so readers holding the slab table lock never see a released slab. */
+    result = kzsThreadLockAcquire(pool->slabTableLock);
+    kzsErrorForward(result);
+
+    pool->slabTable[page] = KZ_NULL;
+
+    result = kzsThreadLockRelease(pool->slabTableLock);
+    kzsErrorForward(result);
+
+    --slab->sizeClass->slabCount;
+
+    result = kzcMemoryPoolFreeBlock_internal(pool, slab);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+/** Returns the slab containing the given pointer, or KZ_NULL if the pointer was allocated from the availability tree. */
+static struct KzcMemoryPoolSlab* kzcMemoryPoolFindSlab_internal(const struct KzcMemoryPool* pool, const void* pointer)
+{
+    struct KzcMemoryPoolSlab* foundSlab = KZ_NULL;
+
+    if (pool->slabTable != KZ_NULL)
+    {
+        /* Slabs are larger than a page, so a slab containing the pointer starts either in the same page or in the previous one. */
+        kzUint page = kzcMemoryPoolGetSlabPage_internal(pool, pointer);
+        struct KzcMemoryPoolSlab* slab = pool->slabTable[page];
+
+        if (slab == KZ_NULL || (const kzByte*)pointer < slab->objects)
+        {
+            slab = (page > 0) ? pool->slabTable[page - 1] : KZ_NULL;
+        }
+
+        if (slab != KZ_NULL && (const kzByte*)pointer >= slab->objects && (const kzByte*)pointer < slab->objectsEnd)
+        {
+            foundSlab = slab;
+        }
+    }
+
+    return foundSlab;
+}
+
+/**
+ * Allocates an object of the given size class from a slab.
+ * Sets the pointer to KZ_NULL if there is no free object and a new slab does not fit in the pool.
+ */
+static kzsError kzcMemoryPoolSlabAlloc_internal(struct KzcMemoryPool* pool, struct KzcMemoryPoolSizeClass* sizeClass, void** out_pointer)
+{
+    kzsError result;
+    struct KzcMemoryPoolSlab* slab = sizeClass->availableSlabs;
+    void* pointer = KZ_NULL;
+
+    if (slab == KZ_NULL)
+    {
+        if (sizeClass->emptySlab != KZ_NULL)
+        {
+            slab = sizeClass->emptySlab;
+            sizeClass->emptySlab = KZ_NULL;
+        }
+        else if (kzcMemoryPoolGetMaximumAvailableSize(pool) >= SLAB_SIZE)
+        {
+            result = kzcMemoryPoolCreateSlab_internal(pool, sizeClass, &slab);
+            kzsErrorForward(result);
+        }
+
+        if (slab != KZ_NULL)
+        {
+            kzcMemoryPoolLinkSlab_internal(sizeClass, slab);
+        }
+    }
+
+    if (slab != KZ_NULL)
+    {
+        kzsAssert(slab->freeObject != KZ_NULL);
+
+        pointer = slab->freeObject;
+        slab->freeObject = *(void**)pointer;
+        ++slab->usedObjectCount;
+
+        /* Full slabs are not needed until one of their objects is freed. */
+        if (slab->freeObject == KZ_NULL)
+        {
+            kzcMemoryPoolUnlinkSlab_internal(sizeClass, slab);
+        }
+
+        ++sizeClass->allocationCount;
+        sizeClass->peakAllocationCount = kzsMaxU(sizeClass->peakAllocationCount, sizeClass->allocationCount);
+        ++sizeClass->cumulativeAllocationCount;
+    }
+
+    *out_pointer = pointer;
+    kzsSuccess();
+}
+
+/** Frees an object allocated from the given slab. */
+static kzsError kzcMemoryPoolSlabFree_internal(struct KzcMemoryPool* pool, struct KzcMemoryPoolSlab* slab, void* pointer)
+{
+    kzsError result;
+    struct KzcMemoryPoolSizeClass* sizeClass = slab->sizeClass;
+
+    kzsAssert((kzUint)((kzByte*)pointer - slab->objects) % sizeClass->objectSize == 0);
+    kzsErrorTest(slab->usedObjectCount > 0, KZC_ERROR_MEMORY_ALLOCATION_MISMATCH, "Given pointer was already freed.");
+
+    /* A full slab becomes available again. */
+    if (slab->freeObject == KZ_NULL)
+    {
+        kzcMemoryPoolLinkSlab_internal(sizeClass, slab);
+    }
+
+    *(void**)pointer = slab->freeObject;
+    slab->freeObject = pointer;
+    --slab->usedObjectCount;
+    --sizeClass->allocationCount;
+
+    /* Keep one empty slab in reserve and return the others to the tree. */
+    if (slab->usedObjectCount == 0)
+    {
+        kzcMemoryPoolUnlinkSlab_internal(sizeClass, slab);
+
+        if (sizeClass->emptySlab == KZ_NULL)
+        {
+            sizeClass->emptySlab = slab;
+        }
+        else
+        {
+            result = kzcMemoryPoolReleaseSlab_internal(pool, slab);
+            kzsErrorForward(result);
+        }
+    }
+
+    kzsSuccess();
+}
+
+kzUint kzcMemoryPoolGetSizeClass(kzUint size)
+{
+    kzsAssert(size > 0 && size <= KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE);
+    return SLAB_SIZE_CLASS_INDICES[(size - 1) / SLAB_SIZE_CLASS_GRANULARITY];
+}
+
+kzUint kzcMemoryPoolGetSizeClassObjectSize(kzUint sizeClass)
+{
+    kzsAssert(sizeClass < KZC_MEMORY_POOL_SIZE_CLASS_COUNT);
+    return SLAB_OBJECT_SIZES[sizeClass];
+}
+
+kzsError kzcMemoryPoolGetObjectSizeClass(const struct KzcMemoryPool* pool, const void* pointer, kzBool* out_isSlabObject, kzUint* out_sizeClass)
+{
+    kzsError result;
+    struct KzcMemoryPoolSlab* slab = KZ_NULL;
+
+    if (pool->slabTable != KZ_NULL)
+    {
+        result = kzsThreadLockAcquire(pool->slabTableLock);
+        kzsErrorForward(result);
+
+        slab = kzcMemoryPoolFindSlab_internal(pool, pointer);
+        if (slab != KZ_NULL)
+        {
+            *out_sizeClass = (kzUint)(slab->sizeClass - pool->sizeClasses);
+        }
+
+        result = kzsThreadLockRelease(pool->slabTableLock);
+        kzsErrorForward(result);
+    }
+
+    *out_isSlabObject = (slab != KZ_NULL);
+    kzsSuccess();
+}
+
+kzsError kzcMemoryPoolAlloc(struct KzcMemoryPool* pool, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
+{
+    kzsError result;
+    void* pointer = KZ_NULL;
+
+    /* Small allocations are served from the slabs of their size class. */
+    if (pool->slabTable != KZ_NULL && size > 0 && size <= KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE)
+    {
+        struct KzcMemoryPoolSizeClass* sizeClass = &pool->sizeClasses[kzcMemoryPoolGetSizeClass(size)];
+        kzsAssert(sizeClass->objectSize >= size);
+
+        result = kzcMemoryPoolSlabAlloc_internal(pool, sizeClass, &pointer);
+        kzsErrorForward(result);
+    }
+
+    /* Large allocations, and small ones when a new slab does not fit, go to the availability tree. */
+    if (pointer == KZ_NULL)
+    {
+        result = kzcMemoryPoolAllocBlock_internal(pool, size, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(description));
+        kzsErrorForward(result);
+    }
+
+    *out_pointer = pointer;
+    kzsSuccess();
+}
+
+kzsError kzcMemoryPoolFree(struct KzcMemoryPool* pool, void* pointer)
+{
+    kzsError result;
+    struct KzcMemoryPoolSlab* slab = kzcMemoryPoolFindSlab_internal(pool, pointer);
+
+    if (slab != KZ_NULL)
+    {
+        result = kzcMemoryPoolSlabFree_internal(pool, slab, pointer);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = kzcMemoryPoolFreeBlock_internal(pool, pointer);
+        kzsErrorForward(result);
+    }
+
+    kzsSuccess();
+}
+
 kzUint kzcMemoryPoolGetMaximumAvailableSize(const struct KzcMemoryPool* pool)
 {
     struct KzcMemoryPoolBlock* block;
@@ -842,6 +1258,30 @@ kzUint kzcMemoryPoolGetMaximumAvailableSize(const struct KzcMemoryPool* pool)
     return result - sizeof(*block);
 }
 
+kzFloat kzcMemoryPoolGetFragmentationIndex(const struct KzcMemoryPool* pool)
+{
+    const struct KzcMemoryPoolBlock* block;
+    kzUint totalAvailableSize = 0;
+    kzUint largestAvailableSize = 0;
+    kzFloat fragmentationIndex = 0.0f;
+
+    for (block = pool->lastBlock; block != KZ_NULL; block = block->previousBlock)
+    {
+        if (block->treeNode != KZ_NULL)
+        {
+            totalAvailableSize += block->size;
+            largestAvailableSize = kzsMaxU(largestAvailableSize, block->size);
+        }
+    }
+
+    if (totalAvailableSize > 0)
+    {
+        fragmentationIndex = 1.0f - (kzFloat)largestAvailableSize / (kzFloat)totalAvailableSize;
+    }
+
+    return fragmentationIndex;
+}
+
 kzBool kzcMemoryPoolIsPointerInRange(const struct KzcMemoryPool* pool, const void* pointer)
 {
     return ((kzByte*)pointer >= pool->data) &&
@@ -1068,4 +1508,23 @@ void kzcMemoryPoolDump(const struct KzcMemoryPool* pool)
         result = kzcStringBufferDelete(stringBuffer);
         KZ_UNUSED_RETURN_VALUE(result); /* Ignore all errors as this is a debugging function. */
     }
+
+    { /* Fragmentation and size classes */
+        kzUint i;
+
+        result = kzcLog(kzcMemoryGetManager(pool), KZS_LOG_LEVEL_INFO, "Fragmentation index: %.3f", kzcMemoryPoolGetFragmentationIndex(pool));
+        KZ_UNUSED_RETURN_VALUE(result); /* Ignore all errors as this is a debugging function. */
+
+        for (i = 0; i < KZC_MEMORY_POOL_SIZE_CLASS_COUNT; ++i)
+        {
+            const struct KzcMemoryPoolSizeClass* sizeClass = &pool->sizeClasses[i];
+            if (sizeClass->cumulativeAllocationCount > 0)
+            {
+                result = kzcLog(kzcMemoryGetManager(pool), KZS_LOG_LEVEL_INFO, "Size class %u bytes: %u slabs, %u/%u objects allocated (peak %u, cumulative %u)",
+                                sizeClass->objectSize, sizeClass->slabCount, sizeClass->allocationCount, sizeClass->slabCount * sizeClass->objectsPerSlab,
+                                sizeClass->peakAllocationCount, sizeClass->cumulativeAllocationCount);
+                KZ_UNUSED_RETURN_VALUE(result); /* Ignore all errors as this is a debugging function. */
+            }
+        }
+    }
 }
@@ -14,6 +14,12 @@
 #include <system/debug/kzs_error.h>
 
 
+/** Number of size classes for small allocations. */
+#define KZC_MEMORY_POOL_SIZE_CLASS_COUNT 7
+/** Largest allocation served from the slabs of a size class. */
+#define KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE 128
+
+
 /* Forward declarations */
 struct KzcMemoryManager;
 
@@ -31,14 +37,35 @@ kzsError kzcMemoryManagerCreatePool(const struct KzcMemoryManager* parentManager
 /** Deletes a memory pool. */
 kzsError kzcMemoryManagerDeletePool(struct KzcMemoryPool* pool);
 
-/** Allocates given amount of memory from the pool. */
+/**
+ * Allocates given amount of memory from the pool.
+ * Allocations up to KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE bytes are served from slabs of fixed size objects, larger ones from the availability tree.
+ * KZC_MEMORY_DEBUG builds serve all allocations from the availability tree so that each one keeps its description.
+ */
 kzsError kzcMemoryPoolAlloc(struct KzcMemoryPool* pool, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description));
 /** Frees the memory of the given pointer. */
 kzsError kzcMemoryPoolFree(struct KzcMemoryPool* pool, void* pointer);
 
+/** Returns the size class of a small allocation of given size. */
+kzUint kzcMemoryPoolGetSizeClass(kzUint size);
+/** Returns the object size of the given size class. Allocations of this size use the whole object. */
+kzUint kzcMemoryPoolGetSizeClassObjectSize(kzUint sizeClass);
+/**
+ * Gets the size class of an object allocated from the pool. out_isSlabObject is KZ_FALSE if the pointer was not allocated
+ * from the slabs of any size class, in which case the object can only be freed to the pool.
+ * Takes only the slab table lock of the pool, so it can be called without holding the lock of the memory manager.
+ */
+kzsError kzcMemoryPoolGetObjectSizeClass(const struct KzcMemoryPool* pool, const void* pointer, kzBool* out_isSlabObject, kzUint* out_sizeClass);
+
 /** Returns the maximum continuous size of memory that can be allocated. */
 kzUint kzcMemoryPoolGetMaximumAvailableSize(const struct KzcMemoryPool* pool);
 
+/**
+ * Returns the fragmentation index of the available memory of the pool.
+ * The index is 1 - (largest available block / total available memory). 0 means that all available memory is continuous.
+ */
+kzFloat kzcMemoryPoolGetFragmentationIndex(const struct KzcMemoryPool* pool);
+
 /** Checks if the given pointer is located within the memory range of this pool. */
 kzBool kzcMemoryPoolIsPointerInRange(const struct KzcMemoryPool* pool, const void* pointer);
 
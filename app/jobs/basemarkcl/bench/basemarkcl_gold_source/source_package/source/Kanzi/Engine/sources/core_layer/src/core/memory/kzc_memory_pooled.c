@@ -22,6 +22,7 @@
 #include <system/debug/kzs_log.h>
 #include <system/kzs_error_codes.h>
 #include <system/wrappers/kzs_math.h>
+#include <system/thread/kzs_thread.h>
 
 
 #ifdef KZC_MEMORY_DEBUG
@@ -40,17 +41,56 @@ struct KzcDebugAllocationEntry
 };
 #endif
 
+/** Number of objects moved from the pools to a thread cache at a time. */
+#define KZC_MEMORY_POOLED_ALLOCATION_BATCH_SIZE 16
+/** Number of small objects freed by a thread before they are returned to the pools at a time. */
+#define KZC_MEMORY_POOLED_FREE_BATCH_SIZE 32
+/** Maximum number of freed objects of one size class kept in a thread cache for reuse. */
+#define KZC_MEMORY_POOLED_MAXIMUM_CACHED_OBJECTS 32
+/** Pool directory is not used if it would need more entries than this per pool. The pools are then searched linearly. */
+#define KZC_MEMORY_POOLED_MAXIMUM_DIRECTORY_ENTRIES_PER_POOL 64
+
+
+/**
+ * Allocation cache of one thread.
+ * Small allocations are taken from the cache, which is refilled from the pools in batches. Freed small objects are
+ * collected and processed in batches, so that the manager lock is taken only once per batch. They are kept in the
+ * cache for reuse up to a limit, and the rest are returned to their pools. Larger blocks are returned at once.
+ *
+ * The owning thread uses the cache under the cache lock alone, or under the manager lock. Other threads only flush
+ * the cache, taking the manager lock first and then the cache lock.
+ */
+struct KzcPooledThreadCache
+{
+    struct KzcPooledMemoryManager* manager; /**< Memory manager of the cache. */
+    struct KzsThreadLock* lock; /**< Lock for the cache content. */
+    struct KzcPooledThreadCache* previousCache; /**< Previous cache in the list of caches of the manager. */
+    struct KzcPooledThreadCache* nextCache; /**< Next cache in the list of caches of the manager. */
+    void* freeObjects[KZC_MEMORY_POOL_SIZE_CLASS_COUNT]; /**< Allocated but unused objects of each size class. Each object stores pointer to the next one. */
+    kzUint freeObjectCounts[KZC_MEMORY_POOL_SIZE_CLASS_COUNT]; /**< Number of objects in freeObjects of each size class. */
+    void* pendingFrees[KZC_MEMORY_POOLED_FREE_BATCH_SIZE]; /**< Pointers freed by the thread but not yet returned to their pools. */
+    kzUint pendingFreeCount; /**< Number of pointers in pendingFrees. */
+};
+
 struct KzcPooledMemoryManager
 {
     struct KzcMemoryManager base; /**< Memory manager base. */
+    const struct KzcMemoryManager* parent; /**< Parent memory manager. */
     kzUint poolCount; /**< Number of memory pools */
+    kzUint poolSize; /**< Size of each memory pool. */
     struct KzcMemoryPool** pools; /**< Array of memory pools */
+    kzUint allocationPoolIndex; /**< Index of the pool, which served the previous allocation. It is tried first on next allocation. */
+    struct KzcMemoryPool** poolDirectory; /**< Pool starting in each poolSize sized address range from poolDirectoryBase, or KZ_NULL. The directory is KZ_NULL if the pools are too far apart. */
+    const kzByte* poolDirectoryBase; /**< Address of the lowest pool. */
+    kzUint poolDirectoryLength; /**< Number of entries in the pool directory. */
+    struct KzsThreadLock* lock; /**< Lock for the pools, allocation bookkeeping and the list of thread caches. Taken before the lock of any cache. */
+    struct KzsThreadLocalStorage* threadCacheStorage; /**< Thread cache of each thread. */
+    struct KzcPooledThreadCache* threadCaches; /**< List of all thread caches. */
 #ifdef KZC_MEMORY_MEASURE
     kzUint peakMaximumAvailableSize; /**< Peak lowest value for the maximum available block. */
 #endif
 
 #ifdef KZC_MEMORY_DEBUG
-    const struct KzcMemoryManager* parent; /**< Parent memory manager. Needed for memory dumping. */
     struct KzcHashMap* debugAllocationMap; /**< Debug allocation entries based on allocation description. <kzString, DebugallocationEntry>. */
 #endif
 };
@@ -59,6 +99,127 @@ struct KzcPooledMemoryManager
 static kzsError kzcMemoryPooledDelete_internal(struct KzcMemoryManager* memoryManager);
 static kzsError kzcMemoryPooledAlloc_internal(const struct KzcMemoryManager* memoryManager, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description));
 static kzsError kzcMemoryPooledFree_internal(const struct KzcMemoryManager* memoryManager, void* pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description));
+static kzsError kzcMemoryPooledFlushThreadCache_internal(struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache* cache);
+static kzsError kzcMemoryPooledFlushThreadCaches_internal(struct KzcPooledMemoryManager* pooledMemoryManager);
+static void kzcMemoryPooledThreadCacheDestructor_internal(void* value);
+
+
+/**
+ * Creates the pool directory, which maps pointers to their pools in constant time.
+ * Pools are allocated separately and do not overlap, so at most one pool starts in each poolSize sized address range.
+ */
+static kzsError kzcMemoryPooledCreateDirectory_internal(struct KzcPooledMemoryManager* pooledMemoryManager)
+{
+    kzsError result;
+    const kzByte* lowestPool = (const kzByte*)pooledMemoryManager->pools[0];
+    const kzByte* highestPool = lowestPool;
+    kzUint directoryLength;
+    kzUint i;
+
+    for (i = 1; i < pooledMemoryManager->poolCount; ++i)
+    {
+        const kzByte* pool = (const kzByte*)pooledMemoryManager->pools[i];
+        if (pool < lowestPool)
+        {
+            lowestPool = pool;
+        }
+        if (pool > highestPool)
+        {
+            highestPool = pool;
+        }
+    }
+
+    directoryLength = (kzUint)(highestPool - lowestPool) / pooledMemoryManager->poolSize + 1;
+
+    pooledMemoryManager->poolDirectory = KZ_NULL;
+    pooledMemoryManager->poolDirectoryBase = lowestPool;
+    pooledMemoryManager->poolDirectoryLength = 0;
+
+    if (directoryLength <= pooledMemoryManager->poolCount * KZC_MEMORY_POOLED_MAXIMUM_DIRECTORY_ENTRIES_PER_POOL)
+    {
+        result = kzcMemoryAllocArray(pooledMemoryManager->parent, pooledMemoryManager->poolDirectory, directoryLength, "Pooled memory manager pool directory");
+        kzsErrorForward(result);
+
+        pooledMemoryManager->poolDirectoryLength = directoryLength;
+
+        for (i = 0; i < directoryLength; ++i)
+        {
+            pooledMemoryManager->poolDirectory[i] = KZ_NULL;
+        }
+
+        for (i = 0; i < pooledMemoryManager->poolCount; ++i)
+        {
+            kzUint index = (kzUint)((const kzByte*)pooledMemoryManager->pools[i] - lowestPool) / pooledMemoryManager->poolSize;
+            kzsAssert(pooledMemoryManager->poolDirectory[index] == KZ_NULL);
+            pooledMemoryManager->poolDirectory[index] = pooledMemoryManager->pools[i];
+        }
+    }
+
+    kzsSuccess();
+}
+
+/** Finds the pool managing the memory of the given pointer. Returns KZ_NULL if none of the pools manages it. */
+static struct KzcMemoryPool* kzcMemoryPooledFindPool_internal(const struct KzcPooledMemoryManager* pooledMemoryManager, const void* pointer)
+{
+    struct KzcMemoryPool* foundPool = KZ_NULL;
+
+    if (pooledMemoryManager->poolDirectory != KZ_NULL)
+    {
+        if ((const kzByte*)pointer >= pooledMemoryManager->poolDirectoryBase)
+        {
+            /* The pool containing the pointer starts either in the same address range or in the previous one. */
+            kzUint index = (kzUint)((const kzByte*)pointer - pooledMemoryManager->poolDirectoryBase) / pooledMemoryManager->poolSize;
+            if (index < pooledMemoryManager->poolDirectoryLength)
+            {
+                struct KzcMemoryPool* pool = pooledMemoryManager->poolDirectory[index];
+                if (pool != KZ_NULL && kzcMemoryPoolIsPointerInRange(pool, pointer))
+                {
+                    foundPool = pool;
+                }
+                else if (index > 0)
+                {
+                    pool = pooledMemoryManager->poolDirectory[index - 1];
+                    if (pool != KZ_NULL && kzcMemoryPoolIsPointerInRange(pool, pointer))
+                    {
+                        foundPool = pool;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        kzUint i;
+        for (i = 0; i < pooledMemoryManager->poolCount && foundPool == KZ_NULL; ++i)
+        {
+            if (kzcMemoryPoolIsPointerInRange(pooledMemoryManager->pools[i], pointer))
+            {
+                foundPool = pooledMemoryManager->pools[i];
+            }
+        }
+    }
+
+    return foundPool;
+}
+
+/** Gets the maximum available block size among the pools. The manager lock must be held by the caller. */
+static kzUint kzcMemoryPooledGetMaximumAvailableSize_internal(const struct KzcPooledMemoryManager* pooledMemoryManager)
+{
+    kzUint largestSize = 0;
+    kzUint i;
+
+    for (i = 0; i < pooledMemoryManager->poolCount; ++i) 
+    {
+        struct KzcMemoryPool* pool = pooledMemoryManager->pools[i];
+        kzUint poolSize = kzcMemoryPoolGetMaximumAvailableSize(pool);
+        if (poolSize >= largestSize)
+        {
+            largestSize = poolSize;
+        }
+    }
+
+    return largestSize;
+}
 
 
 kzsError kzcMemoryManagerCreatePooledManager(const struct KzcMemoryManager* parentManager, kzUint poolCount,
@@ -94,7 +255,11 @@ kzsError kzcMemoryManagerCreatePooledManager(const struct KzcMemoryManager* pare
     /* PooledMemoryManager data follows right after MemoryManager struct */
     kzcByteBufferAllocateWriteVariable(&managerBuffer, pooledMemoryManager);
 
+    pooledMemoryManager->parent = parentManager;
     pooledMemoryManager->poolCount = poolCount;
+    pooledMemoryManager->poolSize = poolSize;
+    pooledMemoryManager->allocationPoolIndex = 0;
+    pooledMemoryManager->threadCaches = KZ_NULL;
 
     /* Pool array data follows right after the PooledMemoryManager struct */
     kzcByteBufferAllocateWriteArray(&managerBuffer, poolCount, pooledMemoryManager->pools);
@@ -107,11 +272,18 @@ kzsError kzcMemoryManagerCreatePooledManager(const struct KzcMemoryManager* pare
         kzsErrorForward(result);
     }
 
+    result = kzcMemoryPooledCreateDirectory_internal(pooledMemoryManager);
+    kzsErrorForward(result);
+
+    result = kzsThreadLockCreate(&pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
+    result = kzsThreadLocalStorageCreate(kzcMemoryPooledThreadCacheDestructor_internal, &pooledMemoryManager->threadCacheStorage);
+    kzsErrorForward(result);
+
 #ifdef KZC_MEMORY_DEBUG
     {
-        pooledMemoryManager->parent = parentManager;
-    
-        result = kzcHashMapCreate(parentManager, KZC_HASH_MAP_CONFIGURATION_STRING, &pooledMemoryManager->debugAllocationMap);
+        result = kzcHashMapCreate(parentManager, KZC_HASH_MAP_CONFIGURATION_STRING_GROUPED, &pooledMemoryManager->debugAllocationMap);
         kzsErrorForward(result);
     }
 #endif
@@ -121,7 +293,7 @@ kzsError kzcMemoryManagerCreatePooledManager(const struct KzcMemoryManager* pare
     memoryManager = (struct KzcMemoryManager*)pooledMemoryManager;
 
 #ifdef KZC_MEMORY_MEASURE
-    pooledMemoryManager->peakMaximumAvailableSize = kzcMemoryPooledGetMaximumAvailableSize(memoryManager);
+    pooledMemoryManager->peakMaximumAvailableSize = kzcMemoryPooledGetMaximumAvailableSize_internal(pooledMemoryManager);
 #endif
 
     *out_memoryManager = memoryManager;
@@ -134,12 +306,41 @@ KZ_CALLBACK static kzsError kzcMemoryPooledDelete_internal(struct KzcMemoryManag
     struct KzcPooledMemoryManager* pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
     kzUint i;
 
+    /* Caches are not released on thread exit after the storage is deleted. */
+    result = kzsThreadLocalStorageDelete(pooledMemoryManager->threadCacheStorage);
+    kzsErrorForward(result);
+
+    /* Return the memory held by thread caches. Other threads must not use the manager any more. */
+    while (pooledMemoryManager->threadCaches != KZ_NULL)
+    {
+        struct KzcPooledThreadCache* cache = pooledMemoryManager->threadCaches;
+        pooledMemoryManager->threadCaches = cache->nextCache;
+
+        result = kzcMemoryPooledFlushThreadCache_internal(pooledMemoryManager, cache);
+        kzsErrorForward(result);
+
+        result = kzsThreadLockDelete(cache->lock);
+        kzsErrorForward(result);
+
+        result = kzcMemoryFreeVariable(cache);
+        kzsErrorForward(result);
+    }
+
     for (i = 0; i < pooledMemoryManager->poolCount; ++i)
     {
         result = kzcMemoryManagerDeletePool(pooledMemoryManager->pools[i]);
         kzsErrorForward(result);
     }
 
+    if (pooledMemoryManager->poolDirectory != KZ_NULL)
+    {
+        result = kzcMemoryFreeArray(pooledMemoryManager->poolDirectory);
+        kzsErrorForward(result);
+    }
+
+    result = kzsThreadLockDelete(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
 #ifdef KZC_MEMORY_DEBUG
     {
         struct KzcHashMapIterator it = kzcHashMapGetIterator(pooledMemoryManager->debugAllocationMap);
@@ -162,23 +363,22 @@ KZ_CALLBACK static kzsError kzcMemoryPooledDelete_internal(struct KzcMemoryManag
     kzsSuccess();
 }
 
-kzUint kzcMemoryPooledGetMaximumAvailableSize(const struct KzcMemoryManager* memoryManager)
+kzsError kzcMemoryPooledGetMaximumAvailableSize(const struct KzcMemoryManager* memoryManager, kzUint* out_size)
 {
-    kzUint largestSize = 0;
+    kzsError result;
     struct KzcPooledMemoryManager* pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
-    kzUint i;
+    kzUint size;
 
-    for (i = 0; i < pooledMemoryManager->poolCount; ++i) 
-    {
-        struct KzcMemoryPool* pool = pooledMemoryManager->pools[i];
-        kzUint poolSize = kzcMemoryPoolGetMaximumAvailableSize(pool);
-        if (poolSize >= largestSize)
-        {
-            largestSize = poolSize;
-        }
-    }
+    result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+    kzsErrorForward(result);
 
-    return largestSize;
+    size = kzcMemoryPooledGetMaximumAvailableSize_internal(pooledMemoryManager);
+
+    result = kzsThreadLockRelease(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
+    *out_size = size;
+    kzsSuccess();
 }
 
 #ifdef KZC_MEMORY_MEASURE
@@ -192,23 +392,56 @@ kzUint kzcMemoryPooledGetPeakMaximumAvailableSize(const struct KzcMemoryManager*
 }
 #endif
 
-KZ_CALLBACK static kzsError kzcMemoryPooledAlloc_internal(const struct KzcMemoryManager* memoryManager, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
+/**
+ * Tries to allocate memory from the pools. Sets the pointer to KZ_NULL if none of the pools has enough space.
+ * The manager lock must be held by the caller. The pool which served the previous allocation is tried first.
+ */
+static kzsError kzcMemoryPooledTryAllocFromPools_internal(struct KzcPooledMemoryManager* pooledMemoryManager, kzUint size,
+                                                          void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
 {
     kzsError result;
-    struct KzcPooledMemoryManager* pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
     void* pointer = KZ_NULL;
     kzUint i;
 
     for (i = 0; i < pooledMemoryManager->poolCount && pointer == KZ_NULL; ++i) 
     {
-        struct KzcMemoryPool* pool = pooledMemoryManager->pools[i];
+        kzUint poolIndex = (pooledMemoryManager->allocationPoolIndex + i) % pooledMemoryManager->poolCount;
+        struct KzcMemoryPool* pool = pooledMemoryManager->pools[poolIndex];
         /* See if there is enough space available in some pool if there are several pools */
         if (pooledMemoryManager->poolCount == 1 || kzcMemoryPoolGetMaximumAvailableSize(pool) >= size)
         {
             result = kzcMemoryPoolAlloc(pool, size, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(description));
             kzsErrorForward(result);
+            pooledMemoryManager->allocationPoolIndex = poolIndex;
         }
     }
+
+    *out_pointer = pointer;
+    kzsSuccess();
+}
+
+/**
+ * Allocates memory from the pools. The manager lock must be held by the caller, but not the lock of any thread cache.
+ * If the pools are exhausted, the memory held by the thread caches is returned to the pools before giving up.
+ */
+static kzsError kzcMemoryPooledAllocFromPools_internal(struct KzcPooledMemoryManager* pooledMemoryManager, kzUint size,
+                                                       void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
+{
+    kzsError result;
+    void* pointer;
+
+    result = kzcMemoryPooledTryAllocFromPools_internal(pooledMemoryManager, size, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(description));
+    kzsErrorForward(result);
+
+    if (pointer == KZ_NULL && pooledMemoryManager->threadCaches != KZ_NULL)
+    {
+        result = kzcMemoryPooledFlushThreadCaches_internal(pooledMemoryManager);
+        kzsErrorForward(result);
+
+        result = kzcMemoryPooledTryAllocFromPools_internal(pooledMemoryManager, size, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(description));
+        kzsErrorForward(result);
+    }
+
     if (pointer == KZ_NULL)
     {
         struct KzcMemoryManager* systemMemoryManager;
@@ -253,45 +486,424 @@ KZ_CALLBACK static kzsError kzcMemoryPooledAlloc_internal(const struct KzcMemory
 
 #ifdef KZC_MEMORY_MEASURE
     pooledMemoryManager->peakMaximumAvailableSize = kzsMinU(pooledMemoryManager->peakMaximumAvailableSize,
-                                                            kzcMemoryPooledGetMaximumAvailableSize(memoryManager));
+                                                            kzcMemoryPooledGetMaximumAvailableSize_internal(pooledMemoryManager));
 #endif
 
     *out_pointer = pointer;
     kzsSuccess();
 }
 
+/** Frees memory back to its pool. The manager lock must be held by the caller. */
+static kzsError kzcMemoryPooledFreeToPool_internal(const struct KzcPooledMemoryManager* pooledMemoryManager, void* pointer)
+{
+    kzsError result;
+    struct KzcMemoryPool* pool = kzcMemoryPooledFindPool_internal(pooledMemoryManager, pointer);
+
+    kzsErrorTest(pool != KZ_NULL, KZC_ERROR_MEMORY_POOL_NOT_FOUND, "None of the memory pools manages the memory range of the given pointer.");
+
+    result = kzcMemoryPoolFree(pool, pointer);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+/**
+ * Processes the pending frees of a thread cache. Small objects are moved to the free objects of the cache while there
+ * is room for them and the rest are returned to their pools. The manager lock must be held by the caller, which must
+ * own the cache.
+ */
+static kzsError kzcMemoryPooledReturnPendingFrees_internal(const struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache* cache)
+{
+    kzsError result;
+    kzUint i;
+
+    for (i = 0; i < cache->pendingFreeCount; ++i)
+    {
+        void* pointer = cache->pendingFrees[i];
+        struct KzcMemoryPool* pool = kzcMemoryPooledFindPool_internal(pooledMemoryManager, pointer);
+        kzBool isSlabObject;
+        kzUint sizeClass;
+
+        kzsAssert(pool != KZ_NULL);
+
+        result = kzcMemoryPoolGetObjectSizeClass(pool, pointer, &isSlabObject, &sizeClass);
+        kzsErrorForward(result);
+
+        if (isSlabObject && cache->freeObjectCounts[sizeClass] < KZC_MEMORY_POOLED_MAXIMUM_CACHED_OBJECTS)
+        {
+            *(void**)pointer = cache->freeObjects[sizeClass];
+            cache->freeObjects[sizeClass] = pointer;
+            ++cache->freeObjectCounts[sizeClass];
+        }
+        else
+        {
+            result = kzcMemoryPoolFree(pool, pointer);
+            kzsErrorForward(result);
+        }
+    }
+    cache->pendingFreeCount = 0;
+
+    kzsSuccess();
+}
+
+/**
+ * Returns all memory held by a thread cache to the pools. The manager lock must be held by the caller, and also the
+ * cache lock unless the caller owns the cache.
+ */
+static kzsError kzcMemoryPooledFlushThreadCache_internal(struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache* cache)
+{
+    kzsError result;
+    kzUint i;
+
+    for (i = 0; i < cache->pendingFreeCount; ++i)
+    {
+        result = kzcMemoryPooledFreeToPool_internal(pooledMemoryManager, cache->pendingFrees[i]);
+        kzsErrorForward(result);
+    }
+    cache->pendingFreeCount = 0;
+
+    for (i = 0; i < KZC_MEMORY_POOL_SIZE_CLASS_COUNT; ++i)
+    {
+        while (cache->freeObjects[i] != KZ_NULL)
+        {
+            void* object = cache->freeObjects[i];
+            cache->freeObjects[i] = *(void**)object;
+
+            result = kzcMemoryPooledFreeToPool_internal(pooledMemoryManager, object);
+            kzsErrorForward(result);
+        }
+        cache->freeObjectCounts[i] = 0;
+    }
+
+    kzsSuccess();
+}
+
+/** Returns the memory held by all thread caches to the pools. The manager lock must be held by the caller, but not the lock of any cache. */
+static kzsError kzcMemoryPooledFlushThreadCaches_internal(struct KzcPooledMemoryManager* pooledMemoryManager)
+{
+    kzsError result;
+    kzsError flushResult;
+    struct KzcPooledThreadCache* cache;
+
+    for (cache = pooledMemoryManager->threadCaches; cache != KZ_NULL; cache = cache->nextCache)
+    {
+        result = kzsThreadLockAcquire(cache->lock);
+        kzsErrorForward(result);
+
+        flushResult = kzcMemoryPooledFlushThreadCache_internal(pooledMemoryManager, cache);
+
+        result = kzsThreadLockRelease(cache->lock);
+        kzsErrorForward(result);
+        kzsErrorForward(flushResult);
+    }
+
+    kzsSuccess();
+}
+
+/** Gets the thread cache of the calling thread, creating it on first use. */
+static kzsError kzcMemoryPooledGetThreadCache_internal(struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache** out_cache)
+{
+    kzsError result;
+    struct KzcPooledThreadCache* cache = (struct KzcPooledThreadCache*)kzsThreadLocalStorageGetValue(pooledMemoryManager->threadCacheStorage);
+
+    if (cache == KZ_NULL)
+    {
+        kzUint i;
+
+        result = kzcMemoryAllocVariable(pooledMemoryManager->parent, cache, "Pooled memory manager thread cache");
+        kzsErrorForward(result);
+
+        result = kzsThreadLockCreate(&cache->lock);
+        kzsErrorForward(result);
+
+        cache->manager = pooledMemoryManager;
+        for (i = 0; i < KZC_MEMORY_POOL_SIZE_CLASS_COUNT; ++i)
+        {
+            cache->freeObjects[i] = KZ_NULL;
+            cache->freeObjectCounts[i] = 0;
+        }
+        cache->pendingFreeCount = 0;
+        cache->previousCache = KZ_NULL;
+
+        result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+        kzsErrorForward(result);
+
+        cache->nextCache = pooledMemoryManager->threadCaches;
+        if (cache->nextCache != KZ_NULL)
+        {
+            cache->nextCache->previousCache = cache;
+        }
+        pooledMemoryManager->threadCaches = cache;
+
+        result = kzsThreadLockRelease(pooledMemoryManager->lock);
+        kzsErrorForward(result);
+
+        result = kzsThreadLocalStorageSetValue(pooledMemoryManager->threadCacheStorage, cache);
+        kzsErrorForward(result);
+    }
+
+    *out_cache = cache;
+    kzsSuccess();
+}
+
+/**
+ * Moves a batch of objects of the given size class from the pools to a thread cache and takes one of them.
+ * The manager lock must be held by the caller, which must own the cache.
+ * Only one object is allocated if the whole batch might not fit, so that running out of memory is reported for the requested object only.
+ */
+static kzsError kzcMemoryPooledRefillThreadCache_internal(struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache* cache,
+                                                          kzUint sizeClass, void** out_pointer)
+{
+    kzsError result;
+    kzUint objectSize = kzcMemoryPoolGetSizeClassObjectSize(sizeClass);
+    kzUint objectCount = 1;
+    void* pointer;
+    kzUint i;
+
+    if (kzcMemoryPooledGetMaximumAvailableSize_internal(pooledMemoryManager) >= objectSize * KZC_MEMORY_POOLED_ALLOCATION_BATCH_SIZE)
+    {
+        objectCount = KZC_MEMORY_POOLED_ALLOCATION_BATCH_SIZE;
+    }
+
+    for (i = 0; i < objectCount; ++i)
+    {
+        void* object;
+
+        result = kzcMemoryPooledAllocFromPools_internal(pooledMemoryManager, objectSize, &object
+                                                        MEMORY_MANAGER_DEBUG_PARAM_PRIVATE("Pooled memory manager thread cache object"));
+        kzsErrorForward(result);
+
+        *(void**)object = cache->freeObjects[sizeClass];
+        cache->freeObjects[sizeClass] = object;
+        ++cache->freeObjectCounts[sizeClass];
+    }
+
+    pointer = cache->freeObjects[sizeClass];
+    cache->freeObjects[sizeClass] = *(void**)pointer;
+    --cache->freeObjectCounts[sizeClass];
+
+    *out_pointer = pointer;
+    kzsSuccess();
+}
+
+KZ_CALLBACK static kzsError kzcMemoryPooledAlloc_internal(const struct KzcMemoryManager* memoryManager, kzUint size, void** out_pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
+{
+    kzsError result;
+    kzsError allocationResult;
+    struct KzcPooledMemoryManager* pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
+    void* pointer;
+
+#ifndef KZC_MEMORY_DEBUG
+    /* Small allocations go through the thread cache. Debug builds bypass it so that each allocation keeps its own description. */
+    if (size > 0 && size <= KZC_MEMORY_POOL_SMALL_OBJECT_MAXIMUM_SIZE)
+    {
+        struct KzcPooledThreadCache* cache;
+        kzUint sizeClass = kzcMemoryPoolGetSizeClass(size);
+
+        result = kzcMemoryPooledGetThreadCache_internal(pooledMemoryManager, &cache);
+        kzsErrorForward(result);
+
+        result = kzsThreadLockAcquire(cache->lock);
+        kzsErrorForward(result);
+
+        pointer = cache->freeObjects[sizeClass];
+        if (pointer != KZ_NULL)
+        {
+            cache->freeObjects[sizeClass] = *(void**)pointer;
+            --cache->freeObjectCounts[sizeClass];
+        }
+
+        result = kzsThreadLockRelease(cache->lock);
+        kzsErrorForward(result);
+
+        if (pointer == KZ_NULL)
+        {
+            result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+            kzsErrorForward(result);
+
+            allocationResult = kzcMemoryPooledRefillThreadCache_internal(pooledMemoryManager, cache, sizeClass, &pointer);
+
+            result = kzsThreadLockRelease(pooledMemoryManager->lock);
+            kzsErrorForward(result);
+            kzsErrorForward(allocationResult);
+        }
+    }
+    else
+#endif
+    {
+        result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+        kzsErrorForward(result);
+
+        allocationResult = kzcMemoryPooledAllocFromPools_internal(pooledMemoryManager, size, &pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(description));
+
+        result = kzsThreadLockRelease(pooledMemoryManager->lock);
+        kzsErrorForward(result);
+        kzsErrorForward(allocationResult);
+    }
+
+    *out_pointer = pointer;
+    kzsSuccess();
+}
+
 KZ_CALLBACK static kzsError kzcMemoryPooledFree_internal(const struct KzcMemoryManager* memoryManager, void* pointer MEMORY_MANAGER_DEBUG_PARAM_PRIVATE(kzString description))
 {
     kzsError result;
+    kzsError freeResult;
     struct KzcPooledMemoryManager* pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
-    kzUint i;
-    kzBool poolFound = KZ_FALSE;
+    /* Pools never move, so the owning pool can be found without the lock. */
+    struct KzcMemoryPool* pool = kzcMemoryPooledFindPool_internal(pooledMemoryManager, pointer);
+
+    kzsErrorTest(pool != KZ_NULL, KZC_ERROR_MEMORY_POOL_NOT_FOUND, "None of the memory pools manages the memory range of the given pointer.");
+
+#ifndef KZC_MEMORY_DEBUG
+    {
+        kzBool isSlabObject;
+        kzUint sizeClass;
+
+        /*
+         * Only small objects are collected to the thread cache, so that freed blocks are available for other allocations at once.
+         * The slab lookup takes only the slab table lock of the pool, so frees do not wait for the manager lock until the batch is full.
+         */
+        result = kzcMemoryPoolGetObjectSizeClass(pool, pointer, &isSlabObject, &sizeClass);
+        kzsErrorForward(result);
+
+        if (isSlabObject)
+        {
+            struct KzcPooledThreadCache* cache;
+            kzBool batchFull;
+
+            result = kzcMemoryPooledGetThreadCache_internal(pooledMemoryManager, &cache);
+            kzsErrorForward(result);
+
+            result = kzsThreadLockAcquire(cache->lock);
+            kzsErrorForward(result);
+
+            cache->pendingFrees[cache->pendingFreeCount++] = pointer;
+            batchFull = (cache->pendingFreeCount == KZC_MEMORY_POOLED_FREE_BATCH_SIZE);
+
+            result = kzsThreadLockRelease(cache->lock);
+            kzsErrorForward(result);
+
+            if (batchFull)
+            {
+                result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+                kzsErrorForward(result);
+
+                freeResult = kzcMemoryPooledReturnPendingFrees_internal(pooledMemoryManager, cache);
+
+                result = kzsThreadLockRelease(pooledMemoryManager->lock);
+                kzsErrorForward(result);
+                kzsErrorForward(freeResult);
+            }
+        }
+        else
+        {
+            result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+            kzsErrorForward(result);
+
+            freeResult = kzcMemoryPoolFree(pool, pointer);
+
+            result = kzsThreadLockRelease(pooledMemoryManager->lock);
+            kzsErrorForward(result);
+            kzsErrorForward(freeResult);
+        }
+    }
+#else
+    result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+    kzsErrorForward(result);
 
-#ifdef KZC_MEMORY_DEBUG
     {
         struct KzcDebugAllocationEntry* entry;
         if (kzcHashMapGet(pooledMemoryManager->debugAllocationMap, description, (void**)&entry))
         {
             --entry->allocationCount;
+            freeResult = kzcMemoryPoolFree(pool, pointer);
         }
         else
         {
-            kzsErrorThrow(KZC_ERROR_MEMORY_ALLOCATION_MISMATCH, "Tried to free unallocated memory.");
+            freeResult = KZC_ERROR_MEMORY_ALLOCATION_MISMATCH;
         }
     }
+
+    result = kzsThreadLockRelease(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+    kzsErrorTest(freeResult != KZC_ERROR_MEMORY_ALLOCATION_MISMATCH, KZC_ERROR_MEMORY_ALLOCATION_MISMATCH, "Tried to free unallocated memory.");
+    kzsErrorForward(freeResult);
 #endif
 
-    for (i = 0; i < pooledMemoryManager->poolCount && !poolFound; ++i)
+    kzsSuccess();
+}
+
+/** Returns the memory of a thread cache to the pools and deletes the cache. Must be called by the thread owning the cache. */
+static kzsError kzcMemoryPooledDeleteThreadCache_internal(struct KzcPooledMemoryManager* pooledMemoryManager, struct KzcPooledThreadCache* cache)
+{
+    kzsError result;
+    kzsError flushResult;
+
+    result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
+    flushResult = kzcMemoryPooledFlushThreadCache_internal(pooledMemoryManager, cache);
+
+    if (cache->previousCache != KZ_NULL)
     {
-        struct KzcMemoryPool* pool = pooledMemoryManager->pools[i];
-        poolFound = kzcMemoryPoolIsPointerInRange(pool, pointer);
-        if (poolFound)
-        {
-            result = kzcMemoryPoolFree(pool, pointer);
-            kzsErrorForward(result);
-        }
+        cache->previousCache->nextCache = cache->nextCache;
+    }
+    else
+    {
+        pooledMemoryManager->threadCaches = cache->nextCache;
+    }
+    if (cache->nextCache != KZ_NULL)
+    {
+        cache->nextCache->previousCache = cache->previousCache;
+    }
+
+    result = kzsThreadLockRelease(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+    kzsErrorForward(flushResult);
+
+    result = kzsThreadLockDelete(cache->lock);
+    kzsErrorForward(result);
+
+    result = kzcMemoryFreeVariable(cache);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
+/** Thread local storage destructor, which deletes the cache of an exiting thread. */
+KZ_CALLBACK static void kzcMemoryPooledThreadCacheDestructor_internal(void* value)
+{
+    kzsError result;
+    struct KzcPooledThreadCache* cache = (struct KzcPooledThreadCache*)value;
+
+    result = kzcMemoryPooledDeleteThreadCache_internal(cache->manager, cache);
+    kzsErrorIf(result)
+    {
+        kzsLog(KZS_LOG_LEVEL_WARNING, "Unable to release the memory cache of an exiting thread");
+    }
+}
+
+kzsError kzcMemoryPooledReleaseThreadCache(const struct KzcMemoryManager* memoryManager)
+{
+    kzsError result;
+    struct KzcPooledMemoryManager* pooledMemoryManager;
+    struct KzcPooledThreadCache* cache;
+
+    kzsErrorTest(memoryManager->type == KZC_MEMORY_MANAGER_TYPE_POOLED,
+                 KZS_ERROR_ILLEGAL_ARGUMENT, "Thread caches are only available for pooled memory managers");
+
+    pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
+    cache = (struct KzcPooledThreadCache*)kzsThreadLocalStorageGetValue(pooledMemoryManager->threadCacheStorage);
+
+    if (cache != KZ_NULL)
+    {
+        result = kzsThreadLocalStorageSetValue(pooledMemoryManager->threadCacheStorage, KZ_NULL);
+        kzsErrorForward(result);
+
+        result = kzcMemoryPooledDeleteThreadCache_internal(pooledMemoryManager, cache);
+        kzsErrorForward(result);
     }
-    kzsErrorTest(poolFound, KZC_ERROR_MEMORY_POOL_NOT_FOUND, "None of the memory pools manages the memory range of the given pointer.");
 
     kzsSuccess();
 }
@@ -332,6 +944,7 @@ kzsError kzcMemoryPrintDebugAllocations(const struct KzcMemoryManager* memoryMan
 
 kzsError kzcMemoryDump(const struct KzcMemoryManager* memoryManager)
 {
+    kzsError result;
     struct KzcPooledMemoryManager* pooledMemoryManager;
     kzUint i;
 
@@ -340,6 +953,9 @@ kzsError kzcMemoryDump(const struct KzcMemoryManager* memoryManager)
 
     pooledMemoryManager = (struct KzcPooledMemoryManager*)memoryManager;
 
+    result = kzsThreadLockAcquire(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
     kzsLog(KZS_LOG_LEVEL_INFO, "Dumping content of memory pools");
     for (i = 0; i < pooledMemoryManager->poolCount; ++i)
     {
@@ -347,5 +963,8 @@ kzsError kzcMemoryDump(const struct KzcMemoryManager* memoryManager)
     }
     kzsLog(KZS_LOG_LEVEL_INFO, "End of memory dump\n");
 
+    result = kzsThreadLockRelease(pooledMemoryManager->lock);
+    kzsErrorForward(result);
+
     kzsSuccess();
 }
@@ -4,6 +4,8 @@
 * Pooled memory manager allocates memory from constant sized preallocated memory pools.
 * This manager type tries to minimize memory fragmentation and is suitable for most common uses.
 * It is not intended for real-time memory allocation however.
+* The manager can be used from several threads. Each thread caches small allocations and collects freed pointers,
+* which are exchanged with the pools in batches.
 * 
 * Copyright 2008-2011 by Rightware. All rights reserved.
 */
@@ -26,6 +28,12 @@ struct KzcPooledMemoryManager;
 kzsError kzcMemoryManagerCreatePooledManager(const struct KzcMemoryManager* parentManager, kzUint poolCount,
                                              kzUint poolSize, struct KzcMemoryManager** out_manager);
 
+/**
+ * Returns the memory cached for the calling thread to the pools and releases the cache.
+ * Caches are released automatically when their threads exit, so this is only needed for returning the memory earlier.
+ */
+kzsError kzcMemoryPooledReleaseThreadCache(const struct KzcMemoryManager* memoryManager);
+
 /** Dumps the memory content to log. This function is only available for pooled memory manager. */
 kzsError kzcMemoryDump(const struct KzcMemoryManager* memoryManager);
 
@@ -33,7 +41,7 @@ kzsError kzcMemoryDump(const struct KzcMemoryManager* memoryManager);
 kzsError kzcMemoryPrintDebugAllocations(const struct KzcMemoryManager* memoryManager);
 
 /** Gets maximum available block size from pooled memory manager. */
-kzUint kzcMemoryPooledGetMaximumAvailableSize(const struct KzcMemoryManager* memoryManager);
+kzsError kzcMemoryPooledGetMaximumAvailableSize(const struct KzcMemoryManager* memoryManager, kzUint* out_size);
 
 #ifdef KZC_MEMORY_MEASURE
 /** Gets peak (lowest among the lifetime) maximum available block size from pooled memory manager. */
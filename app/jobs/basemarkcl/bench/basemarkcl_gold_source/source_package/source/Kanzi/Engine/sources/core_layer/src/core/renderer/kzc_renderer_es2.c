@@ -119,78 +119,50 @@ struct KzcRendererMaterialState
 };
 
 
-/** Uniform cache element data for vec2's. */
-struct KzcUniformVec2Value
-{
-    struct KzcVector2 value; /**< Data value. */
-};
-
-/** Uniform cache element data for vec3's. */
-struct KzcUniformVec3Value
-{
-    struct KzcVector3 value; /**< Data value. */
-};
-
-/** Uniform cache element data for vec4's. */
-struct KzcUniformVec4Value
-{
-    struct KzcVector4 value; /**< Data value. */
-};
-
-/** Uniform cache element data for mat2x2's. */
-struct KzcUniformMatrix2x2Value
-{
-    struct KzcMatrix2x2 value; /**< Data value. */
-};
-
-/** Uniform cache element data for mat3x3's. */
-struct KzcUniformMatrix3x3Value
-{
-    struct KzcMatrix3x3 value; /**< Data value. */
+/** Cached state of one uniform of a shader program. */
+struct KzcUniformSlot
+{
+    kzUint index; /**< Index of the slot in the slot table of the program. */
+    kzInt location; /**< Uniform location, -1 if the uniform is not active in the program. */
+    kzFloat* values; /**< Float values last sent to the uniform, KZ_NULL if the slot has no float storage yet. */
+    kzUint valueCapacity; /**< Number of floats reserved in values. */
+    kzUint valueCount; /**< Number of valid floats in values, 0 if the value is not known. */
+    kzUint arrayDimension; /**< Element size of the array last sent to the uniform, 0 if not set as an array. Used in lights. */
+    kzUint arrayCount; /**< Number of array elements last sent to the uniform. */
+    kzInt integerValue; /**< Integer value last sent to the uniform. Used for integer and sampler uniforms. */
+    kzBool integerValueValid; /**< Is integerValue known. */
 };
 
-/** Uniform cache element data for mat4x4's. */
-struct KzcUniformMatrix4x4Value
-{
-    struct KzcMatrix4x4 value; /**< Data value. */
+#define KZC_RENDERER_BUILT_IN_UNIFORM_WORLD_MATRIX                      0
+#define KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_MATRIX                     1
+#define KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_POSITION                   2
+#define KZC_RENDERER_BUILT_IN_UNIFORM_NORMAL_MATRIX                     3
+#define KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX    4
+#define KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_MATRIX                 5
+#define KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_WORLD_MATRIX               6
+#define KZC_RENDERER_BUILT_IN_UNIFORM_COUNT                             7
+
+/** Names of the built-in transformation uniforms, indexed by KZC_RENDERER_BUILT_IN_UNIFORM_*. */
+static const kzString KZC_RENDERER_BUILT_IN_UNIFORM_NAMES[KZC_RENDERER_BUILT_IN_UNIFORM_COUNT] = {
+    KZC_RENDERER_UNIFORM_WORLD_MATRIX,
+    KZC_RENDERER_UNIFORM_CAMERA_MATRIX,
+    KZC_RENDERER_UNIFORM_CAMERA_POSITION,
+    KZC_RENDERER_UNIFORM_NORMAL_MATRIX,
+    KZC_RENDERER_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX,
+    KZC_RENDERER_UNIFORM_PROJECTION_MATRIX,
+    KZC_RENDERER_UNIFORM_CAMERA_WORLD_MATRIX
 };
 
-/** Uniform cache element data for texture2D / textureCube. */
-struct KzcUniformSamplerValue
-{
-    kzUint value; /**< Data value. */
-};
-
-/** Uniform cache element data for integer uniforms. */
-struct KzcUniformIntegerValue
-{
-    kzInt value; /**< Data value. */
-};
-
-/** Uniform cache element data for arrays; Used in lights. */
-struct KzcUniformFloatArray
-{
-    kzUint size; /**< Size of array element, i.e. list of floats, vec2's, vec3's or vec4's. */
-    kzUint floatValueCount; /**< Number of array elements. */
-    kzFloat* values; /** Values. */
-};
-
-#define KZC_RENDERER_UNIFORM_CACHE_FLOAT        0
-#define KZC_RENDERER_UNIFORM_CACHE_VEC2         1
-#define KZC_RENDERER_UNIFORM_CACHE_VEC3         2
-#define KZC_RENDERER_UNIFORM_CACHE_VEC4         3
-#define KZC_RENDERER_UNIFORM_CACHE_MATRIX4X4    4
-#define KZC_RENDERER_UNIFORM_CACHE_SAMPLER      5
-#define KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY  6
-#define KZC_RENDERER_UNIFORM_CACHE_INTEGER      7
-#define KZC_RENDERER_UNIFORM_CACHE_MATRIX3X3    8
-#define KZC_RENDERER_UNIFORM_CACHE_MATRIX2X2    9
-#define KZC_RENDERER_UNIFORM_CACHE_COUNT        10
-
+/** Uniform slot table of a shader program, built from the active uniforms of the program when it is first used. */
 struct KzcUniformCache
 {
-    struct KzcHashMap* uniformCache[KZC_RENDERER_UNIFORM_CACHE_COUNT];
-    struct KzcHashMap* uniformLocationCache;
+    kzUint stamp; /**< Identifies the table among all tables created by the renderer. */
+    struct KzcUniformSlot* slots; /**< Slots of the active uniforms of the program. */
+    kzUint slotCount; /**< Number of active uniforms. */
+    struct KzcDynamicArray* extraSlots; /**< Slots of names queried outside the active uniform list, e.g. array elements and
+                                             inactive uniforms. Indexed from slotCount onwards. <KzcUniformSlot> */
+    struct KzcHashMap* slotsByName; /**< Slots by uniform name, including the extra slots. <kzString, KzcUniformSlot> */
+    struct KzcUniformSlot* builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_COUNT]; /**< Slots of the transformation uniforms, KZ_NULL if not active. */
 };
 
 
@@ -236,12 +208,13 @@ struct KzcRenderer
 
     kzUint activeFrameBufferHandle; /**< Currently bound framebuffer, 0 if none. */
 
-    struct KzcMemoryManager* uniformCacheMemoryManager; /**< Memory manager for uniform cache. */
+    struct KzcMemoryManager* uniformCacheMemoryManager; /**< Memory manager for uniform slot tables. */
 
-    struct KzcHashMap* uniformCaches; /**< Renderer uniform caches for all shaders. 
+    struct KzcHashMap* uniformCaches; /**< Uniform slot tables for all shaders. 
                                            hashmap<int(shaderHandle), KzcUniformCache(uniformCache)> */
                                                
-    struct KzcUniformCache* currentUniformCache; /**< Current uniform cache. */
+    struct KzcUniformCache* currentUniformCache; /**< Uniform slot table of the active shader. */
+    kzUint uniformCacheStamp; /**< Stamp of the last created uniform slot table. Not reset with the tables. */
 
     struct KzcRendererDebugInfo debugInfo; /**< Renderer debug info. */
 
@@ -266,10 +239,9 @@ struct KzcRenderer
 static void kzcRendererSetDefaultValues_internal(struct KzcRenderer* renderer);
 /** Initializes extensions for renderer. */
 static kzsError kzcRendererExtensionInitialize_internal(struct KzcRenderer* renderer);
-
-/** Checks if tho float array uniforms are equal. */
-static kzBool kzcUniformFloatArrayIsEqual_internal(const struct KzcUniformFloatArray* array1,
-                                                   const kzFloat* data, kzUint valueCount2);
+/** Creates the uniform slot table of a shader program from its active uniforms. */
+static kzsError kzcRendererCreateUniformCache_internal(struct KzcRenderer* renderer, kzUint shaderHandle,
+                                                       struct KzcUniformCache** out_uniformCache);
 
 
 kzsError kzcRendererCreate(const struct KzcMemoryManager* memoryManager, struct KzcRenderer** out_renderer)
@@ -286,6 +258,7 @@ kzsError kzcRendererCreate(const struct KzcMemoryManager* memoryManager, struct
 
     result = kzcHashMapCreate(renderer->uniformCacheMemoryManager, KZC_HASH_MAP_CONFIGURATION_INT, &renderer->uniformCaches);
     kzsErrorForward(result);
+    renderer->uniformCacheStamp = 0;
 
     result = kzcMemoryAllocArray(memoryManager, renderer->zeroFloatArray, 256, "ZeroFloatValues");
     kzsErrorForward(result);
@@ -493,45 +466,45 @@ kzsError kzcRendererResetLights(struct KzcRenderer* renderer)
     {
         kzUint* shaderHandle = (kzUint*)kzcHashMapIteratorGetKey(it);
         struct KzcUniformCache* uniformCache = (struct KzcUniformCache*)kzcHashMapIteratorGetValue(it);
+        struct KzcHashMapIterator slotIterator;
 
         kzsAssert(shaderHandle != KZ_NULL);
+        kzsAssert(uniformCache != KZ_NULL);
 
         result = kzcRendererSetActiveShaderHandle(renderer, *shaderHandle);
         kzsErrorForward(result);
 
-        /* Get float array uniform cache. */
-        if(uniformCache != KZ_NULL && uniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY] != KZ_NULL)
+        /* Zero the array uniforms, which are used for lights. */
+        slotIterator = kzcHashMapGetIterator(uniformCache->slotsByName);
+        while(kzcHashMapIterate(slotIterator))
         {
-            kzUint i;
-            struct KzcHashMapIterator floatArrayIterator = kzcHashMapGetIterator(uniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY]);
+            struct KzcUniformSlot* slot = (struct KzcUniformSlot*)kzcHashMapIteratorGetValue(slotIterator);
 
-            while(kzcHashMapIterate(floatArrayIterator))
+            if(slot->arrayDimension != 0 && slot->location != -1)
             {
-                kzUint* uniformHandle = (kzUint*)kzcHashMapIteratorGetKey(floatArrayIterator);
-                struct KzcUniformFloatArray* foundValue = (struct KzcUniformFloatArray*)kzcHashMapIteratorGetValue(floatArrayIterator);
+                kzUint i;
+                kzsAssert(slot->arrayCount * slot->arrayDimension < kzcArrayLength(renderer->zeroFloatArray));
 
-                kzsAssert(uniformHandle != KZ_NULL);
-                kzsAssert(foundValue != KZ_NULL);
-
-                if(foundValue->size == 1)
+                if(slot->arrayDimension == 1)
                 {
-                    kzsAssert(foundValue->floatValueCount * 1 < kzcArrayLength(renderer->zeroFloatArray));
-                    kzsGlUniform1fv((kzInt)(*uniformHandle), (kzInt)foundValue->floatValueCount, renderer->zeroFloatArray);
+                    kzsGlUniform1fv(slot->location, (kzInt)slot->arrayCount, renderer->zeroFloatArray);
                 }
-                else if(foundValue->size == 3)
+                else if(slot->arrayDimension == 2)
                 {
-                    kzsAssert(foundValue->floatValueCount * 3 < kzcArrayLength(renderer->zeroFloatArray));
-                    kzsGlUniform3fv((kzInt)(*uniformHandle), (kzInt)foundValue->floatValueCount, renderer->zeroFloatArray);
+                    kzsGlUniform2fv(slot->location, (kzInt)slot->arrayCount, renderer->zeroFloatArray);
                 }
-                else if(foundValue->size == 4)
+                else if(slot->arrayDimension == 3)
                 {
-                    kzsAssert(foundValue->floatValueCount * 4 < kzcArrayLength(renderer->zeroFloatArray));
-                    kzsGlUniform4fv((kzInt)(*uniformHandle), (kzInt)foundValue->floatValueCount, renderer->zeroFloatArray);
+                    kzsGlUniform3fv(slot->location, (kzInt)slot->arrayCount, renderer->zeroFloatArray);
+                }
+                else if(slot->arrayDimension == 4)
+                {
+                    kzsGlUniform4fv(slot->location, (kzInt)slot->arrayCount, renderer->zeroFloatArray);
                 }
 
-                for(i = 0; i < foundValue->floatValueCount * foundValue->size; ++i)
+                for(i = 0; i < slot->valueCount; ++i)
                 {
-                    foundValue->values[i] = 0.0f;
+                    slot->values[i] = 0.0f;
                 }
             }
         }
@@ -887,739 +860,715 @@ void kzcRendererSetClearStencil(struct KzcRenderer* renderer, kzInt stencilClear
     }
 }
 
-static kzBool kzcUniformFloatArrayIsEqual_internal(const struct KzcUniformFloatArray* array1,
-                                                   const kzFloat* data, kzUint valueCount2)
+/** Returns the number of floats in one element of an active uniform of given GL type, 0 for integer and sampler types. */
+static kzUint kzcRendererGetUniformTypeFloatCount_internal(kzUint type)
 {
+    kzUint floatCount;
+
+    switch(type)
+    {
+        case KZS_GL_FLOAT: floatCount = 1; break;
+        case KZS_GL_FLOAT_VEC2: floatCount = 2; break;
+        case KZS_GL_FLOAT_VEC3: floatCount = 3; break;
+        case KZS_GL_FLOAT_VEC4: floatCount = 4; break;
+        case KZS_GL_FLOAT_MAT2: floatCount = 4; break;
+        case KZS_GL_FLOAT_MAT3: floatCount = 9; break;
+        case KZS_GL_FLOAT_MAT4: floatCount = 16; break;
+        default: floatCount = 0; break;
+    }
+
+    return floatCount;
+}
+
+/** Resets the cached state of an uniform slot. */
+static void kzcRendererInitializeUniformSlot_internal(struct KzcUniformSlot* slot, kzUint index, kzInt location)
+{
+    slot->index = index;
+    slot->location = location;
+    slot->values = KZ_NULL;
+    slot->valueCapacity = 0;
+    slot->valueCount = 0;
+    slot->arrayDimension = 0;
+    slot->arrayCount = 0;
+    slot->integerValue = 0;
+    slot->integerValueValid = KZ_FALSE;
+}
+
+static kzsError kzcRendererCreateUniformCache_internal(struct KzcRenderer* renderer, kzUint shaderHandle,
+                                                       struct KzcUniformCache** out_uniformCache)
+{
+    kzsError result;
+    struct KzcUniformCache* uniformCache;
+    kzInt activeUniformCount = 0;
+    kzInt maximumNameLength = 0;
     kzUint i;
-    kzUint valueCount = array1->floatValueCount;
-    kzBool result = KZ_TRUE;
 
-    if(valueCount == valueCount2)
+    result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, uniformCache, "UniformCache");
+    kzsErrorForward(result);
+
+    result = kzcHashMapCreate(renderer->uniformCacheMemoryManager, KZC_HASH_MAP_CONFIGURATION_STRING_GROUPED,
+        &uniformCache->slotsByName);
+    kzsErrorForward(result);
+
+    result = kzcDynamicArrayCreate(renderer->uniformCacheMemoryManager, &uniformCache->extraSlots);
+    kzsErrorForward(result);
+
+    uniformCache->stamp = ++renderer->uniformCacheStamp;
+
+    kzsGlGetProgramiv(shaderHandle, KZS_GL_ACTIVE_UNIFORMS, &activeUniformCount);
+    kzsGlGetProgramiv(shaderHandle, KZS_GL_ACTIVE_UNIFORM_MAX_LENGTH, &maximumNameLength);
+
+    uniformCache->slots = KZ_NULL;
+    uniformCache->slotCount = (activeUniformCount > 0) ? (kzUint)activeUniformCount : 0;
+
+    if(uniformCache->slotCount > 0)
     {
-        kzFloat* valueA = array1->values;
+        kzMutableString name;
+        kzFloat* values;
+        kzUint valueCount = 0;
+
+        result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, uniformCache->slots, uniformCache->slotCount,
+            "UniformSlots");
+        kzsErrorForward(result);
+
+        result = kzcStringAllocate(renderer->uniformCacheMemoryManager, (maximumNameLength > 0) ? (kzUint)maximumNameLength : 0, &name);
+        kzsErrorForward(result);
 
-        for(i = 0; i < valueCount * array1->size; ++i)
+        for(i = 0; i < uniformCache->slotCount; ++i)
         {
-            if(!kzsFloatIsEqual(valueA[i], data[i]))
+            struct KzcUniformSlot* slot = &uniformCache->slots[i];
+            kzMutableString slotName;
+            kzInt nameLength = 0;
+            kzInt arraySize = 0;
+            kzUint type = 0;
+
+            name[0] = '\0';
+            kzsGlGetActiveUniform(shaderHandle, i, maximumNameLength + 1, &nameLength, &arraySize, &type, name);
+
+            /* Arrays are listed by their first element, but are referred to by their base name. */
+            if(nameLength >= 3 && kzsStrcmp(&name[nameLength - 3], "[0]") == 0)
             {
-                result = KZ_FALSE;
-                break;
+                name[nameLength - 3] = '\0';
+            }
+
+            kzcRendererInitializeUniformSlot_internal(slot, i, kzsGlGetUniformLocation(shaderHandle, name));
+            slot->valueCapacity = kzcRendererGetUniformTypeFloatCount_internal(type) * ((arraySize > 1) ? (kzUint)arraySize : 1);
+            valueCount += slot->valueCapacity;
+
+            result = kzcStringCopy(renderer->uniformCacheMemoryManager, name, &slotName);
+            kzsErrorForward(result);
+
+            result = kzcHashMapPut(uniformCache->slotsByName, slotName, slot);
+            kzsErrorForward(result);
+        }
+
+        /* Float values of all slots are kept in one block. */
+        if(valueCount > 0)
+        {
+            result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, values, valueCount, "UniformSlotValues");
+            kzsErrorForward(result);
+
+            for(i = 0; i < uniformCache->slotCount; ++i)
+            {
+                struct KzcUniformSlot* slot = &uniformCache->slots[i];
+                if(slot->valueCapacity > 0)
+                {
+                    slot->values = values;
+                    values += slot->valueCapacity;
+                }
             }
         }
     }
-    else
+
+    for(i = 0; i < KZC_RENDERER_BUILT_IN_UNIFORM_COUNT; ++i)
     {
-        result = KZ_FALSE;
+        struct KzcUniformSlot* slot;
+        if(kzcHashMapGet(uniformCache->slotsByName, KZC_RENDERER_BUILT_IN_UNIFORM_NAMES[i], (void**)&slot) &&
+           slot->location != -1)
+        {
+            uniformCache->builtInSlots[i] = slot;
+        }
+        else
+        {
+            uniformCache->builtInSlots[i] = KZ_NULL;
+        }
     }
 
-    return result;
+    *out_uniformCache = uniformCache;
+    kzsSuccess();
 }
 
-kzsError kzcRendererGetUniformLocation(const struct KzcRenderer* renderer, kzString uniformName, kzInt *out_uniformLocation)
+/** Reserves float storage for an extra slot. Slots of the active uniforms get their storage when the slot table is built. */
+static kzsError kzcRendererReserveUniformSlotValues_internal(const struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                            kzUint valueCount)
 {
     kzsError result;
-    kzInt* uniformLocation;
-    kzBool uniformFound;
 
-    kzsAssert(kzcIsValidPointer(renderer));
-    
-    uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformLocationCache, (void*)uniformName, (void**)&uniformLocation);
-    if(!uniformFound)
+    if(slot->location != -1 && valueCount > slot->valueCapacity && slot->index >= renderer->currentUniformCache->slotCount)
     {
-        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, uniformLocation, "Uniform location");
+        /* Outgrown storage is left to the quick manager, which releases it when the renderer is reset. */
+        result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, slot->values, valueCount, "UniformSlotValues");
         kzsErrorForward(result);
 
-        *uniformLocation = kzsGlGetUniformLocation(renderer->activeShaderHandle, uniformName);
-
-        result = kzcHashMapPut(renderer->currentUniformCache->uniformLocationCache, (void*)uniformName, uniformLocation);
-        kzsErrorForward(result);
+        slot->valueCapacity = valueCount;
+        slot->valueCount = 0;
     }
 
-    *out_uniformLocation = *uniformLocation;
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformInteger(struct KzcRenderer* renderer, kzString uniformName, kzInt value)
+/**
+ * Gets the slot of an uniform of the active shader. Names not found from the slot table are resolved once and cached.
+ * Makes sure the slot can hold valueCount floats.
+ */
+static kzsError kzcRendererGetUniformSlot_internal(const struct KzcRenderer* renderer, kzString uniformName, kzUint valueCount,
+                                                   struct KzcUniformSlot** out_slot)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
-    kzBool assignValue = KZ_FALSE;
-    
-    struct KzcUniformIntegerValue* foundValue;
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
-    kzsErrorForward(result);
+    struct KzcUniformCache* uniformCache;
+    struct KzcUniformSlot* slot;
 
-    uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_INTEGER], &uniformLocation, (void**)&foundValue);
-    if(!uniformFound)
+    kzsAssert(kzcIsValidPointer(renderer));
+    kzsAssertText(renderer->currentUniformCache != KZ_NULL, "Uniforms cannot be set if no shader has been applied");
+
+    uniformCache = renderer->currentUniformCache;
+
+    if(!kzcHashMapGet(uniformCache->slotsByName, uniformName, (void**)&slot))
     {
-        kzInt* allocatedUniformLocation;
+        kzMutableString slotName;
 
-        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
+        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, slot, "UniformSlot");
         kzsErrorForward(result);
 
-        *allocatedUniformLocation = uniformLocation;
+        kzcRendererInitializeUniformSlot_internal(slot, uniformCache->slotCount + kzcDynamicArrayGetSize(uniformCache->extraSlots),
+            kzsGlGetUniformLocation(renderer->activeShaderHandle, uniformName));
 
-        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheIntegerValue");
+        result = kzcDynamicArrayAdd(uniformCache->extraSlots, slot);
         kzsErrorForward(result);
-        foundValue->value = value;
 
-        result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_INTEGER], allocatedUniformLocation, foundValue);
+        result = kzcStringCopy(renderer->uniformCacheMemoryManager, uniformName, &slotName);
         kzsErrorForward(result);
-        assignValue = KZ_TRUE;
-    }
-    else if(foundValue->value != value)
-    {
-        foundValue->value = value;
-        assignValue = KZ_TRUE;
-    }
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-    if(assignValue)
-#endif
-    {
-        kzsGlUniform1i(uniformLocation, value);
-        if(renderer->debugInfo.loggingEnabled)
-        {
-            ++renderer->debugInfo.uniformSendings;
-        }
+        result = kzcHashMapPut(uniformCache->slotsByName, slotName, slot);
+        kzsErrorForward(result);
     }
 
+    result = kzcRendererReserveUniformSlotValues_internal(renderer, slot, valueCount);
+    kzsErrorForward(result);
+
+    *out_slot = slot;
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformFloat(struct KzcRenderer* renderer, kzString uniformName, kzFloat value)
+/** Gets the slot of an uniform of the active shader by slot index. Makes sure the slot can hold valueCount floats. */
+static kzsError kzcRendererGetUniformSlotByIndex_internal(const struct KzcRenderer* renderer, kzUint slotIndex, kzUint valueCount,
+                                                          struct KzcUniformSlot** out_slot)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
-    kzBool assignValue = KZ_FALSE;
-    kzFloat* foundValue;
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
-    kzsErrorForward(result);
-
-    uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT], &uniformLocation, (void**)&foundValue);
-    if(!uniformFound)
-    {
-        kzInt* allocatedUniformLocation;
-        
-        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-        kzsErrorForward(result);
+    struct KzcUniformCache* uniformCache;
+    struct KzcUniformSlot* slot;
 
-        *allocatedUniformLocation = uniformLocation;
+    kzsAssert(kzcIsValidPointer(renderer));
+    kzsAssertText(renderer->currentUniformCache != KZ_NULL, "Uniforms cannot be set if no shader has been applied");
 
-        result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheFloatValue");
-        kzsErrorForward(result);
-        *foundValue = value;
+    uniformCache = renderer->currentUniformCache;
 
-        result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT], allocatedUniformLocation, foundValue);
-        kzsErrorForward(result);
-        assignValue = KZ_TRUE;
+    if(slotIndex < uniformCache->slotCount)
+    {
+        slot = &uniformCache->slots[slotIndex];
     }
-    else if(!kzsFloatIsEqual(*foundValue, value))
+    else
     {
-        *foundValue = value;
-        assignValue = KZ_TRUE;
+        kzsErrorTest(slotIndex - uniformCache->slotCount < kzcDynamicArrayGetSize(uniformCache->extraSlots), KZS_ERROR_ILLEGAL_ARGUMENT,
+            "Uniform slot index is not in the slot table of the active shader");
+
+        slot = (struct KzcUniformSlot*)kzcDynamicArrayGet(uniformCache->extraSlots, slotIndex - uniformCache->slotCount);
     }
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-    if(assignValue)
-#endif
+    result = kzcRendererReserveUniformSlotValues_internal(renderer, slot, valueCount);
+    kzsErrorForward(result);
+
+    *out_slot = slot;
+    kzsSuccess();
+}
+
+/** Updates float values of an uniform slot. Returns KZ_TRUE if the values have to be sent to GPU. */
+static kzBool kzcRendererUpdateUniformSlotValues_internal(struct KzcUniformSlot* slot, const kzFloat* values, kzUint valueCount)
+{
+    kzBool assignValue = KZ_TRUE;
+
+    if(valueCount <= slot->valueCapacity)
     {
-        kzsGlUniform1f(uniformLocation, value);
-        if(renderer->debugInfo.loggingEnabled)
+        if(slot->valueCount == valueCount)
+        {
+            kzUint i;
+
+            assignValue = KZ_FALSE;
+            for(i = 0; i < valueCount; ++i)
+            {
+                if(!kzsFloatIsEqual(slot->values[i], values[i]))
+                {
+                    assignValue = KZ_TRUE;
+                    break;
+                }
+            }
+        }
+
+        if(assignValue)
         {
-            ++renderer->debugInfo.uniformSendings;
+            kzsMemcpy(slot->values, values, valueCount * sizeof(kzFloat));
+            slot->valueCount = valueCount;
         }
     }
+    else
+    {
+        /* Values not fitting to the slot are always sent. */
+        slot->valueCount = 0;
+    }
 
-    kzsSuccess();
+#ifndef KZC_RENDERER_ENABLE_UNIFORM_CACHE
+    assignValue = KZ_TRUE;
+#endif
+
+    return assignValue;
 }
 
-kzsError kzcRendererSetUniformFloatArray(struct KzcRenderer* renderer, kzString uniformName, kzUint count, const kzFloat* value)
+/** Updates integer value of an uniform slot. Returns KZ_TRUE if the value has to be sent to GPU. */
+static kzBool kzcRendererUpdateUniformSlotInteger_internal(struct KzcUniformSlot* slot, kzInt value)
 {
-    kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    kzBool assignValue = !slot->integerValueValid || slot->integerValue != value;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
-    kzsErrorForward(result);
+    slot->integerValue = value;
+    slot->integerValueValid = KZ_TRUE;
+
+#ifndef KZC_RENDERER_ENABLE_UNIFORM_CACHE
+    assignValue = KZ_TRUE;
+#endif
 
-    if(uniformLocation != -1)
+    return assignValue;
+}
+
+/** Increases the uniform sending count of debug info. */
+static void kzcRendererAddUniformSending_internal(struct KzcRenderer* renderer)
+{
+    if(renderer->debugInfo.loggingEnabled)
     {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformFloatArray* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], 
-            &uniformLocation, (void**)&foundValue);
+        ++renderer->debugInfo.uniformSendings;
+    }
+}
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+/** Sets integer to an uniform slot. */
+static void kzcRendererSetUniformSlotInteger_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot, kzInt value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotInteger_internal(slot, value))
+    {
+        kzsGlUniform1i(slot->location, value);
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+/** Sets float to an uniform slot. */
+static void kzcRendererSetUniformSlotFloat_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot, kzFloat value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value, 1))
+    {
+        kzsGlUniform1f(slot->location, value);
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-            *allocatedUniformLocation = uniformLocation;
+/** Sets 2-component vector to an uniform slot. */
+static void kzcRendererSetUniformSlotVec2_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                   const struct KzcVector2* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 2))
+    {
+        kzsGlUniform2f(slot->location, kzcVector2GetX(value), kzcVector2GetY(value));
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-            kzsErrorForward(result);
-            result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, foundValue->values, 1 * count, "UniformCacheFloatArray");
-            kzsErrorForward(result);
-            kzsMemcpy(foundValue->values, value, 1 * count);
-            foundValue->floatValueCount = count;
-            foundValue->size = 1;
+/** Sets 3-component vector to an uniform slot. */
+static void kzcRendererSetUniformSlotVec3_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                   const struct KzcVector3* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 3))
+    {
+        kzsGlUniform3f(slot->location, kzcVector3GetX(value), kzcVector3GetY(value), kzcVector3GetZ(value));
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcUniformFloatArrayIsEqual_internal(foundValue, (kzFloat*)value, count))
-        {
-            kzsMemcpy(foundValue->values, value, 1 * count);
-            foundValue->floatValueCount = count;
+/** Sets 4-component vector to an uniform slot. */
+static void kzcRendererSetUniformSlotVec4_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                   const struct KzcVector4* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 4))
+    {
+        kzsGlUniform4f(slot->location, kzcVector4GetX(value), kzcVector4GetY(value), kzcVector4GetZ(value), kzcVector4GetW(value));
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-            assignValue = KZ_TRUE;
-        }
+/** Sets 2x2 matrix to an uniform slot. */
+static void kzcRendererSetUniformSlotMatrix2x2_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                        const struct KzcMatrix2x2* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 4))
+    {
+        kzsGlUniformMatrix2fv(slot->location, 1, KZ_FALSE, &value->data[0]);
+        kzcRendererAddUniformSending_internal(renderer);
+    }
+}
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniform1fv((kzInt)uniformLocation,(kzInt) count, (kzFloat*)value);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
+/** Sets 3x3 matrix to an uniform slot. */
+static void kzcRendererSetUniformSlotMatrix3x3_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                        const struct KzcMatrix3x3* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 9))
+    {
+        kzsGlUniformMatrix3fv(slot->location, 1, KZ_FALSE, &value->data[0]);
+        kzcRendererAddUniformSending_internal(renderer);
     }
+}
 
-    kzsSuccess();
+/** Sets 4x4 matrix to an uniform slot. */
+static void kzcRendererSetUniformSlotMatrix4x4_internal(struct KzcRenderer* renderer, struct KzcUniformSlot* slot,
+                                                        const struct KzcMatrix4x4* value)
+{
+    if(slot->location != -1 && kzcRendererUpdateUniformSlotValues_internal(slot, &value->data[0], 16))
+    {
+        kzsGlUniformMatrix4fv(slot->location, 1, KZ_FALSE, &value->data[0]);
+        kzcRendererAddUniformSending_internal(renderer);
+    }
 }
 
-kzsError kzcRendererSetUniformVec2(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector2* value)
+kzsError kzcRendererGetUniformLocation(const struct KzcRenderer* renderer, kzString uniformName, kzInt *out_uniformLocation)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 0, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformVec2Value* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC2],
-            &uniformLocation, (void**)&foundValue);
-
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
-
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    *out_uniformLocation = slot->location;
+    kzsSuccess();
+}
 
-            *allocatedUniformLocation = uniformLocation;
+kzsError kzcRendererSetUniformInteger(struct KzcRenderer* renderer, kzString uniformName, kzInt value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheVec3Value");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 0, &slot);
+    kzsErrorForward(result);
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC2],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcVector2IsEqual(&foundValue->value, value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+    kzcRendererSetUniformSlotInteger_internal(renderer, slot, value);
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniform2f(uniformLocation, kzcVector2GetX(value), kzcVector2GetY(value));
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformVec3(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector3* value)
+kzsError kzcRendererSetUniformFloat(struct KzcRenderer* renderer, kzString uniformName, kzFloat value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
-    kzBool assignValue = KZ_FALSE;
-    struct KzcUniformVec3Value* foundValue;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 1, &slot);
     kzsErrorForward(result);
-    if(uniformLocation != -1)
-    {
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC3], &uniformLocation, (void**)&foundValue);
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
-
-            *allocatedUniformLocation = uniformLocation;
+    kzcRendererSetUniformSlotFloat_internal(renderer, slot, value);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheVec3Value");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+    kzsSuccess();
+}
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC3], allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcVector3IsEqual(&foundValue->value, value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+kzsError kzcRendererSetUniformFloatArray(struct KzcRenderer* renderer, kzString uniformName, kzUint count, const kzFloat* value)
+{
+    kzsError result;
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniform3f(uniformLocation, kzcVector3GetX(value), kzcVector3GetY(value), kzcVector3GetZ(value));
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
+    result = kzcRendererSetUniformVecArray(renderer, uniformName, count, 1, value);
+    kzsErrorForward(result);
 
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformVecArray(struct KzcRenderer* renderer, kzString uniformName, kzUint count, kzUint dimension, const kzFloat* values)
+kzsError kzcRendererSetUniformVec2(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector2* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 2, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformFloatArray* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], &uniformLocation, (void**)&foundValue);
+    kzcRendererSetUniformSlotVec2_internal(renderer, slot, value);
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+    kzsSuccess();
+}
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+kzsError kzcRendererSetUniformVec3(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector3* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            *allocatedUniformLocation = uniformLocation;
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 3, &slot);
+    kzsErrorForward(result);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-            kzsErrorForward(result);
-            result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, foundValue->values, dimension * count * sizeof(kzFloat), "UniformCacheFloatArray");
-            kzsErrorForward(result);
-            kzsMemcpy(foundValue->values, values, dimension * count);
-            foundValue->floatValueCount = count;
-            foundValue->size = dimension;
+    kzcRendererSetUniformSlotVec3_internal(renderer, slot, value);
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcUniformFloatArrayIsEqual_internal(foundValue, values, count))
-        {
-            kzsMemcpy(foundValue->values, values, dimension * count);
-            foundValue->floatValueCount = count;
+    kzsSuccess();
+}
 
-            assignValue = KZ_TRUE;
-        }
+kzsError kzcRendererSetUniformVecArray(struct KzcRenderer* renderer, kzString uniformName, kzUint count, kzUint dimension, const kzFloat* values)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, count * dimension, &slot);
+    kzsErrorForward(result);
+
+    if(slot->location != -1)
+    {
+        slot->arrayDimension = dimension;
+        slot->arrayCount = count;
+
+        if(kzcRendererUpdateUniformSlotValues_internal(slot, values, count * dimension))
         {
             if(dimension == 1)
             {
-                kzsGlUniform1fv((kzInt)uniformLocation, (kzInt)count, values);
+                kzsGlUniform1fv(slot->location, (kzInt)count, values);
             }
             else if(dimension == 2)
             {
-                kzsGlUniform2fv((kzInt)uniformLocation, (kzInt)count, values);
+                kzsGlUniform2fv(slot->location, (kzInt)count, values);
             }
             else if(dimension == 3)
             {
-                kzsGlUniform3fv((kzInt)uniformLocation, (kzInt)count, values);
+                kzsGlUniform3fv(slot->location, (kzInt)count, values);
             }
             else if(dimension == 4)
             {
-                kzsGlUniform4fv((kzInt)uniformLocation, (kzInt)count, values);
-            }
-            
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
+                kzsGlUniform4fv(slot->location, (kzInt)count, values);
             }
+
+            kzcRendererAddUniformSending_internal(renderer);
         }
     }
+
     kzsSuccess();
 }
 
 kzsError kzcRendererSetUniformVec3Array(struct KzcRenderer* renderer, kzString uniformName, kzUint count, const struct KzcVector3* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererSetUniformVecArray(renderer, uniformName, count, 3, (const kzFloat*)value);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformFloatArray* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], &uniformLocation, (void**)&foundValue);
+    kzsSuccess();
+}
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+kzsError kzcRendererSetUniformVec4(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector4* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 4, &slot);
+    kzsErrorForward(result);
 
-            *allocatedUniformLocation = uniformLocation;
+    kzcRendererSetUniformSlotVec4_internal(renderer, slot, value);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-            kzsErrorForward(result);
-            result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, foundValue->values, 3 * count * sizeof(kzFloat), "UniformCacheFloatArray");
-            kzsErrorForward(result);
-            kzsMemcpy(foundValue->values, value, 3 * count);
-            foundValue->floatValueCount = count;
-            foundValue->size = 3;
+    kzsSuccess();
+}
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY], allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcUniformFloatArrayIsEqual_internal(foundValue, (kzFloat*)&value->data[0], count))
-        {
-            kzsMemcpy(foundValue->values, value, 3 * count);
-            foundValue->floatValueCount = count;
+kzsError kzcRendererSetUniformColorRGBA(struct KzcRenderer* renderer, kzString uniformName, const struct KzcColorRGBA* value)
+{
+    kzsError result;
+    struct KzcVector4 vector = kzcVector4(value->red, value->green, value->blue, value->alpha);
 
-            assignValue = KZ_TRUE;
-        }
+    result = kzcRendererSetUniformVec4(renderer, uniformName, &vector);
+    kzsErrorForward(result);
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniform3fv((kzInt)uniformLocation, (kzInt)count, (kzFloat*)&value->data[0]);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformVec4(struct KzcRenderer* renderer, kzString uniformName, const struct KzcVector4* value)
+kzsError kzcRendererSetUniformVec4Array(struct KzcRenderer* renderer, kzString uniformName, kzUint count, const struct KzcVector4* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererSetUniformVecArray(renderer, uniformName, count, 4, (const kzFloat*)value);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformVec4Value* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC4],
-            &uniformLocation, (void**)&foundValue);
+    kzsSuccess();
+}
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+kzsError kzcRendererSetUniformMatrix2x2(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix2x2* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    result = kzcRendererGetUniformSlot_internal(renderer, matrixName, 4, &slot);
+    kzsErrorForward(result);
 
-            *allocatedUniformLocation = uniformLocation;
+    kzcRendererSetUniformSlotMatrix2x2_internal(renderer, slot, value);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+    kzsSuccess();
+}
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_VEC4],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcVector4IsEqual(&foundValue->value, value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+kzsError kzcRendererSetUniformMatrix3x3(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix3x3* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            
-            kzsGlUniform4f(uniformLocation, kzcVector4GetX(value), kzcVector4GetY(value), kzcVector4GetZ(value), kzcVector4GetW(value));
+    result = kzcRendererGetUniformSlot_internal(renderer, matrixName, 9, &slot);
+    kzsErrorForward(result);
+
+    kzcRendererSetUniformSlotMatrix3x3_internal(renderer, slot, value);
 
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformColorRGBA(struct KzcRenderer* renderer, kzString uniformName, const struct KzcColorRGBA* value)
+kzsError kzcRendererSetUniformMatrix4x4(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix4x4* value)
 {
     kzsError result;
-    struct KzcVector4 vector = kzcVector4(value->red, value->green, value->blue, value->alpha);
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererSetUniformVec4(renderer, uniformName, &vector);
+    result = kzcRendererGetUniformSlot_internal(renderer, matrixName, 16, &slot);
     kzsErrorForward(result);
 
+    kzcRendererSetUniformSlotMatrix4x4_internal(renderer, slot, value);
+
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformVec4Array(struct KzcRenderer* renderer, kzString uniformName, kzUint count, const struct KzcVector4* value)
+kzUint kzcRendererGetUniformSlotTableStamp(const struct KzcRenderer* renderer)
+{
+    kzsAssert(kzcIsValidPointer(renderer));
+
+    return (renderer->currentUniformCache != KZ_NULL) ? renderer->currentUniformCache->stamp : 0;
+}
+
+kzsError kzcRendererGetUniformSlotIndex(const struct KzcRenderer* renderer, kzString uniformName, kzUint* out_slotIndex)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, uniformName, &uniformLocation);
+    result = kzcRendererGetUniformSlot_internal(renderer, uniformName, 0, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformFloatArray* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY],
-            &uniformLocation, (void**)&foundValue);
+    *out_slotIndex = slot->index;
+    kzsSuccess();
+}
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+kzsError kzcRendererSetUniformIntegerBySlot(struct KzcRenderer* renderer, kzUint slotIndex, kzInt value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 0, &slot);
+    kzsErrorForward(result);
 
-            *allocatedUniformLocation = uniformLocation;
+    kzcRendererSetUniformSlotInteger_internal(renderer, slot, value);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-            kzsErrorForward(result);
-            result = kzcMemoryAllocArray(renderer->uniformCacheMemoryManager, foundValue->values, 4 * count, "UniformCacheFloatArray");
-            kzsErrorForward(result);
-            kzsMemcpy(foundValue->values, value, 4 * count);
-            foundValue->floatValueCount = count;
-            foundValue->size = 4;
+    kzsSuccess();
+}
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_FLOAT_ARRAY],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcUniformFloatArrayIsEqual_internal(foundValue, (kzFloat*)&value->data[0], count))
-        {
-            kzsMemcpy(foundValue->values, value, 4 * count);
-            foundValue->floatValueCount = count;
+kzsError kzcRendererSetUniformFloatBySlot(struct KzcRenderer* renderer, kzUint slotIndex, kzFloat value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            assignValue = KZ_TRUE;
-        }
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 1, &slot);
+    kzsErrorForward(result);
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniform4fv((kzInt)uniformLocation, (kzInt)count, (kzFloat*)&value->data[0]);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
+    kzcRendererSetUniformSlotFloat_internal(renderer, slot, value);
 
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformMatrix2x2(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix2x2* value)
+kzsError kzcRendererSetUniformVec2BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector2* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, matrixName, &uniformLocation);
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 2, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformMatrix2x2Value* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX2X2],
-            &uniformLocation, (void**)&foundValue);
-
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+    kzcRendererSetUniformSlotVec2_internal(renderer, slot, value);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    kzsSuccess();
+}
 
-            *allocatedUniformLocation = uniformLocation;
+kzsError kzcRendererSetUniformVec3BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector3* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheMatrixValue");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 3, &slot);
+    kzsErrorForward(result);
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX2X2],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcMatrix2x2IsEqual(&foundValue->value, (struct KzcMatrix2x2*)value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+    kzcRendererSetUniformSlotVec3_internal(renderer, slot, value);
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniformMatrix2fv(uniformLocation, 1, KZ_FALSE, &value->data[0]);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformMatrix3x3(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix3x3* value)
+kzsError kzcRendererSetUniformVec4BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector4* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, matrixName, &uniformLocation);
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 4, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformMatrix3x3Value* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX3X3],
-            &uniformLocation, (void**)&foundValue);
-
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
-
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+    kzcRendererSetUniformSlotVec4_internal(renderer, slot, value);
 
-            *allocatedUniformLocation = uniformLocation;
+    kzsSuccess();
+}
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheMatrixValue");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+kzsError kzcRendererSetUniformColorRGBABySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcColorRGBA* value)
+{
+    kzsError result;
+    struct KzcVector4 vector = kzcVector4(value->red, value->green, value->blue, value->alpha);
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX3X3],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcMatrix3x3IsEqual(&foundValue->value, (struct KzcMatrix3x3*)value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+    result = kzcRendererSetUniformVec4BySlot(renderer, slotIndex, &vector);
+    kzsErrorForward(result);
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-        if(assignValue)
-#endif
-        {
-            kzsGlUniformMatrix3fv(uniformLocation, 1, KZ_FALSE, &value->data[0]);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
     kzsSuccess();
 }
 
-kzsError kzcRendererSetUniformMatrix4x4(struct KzcRenderer* renderer, kzString matrixName, const struct KzcMatrix4x4* value)
+kzsError kzcRendererSetUniformMatrix2x2BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix2x2* value)
 {
     kzsError result;
-    kzInt uniformLocation;
-    kzBool uniformFound;
+    struct KzcUniformSlot* slot;
 
-    result = kzcRendererGetUniformLocation(renderer, matrixName, &uniformLocation);
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 4, &slot);
     kzsErrorForward(result);
 
-    if(uniformLocation != -1)
-    {
-        kzBool assignValue = KZ_FALSE;
-        struct KzcUniformMatrix4x4Value* foundValue;
-        uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX4X4],
-            &uniformLocation, (void**)&foundValue);
+    kzcRendererSetUniformSlotMatrix2x2_internal(renderer, slot, value);
 
-        if(!uniformFound)
-        {
-            kzInt* allocatedUniformLocation;
+    kzsSuccess();
+}
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-            kzsErrorForward(result);
+kzsError kzcRendererSetUniformMatrix3x3BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix3x3* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
 
-            *allocatedUniformLocation = uniformLocation;
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 9, &slot);
+    kzsErrorForward(result);
 
-            result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheMatrixValue");
-            kzsErrorForward(result);
-            foundValue->value = *value;
+    kzcRendererSetUniformSlotMatrix3x3_internal(renderer, slot, value);
 
-            result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_MATRIX4X4],
-                allocatedUniformLocation, foundValue);
-            kzsErrorForward(result);
-            assignValue = KZ_TRUE;
-        }
-        else if(!kzcMatrix4x4IsEqual(&foundValue->value, (struct KzcMatrix4x4*)value))
-        {
-            foundValue->value = *value;
-            assignValue = KZ_TRUE;
-        }
+    kzsSuccess();
+}
 
-#ifdef KZC_RENDERER_ENABLE_UNIFORM_CACHE
-       if(assignValue)
-#endif
-        {
-            kzsGlUniformMatrix4fv(uniformLocation, 1, KZ_FALSE, &value->data[0]);
-            if(renderer->debugInfo.loggingEnabled)
-            {
-                ++renderer->debugInfo.uniformSendings;
-            }
-        }
-    }
+kzsError kzcRendererSetUniformMatrix4x4BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix4x4* value)
+{
+    kzsError result;
+    struct KzcUniformSlot* slot;
+
+    result = kzcRendererGetUniformSlotByIndex_internal(renderer, slotIndex, 16, &slot);
+    kzsErrorForward(result);
+
+    kzcRendererSetUniformSlotMatrix4x4_internal(renderer, slot, value);
 
     kzsSuccess();
 }
@@ -1806,32 +1755,35 @@ void kzcRendererCalculateProjectionCameraWorldMatrix(struct KzcRenderer* rendere
 
 kzsError kzcRendererApplyTransformation(struct KzcRenderer* renderer)
 {
-    kzsError result;
-    kzInt uniformLocation;
+    struct KzcUniformSlot** builtInSlots;
 
     kzsAssert(kzcIsValidPointer(renderer));
+    kzsAssert(renderer->currentUniformCache != KZ_NULL);
+
+    builtInSlots = renderer->currentUniformCache->builtInSlots;
 
     /* Apply necessary matrices to GPU. */
-    result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_WORLD_MATRIX, &renderer->activeMatrix[KZC_RENDERER_MATRIX_WORLD]);
-    kzsErrorForward(result);
-    result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_CAMERA_MATRIX, &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA]);
-    kzsErrorForward(result);
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_WORLD_MATRIX] != KZ_NULL)
+    {
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_WORLD_MATRIX],
+            &renderer->activeMatrix[KZC_RENDERER_MATRIX_WORLD]);
+    }
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_MATRIX] != KZ_NULL)
+    {
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_MATRIX],
+            &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA]);
+    }
 
-    result = kzcRendererGetUniformLocation(renderer, KZC_RENDERER_UNIFORM_CAMERA_POSITION, &uniformLocation);
-    kzsErrorForward(result);
-    if(uniformLocation != -1)
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_POSITION] != KZ_NULL)
     {
         struct KzcMatrix4x4 viewInverse;
         struct KzcVector3 cameraPosition;
         kzcMatrix4x4Inverse(&renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA], &viewInverse);
         cameraPosition = kzcVector3(viewInverse.data[12], viewInverse.data[13], viewInverse.data[14]);
-        result = kzcRendererSetUniformVec3(renderer, KZC_RENDERER_UNIFORM_CAMERA_POSITION, &cameraPosition);
-        kzsErrorForward(result);
+        kzcRendererSetUniformSlotVec3_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_POSITION], &cameraPosition);
     }
     
-    result = kzcRendererGetUniformLocation(renderer, KZC_RENDERER_UNIFORM_NORMAL_MATRIX, &uniformLocation);
-    kzsErrorForward(result);
-    if(uniformLocation != -1)
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_NORMAL_MATRIX] != KZ_NULL)
     {
         struct KzcMatrix4x4 inverseTranspose;
         struct KzcMatrix4x4 worldInverse;
@@ -1840,15 +1792,12 @@ kzsError kzcRendererApplyTransformation(struct KzcRenderer* renderer)
         worldInverse.data[KZC_MATRIX4X4_INDEX_TRANSLATION_Y] = 0.0f;
         worldInverse.data[KZC_MATRIX4X4_INDEX_TRANSLATION_Z] = 0.0f;
         kzcMatrix4x4Transpose(&worldInverse, &inverseTranspose);
-        result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_NORMAL_MATRIX, &inverseTranspose);
-        kzsErrorForward(result);
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_NORMAL_MATRIX], &inverseTranspose);
     }
         
     kzcMatrix4x4MultiplyAffine(&renderer->activeMatrix[KZC_RENDERER_MATRIX_WORLD], &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA], &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA_WORLD]);
     
-    result = kzcRendererGetUniformLocation(renderer, KZC_RENDERER_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX, &uniformLocation);
-    kzsErrorForward(result);
-    if(uniformLocation != -1)
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX] != KZ_NULL)
     {
         struct KzcMatrix4x4 projectionMultCameraWorld;
         kzcMatrix4x4Multiply(&renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA_WORLD],
@@ -1856,14 +1805,20 @@ kzsError kzcRendererApplyTransformation(struct KzcRenderer* renderer)
             &projectionMultCameraWorld);
         kzcRendererSetMatrix(renderer, KZC_RENDERER_MATRIX_PROJECTION_CAMERA_WORLD, &projectionMultCameraWorld);
 
-        result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX, &renderer->activeMatrix[KZC_RENDERER_MATRIX_PROJECTION_CAMERA_WORLD]);
-        kzsErrorForward(result);
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_CAMERA_WORLD_MATRIX],
+            &renderer->activeMatrix[KZC_RENDERER_MATRIX_PROJECTION_CAMERA_WORLD]);
     }
 
-    result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_PROJECTION_MATRIX, &renderer->activeMatrix[KZC_RENDERER_MATRIX_PROJECTION]);
-    kzsErrorForward(result);
-    result = kzcRendererSetUniformMatrix4x4(renderer, KZC_RENDERER_UNIFORM_CAMERA_WORLD_MATRIX, &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA_WORLD]);
-    kzsErrorForward(result);
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_MATRIX] != KZ_NULL)
+    {
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_PROJECTION_MATRIX],
+            &renderer->activeMatrix[KZC_RENDERER_MATRIX_PROJECTION]);
+    }
+    if(builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_WORLD_MATRIX] != KZ_NULL)
+    {
+        kzcRendererSetUniformSlotMatrix4x4_internal(renderer, builtInSlots[KZC_RENDERER_BUILT_IN_UNIFORM_CAMERA_WORLD_MATRIX],
+            &renderer->activeMatrix[KZC_RENDERER_MATRIX_CAMERA_WORLD]);
+    }
 
     kzsSuccess();
 }
@@ -2062,41 +2017,14 @@ kzsError kzcRendererApplyTexture(struct KzcRenderer* renderer, kzUint textureHan
         /* Apply texture */
         if(renderer->currentTextureUniform != KZ_NULL)
         {
-            kzInt uniformLocation;
-            kzBool uniformFound;
-            kzBool assignValue = KZ_FALSE;
-            struct KzcUniformSamplerValue* foundValue;
+            struct KzcUniformSlot* slot;
 
-            result = kzcRendererGetUniformLocation(renderer, renderer->currentTextureUniform, &uniformLocation);
+            result = kzcRendererGetUniformSlot_internal(renderer, renderer->currentTextureUniform, 0, &slot);
             kzsErrorForward(result);
-            uniformFound = kzcHashMapGet(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_SAMPLER], &uniformLocation, (void**)&foundValue);
-
-            if(!uniformFound)
-            {
-                kzInt* allocatedUniformLocation;
-
-                result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, allocatedUniformLocation, "");
-                kzsErrorForward(result);
 
-                *allocatedUniformLocation = uniformLocation;
-
-                result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, foundValue, "UniformCacheSamplerValue");
-                kzsErrorForward(result);
-                foundValue->value = renderer->activeTextureUnit;
-
-                result = kzcHashMapPut(renderer->currentUniformCache->uniformCache[KZC_RENDERER_UNIFORM_CACHE_SAMPLER], allocatedUniformLocation, foundValue);
-                kzsErrorForward(result);
-                assignValue = KZ_TRUE;
-            }
-            else if(foundValue->value != renderer->activeTextureUnit)
-            {
-                foundValue->value = renderer->activeTextureUnit;
-                assignValue = KZ_TRUE;
-            }
-
-            if(assignValue)
+            if(slot->location != -1 && kzcRendererUpdateUniformSlotInteger_internal(slot, (kzInt)renderer->activeTextureUnit))
             {
-                kzsGlUniform1i(uniformLocation, (kzInt)renderer->activeTextureUnit);
+                kzsGlUniform1i(slot->location, (kzInt)renderer->activeTextureUnit);
             }
         }
         else
@@ -2165,8 +2093,6 @@ kzsError kzcRendererSetActiveShaderHandle(struct KzcRenderer* renderer, kzUint a
     kzsError result;
     if(renderer->activeShaderHandle != activeShaderHandle)
     {
-        kzUint i;
-
         renderer->activeShaderHandle = activeShaderHandle;
         kzsGlUseProgram(activeShaderHandle);
         
@@ -2181,19 +2107,7 @@ kzsError kzcRendererSetActiveShaderHandle(struct KzcRenderer* renderer, kzUint a
             {
                 kzU32* value;
 
-                result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, renderer->currentUniformCache,
-                    "UniformCacheEntry");
-                kzsErrorForward(result);
-
-                for(i = 0; i < KZC_RENDERER_UNIFORM_CACHE_COUNT; ++i)
-                {
-                    result = kzcHashMapCreate(renderer->uniformCacheMemoryManager, KZC_HASH_MAP_CONFIGURATION_INT,
-                        &renderer->currentUniformCache->uniformCache[i]);
-                    kzsErrorForward(result);
-                }
-
-                result = kzcHashMapCreate(renderer->uniformCacheMemoryManager, KZC_HASH_MAP_CONFIGURATION_STRING,
-                    &renderer->currentUniformCache->uniformLocationCache);
+                result = kzcRendererCreateUniformCache_internal(renderer, activeShaderHandle, &renderer->currentUniformCache);
                 kzsErrorForward(result);
 
                 result = kzcMemoryAllocVariable(renderer->uniformCacheMemoryManager, value,
@@ -2201,7 +2115,7 @@ kzsError kzcRendererSetActiveShaderHandle(struct KzcRenderer* renderer, kzUint a
                 kzsErrorForward(result);
 
                 *value = (kzU32)activeShaderHandle;
-                /* Active shader handle now contains cache of floats. */
+                /* Active shader handle now contains its uniform slot table. */
                 result = kzcHashMapPut(renderer->uniformCaches, value, renderer->currentUniformCache);
                 kzsErrorForward(result);
             }
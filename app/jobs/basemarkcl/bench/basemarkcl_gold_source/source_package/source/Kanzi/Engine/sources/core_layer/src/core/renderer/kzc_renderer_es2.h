@@ -24,6 +24,9 @@
 /** Size of the uniform cache. */
 #define KZC_RENDERER_UNIFORM_CACHE_SIZE     150000
 
+/** The renderer resolves uniforms into per-program slot tables and can set them by slot index. */
+#define KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS
+
 /* Maximum number of supported texture units. */
 #define KZC_RENDERER_MAX_TEXTURE_UNITS      5
 
@@ -331,6 +334,32 @@ kzsError kzcRendererSetUniformMatrix4x4(struct KzcRenderer* renderer, kzString m
 /** Sets texture uniform for renderer, using currently bound shader. */
 void kzcRendererSetUniformTexture(struct KzcRenderer* renderer, kzString textureName);
 
+/**
+ * Returns the stamp of the uniform slot table of the active shader, 0 if no shader is active.
+ * Slot indices stay valid as long as the stamp does not change. Switching shaders or resetting the renderer changes it.
+ */
+kzUint kzcRendererGetUniformSlotTableStamp(const struct KzcRenderer* renderer);
+/** Resolves the index of the given uniform in the slot table of the active shader. */
+kzsError kzcRendererGetUniformSlotIndex(const struct KzcRenderer* renderer, kzString uniformName, kzUint* out_slotIndex);
+/** Sets integer uniform by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformIntegerBySlot(struct KzcRenderer* renderer, kzUint slotIndex, kzInt value);
+/** Sets float uniform by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformFloatBySlot(struct KzcRenderer* renderer, kzUint slotIndex, kzFloat value);
+/** Sets uniform vec2 by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformVec2BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector2* value);
+/** Sets uniform vec3 by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformVec3BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector3* value);
+/** Sets uniform vec4 by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformVec4BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcVector4* value);
+/** Sets uniform colorRGBA by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformColorRGBABySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcColorRGBA* value);
+/** Sets matrix2x2 uniform by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformMatrix2x2BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix2x2* value);
+/** Sets matrix3x3 uniform by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformMatrix3x3BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix3x3* value);
+/** Sets matrix4x4 uniform by slot index, using currently bound shader. */
+kzsError kzcRendererSetUniformMatrix4x4BySlot(struct KzcRenderer* renderer, kzUint slotIndex, const struct KzcMatrix4x4* value);
+
 
 /** Sets an active color slot value for renderer. */
 void kzcRendererSetActiveColor(struct KzcRenderer* renderer, enum KzcRendererColor color, struct KzcColorRGBA colorRGBA);
@@ -3,6 +3,13 @@
  * Hash map.
  * 
  * Hash map implemented using open addressing for dealing with hash collisions.
+ *
+ * Linear table stores a used flag in each entry and probes the entries one by one.
+ * Grouped table stores a control byte for each entry in a separate array. A control byte is either empty or 7 bits of
+ * the hash of the key in the entry, so that a group of 16 control bytes can be compared to the hash at once before
+ * comparing any keys. The table size is a power of two and the control bytes of the first group are cloned after the
+ * end of the array so that a group can start at any entry. Entries are kept contiguous from their home position up to
+ * the next empty entry, so removal shifts the following entries backwards instead of leaving deleted markers.
  * 
  * Copyright 2008-2011 by Rightware. All rights reserved.
  */
@@ -15,11 +22,18 @@
 #include <system/wrappers/kzs_math.h>
 #include <system/debug/kzs_counter.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KZC_HASH_MAP_GROUP_SSE2 /**< Control byte groups are compared with SSE2 instructions. */
+#include <emmintrin.h>
+#endif
 
-const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_INT = {kzcHashCodeFromInt, kzcCompareInts};
-const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_U32 = {kzcHashCodeFromU32, kzcCompareU32s};
-const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_POINTER = {kzcHashCodeFromPointer, kzcComparePointers};
-const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_STRING = {kzcHashCodeFromString, kzcCompareStrings};
+
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_INT = {kzcHashCodeFromInt, kzcCompareInts, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_U32 = {kzcHashCodeFromU32, kzcCompareU32s, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_POINTER = {kzcHashCodeFromPointer, kzcComparePointers, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_STRING = {kzcHashCodeFromString, kzcCompareStrings, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_POINTER_GROUPED = {kzcHashCodeFromPointer, kzcComparePointers, KZC_HASH_MAP_TABLE_TYPE_GROUPED};
+const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_STRING_GROUPED = {kzcHashCodeFromString, kzcCompareStrings, KZC_HASH_MAP_TABLE_TYPE_GROUPED};
 
 
 /**
@@ -42,18 +56,30 @@ struct KzcHashMapOrderedEntry
     struct KzcHashMapOrderedEntry* next; /**< Next hash map entry. */
 };
 
+/**
+ * Hash map entry of one key -> value pair for grouped table.
+ */
+struct KzcHashMapGroupedEntry
+{
+    struct KzcHashMapEntry parent; /**< For inheritance. */
+    kzU32 hash; /**< Mixed hash of the key. */
+};
+
 typedef union
 {
     struct KzcHashMapEntry* unordered;   /**< The internal table of normal hash map. */
     struct KzcHashMapOrderedEntry* ordered;   /**< The internal table of ordered hash map. */
+    struct KzcHashMapGroupedEntry* grouped;   /**< The internal table of grouped hash map. */
 } KzcHashMapTable; /**< Hash map table definiotion. */
 
 struct KzcHashMap
 {
     struct KzcHashMapConfiguration configuration; /**< Hash map configuration. */
     kzBool isOrdered; /**< Is this hash map ordered or not. */
+    kzBool isGrouped; /**< Does this hash map use grouped table or not. */
 
     KzcHashMapTable table; /**< Hash map entries. */
+    kzU8* controlBytes; /**< Control byte of each entry of grouped table, followed by clone of the first group. */
     kzUint tableSize;                /**< The length of 'table'. */
     kzUint maxSize;                  /**< Maximum number of entries storable in 'table'. */
     kzUint size;                     /**< Current number of used entries stored in the map. */
@@ -76,6 +102,13 @@ struct KzcHashMap
  */
 #define KZC_HASH_MAP_MAXIMUM_LOAD_FACTOR 0.75f
 
+/** Number of control bytes compared at once in grouped table. Also the minimum size of the grouped table. */
+#define KZC_HASH_MAP_GROUP_SIZE 16
+/** Control byte of an empty entry in grouped table. Control bytes of used entries have the highest bit cleared. */
+#define KZC_HASH_MAP_CONTROL_EMPTY 0x80
+/** Bit mask for 32 bit arithmetic, as kzU32 may be wider. */
+#define KZC_HASH_MAP_HASH_MASK 0xFFFFFFFFu
+
 
 /** Return actual entry from hash map corresponging for key. */
 static struct KzcHashMapEntry* kzcHashMapGetEntryForKey_internal(const struct KzcHashMap* HashMap, const void* key);
@@ -117,6 +150,276 @@ static kzsError kzcHashMapGetRequiredSize_internal(const kzUint entryCount, kzUi
     kzsSuccess();
 }
 
+/** Return the power of two size of grouped table required to hold entryCount number of entries. */
+static kzsError kzcHashMapGroupedGetRequiredSize_internal(kzUint entryCount, kzUint* out_size, kzUint* out_maxSize)
+{
+    kzUint size = KZC_HASH_MAP_GROUP_SIZE;
+    kzUint maxSize = size - size / 8;
+
+    /* Entries are probed in groups, so a higher load factor than with linear table is fine. */
+    while (maxSize < entryCount)
+    {
+        kzsErrorTest(size <= KZC_HASH_MAP_HASH_MASK / 2, KZS_ERROR_ILLEGAL_ARGUMENT, "Hash map maximum possible capacity exceeded");
+        size *= 2;
+        maxSize = size - size / 8;
+    }
+
+    *out_size = size;
+    *out_maxSize = maxSize;
+    kzsSuccess();
+}
+
+/** Allocates entries and empty control bytes for grouped table of given size. */
+static kzsError kzcHashMapGroupedAllocateTable_internal(const struct KzcMemoryManager* memoryManager, kzUint tableSize,
+                                                        struct KzcHashMapGroupedEntry** out_entries, kzU8** out_controlBytes)
+{
+    kzsError result;
+    struct KzcHashMapGroupedEntry* entries;
+    kzU8* controlBytes;
+    kzUint i;
+
+    result = kzcMemoryAllocArray(memoryManager, entries, tableSize, "HashMap table");
+    kzsErrorForward(result);
+
+    result = kzcMemoryAllocArray(memoryManager, controlBytes, tableSize + KZC_HASH_MAP_GROUP_SIZE - 1, "HashMap control bytes");
+    kzsErrorForward(result);
+
+    for (i = 0; i < tableSize + KZC_HASH_MAP_GROUP_SIZE - 1; ++i)
+    {
+        controlBytes[i] = KZC_HASH_MAP_CONTROL_EMPTY;
+    }
+
+    *out_entries = entries;
+    *out_controlBytes = controlBytes;
+    kzsSuccess();
+}
+
+/** Mixes the bits of the hash code given by the configuration, as the hash codes of pointers and integers have weak low bits. */
+static kzU32 kzcHashMapGroupedHash_internal(const struct KzcHashMap* hashMap, const void* key)
+{
+    kzU32 hash = hashMap->configuration.hashFunction(key) & KZC_HASH_MAP_HASH_MASK;
+
+    hash ^= hash >> 16;
+    hash = (hash * 0x85EBCA6Bu) & KZC_HASH_MAP_HASH_MASK;
+    hash ^= hash >> 13;
+    hash = (hash * 0xC2B2AE35u) & KZC_HASH_MAP_HASH_MASK;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+/** Returns the control byte for an entry with given hash. The low bits of the hash select the home entry, so the highest 7 bits are used. */
+static kzU8 kzcHashMapGroupedControlByte_internal(kzU32 hash)
+{
+    return (kzU8)((hash >> 25) & 0x7F);
+}
+
+/** Sets the control byte of an entry, including its clone after the end of the table. */
+static void kzcHashMapGroupedSetControlByte_internal(const struct KzcHashMap* hashMap, kzUint index, kzU8 controlByte)
+{
+    hashMap->controlBytes[index] = controlByte;
+    if (index < KZC_HASH_MAP_GROUP_SIZE - 1)
+    {
+        hashMap->controlBytes[hashMap->tableSize + index] = controlByte;
+    }
+}
+
+/** Returns bit mask of the control bytes in the group starting from given control byte that are equal to value. */
+static kzUint kzcHashMapGroupedMatch_internal(const kzU8* group, kzU8 value)
+{
+    kzUint mask;
+#ifdef KZC_HASH_MAP_GROUP_SSE2
+    __m128i controlBytes = _mm_loadu_si128((const __m128i*)group);
+    mask = (kzUint)_mm_movemask_epi8(_mm_cmpeq_epi8(controlBytes, _mm_set1_epi8((char)value)));
+#else
+    /* Compare four control bytes at a time within an integer. */
+    kzUint i;
+    mask = 0;
+    for (i = 0; i < KZC_HASH_MAP_GROUP_SIZE; i += 4)
+    {
+        kzUint word = (kzUint)group[i] | ((kzUint)group[i + 1] << 8) | ((kzUint)group[i + 2] << 16) | ((kzUint)group[i + 3] << 24);
+        kzUint highBits;
+
+        if (value == KZC_HASH_MAP_CONTROL_EMPTY)
+        {
+            /* Only empty control bytes have the highest bit set. */
+            highBits = word & 0x80808080u;
+        }
+        else
+        {
+            /* Zero bytes after xor are detected exactly, apart from bytes above a zero byte, which only cause extra key comparisons. */
+            word ^= value * 0x01010101u;
+            highBits = (word - 0x01010101u) & ~word & 0x80808080u;
+        }
+        mask |= (((highBits >> 7) & 1u) | ((highBits >> 14) & 2u) | ((highBits >> 21) & 4u) | ((highBits >> 28) & 8u)) << i;
+    }
+#endif
+    return mask;
+}
+
+/** Returns index of the lowest set bit of a non-zero mask. */
+static kzUint kzcHashMapGroupedLowestBit_internal(kzUint mask)
+{
+    kzUint bit;
+
+    kzsAssert(mask != 0);
+
+#if defined(__GNUC__)
+    bit = (kzUint)__builtin_ctz(mask);
+#else
+    bit = 0;
+    while ((mask & 1u) == 0)
+    {
+        mask >>= 1;
+        ++bit;
+    }
+#endif
+
+    return bit;
+}
+
+/** Returns the index of the entry with given key and hash in grouped table, or tableSize if the key is not found. */
+static kzUint kzcHashMapGroupedFind_internal(const struct KzcHashMap* hashMap, const void* key, kzU32 hash)
+{
+    kzUint tableSize = hashMap->tableSize;
+    kzUint indexMask = tableSize - 1;
+    kzUint index = (kzUint)hash & indexMask;
+    kzU8 controlByte = kzcHashMapGroupedControlByte_internal(hash);
+    KzcComparatorFunction comparator = hashMap->configuration.keyComparator;
+    kzUint foundIndex = tableSize;
+    kzBool searching = KZ_TRUE;
+
+    /* The key is located between its home entry and the next empty entry. There is always an empty entry, as the table is never full. */
+    while (searching)
+    {
+        const kzU8* group = &hashMap->controlBytes[index];
+        kzUint matches = kzcHashMapGroupedMatch_internal(group, controlByte);
+
+        while (matches != 0)
+        {
+            kzUint entryIndex = (index + kzcHashMapGroupedLowestBit_internal(matches)) & indexMask;
+            const struct KzcHashMapGroupedEntry* entry = &hashMap->table.grouped[entryIndex];
+            if (entry->hash == hash && comparator(entry->parent.key, key) == 0)
+            {
+                foundIndex = entryIndex;
+                matches = 0;
+                searching = KZ_FALSE;
+            }
+            else
+            {
+                matches &= matches - 1;
+            }
+        }
+
+        if (searching)
+        {
+            if (kzcHashMapGroupedMatch_internal(group, KZC_HASH_MAP_CONTROL_EMPTY) != 0)
+            {
+                searching = KZ_FALSE;
+            }
+            else
+            {
+                index = (index + KZC_HASH_MAP_GROUP_SIZE) & indexMask;
+            }
+        }
+    }
+
+    return foundIndex;
+}
+
+/** Inserts an entry to grouped table. The key must not be in the table and the table must have room for it. */
+static void kzcHashMapGroupedInsert_internal(struct KzcHashMap* hashMap, kzU32 hash, const void* key, void* value)
+{
+    kzUint indexMask = hashMap->tableSize - 1;
+    kzUint index = (kzUint)hash & indexMask;
+    kzUint emptyEntries = kzcHashMapGroupedMatch_internal(&hashMap->controlBytes[index], KZC_HASH_MAP_CONTROL_EMPTY);
+    struct KzcHashMapGroupedEntry* entry;
+
+    kzsAssert(hashMap->size < hashMap->maxSize);
+
+    while (emptyEntries == 0)
+    {
+        index = (index + KZC_HASH_MAP_GROUP_SIZE) & indexMask;
+        emptyEntries = kzcHashMapGroupedMatch_internal(&hashMap->controlBytes[index], KZC_HASH_MAP_CONTROL_EMPTY);
+    }
+    index = (index + kzcHashMapGroupedLowestBit_internal(emptyEntries)) & indexMask;
+
+    entry = &hashMap->table.grouped[index];
+    entry->hash = hash;
+    entry->parent.key = key;
+    entry->parent.value = value;
+    entry->parent.isUsed = KZ_TRUE;
+    kzcHashMapGroupedSetControlByte_internal(hashMap, index, kzcHashMapGroupedControlByte_internal(hash));
+    ++hashMap->size;
+}
+
+/** Doubles the size of grouped table if it is full. Stored hashes are reused, so the hash function is not called. */
+static kzsError kzcHashMapGroupedGrowIfFull_internal(struct KzcHashMap* hashMap)
+{
+    kzsError result;
+
+    if (hashMap->size == hashMap->maxSize)
+    {
+        kzUint oldTableSize = hashMap->tableSize;
+        struct KzcHashMapGroupedEntry* oldEntries = hashMap->table.grouped;
+        kzU8* oldControlBytes = hashMap->controlBytes;
+        kzUint i;
+
+        result = kzcHashMapGroupedGetRequiredSize_internal(hashMap->size + 1, &hashMap->tableSize, &hashMap->maxSize);
+        kzsErrorForward(result);
+
+        result = kzcHashMapGroupedAllocateTable_internal(kzcMemoryGetManager(hashMap), hashMap->tableSize, &hashMap->table.grouped, &hashMap->controlBytes);
+        kzsErrorForward(result);
+
+        hashMap->size = 0;
+        for (i = 0; i < oldTableSize; ++i)
+        {
+            if (oldControlBytes[i] != KZC_HASH_MAP_CONTROL_EMPTY)
+            {
+                kzcHashMapGroupedInsert_internal(hashMap, oldEntries[i].hash, oldEntries[i].parent.key, oldEntries[i].parent.value);
+            }
+        }
+
+        result = kzcMemoryFreeArray(oldEntries);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(oldControlBytes);
+        kzsErrorForward(result);
+    }
+
+    kzsCounterIncrease("kzcHashMapGrowIfFull_internal");
+    kzsSuccess();
+}
+
+/**
+ * Removes entry at given index from grouped table.
+ * Following entries up to the next empty entry are shifted backwards, unless their home entry is after the emptied entry.
+ */
+static void kzcHashMapGroupedRemoveAt_internal(struct KzcHashMap* hashMap, kzUint index)
+{
+    kzUint indexMask = hashMap->tableSize - 1;
+    kzUint emptyIndex = index;
+    kzUint nextIndex = (index + 1) & indexMask;
+
+    while (hashMap->controlBytes[nextIndex] != KZC_HASH_MAP_CONTROL_EMPTY)
+    {
+        const struct KzcHashMapGroupedEntry* nextEntry = &hashMap->table.grouped[nextIndex];
+        kzUint homeIndex = (kzUint)nextEntry->hash & indexMask;
+
+        /* Move the entry if the emptied entry is between its home entry and the entry itself. */
+        if (((nextIndex - homeIndex) & indexMask) >= ((nextIndex - emptyIndex) & indexMask))
+        {
+            hashMap->table.grouped[emptyIndex] = *nextEntry;
+            kzcHashMapGroupedSetControlByte_internal(hashMap, emptyIndex, hashMap->controlBytes[nextIndex]);
+            emptyIndex = nextIndex;
+        }
+        nextIndex = (nextIndex + 1) & indexMask;
+    }
+
+    hashMap->table.grouped[emptyIndex].parent.isUsed = KZ_FALSE;
+    kzcHashMapGroupedSetControlByte_internal(hashMap, emptyIndex, KZC_HASH_MAP_CONTROL_EMPTY);
+    --hashMap->size;
+}
+
 static kzsError kzcHashMapCreateWithCapacity_internal(const struct KzcMemoryManager* memoryManager,
                                                       struct KzcHashMapConfiguration configuration,
                                                       kzUint capacity, kzBool ordered, struct KzcHashMap** out_hashMap)
@@ -133,14 +436,29 @@ static kzsError kzcHashMapCreateWithCapacity_internal(const struct KzcMemoryMana
     kzsErrorForward(result);
 
     hashMap->isOrdered = ordered;
+    hashMap->isGrouped = !ordered && configuration.tableType == KZC_HASH_MAP_TABLE_TYPE_GROUPED;
     hashMap->configuration = configuration;
+    hashMap->controlBytes = KZ_NULL;
 
     /* Get size of internal array that can store sizeHint number of entries and allocate memory for internal table.*/
-    result = kzcHashMapGetRequiredSize_internal(capacity, &(hashMap->tableSize), &(hashMap->maxSize));
-    kzsErrorForward(result);
+    if (hashMap->isGrouped)
+    {
+        result = kzcHashMapGroupedGetRequiredSize_internal(capacity, &hashMap->tableSize, &hashMap->maxSize);
+        kzsErrorForward(result);
+    }
+    else
+    {
+        result = kzcHashMapGetRequiredSize_internal(capacity, &(hashMap->tableSize), &(hashMap->maxSize));
+        kzsErrorForward(result);
+    }
 
     /* Allocate the internal array. */
-    if (ordered)
+    if (hashMap->isGrouped)
+    {
+        result = kzcHashMapGroupedAllocateTable_internal(memoryManager, hashMap->tableSize, &hashMap->table.grouped, &hashMap->controlBytes);
+        kzsErrorForward(result);
+    }
+    else if (ordered)
     {
         result = kzcMemoryAllocArray(memoryManager, hashMap->table.ordered, hashMap->tableSize, "HashMap table");
         kzsErrorForward(result);
@@ -216,7 +534,14 @@ kzsError kzcHashMapDelete(struct KzcHashMap* hashMap)
 
     /* Free memory used by hash map. */
 
-    if (hashMap->isOrdered)
+    if (hashMap->isGrouped)
+    {
+        result = kzcMemoryFreeArray(hashMap->table.grouped);
+        kzsErrorForward(result);
+        result = kzcMemoryFreeArray(hashMap->controlBytes);
+        kzsErrorForward(result);
+    }
+    else if (hashMap->isOrdered)
     {
         result = kzcMemoryFreeArray(hashMap->table.ordered);
         kzsErrorForward(result);
@@ -245,6 +570,10 @@ void kzcHashMapClear(struct KzcHashMap* hashMap)
         {
             entry = &hashMap->table.ordered[i].parent;
         }
+        else if (hashMap->isGrouped)
+        {
+            entry = &hashMap->table.grouped[i].parent;
+        }
         else
         {
             entry = &hashMap->table.unordered[i];
@@ -254,6 +583,14 @@ void kzcHashMapClear(struct KzcHashMap* hashMap)
         entry->isUsed = KZ_FALSE;
     }
 
+    if (hashMap->isGrouped)
+    {
+        for (i = 0; i < hashMap->tableSize + KZC_HASH_MAP_GROUP_SIZE - 1; ++i)
+        {
+            hashMap->controlBytes[i] = KZC_HASH_MAP_CONTROL_EMPTY;
+        }
+    }
+
     hashMap->maxNumberOfOverloads = 0;
     hashMap->size = 0;
     hashMap->first = KZ_NULL;
@@ -422,19 +759,40 @@ kzsError kzcHashMapPut(struct KzcHashMap* hashMap, const void* key, void* value)
 
     kzsAssert(hashMap != KZ_NULL);
 
-    entry = kzcHashMapGetEntryForKey_internal(hashMap, key);
-
-    if (entry != KZ_NULL)
+    if (hashMap->isGrouped)
     {
-        entry->key = key;
-        entry->value = value;
+        kzU32 hash = kzcHashMapGroupedHash_internal(hashMap, key);
+        kzUint index = kzcHashMapGroupedFind_internal(hashMap, key, hash);
+
+        if (index < hashMap->tableSize)
+        {
+            hashMap->table.grouped[index].parent.key = key;
+            hashMap->table.grouped[index].parent.value = value;
+        }
+        else
+        {
+            /* The hash is computed only once also when inserting. */
+            result = kzcHashMapGroupedGrowIfFull_internal(hashMap);
+            kzsErrorForward(result);
+            kzcHashMapGroupedInsert_internal(hashMap, hash, key, value);
+        }
     }
     else
     {
-        /* Key was not found in table, now we need to ensure that we have space left for one more entry. */
-        result = kzcHashMapGrowIfFull_internal(hashMap);
-        kzsErrorForward(result);
-        kzcHashMapInsert_internal(hashMap, key, value);
+        entry = kzcHashMapGetEntryForKey_internal(hashMap, key);
+
+        if (entry != KZ_NULL)
+        {
+            entry->key = key;
+            entry->value = value;
+        }
+        else
+        {
+            /* Key was not found in table, now we need to ensure that we have space left for one more entry. */
+            result = kzcHashMapGrowIfFull_internal(hashMap);
+            kzsErrorForward(result);
+            kzcHashMapInsert_internal(hashMap, key, value);
+        }
     }
 
     kzsSuccess();
@@ -451,8 +809,15 @@ kzsError kzcHashMapRemove(struct KzcHashMap* hashMap, const void* key)
 
     kzsErrorTest(entry != KZ_NULL, KZS_ERROR_ILLEGAL_ARGUMENT, "Hash map did no contain given key to remove");
 
-    entry->isUsed = KZ_FALSE;
-    --hashMap->size;
+    if (hashMap->isGrouped)
+    {
+        kzcHashMapGroupedRemoveAt_internal(hashMap, (kzUint)((struct KzcHashMapGroupedEntry*)entry - hashMap->table.grouped));
+    }
+    else
+    {
+        entry->isUsed = KZ_FALSE;
+        --hashMap->size;
+    }
 
     if (hashMap->isOrdered)
     {
@@ -575,24 +940,35 @@ static struct KzcHashMapEntry* kzcHashMapGetEntryForKey_internal(const struct Kz
     numberOfOverloads   = hashMap->maxNumberOfOverloads;
     comparator          = hashMap->configuration.keyComparator;
 
-    /* Calculate initial position in table. */
-    keyHashValue = hashMap->configuration.hashFunction(key);
-
-    for (i = 0; i <= numberOfOverloads; ++i)
+    if (hashMap->isGrouped)
     {
-        kzUint index = ((kzUint)keyHashValue + i) % tableSize;
-        if (hashMap->isOrdered)
-        {
-            entry = &hashMap->table.ordered[index].parent;
-        }
-        else
+        kzUint index = kzcHashMapGroupedFind_internal(hashMap, key, kzcHashMapGroupedHash_internal(hashMap, key));
+        if (index < tableSize)
         {
-            entry = &hashMap->table.unordered[index];
+            result = &hashMap->table.grouped[index].parent;
         }
-        if (entry->isUsed && comparator(entry->key, key) == 0)
+    }
+    else
+    {
+        /* Calculate initial position in table. */
+        keyHashValue = hashMap->configuration.hashFunction(key);
+
+        for (i = 0; i <= numberOfOverloads; ++i)
         {
-            result = entry;
-            break;
+            kzUint index = ((kzUint)keyHashValue + i) % tableSize;
+            if (hashMap->isOrdered)
+            {
+                entry = &hashMap->table.ordered[index].parent;
+            }
+            else
+            {
+                entry = &hashMap->table.unordered[index];
+            }
+            if (entry->isUsed && comparator(entry->key, key) == 0)
+            {
+                result = entry;
+                break;
+            }
         }
     }
 
@@ -640,7 +1016,9 @@ kzBool kzcHashMapIterate_private(struct KzcHashMapIterator* iterator)
         /* Find next entry in use and pass reference to it. */
         for (i = (kzUint)(iterator->data.tableIndex_private + 1); i < iterator->map_private->tableSize; ++i)
         {
-            if (iterator->map_private->table.unordered[i].isUsed)
+            if (iterator->map_private->isGrouped ?
+                iterator->map_private->controlBytes[i] != KZC_HASH_MAP_CONTROL_EMPTY :
+                iterator->map_private->table.unordered[i].isUsed)
             {
                 iterator->data.tableIndex_private = (kzInt)i;
                 result = KZ_TRUE;
@@ -661,6 +1039,10 @@ const void* kzcHashMapIteratorGetKey_private(const struct KzcHashMapIterator* it
     {
         result = iterator->data.entry_private->parent.key;
     }
+    else if (iterator->map_private->isGrouped)
+    {
+        result = iterator->map_private->table.grouped[iterator->data.tableIndex_private].parent.key;
+    }
     else
     {
         result = iterator->map_private->table.unordered[iterator->data.tableIndex_private].key;
@@ -677,6 +1059,10 @@ void* kzcHashMapIteratorGetValue_private(const struct KzcHashMapIterator* iterat
     {
         result = iterator->data.entry_private->parent.value;
     }
+    else if (iterator->map_private->isGrouped)
+    {
+        result = iterator->map_private->table.grouped[iterator->data.tableIndex_private].parent.value;
+    }
     else
     {
         result = iterator->map_private->table.unordered[iterator->data.tableIndex_private].value;
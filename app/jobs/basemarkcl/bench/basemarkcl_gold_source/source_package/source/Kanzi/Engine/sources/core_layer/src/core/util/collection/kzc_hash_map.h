@@ -49,6 +49,18 @@ struct KzcHashMapIterator
     } data; /**< Used for tracking position of the iterator. */
 };
 
+/** Type of the internal table of a HashMap. */
+enum KzcHashMapTableType
+{
+    KZC_HASH_MAP_TABLE_TYPE_LINEAR, /**< Entries with used flag, probed one by one. Entries may be removed during iteration. */
+    /**
+     * Entries with a control byte each, probed 16 control bytes at a time. Full hashes are stored, so the hash function
+     * is called once per operation and never when the table grows. Removing shifts following entries backwards instead of
+     * leaving deleted markers, so entries must not be removed during iteration. Ordered hash maps always use linear table.
+     */
+    KZC_HASH_MAP_TABLE_TYPE_GROUPED
+};
+
 /**
  * Configuration parameters for a HashMap. The configuration specifies what type of keys are used in the hash map.
  * The most common configurations are KZC_HASH_MAP_CONFIGURATION_POINTER, if the keys are arbitrary pointers and
@@ -59,11 +71,14 @@ struct KzcHashMapIterator
  * \see KZC_HASH_MAP_CONFIGURATION_U32
  * \see KZC_HASH_MAP_CONFIGURATION_POINTER
  * \see KZC_HASH_MAP_CONFIGURATION_STRING
+ * \see KZC_HASH_MAP_CONFIGURATION_POINTER_GROUPED
+ * \see KZC_HASH_MAP_CONFIGURATION_STRING_GROUPED
  */
 struct KzcHashMapConfiguration
 {
     KzcHashFunction hashFunction; /**< Returns a hash code for the specified key. */
     KzcComparatorFunction keyComparator; /**< Comparator for the key. */
+    enum KzcHashMapTableType tableType; /**< Type of the internal table. */
 };
 
 
@@ -75,6 +90,10 @@ extern const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_U32;
 extern const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_POINTER;
 /** Configuration for hash maps where key type is a pointer to string. */
 extern const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_STRING;
+/** Configuration for hash maps with grouped table where key type is arbitrary pointer. */
+extern const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_POINTER_GROUPED;
+/** Configuration for hash maps with grouped table where key type is a pointer to string. */
+extern const struct KzcHashMapConfiguration KZC_HASH_MAP_CONFIGURATION_STRING_GROUPED;
 
 
 /** Creates a new initially empty hash map. Stores key-value pairs. Initial capacity is given as a parameter. configuration specifies what type of keys are used in the map. */
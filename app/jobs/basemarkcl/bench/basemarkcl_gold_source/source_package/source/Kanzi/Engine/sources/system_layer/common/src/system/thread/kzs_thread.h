@@ -24,10 +24,19 @@ struct KzsThread;
  */
 struct KzsThreadLock;
 
+/**
+ * \struct KzsThreadLocalStorage
+ * Storage holding a separate pointer value for each thread.
+ */
+struct KzsThreadLocalStorage;
+
 
 /** Thread execution function type. */
 typedef kzsError (*KzsThreadRunner)(void* userData);
 
+/** Destructor of thread local storage values. Called with the value of a thread when the thread exits. */
+typedef void (*KzsThreadLocalStorageDestructor)(void* value);
+
 
 /**
  * Creates a thread using the given runner function and arbitrary user data. This function also starts the thread.
@@ -96,4 +105,20 @@ kzsError kzsThreadLockSet(struct KzsThreadLock* threadLock, kzBool value, kzBool
 kzsError kzsThreadLockIsSet(struct KzsThreadLock* threadLock, kzBool autoLock, kzBool* out_isSet);
 
 
+/**
+ * Creates a thread local storage. The value of the storage is KZ_NULL in all threads until set.
+ * If destructor is not KZ_NULL, it is called for the non-null value of each thread when the thread exits.
+ */
+kzsError kzsThreadLocalStorageCreate(KzsThreadLocalStorageDestructor destructor, struct KzsThreadLocalStorage** out_threadLocalStorage);
+
+/** Deletes a thread local storage. Values stored by the threads are not freed and the destructor is not called for them any more. */
+kzsError kzsThreadLocalStorageDelete(struct KzsThreadLocalStorage* threadLocalStorage);
+
+/** Returns the value of the given thread local storage for the currently executing thread. */
+void* kzsThreadLocalStorageGetValue(const struct KzsThreadLocalStorage* threadLocalStorage);
+
+/** Sets the value of the given thread local storage for the currently executing thread. */
+kzsError kzsThreadLocalStorageSetValue(const struct KzsThreadLocalStorage* threadLocalStorage, void* value);
+
+
 #endif
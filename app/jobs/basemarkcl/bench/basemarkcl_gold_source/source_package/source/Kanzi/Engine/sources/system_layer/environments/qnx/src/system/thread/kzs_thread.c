@@ -35,6 +35,11 @@ struct KzsThreadLock
     kzBool value;
 };
 
+struct KzsThreadLocalStorage
+{
+    pthread_key_t key;
+};
+
 static pthread_mutex_t g_kzsThreadSleepMutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t g_kzsThreadSleepCond = PTHREAD_COND_INITIALIZER;
 
@@ -330,3 +335,46 @@ kzsError kzsThreadLockIsSet(struct KzsThreadLock* threadLock, kzBool autoLock, k
     *out_isSet = value;
     kzsSuccess();
 }
+
+
+kzsError kzsThreadLocalStorageCreate(KzsThreadLocalStorageDestructor destructor, struct KzsThreadLocalStorage** out_threadLocalStorage)
+{
+    kzInt result;
+    struct KzsThreadLocalStorage* threadLocalStorage;
+
+    threadLocalStorage = kzsMalloc(sizeof(*threadLocalStorage));
+    kzsErrorTest(threadLocalStorage != KZ_NULL, KZS_ERROR_OUT_OF_MEMORY, "Out of memory while creating thread local storage");
+
+    result = pthread_key_create(&threadLocalStorage->key, destructor);
+    kzsErrorTest(result == 0, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to create thread local storage key");
+
+    *out_threadLocalStorage = threadLocalStorage;
+    kzsSuccess();
+}
+
+kzsError kzsThreadLocalStorageDelete(struct KzsThreadLocalStorage* threadLocalStorage)
+{
+    kzInt result;
+
+    result = pthread_key_delete(threadLocalStorage->key);
+    kzsErrorTest(result == 0, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to delete thread local storage key");
+
+    kzsFree(threadLocalStorage);
+
+    kzsSuccess();
+}
+
+void* kzsThreadLocalStorageGetValue(const struct KzsThreadLocalStorage* threadLocalStorage)
+{
+    return pthread_getspecific(threadLocalStorage->key);
+}
+
+kzsError kzsThreadLocalStorageSetValue(const struct KzsThreadLocalStorage* threadLocalStorage, void* value)
+{
+    kzInt result;
+
+    result = pthread_setspecific(threadLocalStorage->key, value);
+    kzsErrorTest(result == 0, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to set thread local storage value");
+
+    kzsSuccess();
+}
@@ -35,6 +35,19 @@ struct KzsThreadLock
     kzBool value;
 };
 
+struct KzsThreadLocalStorage
+{
+    DWORD index;
+    KzsThreadLocalStorageDestructor destructor;
+};
+
+/** Value of a thread local storage in one thread. Fiber local storage callbacks only get the value, so the storage is kept along with it. */
+struct KzsThreadLocalStorageEntry
+{
+    const struct KzsThreadLocalStorage* threadLocalStorage;
+    void* value;
+};
+
 
 DWORD WINAPI kzsThreadRunner_internal(LPVOID lpParameter)
 {
@@ -356,3 +369,79 @@ kzsError kzsThreadLockIsSet(struct KzsThreadLock* threadLock, kzBool autoLock, k
     *out_isSet = value;
     kzsSuccess();
 }
+
+
+/** Fiber local storage callback, which is called when a thread exits or the storage is deleted. */
+static VOID WINAPI kzsThreadLocalStorageCallback_internal(PVOID data)
+{
+    struct KzsThreadLocalStorageEntry* entry = (struct KzsThreadLocalStorageEntry*)data;
+
+    if (entry->value != KZ_NULL && entry->threadLocalStorage->destructor != KZ_NULL)
+    {
+        entry->threadLocalStorage->destructor(entry->value);
+    }
+
+    kzsFree(entry);
+}
+
+kzsError kzsThreadLocalStorageCreate(KzsThreadLocalStorageDestructor destructor, struct KzsThreadLocalStorage** out_threadLocalStorage)
+{
+    struct KzsThreadLocalStorage* threadLocalStorage;
+
+    threadLocalStorage = kzsMalloc(sizeof(*threadLocalStorage));
+    kzsErrorTest(threadLocalStorage != KZ_NULL, KZS_ERROR_OUT_OF_MEMORY, "Out of memory while creating thread local storage");
+
+    threadLocalStorage->destructor = destructor;
+    threadLocalStorage->index = FlsAlloc(kzsThreadLocalStorageCallback_internal);
+    kzsErrorTest(threadLocalStorage->index != FLS_OUT_OF_INDEXES, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to allocate thread local storage index");
+
+    *out_threadLocalStorage = threadLocalStorage;
+    kzsSuccess();
+}
+
+kzsError kzsThreadLocalStorageDelete(struct KzsThreadLocalStorage* threadLocalStorage)
+{
+    BOOL result;
+
+    /* Freeing the index calls the callback for the remaining entries, which must only free them. */
+    threadLocalStorage->destructor = KZ_NULL;
+
+    result = FlsFree(threadLocalStorage->index);
+    kzsErrorTest(result, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to free thread local storage index");
+
+    kzsFree(threadLocalStorage);
+
+    kzsSuccess();
+}
+
+void* kzsThreadLocalStorageGetValue(const struct KzsThreadLocalStorage* threadLocalStorage)
+{
+    struct KzsThreadLocalStorageEntry* entry = (struct KzsThreadLocalStorageEntry*)FlsGetValue(threadLocalStorage->index);
+    return (entry != KZ_NULL) ? entry->value : KZ_NULL;
+}
+
+kzsError kzsThreadLocalStorageSetValue(const struct KzsThreadLocalStorage* threadLocalStorage, void* value)
+{
+    struct KzsThreadLocalStorageEntry* entry = (struct KzsThreadLocalStorageEntry*)FlsGetValue(threadLocalStorage->index);
+
+    if (entry == KZ_NULL)
+    {
+        BOOL result;
+
+        entry = kzsMalloc(sizeof(*entry));
+        kzsErrorTest(entry != KZ_NULL, KZS_ERROR_OUT_OF_MEMORY, "Out of memory while setting thread local storage value");
+
+        entry->threadLocalStorage = threadLocalStorage;
+
+        result = FlsSetValue(threadLocalStorage->index, entry);
+        if (!result)
+        {
+            kzsFree(entry);
+        }
+        kzsErrorTest(result, KZS_ERROR_THREAD_OPERATION_FAILED, "Unable to set thread local storage value");
+    }
+
+    entry->value = value;
+
+    kzsSuccess();
+}
@@ -28,7 +28,7 @@ kzsError kzuAnimationPlayerCreate(const struct KzcMemoryManager* memoryManager,
 {
     kzsError result;
     struct KzuAnimationPlayer* player;
-    struct KzcHashMapConfiguration overrideMapConfiguration = {kzuHashCodeFromAnimationOverride, kzuCompareAnimationOverrides};
+    struct KzcHashMapConfiguration overrideMapConfiguration = {kzuHashCodeFromAnimationOverride, kzuCompareAnimationOverrides, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
 
     result = kzcMemoryAllocVariable(memoryManager, player, "AnimationPlayer");
     kzsErrorForward(result);
@@ -112,7 +112,7 @@ static kzsError kzuTimeLineEntryCreate_internal(const struct KzcMemoryManager* m
     struct KzuTimeLineEntry* timeLineEntry;
 
     /* Hash map configuration for overrides. */
-    struct KzcHashMapConfiguration overrideMapConfiguration = {kzuHashCodeFromAnimationOverride, kzuCompareAnimationOverrides};
+    struct KzcHashMapConfiguration overrideMapConfiguration = {kzuHashCodeFromAnimationOverride, kzuCompareAnimationOverrides, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
 
     result = kzcMemoryAllocVariable(memoryManager, timeLineEntry, "Time line entry");
     kzsErrorForward(result);
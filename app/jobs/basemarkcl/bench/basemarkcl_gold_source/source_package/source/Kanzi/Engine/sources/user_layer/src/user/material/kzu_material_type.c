@@ -21,6 +21,7 @@
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
 #include <core/resource_manager/kzc_resource_manager.h>
 #include <core/resource_manager/shader/kzc_resource_shader.h>
+#include <core/renderer/kzc_renderer.h>
 #endif
 
 
@@ -43,6 +44,11 @@ struct KzuMaterialTypeData
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     struct KzcShader* shaderProgram;         /**< Shader program linked to this material type. */
 #endif
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    kzUint* uniformSlotIndices;              /**< Uniform slot indices of the property types, KZ_NULL if not resolved. */
+    kzUint uniformSlotIndexCount;            /**< Number of property types the slot indices were resolved for. */
+    kzUint uniformSlotTableStamp;            /**< Stamp of the uniform slot table the indices were resolved against. */
+#endif
 };
 
 
@@ -75,6 +81,11 @@ kzsError kzuMaterialTypeCreate(const struct KzcMemoryManager* memoryManager, str
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     materialTypeData->shaderProgram = KZ_NULL;
 #endif
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    materialTypeData->uniformSlotIndices = KZ_NULL;
+    materialTypeData->uniformSlotIndexCount = 0;
+    materialTypeData->uniformSlotTableStamp = 0;
+#endif
 
     *out_materialType = materialType;
     kzsSuccess();
@@ -124,6 +135,13 @@ kzsError kzuMaterialTypeDelete(struct KzuMaterialType* materialType)
         kzsErrorForward(result);
     }
 #endif
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    if (materialTypeData->uniformSlotIndices != KZ_NULL)
+    {
+        result = kzcMemoryFreeArray(materialTypeData->uniformSlotIndices);
+        kzsErrorForward(result);
+    }
+#endif
 
     /* Delete light property types hash map. */
     result = kzcHashMapDelete(materialTypeData->lightPropertyTypes);
@@ -349,6 +367,63 @@ struct KzcDynamicArray* kzuMaterialTypeGetPropertyTypes(const struct KzuMaterial
     return kzuPropertyTypeCollectionGetPropertyTypes(materialType->data->propertyTypes);
 }
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+kzsError kzuMaterialTypeGetUniformSlotIndices(const struct KzuMaterialType* materialType, const struct KzcRenderer* renderer,
+                                              const kzUint** out_slotIndices)
+{
+    kzsError result;
+    struct KzuMaterialTypeData* materialTypeData;
+    struct KzcDynamicArray* propertyTypes;
+    kzUint propertyTypeCount;
+    kzUint slotTableStamp;
+
+    kzsAssert(kzuMaterialTypeIsValid(materialType));
+
+    materialTypeData = materialType->data;
+    propertyTypes = kzuPropertyTypeCollectionGetPropertyTypes(materialTypeData->propertyTypes);
+    propertyTypeCount = kzcDynamicArrayGetSize(propertyTypes);
+    slotTableStamp = kzcRendererGetUniformSlotTableStamp(renderer);
+
+    /* Property types are only ever added, so a matching count and stamp means the indices are current. */
+    if (materialTypeData->uniformSlotIndices == KZ_NULL || materialTypeData->uniformSlotIndexCount != propertyTypeCount ||
+        materialTypeData->uniformSlotTableStamp != slotTableStamp)
+    {
+        struct KzcDynamicArrayIterator it;
+        kzUint i = 0;
+
+        if (materialTypeData->uniformSlotIndexCount != propertyTypeCount && materialTypeData->uniformSlotIndices != KZ_NULL)
+        {
+            result = kzcMemoryFreeArray(materialTypeData->uniformSlotIndices);
+            kzsErrorForward(result);
+            materialTypeData->uniformSlotIndices = KZ_NULL;
+        }
+
+        if (materialTypeData->uniformSlotIndices == KZ_NULL)
+        {
+            result = kzcMemoryAllocArray(kzcMemoryGetManager(materialType), materialTypeData->uniformSlotIndices,
+                                         propertyTypeCount, "Material type uniform slot indices");
+            kzsErrorForward(result);
+        }
+
+        it = kzcDynamicArrayGetIterator(propertyTypes);
+        while (kzcDynamicArrayIterate(it))
+        {
+            const struct KzuPropertyType* propertyType = (const struct KzuPropertyType*)kzcDynamicArrayIteratorGetValue(it);
+
+            result = kzcRendererGetUniformSlotIndex(renderer, kzuPropertyTypeGetName(propertyType), &materialTypeData->uniformSlotIndices[i]);
+            kzsErrorForward(result);
+            ++i;
+        }
+
+        materialTypeData->uniformSlotIndexCount = propertyTypeCount;
+        materialTypeData->uniformSlotTableStamp = slotTableStamp;
+    }
+
+    *out_slotIndices = materialTypeData->uniformSlotIndices;
+    kzsSuccess();
+}
+#endif
+
 struct KzcHashMap* kzuMaterialTypeGetLightPropertyTypes(const struct KzuMaterialType* materialType)
 {
     kzsAssert(kzuMaterialTypeIsValid(materialType));
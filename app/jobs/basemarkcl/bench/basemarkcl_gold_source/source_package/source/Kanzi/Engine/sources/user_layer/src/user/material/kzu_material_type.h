@@ -12,6 +12,9 @@
 #include <core/resource_manager/kzc_resource_memory_type.h>
 
 #include <system/wrappers/kzs_opengl_base.h>
+#if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
+#include <core/renderer/kzc_renderer.h>
+#endif
 #include <system/kzs_types.h>
 #include <system/debug/kzs_error.h>
 
@@ -26,6 +29,7 @@ struct KzcResourceManager;
 struct KzcHashMap;
 struct KzcDynamicArray;
 struct KzcShader;
+struct KzcRenderer;
 
 
 /** Shader info for material type (no shader / source shader / binary shader). */
@@ -111,6 +115,14 @@ struct KzcDynamicArray* kzuMaterialTypeGetVertexAttributes(const struct KzuMater
 
 /** Returns property types of material type. */
 struct KzcDynamicArray* kzuMaterialTypeGetPropertyTypes(const struct KzuMaterialType* materialType);
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+/**
+ * Gets the uniform slot indices of the property types of material type in the shader active in the renderer.
+ * The indices are in the order of kzuMaterialTypeGetPropertyTypes() and are resolved again when the slot table changes.
+ */
+kzsError kzuMaterialTypeGetUniformSlotIndices(const struct KzuMaterialType* materialType, const struct KzcRenderer* renderer,
+                                              const kzUint** out_slotIndices);
+#endif
 /** Returns light property types of material type. */
 struct KzcHashMap* kzuMaterialTypeGetLightPropertyTypes(const struct KzuMaterialType* materialType);
 /** Gets property type from material type by name, KZ_NULL if not found. */
@@ -165,7 +165,7 @@ kzsError kzuProjectCreate(const struct KzcMemoryManager* memoryManager, struct K
     struct KzuProject* project;
 
     /* Hash map configuration for project object keys. */
-    struct KzcHashMapConfiguration objectMapConfiguration = {kzuHashCodeFromObjectKey_internal, kzuCompareObjectKeys_internal};
+    struct KzcHashMapConfiguration objectMapConfiguration = {kzuHashCodeFromObjectKey_internal, kzuCompareObjectKeys_internal, KZC_HASH_MAP_TABLE_TYPE_LINEAR};
 
     result = kzcMemoryAllocVariable(memoryManager, project, "Project");
     kzsErrorForward(result);
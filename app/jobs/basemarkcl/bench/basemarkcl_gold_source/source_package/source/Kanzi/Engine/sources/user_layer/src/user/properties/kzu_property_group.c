@@ -110,7 +110,12 @@ void kzuPropertyGroupTransferData(struct KzuPropertyGroup* targetGroup, struct K
 void kzuPropertyGroupSetOverrideProperties(const struct KzuPropertyGroup* group, kzBool overrideProperties)
 {
     kzsAssert(kzuPropertyGroupIsValid(group));
-    group->data->overrideProperties = overrideProperties;
+
+    if (group->data->overrideProperties != overrideProperties)
+    {
+        group->data->overrideProperties = overrideProperties;
+        kzuPropertyManagerMarkObjectChanged(group->data->propertyManager);
+    }
 }
 
 kzBool kzuPropertyGroupIsOverrideProperties(const struct KzuPropertyGroup* group)
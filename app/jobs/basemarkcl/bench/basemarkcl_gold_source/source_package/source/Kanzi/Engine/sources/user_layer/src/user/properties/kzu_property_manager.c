@@ -47,6 +47,12 @@ kzsError kzuPropertyManagerCreate(const struct KzcMemoryManager* memoryManager,
     result = kzcHashMapCreate(memoryManager, KZC_HASH_MAP_CONFIGURATION_STRING, &propertyManager->typesByNames);
     kzsErrorForward(result);
 
+    result = kzcMemoryAllocVariable(memoryManager, propertyManager->changeCounts, "Property manager change counts");
+    kzsErrorForward(result);
+
+    propertyManager->changeCounts->transformationChangeCount = 0;
+    propertyManager->changeCounts->objectChangeCount = 0;
+
     *out_propertyManager = propertyManager;
 
     kzsSuccess();
@@ -101,12 +107,36 @@ kzsError kzuPropertyManagerDelete(struct KzuPropertyManager* propertyManager)
     result = kzcHashMapDelete(propertyManager->typesByNames);
     kzsErrorForward(result);
 
+    result = kzcMemoryFreeVariable(propertyManager->changeCounts);
+    kzsErrorForward(result);
+
     result = kzcMemoryFreeVariable(propertyManager);
     kzsErrorForward(result);
 
     kzsSuccess();
 }
 
+kzUint kzuPropertyManagerGetTransformationChangeCount(const struct KzuPropertyManager* propertyManager)
+{
+    kzsAssert(kzcIsValidPointer(propertyManager));
+
+    return propertyManager->changeCounts->transformationChangeCount;
+}
+
+kzUint kzuPropertyManagerGetObjectChangeCount(const struct KzuPropertyManager* propertyManager)
+{
+    kzsAssert(kzcIsValidPointer(propertyManager));
+
+    return propertyManager->changeCounts->objectChangeCount;
+}
+
+void kzuPropertyManagerMarkObjectChanged(const struct KzuPropertyManager* propertyManager)
+{
+    kzsAssert(kzcIsValidPointer(propertyManager));
+
+    ++propertyManager->changeCounts->objectChangeCount;
+}
+
 kzBool kzuPropertyManagerSetPropertyPriority(const struct KzuPropertyManager* propertyManager, const void* object, const struct KzuPropertyType* propertyType, enum KzuPropertyPriority priority)
 {
     kzBool found = KZ_FALSE;
@@ -118,7 +148,11 @@ kzBool kzuPropertyManagerSetPropertyPriority(const struct KzuPropertyManager* pr
         if (propertyStorage != KZ_NULL)
         {
             found = KZ_TRUE;
-            propertyStorage->priority = priority;
+            if (propertyStorage->priority != priority)
+            {
+                propertyStorage->priority = priority;
+                kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+            }
         }
     }
 
@@ -223,6 +257,8 @@ kzsError kzuPropertyManagerUnregisterPropertyType(const struct KzuPropertyManage
     {
         kzMutableString name;
 
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+
         result = kzcHashMapDelete(typeStorage->propertyContainer);
         kzsErrorForward(result);
 
@@ -276,6 +312,8 @@ kzsError kzuPropertyManagerAddPropertyGroup(const struct KzuPropertyManager* pro
     result = kzcDynamicArrayAdd(groupArray, (void*)propertyGroup);
     kzsErrorForward(result);
 
+    kzuPropertyManagerMarkPropertyChanged_private(propertyManager, KZ_NULL);
+
     kzsSuccess();
 }
 
@@ -297,6 +335,7 @@ kzsError kzuPropertyManagerRemovePropertyGroup(const struct KzuPropertyManager*
                 result = kzcDynamicArrayMutableIteratorRemove(it);                
                 kzsErrorForward(result);
 
+                kzuPropertyManagerMarkPropertyChanged_private(propertyManager, KZ_NULL);
                 break;
             }
         }
@@ -319,6 +358,8 @@ kzsError kzuPropertyManagerRemovePropertyGroups(const struct KzuPropertyManager*
 
         result = kzcDynamicArrayDelete(groupArray);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, KZ_NULL);
     }
 
     kzsSuccess();
@@ -367,6 +408,8 @@ kzsError kzuPropertyManagerCopyProperyGroups(const struct KzuPropertyManager* pr
 
         result = kzcHashMapPut(propertyManager->groupContainer, targetObject, targetGroupArray);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, KZ_NULL);
     }
 
     kzsSuccess();
@@ -401,6 +444,8 @@ kzsError kzuPropertyManagerRemoveProperty(const struct KzuPropertyManager* prope
     {
         result = kzuPropertyManagerRemovePropertyStorage_private(object, typeStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     kzsSuccess();
@@ -421,6 +466,8 @@ kzsError kzuPropertyManagerRemoveProperties(const struct KzuPropertyManager* pro
         kzsErrorForward(result);
     }
 
+    kzuPropertyManagerMarkPropertyChanged_private(propertyManager, KZ_NULL);
+
     kzsSuccess();
 }
 
@@ -781,6 +828,8 @@ kzsError kzuPropertyManagerCopyProperty(const struct KzuPropertyManager* propert
                     kzsErrorThrow(KZS_ERROR_ENUM_OUT_OF_RANGE, "Invalid property type");
                 }
             }
+
+            kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
         }
     }
 
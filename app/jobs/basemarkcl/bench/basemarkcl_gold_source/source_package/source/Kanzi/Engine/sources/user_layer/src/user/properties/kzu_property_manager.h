@@ -41,6 +41,17 @@ kzsError kzuPropertyManagerCreate(const struct KzcMemoryManager* memoryManager,
 /** Delete a property manager. */
 kzsError kzuPropertyManagerDelete(struct KzuPropertyManager* propertyManager);
 
+/**
+* Gets the number of property changes that may affect object node transformations, layouts or visibility.
+* Setting a property to its current value and changing other properties, such as material properties, are not counted.
+* Property group changes are always counted, as the affected property types are not tracked.
+*/
+kzUint kzuPropertyManagerGetTransformationChangeCount(const struct KzuPropertyManager* propertyManager);
+/** Gets the number of changes marked with kzuPropertyManagerMarkObjectChanged(). */
+kzUint kzuPropertyManagerGetObjectChangeCount(const struct KzuPropertyManager* propertyManager);
+/** Marks a change in an object using the property manager that is not a property change, for example a change in object node hierarchy. */
+void kzuPropertyManagerMarkObjectChanged(const struct KzuPropertyManager* propertyManager);
+
 
 /** Remove a property of propertyType associated with an object. */
 kzsError kzuPropertyManagerRemoveProperty(const struct KzuPropertyManager* propertyManager, const void* object, const struct KzuPropertyType* propertyType);
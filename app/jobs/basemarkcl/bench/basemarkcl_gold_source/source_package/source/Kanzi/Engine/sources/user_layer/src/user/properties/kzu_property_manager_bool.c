@@ -59,6 +59,8 @@ kzsError kzuPropertyManagerAcquireBoolStorage_private(const struct KzuPropertyMa
         /* Add to the container. */
         result = kzcHashMapPut(typeStorage->propertyContainer, object, propertyStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     *out_floatStorage = propertyStorage;
@@ -77,7 +79,11 @@ kzsError kzuPropertyManagerSetBool(const struct KzuPropertyManager* propertyMana
     result = kzuPropertyManagerAcquireBoolStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->baseValue = value;
+    if (propertyStorage->baseValue != value)
+    {
+        propertyStorage->baseValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -94,7 +100,11 @@ kzsError kzuPropertyManagerSetRelativeBool(const struct KzuPropertyManager* prop
     result = kzuPropertyManagerAcquireBoolStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->relativeValue = value;
+    if (propertyStorage->relativeValue != value)
+    {
+        propertyStorage->relativeValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
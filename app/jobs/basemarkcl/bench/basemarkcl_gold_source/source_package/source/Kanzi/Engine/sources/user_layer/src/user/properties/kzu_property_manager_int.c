@@ -59,6 +59,8 @@ kzsError kzuPropertyManagerAcquireIntStorage_private(const struct KzuPropertyMan
         /* Add to the container. */
         result = kzcHashMapPut(typeStorage->propertyContainer, object, propertyStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     *out_floatStorage = propertyStorage;
@@ -77,7 +79,11 @@ kzsError kzuPropertyManagerSetInt(const struct KzuPropertyManager* propertyManag
     result = kzuPropertyManagerAcquireIntStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->baseValue = value;
+    if (propertyStorage->baseValue != value)
+    {
+        propertyStorage->baseValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -94,7 +100,11 @@ kzsError kzuPropertyManagerSetRelativeInt(const struct KzuPropertyManager* prope
     result = kzuPropertyManagerAcquireIntStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->relativeValue = value;
+    if (propertyStorage->relativeValue != value)
+    {
+        propertyStorage->relativeValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -9,6 +9,7 @@
 
 #include <user/properties/kzu_property.h>
 #include <user/properties/kzu_float_property.h>
+#include <user/properties/kzu_fixed_properties.h>
 #include <user/scene_graph/kzu_object.h>
 
 #include <core/memory/kzc_memory_manager.h>
@@ -18,6 +19,91 @@
 #include <system/wrappers/kzs_math.h>
 
 
+/**
+* Checks if changes in the given property type may move, resize, show or hide object nodes.
+* Material, light and other rendering properties are excluded so that they do not invalidate transformed scenes.
+*/
+static kzBool kzuPropertyManagerIsTransformationPropertyType_internal(const struct KzuPropertyType* propertyType)
+{
+    return propertyType == KZU_PROPERTY_TYPE_TRANSFORMATION ||
+           propertyType == KZU_PROPERTY_TYPE_VISIBLE ||
+           propertyType == KZU_PROPERTY_TYPE_FACE_TO_CAMERA ||
+           propertyType == KZU_PROPERTY_TYPE_LOOK_AT ||
+           propertyType == KZU_PROPERTY_TYPE_TRAJECTORY ||
+           propertyType == KZU_PROPERTY_TYPE_CLIP_CHILDREN ||
+           propertyType == KZU_PROPERTY_TYPE_VISIBLE_AMOUNT_IN_PARENT ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_WIDTH ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_HEIGHT ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_DEPTH ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_WIDTH_TYPE ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_HEIGHT_TYPE ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_DEPTH_TYPE ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_HORIZONTAL_ALIGNMENT ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_VERTICAL_ALIGNMENT ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_DEPTH_ALIGNMENT ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_HORIZONTAL_MARGIN ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_VERTICAL_MARGIN ||
+           propertyType == KZU_PROPERTY_TYPE_LAYOUT_DEPTH_MARGIN ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_COLUMN ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_ROW ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_COLUMN_SPAN ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_ROW_SPAN ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_COLUMN_DEFINITIONS ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_ROW_DEFINITIONS ||
+           propertyType == KZU_PROPERTY_TYPE_GRID_LAYOUT_DATA ||
+           propertyType == KZU_PROPERTY_TYPE_STACK_LAYOUT_DIRECTION ||
+           propertyType == KZU_PROPERTY_TYPE_STACK_LAYOUT_REVERSED ||
+           propertyType == KZU_PROPERTY_TYPE_TRAJECTORY_LAYOUT_OFFSET ||
+           propertyType == KZU_PROPERTY_TYPE_TRAJECTORY_LAYOUT_START_VALUE ||
+           propertyType == KZU_PROPERTY_TYPE_TRAJECTORY_LAYOUT_END_VALUE ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_TEXT ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_FONT ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_FONT_SIZE ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_LINE_SPACING ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_TERMINATOR ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_HORIZONTAL_ALIGNMENT ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_VERTICAL_ALIGNMENT ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_MAXIMUM_WIDTH ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_MAXIMUM_HEIGHT ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_MAXIMUM_LINES ||
+           propertyType == KZU_PROPERTY_TYPE_LABEL_MAXIMUM_CHARACTERS_PER_LINE ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_VALUE ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_MINIMUM_VALUE ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_MAXIMUM_VALUE ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_DIRECTION ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_EXPAND_DIRECTION ||
+           propertyType == KZU_PROPERTY_TYPE_SLIDER_INVERT_DIRECTION ||
+           propertyType == KZU_PROPERTY_TYPE_DROPDOWN_OPEN_STATE ||
+           propertyType == KZU_PROPERTY_TYPE_DROPDOWN_SELECTED_ITEM;
+}
+
+void kzuPropertyManagerMarkPropertyChanged_private(const struct KzuPropertyManager* propertyManager, const struct KzuPropertyTypeStorage* typeStorage)
+{
+    kzsAssert(kzcIsValidPointer(propertyManager));
+
+    if (typeStorage == KZ_NULL || typeStorage->affectsTransformation)
+    {
+        ++propertyManager->changeCounts->transformationChangeCount;
+    }
+}
+
+kzBool kzuPropertyManagerIsValueDataEqual_private(const void* value1, const void* value2, kzUint size)
+{
+    const kzU8* bytes1 = (const kzU8*)value1;
+    const kzU8* bytes2 = (const kzU8*)value2;
+    kzUint i;
+
+    for (i = 0; i < size; ++i)
+    {
+        if (bytes1[i] != bytes2[i])
+        {
+            break;
+        }
+    }
+
+    return i == size;
+}
+
 void kzuPropertyManagerInitializeBaseProperty_private(struct KzuPropertyBaseStorage* property)
 {
     property->priority = KZU_PROPERTY_PRIORITY_NORMAL;
@@ -189,6 +275,7 @@ kzsError kzuPropertyManagerAcquireTypeStorage_private(const struct KzuPropertyMa
         kzsErrorForward(result);
 
         typeStorage->type = propertyType;
+        typeStorage->affectsTransformation = kzuPropertyManagerIsTransformationPropertyType_internal(propertyType);
 
         /* Allocate the property container. */
         result = kzcHashMapCreate(memoryManager, KZC_HASH_MAP_CONFIGURATION_POINTER, &typeStorage->propertyContainer);
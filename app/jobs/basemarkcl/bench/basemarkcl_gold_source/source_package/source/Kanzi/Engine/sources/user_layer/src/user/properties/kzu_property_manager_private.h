@@ -144,6 +144,14 @@ struct KzuPropertyTypeStorage
 {
     const struct KzuPropertyType* type;
     struct KzcHashMap* propertyContainer;       /**< Property value storage. <void*, KzuPropertyBaseStorage*> */
+    kzBool affectsTransformation;               /**< Does a change in this property type affect object node transformations, layouts or visibility. */
+};
+
+/** Change counters of a property manager. */
+struct KzuPropertyManagerChangeCounts
+{
+    kzUint transformationChangeCount; /**< Number of property changes that may affect object node transformations, layouts or visibility. */
+    kzUint objectChangeCount; /**< Number of other changes marked for objects using the property manager. */
 };
 
 /** Property manager. */
@@ -152,9 +160,18 @@ struct KzuPropertyManager
     struct KzcHashMap* typeContainer; /**< Map for types. <KzuPropertyType*, KzuPropertyTypeStorage*> */
     struct KzcHashMap* groupContainer; /**< Map for property groups. <void*, KzcDynamicArray*> */
     struct KzcHashMap* typesByNames; /**< Map for property types. <kzString, KzuPropertyType>. */
+    struct KzuPropertyManagerChangeCounts* changeCounts; /**< Change counters. Allocated separately so that they can be updated through const property manager pointers. */
 };
 
 
+/**
+* Marks that a property value or property association of the given type storage has changed.
+* Pass KZ_NULL as type storage when the changed property types are not known, for example for property group changes.
+*/
+void kzuPropertyManagerMarkPropertyChanged_private(const struct KzuPropertyManager* propertyManager, const struct KzuPropertyTypeStorage* typeStorage);
+/** Checks if two property values have identical binary representation. */
+kzBool kzuPropertyManagerIsValueDataEqual_private(const void* value1, const void* value2, kzUint size);
+
 /** Initializes base property storage. */
 void kzuPropertyManagerInitializeBaseProperty_private(struct KzuPropertyBaseStorage* property);
 
@@ -68,6 +68,12 @@ kzsError kzuPropertyManagerAssignRelativeString_internal(struct KzuPropertyStrin
     kzsSuccess();
 }
 
+/** Checks if two string property values are equal. Either of the strings may be KZ_NULL. */
+static kzBool kzuPropertyManagerIsStringValueEqual_internal(kzString first, kzString second)
+{
+    return (first == KZ_NULL || second == KZ_NULL) ? (first == second) : kzcStringIsEqual(first, second);
+}
+
 /** Finds float property storage, returns KZ_NULL if not found. */
 static struct KzuPropertyStringStorage* kzuPropertyManagerFindStringStorage_internal(const void* object, const struct KzuPropertyTypeStorage* typeStorage)
 {
@@ -109,6 +115,8 @@ kzsError kzuPropertyManagerAcquireStringStorage_private(const struct KzuProperty
         /* Add to the container. */
         result = kzcHashMapPut(typeStorage->propertyContainer, object, propertyStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     *out_floatStorage = propertyStorage;
@@ -127,8 +135,13 @@ kzsError kzuPropertyManagerSetString(const struct KzuPropertyManager* propertyMa
     result = kzuPropertyManagerAcquireStringStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    result = kzuPropertyManagerAssignBaseString_internal(propertyStorage, value);
-    kzsErrorForward(result);
+    if (!kzuPropertyManagerIsStringValueEqual_internal(propertyStorage->baseValue, value))
+    {
+        result = kzuPropertyManagerAssignBaseString_internal(propertyStorage, value);
+        kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -145,8 +158,13 @@ kzsError kzuPropertyManagerSetRelativeString(const struct KzuPropertyManager* pr
     result = kzuPropertyManagerAcquireStringStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    result = kzuPropertyManagerAssignRelativeString_internal(propertyStorage, value);
-    kzsErrorForward(result);
+    if (!kzuPropertyManagerIsStringValueEqual_internal(propertyStorage->relativeValue, value))
+    {
+        result = kzuPropertyManagerAssignRelativeString_internal(propertyStorage, value);
+        kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -59,6 +59,8 @@ kzsError kzuPropertyManagerAcquireVector2Storage_private(const struct KzuPropert
         /* Add to the container. */
         result = kzcHashMapPut(typeStorage->propertyContainer, object, propertyStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     *out_floatStorage = propertyStorage;
@@ -77,7 +79,11 @@ kzsError kzuPropertyManagerSetVector2(const struct KzuPropertyManager* propertyM
     result = kzuPropertyManagerAcquireVector2Storage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->baseValue = value;
+    if (!kzuPropertyManagerIsValueDataEqual_private(&propertyStorage->baseValue, &value, sizeof(value)))
+    {
+        propertyStorage->baseValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -94,7 +100,11 @@ kzsError kzuPropertyManagerSetRelativeVector2(const struct KzuPropertyManager* p
     result = kzuPropertyManagerAcquireVector2Storage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->relativeValue = value;
+    if (!kzuPropertyManagerIsValueDataEqual_private(&propertyStorage->relativeValue, &value, sizeof(value)))
+    {
+        propertyStorage->relativeValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
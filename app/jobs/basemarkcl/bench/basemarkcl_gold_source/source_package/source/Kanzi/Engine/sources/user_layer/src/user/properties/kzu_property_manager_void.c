@@ -62,6 +62,8 @@ kzsError kzuPropertyManagerAcquireVoidStorage_private(const struct KzuPropertyMa
         /* Add to the container. */
         result = kzcHashMapPut(typeStorage->propertyContainer, object, propertyStorage);
         kzsErrorForward(result);
+
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
     }
 
     *out_floatStorage = propertyStorage;
@@ -80,7 +82,11 @@ kzsError kzuPropertyManagerSetVoid(const struct KzuPropertyManager* propertyMana
     result = kzuPropertyManagerAcquireVoidStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->baseValue = value;
+    if (propertyStorage->baseValue != value)
+    {
+        propertyStorage->baseValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
@@ -97,7 +103,11 @@ kzsError kzuPropertyManagerSetRelativeVoid(const struct KzuPropertyManager* prop
     result = kzuPropertyManagerAcquireVoidStorage_private(propertyManager, object, typeStorage, &propertyStorage);
     kzsErrorForward(result);
 
-    propertyStorage->relativeValue = value;
+    if (propertyStorage->relativeValue != value)
+    {
+        propertyStorage->relativeValue = value;
+        kzuPropertyManagerMarkPropertyChanged_private(propertyManager, typeStorage);
+    }
 
     kzsSuccess();
 }
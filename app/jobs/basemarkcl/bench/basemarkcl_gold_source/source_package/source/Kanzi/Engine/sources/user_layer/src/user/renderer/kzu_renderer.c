@@ -134,8 +134,9 @@ struct KzuRenderer
 };
 
 
-/** Applies property type. */
-static kzsError kzuRendererApplyPropertyType_internal(const struct KzuRenderer* renderer, struct KzuPropertyType* propertyType);
+/** Applies property type. Slot index is the uniform slot of the property type in the active shader, if the renderer supports slots. */
+static kzsError kzuRendererApplyPropertyType_internal(const struct KzuRenderer* renderer, struct KzuPropertyType* propertyType,
+                                                      kzUint slotIndex);
 /** Creates default material for renderer. */
 static kzsError kzuRendererCreateDefaultMaterial_internal(struct KzuRenderer* renderer, struct KzuPropertyManager* propertyManager);
 /** Creates error material for renderer. */
@@ -478,11 +479,12 @@ struct KzuPropertyQuery* kzuRendererGetPropertyQuery(const struct KzuRenderer* r
 }
 
 static kzsError kzuRendererApplyFloatProperty_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
-                                                       const struct KzuPropertyType* propertyType)
+                                                       const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
     kzFloat value = kzuPropertyQueryGetFloat(renderer->propertyQuery, propertyType);
 
 #if KZ_OPENGL_VERSION == KZ_OPENGL_ES_1_1
+    KZ_UNUSED_PARAMETER(slotIndex);
     {
         if (propertyType == KZU_PROPERTY_TYPE_SPECULAR_EXPONENT)
         {
@@ -507,7 +509,12 @@ static kzsError kzuRendererApplyFloatProperty_internal(const struct KzuRenderer*
     {
         kzsError result;
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+        result = kzcRendererSetUniformFloatBySlot(coreRenderer, slotIndex, value);
+#else
+        KZ_UNUSED_PARAMETER(slotIndex);
         result = kzcRendererSetUniformFloat(coreRenderer, kzuPropertyTypeGetName(propertyType), value);
+#endif
         kzsErrorForward(result);
     }
 #else
@@ -515,13 +522,14 @@ static kzsError kzuRendererApplyFloatProperty_internal(const struct KzuRenderer*
     KZ_UNUSED_PARAMETER(value);
     KZ_UNUSED_PARAMETER(propertyType);
     KZ_UNUSED_PARAMETER(coreRenderer);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
 
     kzsSuccess();
 }
 
-static kzsError kzuRendererApplyColorProperty_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer, 
-                                                       const struct KzuPropertyType* propertyType)
+static kzsError kzuRendererApplyColorProperty_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
+                                                       const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if KZ_OPENGL_VERSION != KZ_OPENGL_NONE
     struct KzcColorRGBA value;
@@ -535,6 +543,7 @@ static kzsError kzuRendererApplyColorProperty_internal(const struct KzuRenderer*
     }
 
 #if KZ_OPENGL_VERSION == KZ_OPENGL_ES_1_1
+    KZ_UNUSED_PARAMETER(slotIndex);
     if (propertyType == KZU_PROPERTY_TYPE_DIFFUSE)
     {
         kzcRendererSetDiffuseColor(coreRenderer, value);
@@ -558,8 +567,13 @@ static kzsError kzuRendererApplyColorProperty_internal(const struct KzuRenderer*
 #elif defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     {
         kzsError result;
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+        result = kzcRendererSetUniformColorRGBABySlot(coreRenderer, slotIndex, &value);
+#else
         kzString propertyName = kzuPropertyTypeGetName(propertyType);
+        KZ_UNUSED_PARAMETER(slotIndex);
         result = kzcRendererSetUniformColorRGBA(coreRenderer, propertyName, &value);
+#endif
         kzsErrorForward(result);
     }
 #endif
@@ -567,13 +581,14 @@ static kzsError kzuRendererApplyColorProperty_internal(const struct KzuRenderer*
     KZ_UNUSED_PARAMETER(propertyType);
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
 
     kzsSuccess();
 }
 
-static kzsError kzuRendererApplyVector2Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer, 
-                                                         const struct KzuPropertyType* propertyType)
+static kzsError kzuRendererApplyVector2Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
+                                                         const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -581,18 +596,24 @@ static kzsError kzuRendererApplyVector2Property_internal(const struct KzuRendere
 
     value = kzuPropertyQueryGetVector2(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformVec2BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformVec2(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
     KZ_UNUSED_PARAMETER(propertyType);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
     kzsSuccess();
 }
 
-static kzsError kzuRendererApplyVector3Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer, 
-                                                         const struct KzuPropertyType* propertyType)
+static kzsError kzuRendererApplyVector3Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
+                                                         const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -600,18 +621,24 @@ static kzsError kzuRendererApplyVector3Property_internal(const struct KzuRendere
 
     value = kzuPropertyQueryGetVector3(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformVec3BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformVec3(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
     KZ_UNUSED_PARAMETER(propertyType);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
     kzsSuccess();
 }
 
-static kzsError kzuRendererApplyVector4Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer, 
-                                                         const struct KzuPropertyType* propertyType)
+static kzsError kzuRendererApplyVector4Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
+                                                         const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -619,12 +646,18 @@ static kzsError kzuRendererApplyVector4Property_internal(const struct KzuRendere
 
     value = kzuPropertyQueryGetVector4(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformVec4BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformVec4(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
     KZ_UNUSED_PARAMETER(propertyType);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
     kzsSuccess();
 }
@@ -709,7 +742,7 @@ static kzsError kzuRendererApplyTextureProperty_internal(struct KzcRenderer* cor
 }
 
 static kzsError kzuRendererApplyMatrix2x2Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
-                                                           const struct KzuPropertyType* propertyType)
+                                                           const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -717,19 +750,25 @@ static kzsError kzuRendererApplyMatrix2x2Property_internal(const struct KzuRende
 
     value = kzuPropertyQueryGetMatrix2x2(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformMatrix2x2BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformMatrix2x2(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(propertyType);
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
 
     kzsSuccess();
 }
 
 static kzsError kzuRendererApplyMatrix3x3Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
-                                                           const struct KzuPropertyType* propertyType)
+                                                           const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -737,19 +776,25 @@ static kzsError kzuRendererApplyMatrix3x3Property_internal(const struct KzuRende
 
     value = kzuPropertyQueryGetMatrix3x3(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformMatrix3x3BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformMatrix3x3(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(propertyType);
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
 
     kzsSuccess();
 }
 
 static kzsError kzuRendererApplyMatrix4x4Property_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
-                                                           const struct KzuPropertyType* propertyType)
+                                                           const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -757,19 +802,25 @@ static kzsError kzuRendererApplyMatrix4x4Property_internal(const struct KzuRende
 
     value = kzuPropertyQueryGetMatrix4x4(renderer->propertyQuery, propertyType);
 
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    result = kzcRendererSetUniformMatrix4x4BySlot(coreRenderer, slotIndex, &value);
+#else
+    KZ_UNUSED_PARAMETER(slotIndex);
     result = kzcRendererSetUniformMatrix4x4(coreRenderer, kzuPropertyTypeGetName(propertyType), &value);
+#endif
     kzsErrorForward(result);
 #else
     KZ_UNUSED_PARAMETER(propertyType);
     KZ_UNUSED_PARAMETER(renderer);
     KZ_UNUSED_PARAMETER(coreRenderer);
+    KZ_UNUSED_PARAMETER(slotIndex);
 #endif
 
     kzsSuccess();
 }
 
 static kzsError kzuRendererApplyIntProperty_internal(const struct KzuRenderer* renderer, struct KzcRenderer* coreRenderer,
-                                                     const struct KzuPropertyType* propertyType)
+                                                     const struct KzuPropertyType* propertyType, kzUint slotIndex)
 {
 #if defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
     kzsError result;
@@ -777,6 +828,10 @@ static kzsError kzuRendererApplyIntProperty_internal(const struct KzuRenderer* r
     
     kzInt value = kzuPropertyQueryGetInt(renderer->propertyQuery, propertyType);
 
+#if !defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+    KZ_UNUSED_PARAMETER(slotIndex);
+#endif
+
     if (propertyType == KZU_PROPERTY_TYPE_BLEND_MODE)
     {
         /*lint -e(930)*/
@@ -790,6 +845,9 @@ static kzsError kzuRendererApplyIntProperty_internal(const struct KzuRenderer* r
             /*lint -e(930)*/
             kzcRendererSetFogMode(coreRenderer, (enum KzcRendererFogMode)value);
         }
+#elif defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+        result = kzcRendererSetUniformIntegerBySlot(coreRenderer, slotIndex, value);
+        kzsErrorForward(result);
 #elif defined(KZ_OPENGL_VERSION_SUPPORTS_SHADER_PROGRAMS)
         result = kzcRendererSetUniformInteger(coreRenderer, kzuPropertyTypeGetName(propertyType), value);
         kzsErrorForward(result);
@@ -1074,7 +1132,8 @@ static kzsError kzuRendererApplyMaterialLights_internal(struct KzuRenderer* rend
     kzsSuccess();
 }
 
-static kzsError kzuRendererApplyPropertyType_internal(const struct KzuRenderer* renderer, struct KzuPropertyType* propertyType)
+static kzsError kzuRendererApplyPropertyType_internal(const struct KzuRenderer* renderer, struct KzuPropertyType* propertyType,
+                                                      kzUint slotIndex)
 {
     kzsError result;
 
@@ -1086,55 +1145,55 @@ static kzsError kzuRendererApplyPropertyType_internal(const struct KzuRenderer*
     {
         case KZU_PROPERTY_DATA_TYPE_FLOAT:
         {
-            result = kzuRendererApplyFloatProperty_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyFloatProperty_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_INT:
         {
-            result = kzuRendererApplyIntProperty_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyIntProperty_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_COLOR:
         {
-            result = kzuRendererApplyColorProperty_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyColorProperty_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_VECTOR2:
         {
-            result = kzuRendererApplyVector2Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyVector2Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_VECTOR3:
         {
-            result = kzuRendererApplyVector3Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyVector3Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_VECTOR4:
         {
-            result = kzuRendererApplyVector4Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyVector4Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_MATRIX2X2:
         {
-            result = kzuRendererApplyMatrix2x2Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyMatrix2x2Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_MATRIX3X3:
         {
-            result = kzuRendererApplyMatrix3x3Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyMatrix3x3Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
         case KZU_PROPERTY_DATA_TYPE_MATRIX4X4:
         {
-            result = kzuRendererApplyMatrix4x4Property_internal(renderer, coreRenderer, propertyType);
+            result = kzuRendererApplyMatrix4x4Property_internal(renderer, coreRenderer, propertyType, slotIndex);
             kzsErrorForward(result);
             break;
         }
@@ -1170,6 +1229,7 @@ kzsError kzuRendererApplyMaterial(struct KzuRenderer* renderer, struct KzuMateri
     struct KzcDynamicArrayIterator it;
     struct KzcRenderer* coreRenderer;
     struct KzuMaterialType* materialType;
+    const kzUint* slotIndices = KZ_NULL;
 
     kzsAssert(kzcIsValidPointer(renderer));
     kzsAssert(kzcIsValidPointer(material));
@@ -1182,6 +1242,12 @@ kzsError kzuRendererApplyMaterial(struct KzuRenderer* renderer, struct KzuMateri
         shader = kzuMaterialTypeGetShaderProgram(materialType);
         result = kzcShaderApply(shader, renderer->coreRenderer);
         kzsErrorForward(result);
+
+#if defined(KZC_RENDERER_SUPPORTS_UNIFORM_SLOTS)
+        /* Uniform slots of the material type are resolved once per shader program and reused on later applies. */
+        result = kzuMaterialTypeGetUniformSlotIndices(materialType, renderer->coreRenderer, &slotIndices);
+        kzsErrorForward(result);
+#endif
     }
 #else
     {
@@ -1206,11 +1272,17 @@ kzsError kzuRendererApplyMaterial(struct KzuRenderer* renderer, struct KzuMateri
 
         it = kzcDynamicArrayGetIterator(kzuMaterialTypeGetPropertyTypes(materialType));
         /* Apply all material property types. */
-        while (kzcDynamicArrayIterate(it))
         {
-            struct KzuPropertyType* propertyType = (struct KzuPropertyType*)kzcDynamicArrayIteratorGetValue(it);
-            result = kzuRendererApplyPropertyType_internal(renderer, propertyType);
-            kzsErrorForward(result);
+            kzUint propertyTypeIndex = 0;
+            while (kzcDynamicArrayIterate(it))
+            {
+                struct KzuPropertyType* propertyType = (struct KzuPropertyType*)kzcDynamicArrayIteratorGetValue(it);
+                kzUint slotIndex = (slotIndices != KZ_NULL) ? slotIndices[propertyTypeIndex] : 0;
+
+                result = kzuRendererApplyPropertyType_internal(renderer, propertyType, slotIndex);
+                kzsErrorForward(result);
+                ++propertyTypeIndex;
+            }
         }
 
         result = kzuRendererApplyMaterialLights_internal(renderer, materialType, coreRenderer);
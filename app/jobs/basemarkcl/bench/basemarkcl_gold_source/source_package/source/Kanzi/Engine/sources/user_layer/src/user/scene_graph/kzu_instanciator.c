@@ -10,6 +10,8 @@
 #include "kzu_object.h"
 #include "kzu_object_private.h"
 
+#include <user/properties/kzu_property_manager.h>
+
 #include <core/memory/kzc_memory_manager.h>
 
 
@@ -106,6 +108,7 @@ kzsError kzuInstanciatorNodeInitialize(const struct KzuInstanciatorNode* instanc
     kzsAssert(kzcIsValidPointer(instanciatorNodeData));
 
     instanciatorNodeData->targetObjectNode = targetObjectNode;
+    kzuPropertyManagerMarkObjectChanged(kzuObjectNodeGetPropertyManager(&instanciatorNode->objectNode));
 
     kzsSuccess();
 }
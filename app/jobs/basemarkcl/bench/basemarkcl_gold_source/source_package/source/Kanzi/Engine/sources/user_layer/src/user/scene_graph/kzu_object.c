@@ -358,6 +358,7 @@ kzsError kzuObjectNodeAddChild(struct KzuObjectNode* parentObjectNode, struct Kz
     kzsErrorForward(result);
 
     childObjectNode->data->parent = parentObjectNode;
+    kzuPropertyManagerMarkObjectChanged(parentObjectNode->data->propertyManager);
 
     kzsSuccess();
 }
@@ -375,6 +376,7 @@ kzsError kzuObjectNodeAddChildAtIndex(struct KzuObjectNode* parentObjectNode, kz
     kzsErrorForward(result);
 
     childObjectNode->data->parent = parentObjectNode;
+    kzuPropertyManagerMarkObjectChanged(parentObjectNode->data->propertyManager);
 
     kzsSuccess();
 }
@@ -397,6 +399,7 @@ kzsError kzuObjectNodeRemoveChild(const struct KzuObjectNode* parentObjectNode,
     kzsErrorForward(result);
 
     childObjectNode->data->parent = KZ_NULL;
+    kzuPropertyManagerMarkObjectChanged(parentObjectNode->data->propertyManager);
 
     kzsSuccess();
 }
@@ -434,6 +437,8 @@ kzsError kzuObjectNodeRemoveAllChildren(const struct KzuObjectNode* parentObject
 
     kzcHashMapClear(parentObjectNode->data->childrenFromKzb);
 
+    kzuPropertyManagerMarkObjectChanged(parentObjectNode->data->propertyManager);
+
     kzsSuccess();
 }
 
@@ -507,6 +512,7 @@ void kzuObjectNodeSetParent_private(const struct KzuObjectNode* objectNode, stru
     kzsAssert(kzuObjectNodeIsValid(objectNode));
 
     objectNode->data->parent = parentObjectNode;
+    kzuPropertyManagerMarkObjectChanged(objectNode->data->propertyManager);
 }
 
 kzsError kzuObjectNodeSetName(const struct KzuObjectNode* objectNode, kzString name)
@@ -13,6 +13,7 @@
 #include <user/scene_graph/kzu_camera.h>
 #include <user/scene_graph/kzu_transformed_object.h>
 #include <user/scene_graph/kzu_object.h>
+#include <user/scene_graph/kzu_object_properties.h>
 #include <user/properties/kzu_bool_property.h>
 #include <user/properties/kzu_property.h>
 #include <user/properties/kzu_property_manager.h>
@@ -28,12 +29,23 @@
 
 struct KzuTransformedScene
 {
-    struct KzcMemoryManager* quickMemoryManager; /**< Quick memory manager for internal data. This is created only once for the whole transformed scene. */
+    struct KzcMemoryManager* quickMemoryManager; /**< Quick memory manager for the extracted tree. This is created only once for the whole transformed scene. */
+    struct KzcMemoryManager* runtimeMemoryManager; /**< Quick memory manager for per-frame object source outputs and constraint iteration. This is created only once for the whole transformed scene. */
 
-    /* The following members are created in every extract call. */
+    /* The following members are created when the tree is rebuilt. */
     struct KzuScene* originalScene; /**< Original scene used to create this transformed scene. */
     struct KzcDynamicArray* transformedObjects; /**< Extracted object list. */
     struct KzuTransformedObjectNode* extractedRootNode; /**< Extracted (transformed) root node. */
+    kzBool hasLayout; /**< Extracted tree contains layout nodes, which are measured and arranged only in a full rebuild. */
+
+    /* The following members are used for detecting changes between extract calls. */
+    struct KzuObjectNode* extractedSceneRootNode; /**< Scene root node when the tree was extracted. */
+    struct KzuCameraNode* extractedViewCamera; /**< Scene view camera when the world matrices were calculated. */
+    const struct KzuPropertyManager* propertyManager; /**< Property manager of the scene when the tree was extracted. */
+    kzUint transformationChangeCount; /**< Transformation change count of the property manager when the world matrices were calculated. */
+    kzUint objectChangeCount; /**< Object change count when the tree was extracted. */
+
+    /* The following members are created in every extract call. */
     struct KzuObjectSource* rootObjectSource; /**< Root object source. */
     struct KzuObjectSourceRuntimeData* objectSourceRuntimeData; /**< Runtime data for object sources. */
 };
@@ -42,6 +54,7 @@ struct KzuTransformedScene
 kzsError kzuTransformedSceneCreate(const struct KzcMemoryManager* memoryManager, struct KzuTransformedScene** out_scene)
 {
     kzUint quickMemorySize = 1 << 20;
+    kzUint runtimeMemorySize = 1 << 18; /* Per-frame data consists only of object lists and iterators, so it needs less than the extracted tree. */
     kzsError result;
     struct KzuTransformedScene* transformedScene;
 
@@ -52,9 +65,18 @@ kzsError kzuTransformedSceneCreate(const struct KzcMemoryManager* memoryManager,
     result = kzcMemoryManagerCreateQuickManager(memoryManager, quickMemorySize, &transformedScene->quickMemoryManager);
     kzsErrorForward(result);
 
+    result = kzcMemoryManagerCreateQuickManager(memoryManager, runtimeMemorySize, &transformedScene->runtimeMemoryManager);
+    kzsErrorForward(result);
+
     transformedScene->originalScene = KZ_NULL;
     transformedScene->transformedObjects = KZ_NULL;
     transformedScene->extractedRootNode = KZ_NULL;
+    transformedScene->hasLayout = KZ_FALSE;
+    transformedScene->extractedSceneRootNode = KZ_NULL;
+    transformedScene->extractedViewCamera = KZ_NULL;
+    transformedScene->propertyManager = KZ_NULL;
+    transformedScene->transformationChangeCount = 0;
+    transformedScene->objectChangeCount = 0;
     transformedScene->rootObjectSource = KZ_NULL;
     transformedScene->objectSourceRuntimeData = KZ_NULL;
 
@@ -68,6 +90,8 @@ kzsError kzuTransformedSceneDelete(struct KzuTransformedScene* transformedScene)
 
     kzsAssert(kzcIsValidPointer(transformedScene));
 
+    result = kzcMemoryManagerDelete(transformedScene->runtimeMemoryManager);
+    kzsErrorForward(result);
     result = kzcMemoryManagerDelete(transformedScene->quickMemoryManager);
     kzsErrorForward(result);
     result = kzcMemoryFreeVariable(transformedScene);
@@ -76,14 +100,11 @@ kzsError kzuTransformedSceneDelete(struct KzuTransformedScene* transformedScene)
     kzsSuccess();
 }
 
-kzsError kzuTransformedSceneExtract(struct KzuTransformedScene* transformedScene, struct KzuScene* scene)
+/** Rebuilds the whole extracted tree from the scene. */
+static kzsError kzuTransformedSceneRebuild_internal(struct KzuTransformedScene* transformedScene, struct KzuScene* scene)
 {
     kzsError result;
-
-    kzsAssert(kzcIsValidPointer(transformedScene));
-
-    /* Save the scene. */
-    transformedScene->originalScene = scene;
+    struct KzcDynamicArrayIterator it;
 
     /* Reset quick memory. */
     result = kzcMemoryManagerResetQuickManager(transformedScene->quickMemoryManager);
@@ -93,19 +114,51 @@ kzsError kzuTransformedSceneExtract(struct KzuTransformedScene* transformedScene
     result = kzcDynamicArrayCreate(transformedScene->quickMemoryManager, &transformedScene->transformedObjects);
     kzsErrorForward(result);
 
-    transformedScene->rootObjectSource = kzuSceneGetRootObjectSource(scene);
-    kzuObjectSourceResetMeasurementInfo(transformedScene->rootObjectSource);
+    result = kzuSceneApplyConstraints(scene, transformedScene->runtimeMemoryManager);
+    kzsErrorForward(result);
 
-    /* Create runtime data for object sources. */
-    result = kzuObjectSourceRuntimeDataCreate(transformedScene->quickMemoryManager, kzuSceneGetRootObjectSource(scene),
-                                              transformedScene->transformedObjects,
-                                              &transformedScene->objectSourceRuntimeData);
+    result = kzuSceneExtract(transformedScene->quickMemoryManager, scene, transformedScene->transformedObjects, &transformedScene->extractedRootNode);
     kzsErrorForward(result);
 
-    result = kzuSceneApplyConstraints(scene, transformedScene->quickMemoryManager);
+    transformedScene->hasLayout = KZ_FALSE;
+    it = kzcDynamicArrayGetIterator(transformedScene->transformedObjects);
+    while (kzcDynamicArrayIterate(it))
+    {
+        struct KzuTransformedObjectNode* transformedObjectNode = (struct KzuTransformedObjectNode*)kzcDynamicArrayIteratorGetValue(it);
+        if (kzuTransformedObjectNodeHasUiData(transformedObjectNode))
+        {
+            transformedScene->hasLayout = KZ_TRUE;
+            break;
+        }
+    }
+
+    kzuTransformedSceneApplyPreRenderingProperties(transformedScene);
+
+    kzsSuccess();
+}
+
+/** Recalculates the world matrices of the extracted tree without rebuilding it. Only valid for trees without layout nodes. */
+static kzsError kzuTransformedSceneUpdateMatrices_internal(const struct KzuTransformedScene* transformedScene, const struct KzuScene* scene)
+{
+    kzsError result;
+    struct KzcDynamicArrayIterator it;
+
+    kzsAssert(!transformedScene->hasLayout);
+
+    result = kzuSceneApplyConstraints(scene, transformedScene->runtimeMemoryManager);
     kzsErrorForward(result);
 
-    result = kzuSceneExtract(transformedScene->quickMemoryManager, scene, transformedScene->transformedObjects, &transformedScene->extractedRootNode);
+    /* Restore local transformations, as the previous world transformations were calculated in place. */
+    it = kzcDynamicArrayGetIterator(transformedScene->transformedObjects);
+    while (kzcDynamicArrayIterate(it))
+    {
+        struct KzuTransformedObjectNode* transformedObjectNode = (struct KzuTransformedObjectNode*)kzcDynamicArrayIteratorGetValue(it);
+        struct KzcMatrix4x4 transformation = kzuObjectNodeGetTransformation(kzuTransformedObjectNodeGetObjectNode(transformedObjectNode));
+
+        kzuTransformedObjectNodeSetMatrix(transformedObjectNode, &transformation);
+    }
+
+    result = kzuSceneTransformNode(scene, transformedScene->extractedRootNode, KZ_NULL);
     kzsErrorForward(result);
 
     kzuTransformedSceneApplyPreRenderingProperties(transformedScene);
@@ -113,6 +166,64 @@ kzsError kzuTransformedSceneExtract(struct KzuTransformedScene* transformedScene
     kzsSuccess();
 }
 
+kzsError kzuTransformedSceneExtract(struct KzuTransformedScene* transformedScene, struct KzuScene* scene)
+{
+    kzsError result;
+    struct KzuObjectNode* rootNode;
+    struct KzuCameraNode* viewCamera;
+    const struct KzuPropertyManager* propertyManager;
+    kzBool sameTree;
+
+    kzsAssert(kzcIsValidPointer(transformedScene));
+
+    rootNode = kzuSceneGetRootNode(scene);
+    viewCamera = kzuSceneGetViewCamera(scene);
+    propertyManager = kzuObjectNodeGetPropertyManager(rootNode);
+
+    /* The extracted tree is kept as long as the scene graph hierarchy stays the same. */
+    sameTree = transformedScene->originalScene == scene &&
+               transformedScene->extractedSceneRootNode == rootNode &&
+               transformedScene->propertyManager == propertyManager &&
+               transformedScene->objectChangeCount == kzuPropertyManagerGetObjectChangeCount(propertyManager);
+
+    /* Save the scene. */
+    transformedScene->originalScene = scene;
+
+    /* Reset per-frame quick memory. */
+    result = kzcMemoryManagerResetQuickManager(transformedScene->runtimeMemoryManager);
+    kzsErrorForward(result);
+
+    if (!sameTree || (transformedScene->hasLayout && transformedScene->transformationChangeCount != kzuPropertyManagerGetTransformationChangeCount(propertyManager)))
+    {
+        result = kzuTransformedSceneRebuild_internal(transformedScene, scene);
+        kzsErrorForward(result);
+    }
+    else if (transformedScene->transformationChangeCount != kzuPropertyManagerGetTransformationChangeCount(propertyManager) ||
+             transformedScene->extractedViewCamera != viewCamera)
+    {
+        result = kzuTransformedSceneUpdateMatrices_internal(transformedScene, scene);
+        kzsErrorForward(result);
+    }
+
+    /* Constraints may have changed properties, so the counts are stored only after they have been applied. */
+    transformedScene->extractedSceneRootNode = rootNode;
+    transformedScene->extractedViewCamera = viewCamera;
+    transformedScene->propertyManager = propertyManager;
+    transformedScene->transformationChangeCount = kzuPropertyManagerGetTransformationChangeCount(propertyManager);
+    transformedScene->objectChangeCount = kzuPropertyManagerGetObjectChangeCount(propertyManager);
+
+    transformedScene->rootObjectSource = kzuSceneGetRootObjectSource(scene);
+    kzuObjectSourceResetMeasurementInfo(transformedScene->rootObjectSource);
+
+    /* Create runtime data for object sources. Filter outputs depend on the render pass camera, so they are recreated in every frame. */
+    result = kzuObjectSourceRuntimeDataCreate(transformedScene->runtimeMemoryManager, transformedScene->rootObjectSource,
+                                              transformedScene->transformedObjects,
+                                              &transformedScene->objectSourceRuntimeData);
+    kzsErrorForward(result);
+
+    kzsSuccess();
+}
+
 void kzuTransformedSceneApplyPreRenderingProperties(const struct KzuTransformedScene* transformedScene)
 {
     struct KzcDynamicArrayIterator it;
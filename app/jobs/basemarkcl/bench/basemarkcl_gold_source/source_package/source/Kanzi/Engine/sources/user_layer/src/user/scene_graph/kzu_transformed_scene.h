@@ -34,7 +34,12 @@ kzsError kzuTransformedSceneCreate(const struct KzcMemoryManager* memoryManager,
 /** Delete a transformed scene object. */
 kzsError kzuTransformedSceneDelete(struct KzuTransformedScene* transformedScene);
 
-/** Generates a transformed scene from a scene. */
+/**
+* Generates a transformed scene from a scene. The extracted tree is kept between calls and rebuilt only when the scene
+* hierarchy has changed. If only transformation or layout properties have changed, world matrices are recalculated for the existing tree.
+* Changes made outside the property manager and the object node hierarchy, for example changes in mesh data that affect
+* layouts, are not detected. Call kzuPropertyManagerMarkObjectChanged() after such changes to rebuild the tree.
+*/
 kzsError kzuTransformedSceneExtract(struct KzuTransformedScene* transformedScene, struct KzuScene* scene);
 
 /** Applies pre-rendering properties for transformed scene such as face to camera. */
@@ -19,6 +19,7 @@
 #include <user/properties/kzu_property.h>
 #include <user/properties/kzu_void_property.h>
 #include <user/properties/kzu_property_collection.h>
+#include <user/properties/kzu_property_manager.h>
 
 #include <core/util/math/kzc_vector2.h>
 #include <core/util/math/kzc_vector3.h>
@@ -415,6 +416,7 @@ void kzuUiComponentNodeSetMeasureFunction(const struct KzuUiComponentNode* uiCom
     kzsAssert(kzcIsValidPointer(uiComponentNodeData));
 
     uiComponentNodeData->measureFunction = function;
+    kzuPropertyManagerMarkObjectChanged(kzuObjectNodeGetPropertyManager(kzuUiComponentNodeToObjectNode(uiComponentNode)));
 }
 
 void kzuUiComponentNodeSetArrangeFunction(const struct KzuUiComponentNode* uiComponentNode, KzuUiComponentArrangeFunction function)
@@ -424,6 +426,7 @@ void kzuUiComponentNodeSetArrangeFunction(const struct KzuUiComponentNode* uiCom
     kzsAssert(kzcIsValidPointer(uiComponentNodeData));
 
     uiComponentNodeData->arrangeFunction = function;
+    kzuPropertyManagerMarkObjectChanged(kzuObjectNodeGetPropertyManager(kzuUiComponentNodeToObjectNode(uiComponentNode)));
 }
 
 void kzuUiComponentNodeSetSpecificCopyFunction(const struct KzuUiComponentNode* uiComponentNode, KzuUiComponentSpecificCopyFunction function)